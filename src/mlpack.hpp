@@ -13,6 +13,9 @@
  * #include <mlpack.hpp>
  * ```
  *
+ * Networks of arma::fmat also need MLPACK_ENABLE_ANN_SERIALIZATION_FMAT to be
+ * defined.
+ *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
  * 3-clause BSD license along with mlpack.  If not, see
@@ -75,6 +78,7 @@
 #include "mlpack/methods/sparse_autoencoder.hpp"
 #include "mlpack/methods/sparse_coding.hpp"
 #include "mlpack/methods/svdplusplus.hpp"
+#include "mlpack/methods/xgboost.hpp"
 
 // Include reverse compatibility.
 #include "mlpack/namespace_compat.hpp"
@@ -0,0 +1,214 @@
+/**
+ * @file core/data/chunked_reader.hpp
+ *
+ * Definition of the ChunkedReader class, which reads a dataset from a file a
+ * fixed number of points at a time, so that datasets larger than memory can be
+ * processed.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_READER_HPP
+#define MLPACK_CORE_DATA_CHUNKED_READER_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "dataset_mapper.hpp"
+#include "extension.hpp"
+#include "load_csv.hpp"
+#include "string_algorithms.hpp"
+
+namespace mlpack {
+namespace data {
+
+/**
+ * The ChunkedReader class reads a dataset from a file in chunks of at most
+ * ChunkSize() points.  Only the current chunk is held in memory, so a file of
+ * any size can be processed with bounded memory, for instance by a streaming
+ * learner such as HoeffdingTree.  As with data::Load(), each point is one line
+ * of the file, and each point is returned as one column of the chunk.
+ *
+ * The following formats are supported, detected by the extension of the file:
+ *
+ *  - CSV (.csv), TSV (.tsv) and space-separated text (.txt) files, with no
+ *    header.  These may contain categorical values, if a DatasetInfo is given
+ *    to Next().
+ *  - Armadillo binary files (.bin) holding doubles or floats, as written by
+ *    data::Save() (that is, with one point per row of the stored matrix).
+ *
+ * Optionally, the last value of each point may be read as a label, as is often
+ * done for labeled datasets stored in a single file.
+ *
+ * When categorical data is read with a DatasetInfo that has no dimensions yet,
+ * the type of each dimension is determined from the first chunk only: a
+ * dimension is categorical if any of its values in the first chunk is not
+ * numeric.  Later chunks may add new categories to the mappings of categorical
+ * dimensions, but a non-numeric value in a numeric dimension causes an
+ * exception.  If the first chunk is not representative, give a DatasetInfo
+ * that already has the right types.
+ *
+ * Example use:
+ *
+ * @code
+ * data::ChunkedReader reader("dataset.csv", 100000);
+ * data::DatasetInfo info;
+ * arma::mat chunk;
+ * arma::Row<size_t> labels;
+ * while (reader.Next(chunk, info, labels))
+ * {
+ *   // Do something with the chunk.
+ * }
+ * @endcode
+ */
+class ChunkedReader
+{
+ public:
+  /**
+   * Open the given file for reading in chunks of the given number of points.
+   * An exception is thrown if the file cannot be opened or its format is not
+   * supported.
+   *
+   * @param filename Name of the file to read.
+   * @param chunkSize Maximum number of points in each chunk.
+   */
+  ChunkedReader(const std::string& filename, const size_t chunkSize = 10000);
+
+  /**
+   * Read the next chunk of numeric data from the file.  If there are no more
+   * points in the file, the chunk is cleared and false is returned.
+   *
+   * @param chunk Matrix to store the points of the chunk in.
+   * @return true if any points were read.
+   */
+  template<typename eT>
+  bool Next(arma::Mat<eT>& chunk);
+
+  /**
+   * Read the next chunk of numeric data from the file, taking the last value
+   * of each point as its label.  If there are no more points in the file, the
+   * chunk and labels are cleared and false is returned.
+   *
+   * @param chunk Matrix to store the points of the chunk in.
+   * @param labels Row to store the labels of the points in.
+   * @return true if any points were read.
+   */
+  template<typename eT>
+  bool Next(arma::Mat<eT>& chunk, arma::Row<size_t>& labels);
+
+  /**
+   * Read the next chunk of data, which may be categorical, from the file,
+   * mapping categorical values with the given DatasetMapper.  If there are no
+   * more points in the file, the chunk is cleared and false is returned.
+   *
+   * @param chunk Matrix to store the points of the chunk in.
+   * @param info DatasetMapper to use for categorical values.
+   * @return true if any points were read.
+   */
+  template<typename eT, typename PolicyType>
+  bool Next(arma::Mat<eT>& chunk, DatasetMapper<PolicyType>& info);
+
+  /**
+   * Read the next chunk of data, which may be categorical, from the file,
+   * mapping categorical values with the given DatasetMapper and taking the
+   * last value of each point as its label.  The label is not part of the
+   * DatasetMapper's dimensions.  If there are no more points in the file, the
+   * chunk and labels are cleared and false is returned.
+   *
+   * @param chunk Matrix to store the points of the chunk in.
+   * @param info DatasetMapper to use for categorical values.
+   * @param labels Row to store the labels of the points in.
+   * @return true if any points were read.
+   */
+  template<typename eT, typename PolicyType>
+  bool Next(arma::Mat<eT>& chunk,
+            DatasetMapper<PolicyType>& info,
+            arma::Row<size_t>& labels);
+
+  /**
+   * Go back to the start of the file, so that the next call to Next() returns
+   * the first chunk again.
+   */
+  void Reset();
+
+  //! Get the name of the file being read.
+  const std::string& Filename() const { return filename; }
+
+  //! Get the maximum number of points in each chunk.
+  size_t ChunkSize() const { return chunkSize; }
+  //! Modify the maximum number of points in each chunk.
+  size_t& ChunkSize() { return chunkSize; }
+
+  //! Get the number of points read since the start of the file.
+  size_t PointsRead() const { return pointsRead; }
+
+ private:
+  /**
+   * Read the next chunk; info and labels may be NULL if they are not needed.
+   */
+  template<typename eT, typename PolicyType>
+  bool NextInternal(arma::Mat<eT>& chunk,
+                    DatasetMapper<PolicyType>* info,
+                    arma::Row<size_t>* labels);
+
+  /**
+   * Read the next chunk of a text file into the tokens buffer, returning the
+   * number of points read.
+   */
+  size_t ReadTokens();
+
+  /**
+   * Read the values of the next count points of an Armadillo binary file,
+   * stored as FileElemType, into the given chunk (and labels, if not NULL).
+   */
+  template<typename FileElemType, typename eT>
+  void ReadBinary(arma::Mat<eT>& chunk,
+                  const size_t count,
+                  arma::Row<size_t>* labels);
+
+  //! Read the header of an Armadillo binary file.
+  void ReadBinaryHeader();
+
+  //! Convert the given label token, throwing if it is not a valid label.
+  size_t ConvertLabel(const std::string& token);
+
+  //! Convert the given label value, throwing if it is not a valid label.
+  size_t ToLabel(const double value) const;
+
+  //! The name of the file.
+  std::string filename;
+  //! The maximum number of points in each chunk.
+  size_t chunkSize;
+  //! The file being read.
+  std::ifstream stream;
+  //! Whether the file is an Armadillo binary file.
+  bool binary;
+  //! The delimiter between values, for text files.
+  char delim;
+  //! Whether the binary file holds floats instead of doubles.
+  bool binaryFloat;
+  //! The total number of points in the binary file.
+  size_t binaryPoints;
+  //! The position of the first value in the binary file.
+  std::streampos dataStart;
+  //! The number of values of each point (including the label), or 0 if no
+  //! point has been read yet.
+  size_t dimensionality;
+  //! The number of points read since the start of the file.
+  size_t pointsRead;
+  //! The number of lines read since the start of the file.
+  size_t lineNumber;
+  //! The values of the current chunk of a text file, point by point.
+  std::vector<std::string> tokens;
+  //! Used to convert numeric tokens.
+  LoadCSV converter;
+};
+
+} // namespace data
+} // namespace mlpack
+
+// Include implementation.
+#include "chunked_reader_impl.hpp"
+
+#endif
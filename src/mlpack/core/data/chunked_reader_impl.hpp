@@ -0,0 +1,359 @@
+/**
+ * @file core/data/chunked_reader_impl.hpp
+ *
+ * Implementation of the ChunkedReader class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_CORE_DATA_CHUNKED_READER_IMPL_HPP
+#define MLPACK_CORE_DATA_CHUNKED_READER_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "chunked_reader.hpp"
+
+namespace mlpack {
+namespace data {
+
+inline ChunkedReader::ChunkedReader(const std::string& filename,
+                                    const size_t chunkSize) :
+    filename(filename),
+    chunkSize(chunkSize),
+    binary(false),
+    delim(','),
+    binaryFloat(false),
+    binaryPoints(0),
+    dataStart(0),
+    dimensionality(0),
+    pointsRead(0),
+    lineNumber(0)
+{
+  if (chunkSize == 0)
+  {
+    throw std::invalid_argument("ChunkedReader::ChunkedReader(): chunk size "
+        "must be greater than 0!");
+  }
+
+  const std::string extension = Extension(filename);
+  if (extension == "csv")
+    delim = ',';
+  else if (extension == "tsv")
+    delim = '\t';
+  else if (extension == "txt")
+    delim = ' ';
+  else if (extension == "bin")
+    binary = true;
+  else
+  {
+    throw std::invalid_argument("ChunkedReader::ChunkedReader(): cannot read '"
+        + filename + "' in chunks; only .csv, .tsv, .txt and .bin files are "
+        "supported!");
+  }
+
+  stream.open(filename, binary ? (std::ios::in | std::ios::binary) :
+      std::ios::in);
+  if (!stream.is_open())
+  {
+    throw std::runtime_error("ChunkedReader::ChunkedReader(): cannot open file "
+        "'" + filename + "'!");
+  }
+
+  if (binary)
+    ReadBinaryHeader();
+}
+
+template<typename eT>
+bool ChunkedReader::Next(arma::Mat<eT>& chunk)
+{
+  return NextInternal(chunk, (DatasetInfo*) NULL, NULL);
+}
+
+template<typename eT>
+bool ChunkedReader::Next(arma::Mat<eT>& chunk, arma::Row<size_t>& labels)
+{
+  return NextInternal(chunk, (DatasetInfo*) NULL, &labels);
+}
+
+template<typename eT, typename PolicyType>
+bool ChunkedReader::Next(arma::Mat<eT>& chunk, DatasetMapper<PolicyType>& info)
+{
+  return NextInternal(chunk, &info, NULL);
+}
+
+template<typename eT, typename PolicyType>
+bool ChunkedReader::Next(arma::Mat<eT>& chunk,
+                         DatasetMapper<PolicyType>& info,
+                         arma::Row<size_t>& labels)
+{
+  return NextInternal(chunk, &info, &labels);
+}
+
+inline void ChunkedReader::Reset()
+{
+  stream.clear();
+  stream.seekg(binary ? dataStart : std::streampos(0));
+  pointsRead = 0;
+  lineNumber = 0;
+}
+
+template<typename eT, typename PolicyType>
+bool ChunkedReader::NextInternal(arma::Mat<eT>& chunk,
+                                 DatasetMapper<PolicyType>* info,
+                                 arma::Row<size_t>* labels)
+{
+  const size_t count = binary ? std::min(chunkSize, binaryPoints - pointsRead) :
+      ReadTokens();
+  if (count == 0)
+  {
+    chunk.clear();
+    if (labels != NULL)
+      labels->clear();
+    return false;
+  }
+
+  const size_t labelDims = (labels != NULL) ? 1 : 0;
+  if (dimensionality <= labelDims)
+  {
+    throw std::runtime_error("ChunkedReader::Next(): the points in '" +
+        filename + "' have no values besides the label!");
+  }
+  const size_t dims = dimensionality - labelDims;
+
+  if (info != NULL && info->Dimensionality() == 0)
+  {
+    // The types of the dimensions are determined from the first chunk.
+    info->SetDimensionality(dims);
+    if (PolicyType::NeedsFirstPass && !binary)
+    {
+      for (size_t i = 0; i < count; ++i)
+        for (size_t d = 0; d < dims; ++d)
+          info->template MapFirstPass<eT>(tokens[i * dimensionality + d], d);
+    }
+  }
+  else if (info != NULL && info->Dimensionality() != dims)
+  {
+    std::ostringstream oss;
+    oss << "ChunkedReader::Next(): given DatasetInfo has dimensionality "
+        << info->Dimensionality() << ", but data has dimensionality " << dims
+        << "!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  chunk.set_size(dims, count);
+  if (labels != NULL)
+    labels->set_size(count);
+
+  if (binary)
+  {
+    if (binaryFloat)
+      ReadBinary<float>(chunk, count, labels);
+    else
+      ReadBinary<double>(chunk, count, labels);
+  }
+  else
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      const std::string* pointTokens = &tokens[i * dimensionality];
+      for (size_t d = 0; d < dims; ++d)
+      {
+        if (info == NULL)
+        {
+          if (!converter.ConvertToken(chunk(d, i), pointTokens[d]))
+          {
+            std::ostringstream oss;
+            oss << "ChunkedReader::Next(): cannot convert value '"
+                << pointTokens[d] << "' in dimension " << d << " of '"
+                << filename << "'!";
+            throw std::runtime_error(oss.str());
+          }
+        }
+        else
+        {
+          // Mapping a non-numeric value would turn a numeric dimension into a
+          // categorical one, but the values of earlier chunks were not mapped.
+          const Datatype type = info->Type(d);
+          chunk(d, i) = info->template MapString<eT>(pointTokens[d], d);
+          if (info->Type(d) != type)
+          {
+            std::ostringstream oss;
+            oss << "ChunkedReader::Next(): non-numeric value '"
+                << pointTokens[d] << "' found in dimension " << d << " of '"
+                << filename << "', which is numeric!";
+            throw std::runtime_error(oss.str());
+          }
+        }
+      }
+
+      if (labels != NULL)
+        (*labels)[i] = ConvertLabel(pointTokens[dims]);
+    }
+  }
+
+  pointsRead += count;
+  return true;
+}
+
+inline size_t ChunkedReader::ReadTokens()
+{
+  tokens.clear();
+
+  size_t count = 0;
+  std::string line, token, part;
+  std::stringstream lineStream;
+  while (count < chunkSize && std::getline(stream, line))
+  {
+    ++lineNumber;
+
+    // Remove whitespace from either side, and skip empty lines.
+    Trim(line);
+    if (line.size() == 0)
+      continue;
+
+    const size_t firstToken = tokens.size();
+    lineStream.clear();
+    lineStream.str(line);
+    while (lineStream.good())
+    {
+      std::getline(lineStream, token, delim);
+      Trim(token);
+
+      // Quoted values may contain the delimiter.
+      if (token.size() > 0 && token[0] == '"')
+      {
+        while (lineStream.good() &&
+            (token.size() == 1 || token[token.size() - 1] != '"'))
+        {
+          std::getline(lineStream, part, delim);
+          token += delim;
+          token += part;
+        }
+      }
+
+      // Consecutive spaces separate values in space-separated files.
+      if (delim == ' ' && token.size() == 0)
+        continue;
+
+      tokens.push_back(token);
+    }
+
+    const size_t lineDims = tokens.size() - firstToken;
+    if (dimensionality == 0)
+    {
+      dimensionality = lineDims;
+    }
+    else if (lineDims != dimensionality)
+    {
+      std::ostringstream oss;
+      oss << "ChunkedReader::Next(): line " << lineNumber << " of '" << filename
+          << "' has " << lineDims << " values, but " << dimensionality
+          << " were expected!";
+      throw std::runtime_error(oss.str());
+    }
+
+    ++count;
+  }
+
+  return count;
+}
+
+template<typename FileElemType, typename eT>
+void ChunkedReader::ReadBinary(arma::Mat<eT>& chunk,
+                               const size_t count,
+                               arma::Row<size_t>* labels)
+{
+  arma::Col<FileElemType> buffer(count);
+  for (size_t d = 0; d < dimensionality; ++d)
+  {
+    // The file holds the transpose of the dataset, so the values of one
+    // dimension of consecutive points are contiguous.
+    const std::streamoff offset = (std::streamoff)
+        ((d * binaryPoints + pointsRead) * sizeof(FileElemType));
+    stream.seekg(dataStart + offset);
+    stream.read((char*) buffer.memptr(), count * sizeof(FileElemType));
+    if (stream.fail())
+    {
+      throw std::runtime_error("ChunkedReader::Next(): unexpected end of file "
+          "'" + filename + "'!");
+    }
+
+    if (d < chunk.n_rows)
+    {
+      for (size_t i = 0; i < count; ++i)
+        chunk(d, i) = eT(buffer[i]);
+    }
+    else
+    {
+      for (size_t i = 0; i < count; ++i)
+        (*labels)[i] = ToLabel((double) buffer[i]);
+    }
+  }
+}
+
+inline void ChunkedReader::ReadBinaryHeader()
+{
+  std::string header;
+  size_t rows = 0;
+  size_t cols = 0;
+  stream >> header >> rows >> cols;
+  if (stream.fail() || header.compare(0, 12, "ARMA_MAT_BIN") != 0)
+  {
+    throw std::runtime_error("ChunkedReader::ChunkedReader(): '" + filename +
+        "' is not an Armadillo binary matrix!");
+  }
+
+  if (header == "ARMA_MAT_BIN_FN008")
+  {
+    binaryFloat = false;
+  }
+  else if (header == "ARMA_MAT_BIN_FN004")
+  {
+    binaryFloat = true;
+  }
+  else
+  {
+    throw std::runtime_error("ChunkedReader::ChunkedReader(): '" + filename +
+        "' must hold doubles or floats to be read in chunks!");
+  }
+
+  // Skip the newline after the header.
+  stream.get();
+  dataStart = stream.tellg();
+
+  // data::Save() stores the transpose of the dataset, so each row of the
+  // stored matrix is one point.
+  binaryPoints = rows;
+  dimensionality = cols;
+}
+
+inline size_t ChunkedReader::ConvertLabel(const std::string& token)
+{
+  double value;
+  if (token.size() == 0 || !converter.ConvertToken(value, token))
+  {
+    throw std::runtime_error("ChunkedReader::Next(): invalid label '" + token +
+        "' in '" + filename + "'; labels must be non-negative integers!");
+  }
+
+  return ToLabel(value);
+}
+
+inline size_t ChunkedReader::ToLabel(const double value) const
+{
+  if (!(value >= 0.0) || value != std::floor(value))
+  {
+    std::ostringstream oss;
+    oss << "ChunkedReader::Next(): invalid label " << value << " in '"
+        << filename << "'; labels must be non-negative integers!";
+    throw std::runtime_error(oss.str());
+  }
+
+  return (size_t) value;
+}
+
+} // namespace data
+} // namespace mlpack
+
+#endif
@@ -27,6 +27,7 @@
 #include "tokenizers/tokenizers.hpp"
 
 #include "binarize.hpp"
+#include "chunked_reader.hpp"
 #include "check_categorical_param.hpp"
 #include "confusion_matrix.hpp"
 #include "dataset_mapper.hpp"
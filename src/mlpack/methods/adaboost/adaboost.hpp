@@ -312,6 +312,11 @@ class AdaBoost
                          const WeakLearnerType& wl,
                          WeakLearnerArgs&&... weakLearnerArgs);
 
+  //! The number of test points in each tile of a batch classification.  All
+  //! weak learners are evaluated on one tile before moving to the next, so
+  //! that the points of the tile stay in cache.
+  static const size_t classifyBlockSize = 256;
+
   //! The number of classes in the model.
   size_t numClasses;
   //! The maximum number of weak learners allowed in the model.
@@ -238,21 +238,39 @@ void AdaBoost<WeakLearnerType, MatType>::Classify(
   probabilities.zeros(numClasses, test.n_cols);
   predictedLabels.set_size(test.n_cols);
 
-  for (size_t i = 0; i < wl.size(); ++i)
+  // The points are split into tiles, and all weak learners are evaluated on
+  // one tile at a time.  Each tile writes only its own columns, so tiles can
+  // be processed in parallel, and the result does not depend on the number of
+  // threads.
+  const size_t blockSize = (size_t) classifyBlockSize;
+  const size_t numBlocks = (test.n_cols + blockSize - 1) / blockSize;
+
+  #pragma omp parallel for schedule(dynamic) if(numBlocks > 1)
+  for (size_t b = 0; b < numBlocks; ++b)
   {
-    wl[i].Classify(test, predictedLabels);
+    const size_t begin = b * blockSize;
+    const size_t count = std::min(blockSize, (size_t) test.n_cols - begin);
 
-    for (size_t j = 0; j < predictedLabels.n_cols; ++j)
-      probabilities(predictedLabels(j), j) += alpha[i];
-  }
+    // Alias the columns of the tile, instead of copying them.
+    const MatType tile(const_cast<ElemType*>(test.colptr(begin)), test.n_rows,
+        count, false, true);
+    arma::Row<size_t> tilePredictions;
 
-  arma::uword maxIndex = 0;
+    for (size_t i = 0; i < wl.size(); ++i)
+    {
+      wl[i].Classify(tile, tilePredictions);
 
-  for (size_t i = 0; i < predictedLabels.n_cols; ++i)
-  {
-    probabilities.col(i) /= arma::accu(probabilities.col(i));
-    probabilities.col(i).max(maxIndex);
-    predictedLabels(i) = maxIndex;
+      for (size_t j = 0; j < count; ++j)
+        probabilities(tilePredictions[j], begin + j) += alpha[i];
+    }
+
+    for (size_t j = begin; j < begin + count; ++j)
+    {
+      arma::uword maxIndex = 0;
+      probabilities.col(j) /= arma::accu(probabilities.col(j));
+      probabilities.col(j).max(maxIndex);
+      predictedLabels[j] = maxIndex;
+    }
   }
 }
 
@@ -394,13 +412,6 @@ typename MatType::elem_type AdaBoost<WeakLearnerType, MatType>::TrainInternal(
   // To be used for prediction by the weak learner.
   arma::Row<size_t> predictedLabels(labels.n_cols);
 
-  // Use tempData to modify input data for incorporating weights.
-  MatType tempData(data);
-
-  // This matrix is a helper matrix used to calculate the final hypothesis.
-  MatType sumFinalH(numClasses, predictedLabels.n_cols);
-  sumFinalH.zeros();
-
   // Load the initial weights into a 2-D matrix.
   const ElemType initWeight = 1.0 / ElemType(data.n_cols * numClasses);
   MatType D(numClasses, data.n_cols);
@@ -409,9 +420,6 @@ typename MatType::elem_type AdaBoost<WeakLearnerType, MatType>::TrainInternal(
   // Weights are stored in this row vector.
   arma::Row<ElemType> weights(predictedLabels.n_cols);
 
-  // This is the final hypothesis.
-  arma::Row<size_t> finalH(predictedLabels.n_cols);
-
   // Now, start the boosting rounds.
   for (size_t i = 0; i < maxIterations; ++i)
   {
@@ -420,9 +428,6 @@ typename MatType::elem_type AdaBoost<WeakLearnerType, MatType>::TrainInternal(
     // rt = (sum) D(i) y(i) ht(xi)
     rt = 0.0;
 
-    // zt is used for weight normalization.
-    zt = 0.0;
-
     // Build the weight vectors.
     weights = sum(D);
 
@@ -433,17 +438,18 @@ typename MatType::elem_type AdaBoost<WeakLearnerType, MatType>::TrainInternal(
     WeakLearnerType w = WeakLearnerTrainer<
         UseExistingWeakLearner, MatType, arma::Row<ElemType>, WeakLearnerType,
         WeakLearnerArgs...
-    >::Train(tempData, labels, numClasses, weights, other, weakLearnerArgs...);
+    >::Train(data, labels, numClasses, weights, other, weakLearnerArgs...);
 
-    w.Classify(tempData, predictedLabels);
+    w.Classify(data, predictedLabels);
 
-    // Now, calculate alpha(t) using ht.
+    // Now, calculate alpha(t) using ht.  The weight of each point is the sum
+    // of its column of D, which is already held in `weights`.
     for (size_t j = 0; j < D.n_cols; ++j) // instead of D, ht
     {
       if (predictedLabels(j) == labels(j))
-        rt += arma::accu(D.col(j));
+        rt += weights(j);
       else
-        rt -= arma::accu(D.col(j));
+        rt -= weights(j);
     }
 
     if ((i > 0) && (std::abs(rt - crt) < tolerance))
@@ -467,44 +473,22 @@ typename MatType::elem_type AdaBoost<WeakLearnerType, MatType>::TrainInternal(
     alpha.push_back(alphat);
     wl.push_back(w);
 
-    // Now start modifying the weights.
-    for (size_t j = 0; j < D.n_cols; ++j)
+    // Now start modifying the weights.  Each column is updated
+    // independently, so this can be done in parallel; the normalization
+    // constant zt is computed afterwards, so that it does not depend on the
+    // number of threads.
+    const ElemType expo = std::exp(alphat);
+    #pragma omp parallel for
+    for (size_t j = 0; j < (size_t) D.n_cols; ++j)
     {
-      const ElemType expo = std::exp(alphat);
       if (predictedLabels(j) == labels(j))
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) /= expo;
-          zt += D(k, j); // * exp(-1 * alphat * yt(j,k) * ht(j,k));
-
-          // Add to the final hypothesis matrix.
-          // sumFinalH(k, j) += (alphat * ht(k, j));
-          if (k == labels(j))
-            sumFinalH(k, j) += (alphat); // * ht(k, j));
-          else
-            sumFinalH(k, j) -= (alphat);
-        }
-      }
+        D.col(j) /= expo;
       else
-      {
-        for (size_t k = 0; k < D.n_rows; ++k)
-        {
-          // We calculate zt, the normalization constant.
-          D(k, j) *= expo;
-          zt += D(k, j);
-
-          // Add to the final hypothesis matrix.
-          if (k == labels(j))
-            sumFinalH(k, j) += alphat; // * ht(k, j));
-          else
-            sumFinalH(k, j) -= alphat;
-        }
-      }
+        D.col(j) *= expo;
     }
 
     // Normalize D.
+    zt = arma::accu(D);
     D /= zt;
 
     // Accumulate the value of zt for the Hamming loss bound.
@@ -16,6 +16,7 @@
 #ifndef MLPACK_METHODS_ANN_ANN_HPP
 #define MLPACK_METHODS_ANN_ANN_HPP
 
+#include "bfloat16.hpp"
 #include "forward_decls.hpp"
 #include "make_alias.hpp"
 
@@ -29,6 +30,11 @@
 #include "regularizer/regularizer.hpp"
 
 #include "ffn.hpp"
+#include "ffn_bfloat16.hpp"
+#include "ffn_data_parallel.hpp"
+#include "ffn_fusion.hpp"
+#include "ffn_inference.hpp"
+#include "ffn_quantization.hpp"
 #include "rnn.hpp"
 
 #endif
@@ -0,0 +1,130 @@
+/**
+ * @file methods/ann/bfloat16.hpp
+ *
+ * Conversions between single-precision floating point values and bfloat16, a
+ * 16-bit storage format that keeps the exponent range of float but only 8 bits
+ * of precision.  This halves the memory needed to store parameters or
+ * activations, for instance for checkpoints or caches of large networks.  See
+ * also FFNBFloat16, which computes the predictions of a network whose
+ * parameters are stored as bfloat16.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_BFLOAT16_HPP
+#define MLPACK_METHODS_ANN_BFLOAT16_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Convert the given value to bfloat16, rounding to the nearest representable
+ * value (ties to even).  NaN values stay NaN and infinite values stay infinite.
+ * The bfloat16 value is returned as its bit pattern.
+ *
+ * @param value Value to convert.
+ * @return Bit pattern of the bfloat16 value.
+ */
+inline uint16_t ToBFloat16(const float value)
+{
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(float));
+
+  // Keep NaNs quiet, so that rounding cannot turn them into infinity.
+  if ((bits & 0x7fffffff) > 0x7f800000)
+    return (uint16_t) ((bits >> 16) | 0x0040);
+
+  // Round to nearest even: add 0x7fff, plus one if the result would be odd.
+  bits += 0x7fff + ((bits >> 16) & 1);
+  return (uint16_t) (bits >> 16);
+}
+
+/**
+ * Convert the given bfloat16 bit pattern to float.  This conversion is exact.
+ *
+ * @param value Bit pattern of the bfloat16 value.
+ * @return The value as a float.
+ */
+inline float FromBFloat16(const uint16_t value)
+{
+  const uint32_t bits = ((uint32_t) value) << 16;
+  float result;
+  std::memcpy(&result, &bits, sizeof(float));
+  return result;
+}
+
+/**
+ * Convert every element of the given matrix to bfloat16, storing the bit
+ * patterns in `output`, which is resized to the size of `input`.
+ *
+ * @param input Matrix to convert.
+ * @param output Matrix to store the bfloat16 bit patterns in.
+ */
+template<typename MatType>
+void ToBFloat16(const MatType& input, arma::Mat<uint16_t>& output)
+{
+  output.set_size(input.n_rows, input.n_cols);
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < (size_t) input.n_elem; ++i)
+    output[i] = ToBFloat16((float) input[i]);
+}
+
+/**
+ * Convert every bfloat16 bit pattern of the given matrix back to the element
+ * type of `output`, which is resized to the size of `input`.
+ *
+ * @param input Matrix of bfloat16 bit patterns.
+ * @param output Matrix to store the converted values in.
+ */
+template<typename MatType>
+void FromBFloat16(const arma::Mat<uint16_t>& input, MatType& output)
+{
+  output.set_size(input.n_rows, input.n_cols);
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < (size_t) input.n_elem; ++i)
+    output[i] = (typename MatType::elem_type) FromBFloat16(input[i]);
+}
+
+/**
+ * Convert the given number of bfloat16 bit patterns to the element type of
+ * `output`, which must have room for them.  This is used to widen a part of a
+ * larger block of bfloat16 values without allocating memory.
+ *
+ * @param input Pointer to the bfloat16 bit patterns.
+ * @param n Number of values to convert.
+ * @param output Pointer to the memory to store the converted values in.
+ */
+template<typename ElemType>
+void FromBFloat16(const uint16_t* input, const size_t n, ElemType* output)
+{
+  #pragma omp parallel for
+  for (size_t i = 0; i < n; ++i)
+    output[i] = (ElemType) FromBFloat16(input[i]);
+}
+
+/**
+ * Round every element of the given matrix to the nearest value that can be
+ * stored in bfloat16.  This can be used to train with the precision of bfloat16
+ * storage while computing in single precision.
+ *
+ * @param m Matrix to round.
+ */
+template<typename MatType>
+void RoundToBFloat16(MatType& m)
+{
+  #pragma omp parallel for
+  for (size_t i = 0; i < (size_t) m.n_elem; ++i)
+  {
+    m[i] = (typename MatType::elem_type) FromBFloat16(
+        ToBFloat16((float) m[i]));
+  }
+}
+
+} // namespace mlpack
+
+#endif
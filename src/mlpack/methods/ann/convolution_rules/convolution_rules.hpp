@@ -15,6 +15,7 @@
 
 #include "border_modes.hpp"
 #include "fft_convolution.hpp"
+#include "im2col_convolution.hpp"
 #include "naive_convolution.hpp"
 #include "svd_convolution.hpp"
 
@@ -0,0 +1,357 @@
+/**
+ * @file methods/ann/convolution_rules/im2col_convolution.hpp
+ *
+ * Implementation of the convolution through lowering of the input to a matrix
+ * of patches (im2col) followed by a matrix multiplication.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_CONVOLUTION_RULES_IM2COL_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/make_alias.hpp>
+#include "border_modes.hpp"
+
+namespace mlpack {
+
+/**
+ * Computes the two-dimensional convolution by copying every patch of the input
+ * that the filter is applied to into one row of a matrix (im2col), so that the
+ * convolution becomes a single matrix multiplication.  The matrix
+ * multiplication is done by BLAS, which is typically much faster than the
+ * direct loops of NaiveConvolution, at the cost of the memory of the lowered
+ * matrix.
+ *
+ * When this rule is used as a convolution rule of the Convolution layer, the
+ * layer does not convolve each pair of input and output maps separately;
+ * instead, the whole batch is lowered at once and the forward pass, the
+ * backward pass and the gradient are each computed with one matrix
+ * multiplication that involves all of the maps.  The static Im2Col() and
+ * Col2Im() functions of this class are used for that.
+ *
+ * FullConvolution: returns the full two-dimensional convolution.
+ * ValidConvolution: returns only those parts of the convolution that are
+ * computed without the zero-padded edges.
+ *
+ * @tparam BorderMode Type of the border mode (FullConvolution or
+ * ValidConvolution).
+ */
+template<typename BorderMode = FullConvolution>
+class Im2ColConvolution
+{
+ public:
+  /**
+   * Perform a convolution (valid mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename InMatType, typename FilMatType, typename OutMatType,
+      typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, ValidConvolution>::value, void>::type
+  Convolution(const InMatType& input,
+              const FilMatType& filter,
+              OutMatType& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1,
+              const bool appending = false,
+              const typename std::enable_if_t<IsMatrix<InMatType>::value>* = 0)
+  {
+    typedef typename GetCubeType<InMatType>::type CubeType;
+
+    // See NaiveConvolution for the computation of the output size.
+    if (!appending)
+    {
+      const size_t filterRows = filter.n_rows * dilationH - (dilationH - 1);
+      const size_t filterCols = filter.n_cols * dilationW - (dilationW - 1);
+      const size_t outputRows = (input.n_rows - filterRows + dH) / dH;
+      const size_t outputCols = (input.n_cols - filterCols + dW) / dW;
+      output.zeros(outputRows, outputCols);
+    }
+
+    CubeType inputCube;
+    MakeAlias(inputCube, const_cast<InMatType&>(input).memptr(), input.n_rows,
+        input.n_cols, 1);
+
+    InMatType columns;
+    Im2Col(inputCube, 0, 1, 1, filter.n_rows, filter.n_cols, output.n_rows,
+        output.n_cols, dH, dW, dilationH, dilationW, columns);
+
+    // Each row of `columns` holds the patch of one element of the output, in
+    // column-major order, so the product has the layout of the output.
+    OutMatType flatOutput;
+    MakeAlias(flatOutput, output.memptr(), output.n_elem, 1);
+    flatOutput += columns * arma::vectorise(filter);
+  }
+
+  /**
+   * Perform a convolution (full mode).
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename InMatType, typename FilMatType, typename OutMatType,
+      typename Border = BorderMode>
+  static typename std::enable_if<
+      std::is_same<Border, FullConvolution>::value, void>::type
+  Convolution(const InMatType& input,
+              const FilMatType& filter,
+              OutMatType& output,
+              const size_t dW = 1,
+              const size_t dH = 1,
+              const size_t dilationW = 1,
+              const size_t dilationH = 1,
+              const bool appending = false,
+              const typename std::enable_if_t<IsMatrix<InMatType>::value>* = 0)
+  {
+    // Pad the input with the size of the filter on each side, and compute the
+    // valid convolution of the result.
+    const size_t paddingRows = filter.n_rows * dilationH - dilationH;
+    const size_t paddingCols = filter.n_cols * dilationW - dilationW;
+
+    InMatType inputPadded(input.n_rows + 2 * paddingRows,
+        input.n_cols + 2 * paddingCols, arma::fill::zeros);
+    inputPadded.submat(paddingRows, paddingCols, paddingRows + input.n_rows - 1,
+        paddingCols + input.n_cols - 1) = input;
+
+    Im2ColConvolution<ValidConvolution>::Convolution(inputPadded, filter,
+        output, dW, dH, dilationW, dilationH, appending);
+  }
+
+  /**
+   * Perform a convolution using 3rd order tensors.
+   *
+   * @param input Input used to perform the convolution.
+   * @param filter Filter used to perform the convolution.
+   * @param output Output data that contains the results of the convolution.
+   * @param dW Stride of filter application in the x direction.
+   * @param dH Stride of filter application in the y direction.
+   * @param dilationW The dilation factor in x direction.
+   * @param dilationH The dilation factor in y direction.
+   * @param appending If true, it will not initialize the output. Instead,
+   *                  it will append the results to the output.
+   */
+  template<typename CubeType>
+  static void Convolution(const CubeType& input,
+                          const CubeType& filter,
+                          CubeType& output,
+                          const size_t dW = 1,
+                          const size_t dH = 1,
+                          const size_t dilationW = 1,
+                          const size_t dilationH = 1,
+                          const bool appending = false,
+                          const typename std::enable_if_t<
+                              IsCube<CubeType>::value>* = 0)
+  {
+    typedef typename GetDenseMatType<CubeType>::type MatType;
+    MatType convOutput;
+    Im2ColConvolution<BorderMode>::Convolution(input.slice(0), filter.slice(0),
+        convOutput, dW, dH, dilationW, dilationH, appending);
+
+    if (!appending)
+      output = CubeType(convOutput.n_rows, convOutput.n_cols, input.n_slices);
+
+    output.slice(0) = convOutput;
+
+    for (size_t i = 1; i < input.n_slices; ++i)
+    {
+      Im2ColConvolution<BorderMode>::Convolution(input.slice(i),
+          filter.slice(i), output.slice(i), dW, dH, dilationW, dilationH,
+          appending);
+    }
+  }
+
+  /**
+   * Lower a set of images with `inMaps` maps each, stored as consecutive
+   * slices of `input` starting at `firstSlice`, to a matrix of patches.  Row
+   * `i + outputRows * (j + outputCols * n)` of `columns` holds the patch of
+   * output element `(i, j)` of image `n`, and column
+   * `ki + filterRows * (kj + filterCols * map)` of `columns` holds filter
+   * element `(ki, kj)` of input map `map`; this is the layout of the filters of
+   * the Convolution layer for one output map.  `columns` is only reallocated
+   * if its size changes.
+   *
+   * @param input Slices of the images to lower.
+   * @param firstSlice Index of the first slice of the first image.
+   * @param inMaps Number of slices of each image.
+   * @param numImages Number of images to lower.
+   * @param filterRows Number of rows of the filter.
+   * @param filterCols Number of columns of the filter.
+   * @param outputRows Number of rows of each output map.
+   * @param outputCols Number of columns of each output map.
+   * @param strideRows Stride of filter application along the rows.
+   * @param strideCols Stride of filter application along the columns.
+   * @param dilationRows Dilation of the filter along the rows.
+   * @param dilationCols Dilation of the filter along the columns.
+   * @param columns Matrix to store the patches in.
+   */
+  template<typename CubeType, typename MatType>
+  static void Im2Col(const CubeType& input,
+                     const size_t firstSlice,
+                     const size_t inMaps,
+                     const size_t numImages,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     const size_t strideRows,
+                     const size_t strideCols,
+                     const size_t dilationRows,
+                     const size_t dilationCols,
+                     MatType& columns)
+  {
+    typedef typename CubeType::elem_type eT;
+
+    columns.set_size(outputRows * outputCols * numImages,
+        filterRows * filterCols * inMaps);
+
+    // Each column of `columns` is filled independently and contiguously.
+    #pragma omp parallel for
+    for (size_t k = 0; k < (size_t) columns.n_cols; ++k)
+    {
+      const size_t ki = k % filterRows;
+      const size_t kj = (k / filterRows) % filterCols;
+      const size_t map = k / (filterRows * filterCols);
+
+      eT* columnPtr = columns.colptr(k);
+      for (size_t n = 0; n < numImages; ++n)
+      {
+        const size_t slice = firstSlice + n * inMaps + map;
+        for (size_t j = 0; j < outputCols; ++j)
+        {
+          const eT* inputPtr = input.slice_colptr(slice,
+              j * strideCols + kj * dilationCols) + ki * dilationRows;
+          for (size_t i = 0; i < outputRows; ++i, ++columnPtr,
+              inputPtr += strideRows)
+            *columnPtr = *inputPtr;
+        }
+      }
+    }
+  }
+
+  /**
+   * Add a matrix of patches with the layout produced by Im2Col() back to the
+   * images it was lowered from; elements of the images that belong to several
+   * patches receive the sum of those patches.  This is the adjoint of
+   * Im2Col(), and is used to compute the gradient with respect to the input.
+   *
+   * @param columns Matrix of patches to add to the images.
+   * @param firstSlice Index of the first slice of the first image.
+   * @param inMaps Number of slices of each image.
+   * @param numImages Number of images to add the patches to.
+   * @param filterRows Number of rows of the filter.
+   * @param filterCols Number of columns of the filter.
+   * @param outputRows Number of rows of each output map.
+   * @param outputCols Number of columns of each output map.
+   * @param strideRows Stride of filter application along the rows.
+   * @param strideCols Stride of filter application along the columns.
+   * @param dilationRows Dilation of the filter along the rows.
+   * @param dilationCols Dilation of the filter along the columns.
+   * @param output Slices of the images to add the patches to.
+   */
+  template<typename MatType, typename CubeType>
+  static void Col2Im(const MatType& columns,
+                     const size_t firstSlice,
+                     const size_t inMaps,
+                     const size_t numImages,
+                     const size_t filterRows,
+                     const size_t filterCols,
+                     const size_t outputRows,
+                     const size_t outputCols,
+                     const size_t strideRows,
+                     const size_t strideCols,
+                     const size_t dilationRows,
+                     const size_t dilationCols,
+                     CubeType& output)
+  {
+    typedef typename CubeType::elem_type eT;
+
+    const size_t outputSize = outputRows * outputCols;
+
+    // Different slices never overlap, so each can be handled by a different
+    // thread.
+    #pragma omp parallel for
+    for (size_t s = 0; s < (size_t) (numImages * inMaps); ++s)
+    {
+      const size_t n = s / inMaps;
+      const size_t map = s % inMaps;
+      for (size_t kj = 0; kj < filterCols; ++kj)
+      {
+        for (size_t ki = 0; ki < filterRows; ++ki)
+        {
+          const size_t k = ki + filterRows * (kj + filterCols * map);
+          const eT* columnPtr = columns.colptr(k) + n * outputSize;
+          for (size_t j = 0; j < outputCols; ++j)
+          {
+            eT* outputPtr = output.slice_colptr(firstSlice + s,
+                j * strideCols + kj * dilationCols) + ki * dilationRows;
+            for (size_t i = 0; i < outputRows; ++i, ++columnPtr,
+                outputPtr += strideRows)
+              *outputPtr += *columnPtr;
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Return the number of images of the given size that can be lowered at once
+   * while keeping the matrix of patches below MaxColumnsSize() elements (but
+   * at least one image).
+   *
+   * @param patchesSize Number of elements of the patches of one image.
+   * @param numImages Total number of images to lower.
+   */
+  static size_t ImagesPerBlock(const size_t patchesSize,
+                               const size_t numImages)
+  {
+    const size_t images = (patchesSize == 0) ? numImages :
+        MaxColumnsSize() / patchesSize;
+    return std::max(size_t(1), std::min(images, numImages));
+  }
+
+  //! Get the maximum number of elements of the matrix of patches of a batch;
+  //! larger batches are lowered a block of images at a time.
+  static size_t MaxColumnsSize() { return 16777216; }
+};  // class Im2ColConvolution
+
+/**
+ * Determine whether a convolution rule is Im2ColConvolution; the Convolution
+ * layer lowers whole batches at once for such rules.
+ */
+template<typename ConvolutionRule>
+struct IsIm2ColConvolution
+{
+  static const bool value = false;
+};
+
+template<typename BorderMode>
+struct IsIm2ColConvolution<Im2ColConvolution<BorderMode>>
+{
+  static const bool value = true;
+};
+
+} // namespace mlpack
+
+#endif
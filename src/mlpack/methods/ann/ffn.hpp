@@ -230,6 +230,11 @@ class FFN
   //! Get the logical dimensions of the input.
   const std::vector<size_t>& InputDimensions() const { return inputDimensions; }
 
+  //! Get the output layer used to evaluate the network.
+  const OutputLayerType& OutputLayer() const { return outputLayer; }
+  //! Modify the output layer used to evaluate the network.
+  OutputLayerType& OutputLayer() { return outputLayer; }
+
   //! Return the current set of weights.  These are linearized: this contains
   //! the weights of every layer.
   const MatType& Parameters() const { return parameters; }
@@ -557,6 +562,10 @@ class FFN
 
   // RNN will call `CheckNetwork()`, which is private.
   friend class RNN<OutputLayerType, InitializationRuleType, MatType>;
+  // FFNDataParallel trains the network with copies of its layers, and needs
+  // access to the training data and `CheckNetwork()`.
+  friend class FFNDataParallel<OutputLayerType, InitializationRuleType,
+                               MatType>;
 }; // class FFN
 
 } // namespace mlpack
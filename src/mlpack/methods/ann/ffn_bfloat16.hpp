@@ -0,0 +1,108 @@
+/**
+ * @file methods/ann/ffn_bfloat16.hpp
+ *
+ * Definition of the FFNBFloat16 class, which computes the predictions of a
+ * trained FFN whose parameters are stored as bfloat16.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_BFLOAT16_HPP
+#define MLPACK_METHODS_ANN_FFN_BFLOAT16_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "bfloat16.hpp"
+#include "ffn.hpp"
+#include "layer/multi_layer.hpp"
+
+#include <numeric>
+
+namespace mlpack {
+
+/**
+ * A trained `FFN` whose parameters are stored as bfloat16 values, which take
+ * half the memory of single-precision parameters.  The parameters are only
+ * widened when they are used: `Predict()` passes each batch through the layers
+ * one at a time, and widens the weights of each layer into scratch memory just
+ * before its forward pass, so that at most the weights of the largest layer are
+ * held in full precision at once.  The computation itself is done with
+ * `MatType`, and the activations of a batch are kept in `MatType` as well.
+ *
+ * Example usage:
+ *
+ * @code
+ * FFN<NegativeLogLikelihoodType<arma::fmat>, RandomInitialization,
+ *     arma::fmat> model;
+ * // ... add layers and train the model ...
+ *
+ * FFNBFloat16<arma::fmat> stored(model);
+ * // `model` can now be destroyed.
+ * stored.Predict(testData, predictions);
+ * @endcode
+ *
+ * @tparam MatType Type of matrix used by the network.
+ */
+template<typename MatType = arma::mat>
+class FFNBFloat16
+{
+ public:
+  //! Create an empty FFNBFloat16 object.
+  FFNBFloat16();
+
+  /**
+   * Create the FFNBFloat16 object from the given network, which must have been
+   * trained or used for prediction already (so that its parameters and the
+   * dimensions of each layer are set).  The parameters of the network are
+   * rounded to the nearest bfloat16 values.
+   *
+   * @param model Network to store.
+   */
+  template<typename OutputLayerType, typename InitializationRuleType>
+  FFNBFloat16(
+      const FFN<OutputLayerType, InitializationRuleType, MatType>& model);
+
+  /**
+   * Compute the predictions of the network for the given points (one per
+   * column), and store them in `results`.
+   *
+   * @param predictors Points to compute predictions for.
+   * @param results Matrix to store the predictions in.
+   * @param batchSize Number of points to pass through the network at once.
+   */
+  void Predict(const MatType& predictors,
+               MatType& results,
+               const size_t batchSize = 128);
+
+  //! Get the bfloat16 bit patterns of the parameters of the network.
+  const arma::Mat<uint16_t>& Parameters() const { return parameters; }
+
+  //! Get the number of elements in each input point.
+  size_t InputSize() const { return inputSize; }
+  //! Get the number of elements in each prediction.
+  size_t OutputSize() const { return outputSize; }
+
+ private:
+  //! Copy of the layers of the network.
+  MultiLayer<MatType> network;
+  //! Parameters of the network, as bfloat16 bit patterns.
+  arma::Mat<uint16_t> parameters;
+  //! Offset of the weights of each layer in `parameters`.
+  std::vector<size_t> offsets;
+  //! Scratch memory for the widened weights of one layer.
+  MatType weights;
+
+  //! Number of elements in each input point.
+  size_t inputSize;
+  //! Number of elements in each prediction.
+  size_t outputSize;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "ffn_bfloat16_impl.hpp"
+
+#endif
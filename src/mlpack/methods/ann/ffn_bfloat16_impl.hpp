@@ -0,0 +1,140 @@
+/**
+ * @file methods/ann/ffn_bfloat16_impl.hpp
+ *
+ * Implementation of the FFNBFloat16 class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_BFLOAT16_IMPL_HPP
+#define MLPACK_METHODS_ANN_FFN_BFLOAT16_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ffn_bfloat16.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+FFNBFloat16<MatType>::FFNBFloat16() :
+    inputSize(0),
+    outputSize(0)
+{
+  // Nothing to do.
+}
+
+template<typename MatType>
+template<typename OutputLayerType, typename InitializationRuleType>
+FFNBFloat16<MatType>::FFNBFloat16(
+    const FFN<OutputLayerType, InitializationRuleType, MatType>& model) :
+    inputSize(0),
+    outputSize(0)
+{
+  if (model.Network().size() == 0)
+  {
+    throw std::invalid_argument("FFNBFloat16::FFNBFloat16(): cannot use "
+        "network with no layers!");
+  }
+
+  // Copy the layers of the model; the input dimensions of the first layer are
+  // only known once the model has been used.
+  for (size_t i = 0; i < model.Network().size(); ++i)
+    network.Add(model.Network()[i]->Clone());
+
+  const std::vector<size_t>& inputDimensions =
+      model.Network().front()->InputDimensions();
+  if (inputDimensions.empty())
+  {
+    throw std::invalid_argument("FFNBFloat16::FFNBFloat16(): the network "
+        "must be trained or used for prediction first!");
+  }
+
+  network.InputDimensions() = inputDimensions;
+  inputSize = std::accumulate(inputDimensions.begin(), inputDimensions.end(),
+      (size_t) 1, std::multiplies<size_t>());
+  outputSize = network.OutputSize();
+
+  if (network.WeightSize() != model.Parameters().n_elem)
+  {
+    throw std::invalid_argument("FFNBFloat16::FFNBFloat16(): the network "
+        "must be trained or used for prediction first!");
+  }
+
+  network.Training() = false;
+
+  // Store the parameters as bfloat16, and find where the weights of each layer
+  // start; the scratch memory only has to hold the largest layer.
+  ToBFloat16(model.Parameters(), parameters);
+
+  const std::vector<Layer<MatType>*>& layers = network.Network();
+  offsets.resize(layers.size());
+  size_t offset = 0, maxWeightSize = 0;
+  for (size_t i = 0; i < layers.size(); ++i)
+  {
+    offsets[i] = offset;
+    offset += layers[i]->WeightSize();
+    maxWeightSize = std::max(maxWeightSize, layers[i]->WeightSize());
+  }
+
+  weights.set_size(maxWeightSize, 1);
+}
+
+template<typename MatType>
+void FFNBFloat16<MatType>::Predict(const MatType& predictors,
+                                   MatType& results,
+                                   const size_t batchSize)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  if (predictors.n_rows != inputSize)
+  {
+    std::ostringstream oss;
+    oss << "FFNBFloat16::Predict(): input size (" << predictors.n_rows << ") "
+        << "does not match the input size of the network (" << inputSize
+        << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  const std::vector<Layer<MatType>*>& layers = network.Network();
+  results.set_size(outputSize, predictors.n_cols);
+
+  // The outputs of the layers alternate between two buffers.
+  MatType input, buffers[2], resultAlias;
+  for (size_t i = 0; i < predictors.n_cols; i += batchSize)
+  {
+    const size_t effectiveBatchSize = std::min(batchSize,
+        size_t(predictors.n_cols) - i);
+
+    MakeAlias(input, const_cast<ElemType*>(predictors.colptr(i)),
+        predictors.n_rows, effectiveBatchSize);
+    MakeAlias(resultAlias, results.colptr(i), results.n_rows,
+        effectiveBatchSize);
+
+    const MatType* layerInput = &input;
+    for (size_t l = 0; l < layers.size(); ++l)
+    {
+      // Widen the weights of this layer only.
+      const size_t weightSize = layers[l]->WeightSize();
+      if (weightSize > 0)
+      {
+        FromBFloat16(parameters.memptr() + offsets[l], weightSize,
+            weights.memptr());
+        layers[l]->SetWeights(weights.memptr());
+      }
+
+      // The last layer writes directly into the results.
+      MatType& layerOutput = (l == layers.size() - 1) ? resultAlias :
+          buffers[l % 2];
+      if (l != layers.size() - 1)
+        layerOutput.set_size(layers[l]->OutputSize(), effectiveBatchSize);
+
+      layers[l]->Forward(*layerInput, layerOutput);
+      layerInput = &layerOutput;
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,246 @@
+/**
+ * @file methods/ann/ffn_data_parallel.hpp
+ *
+ * Definition of the FFNDataParallel class, which trains an FFN by splitting
+ * each mini-batch over copies of the network on several threads.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_DATA_PARALLEL_HPP
+#define MLPACK_METHODS_ANN_FFN_DATA_PARALLEL_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+#include "layer/multi_layer.hpp"
+
+#include <numeric>
+
+namespace mlpack {
+
+/**
+ * Data-parallel training for an `FFN`.  Instead of relying on a multithreaded
+ * BLAS inside each matrix product (which scales poorly for small layers), each
+ * mini-batch is split into one shard per replica of the network, and the
+ * shards are processed at the same time on different threads (with OpenMP).
+ * The first replica is the network of the model itself; the other replicas are
+ * copies of its layers, which use the same parameters but have their own
+ * memory for activations.  The gradients of the shards are then summed with a
+ * tree reduction into the gradient the optimizer sees (in log2(replicas)
+ * steps, where each step adds pairs of gradients in parallel), before the
+ * optimizer updates the shared parameters.
+ *
+ * Example usage:
+ *
+ * @code
+ * FFN<> model;
+ * // ... add layers ...
+ *
+ * FFNDataParallel<> trainer(model, 4);
+ * ens::Adam optimizer(0.001, 256);
+ * trainer.Train(trainData, trainLabels, optimizer);
+ *
+ * // The model is trained as if `model.Train()` had been called.
+ * model.Predict(testData, predictions);
+ * @endcode
+ *
+ * The objective and the gradient of a mini-batch are combined from those of its
+ * shards so that they are the same as for `FFN::Train()`: with the 'sum'
+ * reduction of the output layer they are summed, and with 'mean' reduction
+ * each shard is weighted by its fraction of the batch.  (Output layers without
+ * a `Reduction()` member, whose objective is not a sum or a mean over points,
+ * are not supported.)  The loss and the gradient of the regularization
+ * penalties of layers (e.g. of a regularized `Linear` layer) only depend on the
+ * parameters, and are counted once per batch: the extra copies included in the
+ * gradients of the shards are removed with the gradient of a single point with
+ * zero error, computed by one more replica.  Layers that compute statistics of
+ * the batch (such as `BatchNorm`) compute them per shard, and the running
+ * statistics of the model are those of the first replica.
+ *
+ * For the best speedup, use a single-threaded BLAS, or limit the number of
+ * BLAS threads, so that the replicas do not compete for cores.  If mlpack is
+ * built without OpenMP, the shards are processed one after another.
+ *
+ * @tparam OutputLayerType The output layer type used to evaluate the network.
+ * @tparam InitializationRuleType Rule used to initialize the weight matrix.
+ * @tparam MatType Type of matrix used by the network.
+ */
+template<typename OutputLayerType = NegativeLogLikelihood,
+         typename InitializationRuleType = RandomInitialization,
+         typename MatType = arma::mat>
+class FFNDataParallel
+{
+ public:
+  //! The type of the network being trained.
+  typedef FFN<OutputLayerType, InitializationRuleType, MatType> NetworkType;
+  typedef typename MatType::elem_type ElemType;
+
+  /**
+   * Create the FFNDataParallel object for the given network.  The network is
+   * held by reference, and is modified by `Train()`.
+   *
+   * @param model Network to train.
+   * @param numThreads Number of replicas of the network, and so of shards of
+   *     each mini-batch (0 uses one per OpenMP thread).
+   * @throws std::invalid_argument if the output layer has no `Reduction()`
+   *     member.
+   */
+  FFNDataParallel(NetworkType& model, const size_t numThreads = 0);
+
+  /**
+   * Train the network on the given data with the given optimizer, in the same
+   * way as `FFN::Train()` (including the initialization of the parameters, if
+   * they are not set yet), but with each mini-batch split over the replicas.
+   * The optimizer must be an optimizer for separable functions (such as
+   * `ens::SGD` or `ens::Adam`).
+   *
+   * @tparam OptimizerType Type of optimizer to use to train the model.
+   * @tparam CallbackTypes Types of Callback Functions.
+   * @param predictors Input training variables.
+   * @param responses Outputs results from input training variables.
+   * @param optimizer Instantiated optimizer used to train the model.
+   * @param callbacks Callback function for ensmallen optimizer `OptimizerType`.
+   * @return The final objective of the trained model (NaN or Inf on error).
+   */
+  template<typename OptimizerType, typename... CallbackTypes>
+  ElemType Train(MatType predictors,
+                 MatType responses,
+                 OptimizerType& optimizer,
+                 CallbackTypes&&... callbacks);
+
+  /**
+   * Evaluate the network on the points `begin` to `begin + batchSize - 1` of
+   * the training data, with the shards processed in parallel.  This is used
+   * by the optimizer during `Train()`.
+   *
+   * @param parameters Parameters of the network (ignored; the parameters of
+   *     the model are used).
+   * @param begin Index of the first point to evaluate.
+   * @param batchSize Number of points to evaluate.
+   */
+  ElemType Evaluate(const MatType& parameters,
+                    const size_t begin,
+                    const size_t batchSize);
+
+  /**
+   * Evaluate the network and compute the gradient of the objective on the
+   * points `begin` to `begin + batchSize - 1` of the training data, with the
+   * shards processed in parallel.  This is used by the optimizer during
+   * `Train()`.
+   *
+   * @param parameters Parameters of the network (ignored; the parameters of
+   *     the model are used).
+   * @param begin Index of the first point to evaluate.
+   * @param gradient Matrix to store the gradient in.
+   * @param batchSize Number of points to evaluate.
+   */
+  ElemType EvaluateWithGradient(const MatType& parameters,
+                                const size_t begin,
+                                MatType& gradient,
+                                const size_t batchSize);
+
+  /**
+   * Compute the gradient of the objective on the points `begin` to
+   * `begin + batchSize - 1` of the training data.  This is used by the
+   * optimizer during `Train()`.
+   *
+   * @param parameters Parameters of the network.
+   * @param begin Index of the first point to evaluate.
+   * @param gradient Matrix to store the gradient in.
+   * @param batchSize Number of points to evaluate.
+   */
+  void Gradient(const MatType& parameters,
+                const size_t begin,
+                MatType& gradient,
+                const size_t batchSize);
+
+  //! Return the number of separable functions (the number of training points).
+  size_t NumFunctions() const { return model.NumFunctions(); }
+
+  //! Shuffle the order of the training data.
+  void Shuffle() { model.Shuffle(); }
+
+  //! Get the number of replicas of the network.
+  size_t NumThreads() const { return numThreads; }
+
+ private:
+  // SFINAE check for the Reduction() member of output layers.
+  HAS_MEM_FUNC(Reduction, HasReduction);
+
+  //! Return the weight of the objective and the error of a shard of
+  //! `shardSize` points in a batch of `batchSize` points: 1 for 'sum'
+  //! reduction, and the fraction of the batch for 'mean' reduction.
+  template<typename T = OutputLayerType>
+  ElemType ShardWeight(
+      const size_t shardSize,
+      const size_t batchSize,
+      const typename std::enable_if<
+          HasReduction<T, bool(T::*)() const>::value>::type* = 0) const;
+
+  //! Output layers without a Reduction() member are rejected by the
+  //! constructor, so this is never used.
+  template<typename T = OutputLayerType>
+  ElemType ShardWeight(
+      const size_t /* shardSize */,
+      const size_t /* batchSize */,
+      const typename std::enable_if<
+          !HasReduction<T, bool(T::*)() const>::value>::type* = 0) const
+  { return ElemType(1); }
+
+  /**
+   * Compute the gradient of the regularization penalties of the layers (which
+   * only depends on the parameters) into `regularization`, by passing the
+   * given point with zero error through `regularizationReplica`.
+   *
+   * @param point Input point, only used to set up the layers.
+   */
+  void RegularizationGradient(const MatType& point);
+
+  /**
+   * Make sure the network of the model is set up, and create (or update) the
+   * other replicas of the network.
+   *
+   * @param functionName Name of the calling function, for error messages.
+   */
+  void CheckReplicas(const std::string& functionName);
+
+  //! Split the given batch into shards, and return the index of the first
+  //! point of each shard (and, last, the end of the batch).
+  std::vector<size_t> Shards(const size_t begin, const size_t batchSize) const;
+
+  //! The network being trained.
+  NetworkType& model;
+  //! Number of replicas of the network.
+  size_t numThreads;
+
+  //! Copies of the layers of the model for the replicas other than the first.
+  std::vector<MultiLayer<MatType>> replicas;
+  //! Copies of the output layer of the model for the other replicas.
+  std::vector<OutputLayerType> outputLayers;
+  //! Copy of the layers of the model used to compute the gradient of the
+  //! regularization penalties.
+  MultiLayer<MatType> regularizationReplica;
+  //! Parameters the replicas currently use.
+  ElemType* replicaParameters;
+
+  //! Output of the network of each replica.
+  std::vector<MatType> outputs;
+  //! Error of the output layer of each replica.
+  std::vector<MatType> errors;
+  //! Output of the backward pass of each replica.
+  std::vector<MatType> deltas;
+  //! Gradient of each replica other than the first.
+  std::vector<MatType> gradients;
+  //! Gradient of the regularization penalties.
+  MatType regularization;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "ffn_data_parallel_impl.hpp"
+
+#endif
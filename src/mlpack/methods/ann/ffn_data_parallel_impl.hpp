@@ -0,0 +1,338 @@
+/**
+ * @file methods/ann/ffn_data_parallel_impl.hpp
+ *
+ * Implementation of the FFNDataParallel class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_DATA_PARALLEL_IMPL_HPP
+#define MLPACK_METHODS_ANN_FFN_DATA_PARALLEL_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ffn_data_parallel.hpp"
+
+namespace mlpack {
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+FFNDataParallel<OutputLayerType, InitializationRuleType, MatType>::
+FFNDataParallel(NetworkType& model, const size_t numThreads) :
+    model(model),
+    numThreads(numThreads),
+    replicaParameters(NULL)
+{
+  if (this->numThreads == 0)
+  {
+    #ifdef MLPACK_USE_OPENMP
+    this->numThreads = (size_t) omp_get_max_threads();
+    #else
+    this->numThreads = 1;
+    #endif
+  }
+
+  // The objective of a batch can only be split over shards if it is the sum or
+  // the mean of the objectives of its points.
+  if (!HasReduction<OutputLayerType,
+      bool(OutputLayerType::*)() const>::value)
+  {
+    throw std::invalid_argument("FFNDataParallel::FFNDataParallel(): the "
+        "output layer must have 'sum' or 'mean' reduction (a Reduction() "
+        "member)!");
+  }
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename OptimizerType, typename... CallbackTypes>
+typename MatType::elem_type FFNDataParallel<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Train(MatType predictors,
+         MatType responses,
+         OptimizerType& optimizer,
+         CallbackTypes&&... callbacks)
+{
+  model.ResetData(std::move(predictors), std::move(responses));
+
+  model.template WarnMessageMaxIterations<OptimizerType>(optimizer,
+      model.predictors.n_cols);
+
+  // Ensure that the network can be used, and (re)create the replicas from the
+  // current layers of the model.
+  model.CheckNetwork("FFNDataParallel::Train()", model.predictors.n_rows, true,
+      true);
+  outputs.clear();
+  CheckReplicas("FFNDataParallel::Train()");
+
+  // Train the model.
+  Timer::Start("ffn_optimization");
+  const ElemType out = optimizer.Optimize(*this, model.parameters,
+      callbacks...);
+  Timer::Stop("ffn_optimization");
+
+  Log::Info << "FFNDataParallel::Train(): final objective of trained model is "
+      << out << "." << std::endl;
+  return out;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type FFNDataParallel<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Evaluate(const MatType& /* parameters */,
+            const size_t begin,
+            const size_t batchSize)
+{
+  CheckReplicas("FFNDataParallel::Evaluate()");
+
+  MatType& predictors = model.predictors;
+  MatType& responses = model.responses;
+  const std::vector<size_t> shards = Shards(begin, batchSize);
+  const size_t numShards = shards.size() - 1;
+  std::vector<ElemType> objectives(numShards);
+
+  #pragma omp parallel for
+  for (size_t s = 0; s < numShards; ++s)
+  {
+    MultiLayer<MatType>& network = (s == 0) ? model.network : replicas[s - 1];
+    OutputLayerType& outputLayer = (s == 0) ? model.outputLayer :
+        outputLayers[s - 1];
+    const size_t shardSize = shards[s + 1] - shards[s];
+
+    MatType predictorsShard, responsesShard;
+    MakeAlias(predictorsShard, predictors.colptr(shards[s]), predictors.n_rows,
+        shardSize);
+    MakeAlias(responsesShard, responses.colptr(shards[s]), responses.n_rows,
+        shardSize);
+
+    outputs[s].set_size(network.OutputSize(), shardSize);
+    network.Forward(predictorsShard, outputs[s]);
+    objectives[s] = ShardWeight(shardSize, batchSize) *
+        outputLayer.Forward(outputs[s], responsesShard);
+  }
+
+  // The loss of the layers only depends on the parameters, so it is added
+  // once.
+  return std::accumulate(objectives.begin(), objectives.end(), ElemType(0)) +
+      model.network.Loss();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+typename MatType::elem_type FFNDataParallel<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::EvaluateWithGradient(const MatType& parameters,
+                        const size_t begin,
+                        MatType& gradient,
+                        const size_t batchSize)
+{
+  CheckReplicas("FFNDataParallel::EvaluateWithGradient()");
+
+  MatType& predictors = model.predictors;
+  MatType& responses = model.responses;
+  const std::vector<size_t> shards = Shards(begin, batchSize);
+  const size_t numShards = shards.size() - 1;
+  std::vector<ElemType> objectives(numShards);
+
+  // The first replica writes its gradient directly into `gradient`.
+  gradient.set_size(parameters.n_rows, parameters.n_cols);
+  std::vector<MatType*> shardGradients(numShards, &gradient);
+  for (size_t s = 1; s < numShards; ++s)
+    shardGradients[s] = &gradients[s - 1];
+
+  // Each replica computes the forward pass, the backward pass and the gradient
+  // of its shard; see FFN::EvaluateWithGradient().
+  #pragma omp parallel for
+  for (size_t s = 0; s < numShards; ++s)
+  {
+    MultiLayer<MatType>& network = (s == 0) ? model.network : replicas[s - 1];
+    OutputLayerType& outputLayer = (s == 0) ? model.outputLayer :
+        outputLayers[s - 1];
+    const size_t shardSize = shards[s + 1] - shards[s];
+
+    MatType predictorsShard, responsesShard;
+    MakeAlias(predictorsShard, predictors.colptr(shards[s]), predictors.n_rows,
+        shardSize);
+    MakeAlias(responsesShard, responses.colptr(shards[s]), responses.n_rows,
+        shardSize);
+
+    outputs[s].set_size(network.OutputSize(), shardSize);
+    network.Forward(predictorsShard, outputs[s]);
+
+    // With 'mean' reduction, the objective and the error of the shard are
+    // scaled to be those of its points within the whole batch.
+    const ElemType weight = ShardWeight(shardSize, batchSize);
+    objectives[s] = weight * outputLayer.Forward(outputs[s], responsesShard);
+
+    outputLayer.Backward(outputs[s], responsesShard, errors[s]);
+    if (weight != ElemType(1))
+      errors[s] *= weight;
+
+    deltas[s].set_size(predictors.n_rows, shardSize);
+    network.Backward(predictorsShard, outputs[s], errors[s], deltas[s]);
+
+    shardGradients[s]->set_size(parameters.n_rows, parameters.n_cols);
+    network.Gradient(predictorsShard, errors[s], *shardGradients[s]);
+  }
+
+  // Sum the gradients with a tree reduction: at each step, the gradient of
+  // shard s receives the gradient of shard s + step, for all pairs at once, so
+  // that the sum ends up in the gradient of the first shard.
+  for (size_t step = 1; step < numShards; step *= 2)
+  {
+    #pragma omp parallel for
+    for (size_t s = 0; s < numShards; s += 2 * step)
+    {
+      if (s + step < numShards)
+        *shardGradients[s] += *shardGradients[s + step];
+    }
+  }
+
+  // Every shard added the gradient of the regularization penalties, which only
+  // depends on the parameters; keep only one of them.
+  if (numShards > 1)
+  {
+    MatType point;
+    MakeAlias(point, predictors.colptr(begin), predictors.n_rows, 1);
+    RegularizationGradient(point);
+    gradient -= ElemType(numShards - 1) * regularization;
+  }
+
+  return std::accumulate(objectives.begin(), objectives.end(), ElemType(0)) +
+      model.network.Loss();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFNDataParallel<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Gradient(const MatType& parameters,
+            const size_t begin,
+            MatType& gradient,
+            const size_t batchSize)
+{
+  EvaluateWithGradient(parameters, begin, gradient, batchSize);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+template<typename T>
+typename MatType::elem_type FFNDataParallel<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ShardWeight(
+    const size_t shardSize,
+    const size_t batchSize,
+    const typename std::enable_if<
+        HasReduction<T, bool(T::*)() const>::value>::type*) const
+{
+  return model.outputLayer.Reduction() ? ElemType(1) :
+      ElemType(shardSize) / ElemType(batchSize);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFNDataParallel<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::RegularizationGradient(const MatType& point)
+{
+  // The error is zero, so the gradient with respect to the data vanishes and
+  // only the terms added by the regularizers of the layers are left.
+  MatType output(regularizationReplica.OutputSize(), 1);
+  regularizationReplica.Forward(point, output);
+
+  MatType error(output.n_rows, 1, arma::fill::zeros);
+  MatType delta(point.n_rows, 1);
+  regularizationReplica.Backward(point, output, error, delta);
+
+  regularization.set_size(model.parameters.n_rows, model.parameters.n_cols);
+  regularizationReplica.Gradient(point, error, regularization);
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+void FFNDataParallel<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::CheckReplicas(const std::string& functionName)
+{
+  model.CheckNetwork(functionName, model.predictors.n_rows);
+
+  // The replicas are (re)created at the start of each call to Train().
+  if (outputs.size() != numThreads)
+  {
+    // Each replica other than the first gets its own copy of the layers and
+    // the output layer of the model.
+    replicas.clear();
+    replicas.resize(numThreads - 1, model.network);
+    outputLayers.clear();
+    outputLayers.resize(numThreads - 1, model.outputLayer);
+    regularizationReplica = model.network;
+
+    outputs.resize(numThreads);
+    errors.resize(numThreads);
+    deltas.resize(numThreads);
+    gradients.resize(numThreads - 1);
+
+    replicaParameters = NULL;
+  }
+
+  // The parameters of the model may have been reallocated since the last
+  // call, so make sure every replica uses them.
+  if (replicaParameters != model.parameters.memptr())
+  {
+    replicaParameters = model.parameters.memptr();
+    for (size_t i = 0; i < replicas.size(); ++i)
+      replicas[i].SetWeights(replicaParameters);
+    regularizationReplica.SetWeights(replicaParameters);
+  }
+
+  for (size_t i = 0; i < replicas.size(); ++i)
+    replicas[i].Training() = model.network.Training();
+  regularizationReplica.Training() = model.network.Training();
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+std::vector<size_t> FFNDataParallel<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::Shards(const size_t begin, const size_t batchSize) const
+{
+  // Use at most one shard per point, and spread the points evenly.
+  const size_t numShards = std::max(size_t(1), std::min(numThreads,
+      batchSize));
+  std::vector<size_t> shards(numShards + 1);
+  for (size_t s = 0; s <= numShards; ++s)
+    shards[s] = begin + (s * batchSize) / numShards;
+
+  return shards;
+}
+
+} // namespace mlpack
+
+#endif
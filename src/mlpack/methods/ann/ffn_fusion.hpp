@@ -0,0 +1,91 @@
+/**
+ * @file methods/ann/ffn_fusion.hpp
+ *
+ * Operator fusion for inference with feedforward networks: FuseFFN() folds
+ * the BatchNorm layers of a trained FFN into the Linear or Convolution layers
+ * before them, and merges element-wise activation layers into the output of
+ * the layer before them.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_FUSION_HPP
+#define MLPACK_METHODS_ANN_FFN_FUSION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+#include "ffn_rebuild.hpp"
+#include "layer/batch_norm.hpp"
+#include "layer/fused_activation.hpp"
+#include "layer/fused_convolution.hpp"
+#include "layer/fused_linear.hpp"
+
+namespace mlpack {
+
+/**
+ * Compute the affine transformation x -> scale * x + shift that the given
+ * BatchNorm layer applies at inference time, for the output of a layer whose
+ * output (for one point) consists of consecutive blocks of `blockSize`
+ * elements, which belong to `units` units in turn (e.g., for a Linear layer,
+ * blocks of one element, one per output unit; for a Convolution layer, blocks
+ * of one output map each, cycling through the maps).  The transformation can
+ * only be folded into the layer if every element of a unit is normalized with
+ * the same channel of the BatchNorm layer; if that is not the case, false is
+ * returned.
+ *
+ * @param layer BatchNorm layer; its weights and input dimensions must be set.
+ * @param blockSize Number of consecutive elements of one block.
+ * @param units Number of units of the layer before the BatchNorm layer.
+ * @param scale Matrix to store the scale of each unit in (units x 1).
+ * @param shift Matrix to store the shift of each unit in (units x 1).
+ * @return Whether the BatchNorm layer can be folded into the layer before it.
+ */
+template<typename MatType>
+bool BatchNormScaleShift(const BatchNormType<MatType>& layer,
+                         const size_t blockSize,
+                         const size_t units,
+                         MatType& scale,
+                         MatType& shift);
+
+/**
+ * Fuse the layers of the given trained network for inference.  Each Linear,
+ * LinearNoBias or Convolution layer (with naive or im2col convolution rules)
+ * is merged with the layers that directly follow it:
+ *
+ *  - a BatchNorm layer is folded into the weights and the bias, using the mean
+ *    and variance accumulated during training; for Convolution layers this is
+ *    only done if the BatchNorm layer normalizes each output map as a whole
+ *    (which is the default for three-dimensional inputs).
+ *  - an element-wise activation layer without parameters (e.g. ReLU, Sigmoid,
+ *    TanH, GELU, Swish, or Identity; see `VisitFusedActivations()`) is applied
+ *    while the output of the layer is written.
+ *
+ * Each such group of layers is replaced by one FusedLinear or FusedConvolution
+ * layer, which saves one or two passes over the activations of the group and
+ * the memory of its intermediate outputs.  All other layers (and their
+ * weights) are kept as they are.  Only layers at the top level of the network
+ * are fused; layers held inside other layers (e.g. in a MultiLayer) are kept.
+ *
+ * The fused network computes the same predictions as the original network in
+ * inference mode (up to floating-point rounding), and can be serialized and
+ * loaded like any other network (with MLPACK_ENABLE_ANN_SERIALIZATION
+ * defined).  It cannot be trained.
+ *
+ * @param model Trained network to fuse.
+ * @return The fused network.
+ */
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+FFN<OutputLayerType, InitializationRuleType, MatType> FuseFFN(
+    const FFN<OutputLayerType, InitializationRuleType, MatType>& model);
+
+} // namespace mlpack
+
+// Include implementation.
+#include "ffn_fusion_impl.hpp"
+
+#endif
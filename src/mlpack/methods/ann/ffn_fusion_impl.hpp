@@ -0,0 +1,195 @@
+/**
+ * @file methods/ann/ffn_fusion_impl.hpp
+ *
+ * Implementation of operator fusion for feedforward networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_FUSION_IMPL_HPP
+#define MLPACK_METHODS_ANN_FFN_FUSION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ffn_fusion.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+bool BatchNormScaleShift(const BatchNormType<MatType>& layer,
+                         const size_t blockSize,
+                         const size_t units,
+                         MatType& scale,
+                         MatType& shift)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  const std::vector<size_t>& dimensions = layer.InputDimensions();
+  if (dimensions.empty() || blockSize == 0 || units == 0)
+    return false;
+
+  // See BatchNormType::ComputeOutputDimensions(): each channel covers
+  // `inputDimension` consecutive elements, and the channels repeat for the
+  // dimensions above the max axis.
+  const size_t minAxis = std::min(layer.MinAxis(), dimensions.size() - 1);
+  size_t inputDimension = 1;
+  for (size_t i = 0; i < minAxis; ++i)
+    inputDimension *= dimensions[i];
+
+  size_t totalSize = 1;
+  for (size_t i = 0; i < dimensions.size(); ++i)
+    totalSize *= dimensions[i];
+
+  if (totalSize % (blockSize * units) != 0)
+    return false;
+
+  // Find the channel of each unit, and make sure it is the same for every
+  // element of the unit.
+  const size_t channels = layer.InputSize();
+  std::vector<size_t> unitChannels(units, channels);
+  for (size_t r = 0; r < totalSize; ++r)
+  {
+    const size_t channel = (r / inputDimension) % channels;
+    const size_t unit = (r / blockSize) % units;
+    if (unitChannels[unit] == channels)
+      unitChannels[unit] = channel;
+    else if (unitChannels[unit] != channel)
+      return false;
+  }
+
+  // At inference time, BatchNorm computes
+  // (x - mean) / sqrt(variance + eps) * gamma + beta.
+  const MatType& parameters = layer.Parameters();
+  scale.set_size(units, 1);
+  shift.set_size(units, 1);
+  for (size_t u = 0; u < units; ++u)
+  {
+    const size_t c = unitChannels[u];
+    const ElemType gamma = parameters[c];
+    const ElemType beta = parameters[channels + c];
+    scale[u] = gamma / std::sqrt(layer.TrainingVariance()[c] +
+        ElemType(layer.Epsilon()));
+    shift[u] = beta - layer.TrainingMean()[c] * scale[u];
+  }
+
+  return true;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+FFN<OutputLayerType, InitializationRuleType, MatType> FuseFFN(
+    const FFN<OutputLayerType, InitializationRuleType, MatType>& model)
+{
+  typedef ConvolutionType<NaiveConvolution<ValidConvolution>,
+                          NaiveConvolution<FullConvolution>,
+                          NaiveConvolution<ValidConvolution>,
+                          MatType> NaiveConvolutionLayer;
+  typedef ConvolutionType<Im2ColConvolution<ValidConvolution>,
+                          Im2ColConvolution<FullConvolution>,
+                          Im2ColConvolution<ValidConvolution>,
+                          MatType> Im2ColConvolutionLayer;
+
+  return RebuildFFN(model, "FuseFFN()", [](
+      const std::vector<Layer<MatType>*>& layers,
+      const size_t i,
+      Layer<MatType>*& replacement)
+  {
+    const LinearType<MatType>* linear =
+        dynamic_cast<const LinearType<MatType>*>(layers[i]);
+    const LinearNoBiasType<MatType>* linearNoBias =
+        dynamic_cast<const LinearNoBiasType<MatType>*>(layers[i]);
+    const NaiveConvolutionLayer* naiveConvolution =
+        dynamic_cast<const NaiveConvolutionLayer*>(layers[i]);
+    const Im2ColConvolutionLayer* im2colConvolution =
+        dynamic_cast<const Im2ColConvolutionLayer*>(layers[i]);
+    const bool isLinear = (linear != NULL || linearNoBias != NULL);
+    const bool isConvolution = (naiveConvolution != NULL ||
+        im2colConvolution != NULL);
+
+    // Find the BatchNorm layer and the activation layer to fuse, if any.
+    size_t next = i + 1;
+    MatType scale, shift;
+    bool foldBatchNorm = false;
+    if ((isLinear || isConvolution) && next < layers.size())
+    {
+      const BatchNormType<MatType>* batchNorm =
+          dynamic_cast<const BatchNormType<MatType>*>(layers[next]);
+      if (batchNorm != NULL)
+      {
+        const std::vector<size_t>& outputDimensions =
+            layers[i]->OutputDimensions();
+        const size_t blockSize = isLinear ? 1 :
+            outputDimensions[0] * outputDimensions[1];
+        const size_t units = isLinear ? outputDimensions[0] :
+            outputDimensions[2];
+        foldBatchNorm = BatchNormScaleShift(*batchNorm, blockSize, units,
+            scale, shift);
+        if (foldBatchNorm)
+          ++next;
+      }
+    }
+
+    std::string activation;
+    if ((isLinear || isConvolution) && next < layers.size())
+    {
+      activation = FusedActivationName(*layers[next]);
+      if (!activation.empty())
+        ++next;
+    }
+
+    // If there is nothing to fuse, keep the layer and its weights.
+    if (!foldBatchNorm && activation.empty())
+    {
+      replacement = NULL;
+      return size_t(1);
+    }
+
+    if (activation.empty())
+      activation = "identity";
+
+    if (isLinear)
+    {
+      MatType weight, bias;
+      if (linear != NULL)
+      {
+        weight = linear->Weight();
+        bias = vectorise(linear->Bias());
+      }
+      else
+      {
+        weight = linearNoBias->Parameters();
+        bias.zeros(weight.n_rows, 1);
+      }
+
+      if (foldBatchNorm)
+      {
+        weight.each_col() %= scale;
+        bias = bias % scale + shift;
+      }
+
+      replacement = new FusedLinearType<MatType>(weight, bias, activation);
+    }
+    else
+    {
+      FusedConvolutionType<MatType>* convolution = (naiveConvolution != NULL) ?
+          new FusedConvolutionType<MatType>(*naiveConvolution, activation) :
+          new FusedConvolutionType<MatType>(*im2colConvolution, activation);
+
+      if (foldBatchNorm)
+      {
+        convolution->Weight().each_row() %= scale.t();
+        convolution->Bias() = convolution->Bias() % scale + shift;
+      }
+
+      replacement = convolution;
+    }
+
+    return next - i;
+  });
+}
+
+} // namespace mlpack
+
+#endif
@@ -387,6 +387,17 @@ void FFN<
           "build options\" section of the README for more information.");
     #endif
   #else
+    #if !defined(MLPACK_ENABLE_ANN_SERIALIZATION_FMAT) && \
+        !defined(MLPACK_ANN_IGNORE_SERIALIZATION_WARNING)
+      if (std::is_same<MatType, arma::fmat>::value)
+      {
+        throw std::runtime_error("Cannot serialize a neural network of "
+            "arma::fmat unless MLPACK_ENABLE_ANN_SERIALIZATION_FMAT is "
+            "defined!  See the \"Additional build options\" section of the "
+            "README for more information.");
+      }
+    #endif
+
     // Serialize the output layer and initialization rule.
     ar(CEREAL_NVP(outputLayer));
     ar(CEREAL_NVP(initializeRule));
@@ -0,0 +1,190 @@
+/**
+ * @file methods/ann/ffn_inference.hpp
+ *
+ * Definition of the FFNInference class, a thread-safe handle for computing
+ * predictions of a trained FFN that groups concurrent requests into batches.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_INFERENCE_HPP
+#define MLPACK_METHODS_ANN_FFN_INFERENCE_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+#include "layer/multi_layer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace mlpack {
+
+/**
+ * A thread-safe handle for computing the predictions of a trained `FFN`.  The
+ * `FFN` class itself cannot be used from multiple threads at once, since its
+ * layers hold the state of the last forward pass.  An `FFNInference` object
+ * holds one copy of the parameters of the network, which is shared read-only
+ * by a number of worker threads; each worker thread has its own copy of the
+ * layers, and so its own scratch memory.
+ *
+ * Any number of threads may call `Predict()` at the same time.  Requests are
+ * placed in a queue, and each worker thread takes as many queued requests as
+ * fit in one batch of `MaxBatchSize()` points.  If fewer points than that are
+ * queued, a worker waits at most `MaxDelay()` after the oldest request arrived
+ * for more requests before it processes the batch.  So, many concurrent
+ * single-point requests are coalesced into a few batched forward passes.  (A
+ * single request with more than `MaxBatchSize()` points is computed in one
+ * forward pass.)
+ *
+ * Example usage:
+ *
+ * @code
+ * FFN<> model;
+ * // ... add layers and train the model ...
+ *
+ * FFNInference<> inference(model, 4, 64);
+ *
+ * // This can be called from any thread.
+ * arma::mat point(inputSize, 1), prediction;
+ * inference.Predict(point, prediction);
+ * @endcode
+ *
+ * Changes made to the model after the `FFNInference` object is constructed are
+ * not visible to it.
+ *
+ * @tparam MatType Type of matrix used by the network.
+ */
+template<typename MatType = arma::mat>
+class FFNInference
+{
+ public:
+  /**
+   * Create the FFNInference object from the given network, which must have
+   * been trained or used for prediction already (so that its parameters and
+   * the dimensions of each layer are set).  The worker threads are started
+   * immediately.
+   *
+   * @param model Network to compute predictions of.
+   * @param numThreads Number of worker threads (0 uses one per hardware
+   *     thread).
+   * @param maxBatchSize Maximum number of points in one forward pass.
+   * @param maxDelay Maximum time a worker waits for more requests to fill a
+   *     batch.
+   */
+  template<typename OutputLayerType, typename InitializationRuleType>
+  FFNInference(
+      const FFN<OutputLayerType, InitializationRuleType, MatType>& model,
+      const size_t numThreads = 0,
+      const size_t maxBatchSize = 64,
+      const std::chrono::microseconds maxDelay =
+          std::chrono::microseconds(500));
+
+  //! Stop the worker threads, after all queued requests are processed.
+  ~FFNInference();
+
+  //! The worker threads and the queue cannot be copied.
+  FFNInference(const FFNInference&) = delete;
+  //! The worker threads and the queue cannot be copied.
+  FFNInference& operator=(const FFNInference&) = delete;
+
+  /**
+   * Compute the predictions of the network for the given points (one per
+   * column), and store them in `results`.  This blocks until the predictions
+   * are computed.  It is safe to call this from multiple threads at once.  Any
+   * exception thrown during the forward pass is rethrown here.
+   *
+   * @param predictors Points to compute predictions for.
+   * @param results Matrix to store the predictions in.
+   */
+  void Predict(const MatType& predictors, MatType& results);
+
+  /**
+   * Queue the computation of the predictions of the network for the given
+   * points, and return without waiting for it.  The future becomes ready once
+   * `results` holds the predictions.  `predictors` and `results` must not be
+   * destroyed or modified until then.
+   *
+   * @param predictors Points to compute predictions for.
+   * @param results Matrix to store the predictions in.
+   */
+  std::future<void> PredictAsync(const MatType& predictors, MatType& results);
+
+  //! Get the number of worker threads.
+  size_t NumThreads() const { return workers.size(); }
+  //! Get the maximum number of points in one forward pass.
+  size_t MaxBatchSize() const { return maxBatchSize; }
+  //! Get the maximum time a worker waits for more requests.
+  std::chrono::microseconds MaxDelay() const { return maxDelay; }
+
+  //! Get the number of forward passes computed so far.
+  size_t Batches() const { return batches; }
+
+ private:
+  //! A request for the predictions of some points.
+  struct Request
+  {
+    //! Points to compute predictions for.
+    const MatType* predictors;
+    //! Matrix to store the predictions in.
+    MatType* results;
+    //! Set when the predictions are stored.
+    std::promise<void> done;
+    //! Time at which the request was queued.
+    std::chrono::steady_clock::time_point arrival;
+  };
+
+  //! Main loop of the worker thread with the given index.
+  void Worker(const size_t index);
+
+  //! Compute the predictions of the given requests with the given network,
+  //! using `batch` and `batchResults` as scratch memory.
+  void Process(MultiLayer<MatType>& network,
+               MatType& batch,
+               MatType& batchResults,
+               std::vector<Request>& requests);
+
+  //! Parameters of the network, shared by all worker threads.
+  MatType parameters;
+  //! Number of elements in each input point.
+  size_t inputSize;
+  //! Number of elements in each prediction.
+  size_t outputSize;
+  //! Maximum number of points in one forward pass.
+  size_t maxBatchSize;
+  //! Maximum time a worker waits for more requests.
+  std::chrono::microseconds maxDelay;
+
+  //! Copy of the layers of the network for each worker thread.
+  std::vector<MultiLayer<MatType>> networks;
+  //! The worker threads.
+  std::vector<std::thread> workers;
+
+  //! Queued requests.
+  std::deque<Request> queue;
+  //! Total number of points in the queued requests.
+  size_t queuedPoints;
+  //! Protects `queue`, `queuedPoints` and `stopping`.
+  std::mutex queueMutex;
+  //! Signaled when a request is queued or the workers must stop.
+  std::condition_variable queueCondition;
+  //! If true, the worker threads exit once the queue is empty.
+  bool stopping;
+  //! Number of forward passes computed so far.
+  std::atomic<size_t> batches;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "ffn_inference_impl.hpp"
+
+#endif
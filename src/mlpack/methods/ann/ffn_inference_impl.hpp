@@ -0,0 +1,261 @@
+/**
+ * @file methods/ann/ffn_inference_impl.hpp
+ *
+ * Implementation of the FFNInference class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_INFERENCE_IMPL_HPP
+#define MLPACK_METHODS_ANN_FFN_INFERENCE_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ffn_inference.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+template<typename OutputLayerType, typename InitializationRuleType>
+FFNInference<MatType>::FFNInference(
+    const FFN<OutputLayerType, InitializationRuleType, MatType>& model,
+    const size_t numThreads,
+    const size_t maxBatchSize,
+    const std::chrono::microseconds maxDelay) :
+    parameters(model.Parameters()),
+    inputSize(0),
+    outputSize(0),
+    maxBatchSize(maxBatchSize),
+    maxDelay(maxDelay),
+    queuedPoints(0),
+    stopping(false),
+    batches(0)
+{
+  if (model.Network().size() == 0)
+  {
+    throw std::invalid_argument("FFNInference::FFNInference(): cannot use "
+        "network with no layers!");
+  }
+
+  if (maxBatchSize == 0)
+  {
+    throw std::invalid_argument("FFNInference::FFNInference(): maxBatchSize "
+        "must be positive!");
+  }
+
+  // Copy the layers of the model; the input dimensions of the first layer are
+  // only known once the model has been used.
+  MultiLayer<MatType> network;
+  for (size_t i = 0; i < model.Network().size(); ++i)
+    network.Add(model.Network()[i]->Clone());
+
+  const std::vector<size_t>& inputDimensions =
+      model.Network().front()->InputDimensions();
+  if (inputDimensions.empty())
+  {
+    throw std::invalid_argument("FFNInference::FFNInference(): the network "
+        "must be trained or used for prediction first!");
+  }
+
+  network.InputDimensions() = inputDimensions;
+  inputSize = std::accumulate(inputDimensions.begin(), inputDimensions.end(),
+      (size_t) 1, std::multiplies<size_t>());
+  outputSize = network.OutputSize();
+
+  if (network.WeightSize() != parameters.n_elem)
+  {
+    throw std::invalid_argument("FFNInference::FFNInference(): the network "
+        "must be trained or used for prediction first!");
+  }
+
+  network.Training() = false;
+
+  // Give each worker thread its own copy of the layers, all of which use the
+  // same parameters.
+  const size_t threads = (numThreads == 0) ?
+      std::max(std::thread::hardware_concurrency(), 1u) : numThreads;
+  networks.resize(threads, network);
+  for (size_t i = 0; i < threads; ++i)
+    networks[i].SetWeights(parameters.memptr());
+
+  workers.reserve(threads);
+  for (size_t i = 0; i < threads; ++i)
+    workers.emplace_back(&FFNInference::Worker, this, i);
+}
+
+template<typename MatType>
+FFNInference<MatType>::~FFNInference()
+{
+  {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    stopping = true;
+  }
+  queueCondition.notify_all();
+
+  for (size_t i = 0; i < workers.size(); ++i)
+    workers[i].join();
+}
+
+template<typename MatType>
+void FFNInference<MatType>::Predict(const MatType& predictors,
+                                    MatType& results)
+{
+  PredictAsync(predictors, results).get();
+}
+
+template<typename MatType>
+std::future<void> FFNInference<MatType>::PredictAsync(
+    const MatType& predictors,
+    MatType& results)
+{
+  if (predictors.n_rows != inputSize)
+  {
+    std::ostringstream oss;
+    oss << "FFNInference::Predict(): expected input with " << inputSize
+        << " rows, but got " << predictors.n_rows << " rows!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Request request;
+  request.predictors = &predictors;
+  request.results = &results;
+  request.arrival = std::chrono::steady_clock::now();
+  std::future<void> future = request.done.get_future();
+
+  // There is nothing to compute for an empty request.
+  if (predictors.n_cols == 0)
+  {
+    results.set_size(outputSize, 0);
+    request.done.set_value();
+    return future;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    queuedPoints += predictors.n_cols;
+    queue.push_back(std::move(request));
+  }
+  queueCondition.notify_one();
+
+  return future;
+}
+
+template<typename MatType>
+void FFNInference<MatType>::Worker(const size_t index)
+{
+  std::vector<Request> requests;
+  MatType batch, batchResults;
+
+  while (true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(queueMutex);
+
+      // Wait until either a full batch is queued, or the oldest request has
+      // waited `maxDelay`.  Other workers may take requests in the meantime,
+      // so the oldest request is checked again after every wakeup.
+      while (true)
+      {
+        if (queue.empty())
+        {
+          if (stopping)
+            return;
+
+          queueCondition.wait(lock);
+          continue;
+        }
+
+        if (stopping || queuedPoints >= maxBatchSize)
+          break;
+
+        const std::chrono::steady_clock::time_point deadline =
+            queue.front().arrival + maxDelay;
+        if (std::chrono::steady_clock::now() >= deadline)
+          break;
+
+        queueCondition.wait_until(lock, deadline);
+      }
+
+      // Take the oldest requests, as long as they fit into one batch.  The
+      // first request is always taken.
+      size_t points = 0;
+      requests.clear();
+      do
+      {
+        points += queue.front().predictors->n_cols;
+        requests.push_back(std::move(queue.front()));
+        queue.pop_front();
+      }
+      while (!queue.empty() &&
+          points + queue.front().predictors->n_cols <= maxBatchSize);
+
+      queuedPoints -= points;
+    }
+
+    // If requests are left, another worker can start on them.
+    queueCondition.notify_one();
+
+    ++batches;
+    Process(networks[index], batch, batchResults, requests);
+  }
+}
+
+template<typename MatType>
+void FFNInference<MatType>::Process(MultiLayer<MatType>& network,
+                                    MatType& batch,
+                                    MatType& batchResults,
+                                    std::vector<Request>& requests)
+{
+  try
+  {
+    if (requests.size() == 1)
+    {
+      // No copies are needed for a single request.
+      const MatType& predictors = *requests[0].predictors;
+      requests[0].results->set_size(outputSize, predictors.n_cols);
+      network.Forward(predictors, *requests[0].results);
+    }
+    else
+    {
+      size_t points = 0;
+      for (size_t i = 0; i < requests.size(); ++i)
+        points += requests[i].predictors->n_cols;
+
+      // Gather the points of all requests into one batch.
+      batch.set_size(inputSize, points);
+      size_t col = 0;
+      for (size_t i = 0; i < requests.size(); ++i)
+      {
+        const MatType& predictors = *requests[i].predictors;
+        batch.cols(col, col + predictors.n_cols - 1) = predictors;
+        col += predictors.n_cols;
+      }
+
+      batchResults.set_size(outputSize, points);
+      network.Forward(batch, batchResults);
+
+      // Now scatter the predictions back to each request.
+      col = 0;
+      for (size_t i = 0; i < requests.size(); ++i)
+      {
+        const size_t cols = requests[i].predictors->n_cols;
+        *requests[i].results = batchResults.cols(col, col + cols - 1);
+        col += cols;
+      }
+    }
+  }
+  catch (...)
+  {
+    for (size_t i = 0; i < requests.size(); ++i)
+      requests[i].done.set_exception(std::current_exception());
+    return;
+  }
+
+  for (size_t i = 0; i < requests.size(); ++i)
+    requests[i].done.set_value();
+}
+
+} // namespace mlpack
+
+#endif
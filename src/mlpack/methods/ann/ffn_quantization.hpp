@@ -0,0 +1,113 @@
+/**
+ * @file methods/ann/ffn_quantization.hpp
+ *
+ * Post-training int8 quantization of feedforward networks: QuantizeFFN()
+ * replaces the Linear, LinearNoBias and Convolution layers of a trained FFN by
+ * quantized layers calibrated on sample data, and EvaluateQuantization()
+ * reports how much the predictions of the quantized network differ from those
+ * of the original network.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_QUANTIZATION_HPP
+#define MLPACK_METHODS_ANN_FFN_QUANTIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+#include "ffn_rebuild.hpp"
+#include "quantization.hpp"
+#include "layer/quantized_convolution.hpp"
+#include "layer/quantized_linear.hpp"
+
+namespace mlpack {
+
+/**
+ * The differences between the predictions of a network and its quantized
+ * version, as computed by EvaluateQuantization().
+ */
+struct QuantizationReport
+{
+  //! Largest absolute difference between two predicted values.
+  double maxAbsoluteError;
+  //! Mean absolute difference between the predicted values.
+  double meanAbsoluteError;
+  //! Frobenius norm of the differences, relative to the Frobenius norm of the
+  //! predictions of the original network.
+  double relativeError;
+  //! Fraction of points for which the index of the largest predicted value
+  //! (i.e. the predicted class, for classification networks) is the same.
+  double argmaxAgreement;
+};
+
+/**
+ * Return a quantized version of the given layer, which computes its forward
+ * pass with int8 weights and inputs, or NULL if the layer type cannot be
+ * quantized.  Linear and LinearNoBias layers (without regularizer) and
+ * Convolution layers (with naive or im2col convolution rules) can be
+ * quantized.  The caller is responsible for deleting the returned layer.
+ *
+ * @param layer Layer to quantize; its weights must be set.
+ * @param inputRange Largest absolute value of the input of the layer expected
+ *     during inference; larger values saturate.
+ */
+template<typename MatType>
+Layer<MatType>* QuantizeLayer(const Layer<MatType>& layer,
+                              const typename MatType::elem_type inputRange);
+
+/**
+ * Quantize the given trained network for inference.  Each Linear, LinearNoBias
+ * and Convolution layer is replaced by a QuantizedLinear or
+ * QuantizedConvolution layer, which stores its weights as int8 values with one
+ * scale per output unit or output map, and computes its output with an int8 x
+ * int8 -> int32 matrix product.  All other layers (and their weights) are kept
+ * as they are.
+ *
+ * The scale used to quantize the input of each quantized layer is calibrated
+ * by passing `calibrationData` through the original network: the largest
+ * absolute value seen at the input of the layer is mapped to 127.  So, the
+ * calibration data should be a representative sample of the data the network
+ * will be used on.
+ *
+ * The quantized network can be used with `Predict()`, and serialized and
+ * loaded like any other network (with MLPACK_ENABLE_ANN_SERIALIZATION defined).
+ * It cannot be trained.  Only layers at the top level of the network are
+ * quantized; layers held inside other layers (e.g. in a MultiLayer) are kept.
+ *
+ * @param model Trained network to quantize.
+ * @param calibrationData Sample input points, one per column.
+ * @return The quantized network.
+ */
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+FFN<OutputLayerType, InitializationRuleType, MatType> QuantizeFFN(
+    const FFN<OutputLayerType, InitializationRuleType, MatType>& model,
+    const MatType& calibrationData);
+
+/**
+ * Compare the predictions of a network and its quantized version (as returned
+ * by QuantizeFFN()) on the given data.
+ *
+ * @param model Original network.
+ * @param quantized Quantized network.
+ * @param data Input points to compare the predictions on, one per column.
+ * @return The differences between the predictions.
+ */
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+QuantizationReport EvaluateQuantization(
+    FFN<OutputLayerType, InitializationRuleType, MatType>& model,
+    FFN<OutputLayerType, InitializationRuleType, MatType>& quantized,
+    const MatType& data);
+
+} // namespace mlpack
+
+// Include implementation.
+#include "ffn_quantization_impl.hpp"
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * @file methods/ann/ffn_quantization_impl.hpp
+ *
+ * Implementation of post-training int8 quantization of feedforward networks.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_QUANTIZATION_IMPL_HPP
+#define MLPACK_METHODS_ANN_FFN_QUANTIZATION_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "ffn_quantization.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+Layer<MatType>* QuantizeLayer(const Layer<MatType>& layer,
+                              const typename MatType::elem_type inputRange)
+{
+  typedef typename MatType::elem_type ElemType;
+  typedef ConvolutionType<NaiveConvolution<ValidConvolution>,
+                          NaiveConvolution<FullConvolution>,
+                          NaiveConvolution<ValidConvolution>,
+                          MatType> NaiveConvolutionLayer;
+  typedef ConvolutionType<Im2ColConvolution<ValidConvolution>,
+                          Im2ColConvolution<FullConvolution>,
+                          Im2ColConvolution<ValidConvolution>,
+                          MatType> Im2ColConvolutionLayer;
+
+  const ElemType inputScale = QuantizationScale(inputRange);
+
+  if (const LinearType<MatType>* linear =
+      dynamic_cast<const LinearType<MatType>*>(&layer))
+  {
+    return new QuantizedLinearType<MatType>(*linear, inputScale);
+  }
+  else if (const LinearNoBiasType<MatType>* linearNoBias =
+      dynamic_cast<const LinearNoBiasType<MatType>*>(&layer))
+  {
+    return new QuantizedLinearType<MatType>(*linearNoBias, inputScale);
+  }
+  else if (const NaiveConvolutionLayer* convolution =
+      dynamic_cast<const NaiveConvolutionLayer*>(&layer))
+  {
+    return new QuantizedConvolutionType<MatType>(*convolution, inputScale);
+  }
+  else if (const Im2ColConvolutionLayer* convolution =
+      dynamic_cast<const Im2ColConvolutionLayer*>(&layer))
+  {
+    return new QuantizedConvolutionType<MatType>(*convolution, inputScale);
+  }
+
+  return NULL;
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+FFN<OutputLayerType, InitializationRuleType, MatType> QuantizeFFN(
+    const FFN<OutputLayerType, InitializationRuleType, MatType>& model,
+    const MatType& calibrationData)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  if (calibrationData.n_cols == 0)
+  {
+    throw std::invalid_argument("QuantizeFFN(): no calibration data given!");
+  }
+
+  // Pass the calibration data through the layers as they are visited, so that
+  // each layer is quantized with the range of its input.
+  MatType input(calibrationData), output;
+  return RebuildFFN(model, "QuantizeFFN()", [&](
+      const std::vector<Layer<MatType>*>& layers,
+      const size_t i,
+      Layer<MatType>*& replacement)
+  {
+    const ElemType inputRange =
+        (ElemType) arma::max(arma::abs(arma::vectorise(input)));
+
+    output.set_size(layers[i]->OutputSize(), input.n_cols);
+    layers[i]->Forward(input, output);
+    std::swap(input, output);
+
+    replacement = QuantizeLayer(*layers[i], inputRange);
+    return size_t(1);
+  });
+}
+
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+QuantizationReport EvaluateQuantization(
+    FFN<OutputLayerType, InitializationRuleType, MatType>& model,
+    FFN<OutputLayerType, InitializationRuleType, MatType>& quantized,
+    const MatType& data)
+{
+  MatType predictions, quantizedPredictions;
+  model.Predict(data, predictions);
+  quantized.Predict(data, quantizedPredictions);
+
+  if (predictions.n_rows != quantizedPredictions.n_rows ||
+      predictions.n_cols != quantizedPredictions.n_cols)
+  {
+    throw std::invalid_argument("EvaluateQuantization(): the networks do not "
+        "have the same output size!");
+  }
+
+  const MatType errors = arma::abs(predictions - quantizedPredictions);
+
+  QuantizationReport report;
+  report.maxAbsoluteError = (double) errors.max();
+  report.meanAbsoluteError = (double) arma::accu(errors) / errors.n_elem;
+
+  const double norm = (double) arma::norm(arma::vectorise(predictions), 2);
+  report.relativeError = (norm > 0) ?
+      (double) arma::norm(arma::vectorise(errors), 2) / norm : 0.0;
+
+  const arma::urowvec classes = arma::index_max(predictions, 0);
+  const arma::urowvec quantizedClasses = arma::index_max(quantizedPredictions,
+      0);
+  report.argmaxAgreement = (double) arma::accu(classes == quantizedClasses) /
+      classes.n_elem;
+
+  return report;
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * @file methods/ann/ffn_rebuild.hpp
+ *
+ * RebuildFFN(), the pass shared by FuseFFN() and QuantizeFFN(): it copies the
+ * layers of a trained FFN and builds a new network for inference out of them,
+ * replacing groups of layers as directed by the caller.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_FFN_REBUILD_HPP
+#define MLPACK_METHODS_ANN_FFN_REBUILD_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "ffn.hpp"
+
+namespace mlpack {
+
+/**
+ * Build a network for inference out of the given trained network.  The layers
+ * of `model` are copied (in inference mode, with their weights set to a copy
+ * of the parameters of `model`), and passed over in order.  For each layer `i`
+ * that does not belong to an earlier group, `rebuild(layers, i, replacement)`
+ * is called, where `layers` holds the copies of all layers.  It must either
+ *
+ *  - set `replacement` to a new layer that replaces the group of layers
+ *    starting at `i`, and return the number of layers in the group; or
+ *  - set `replacement` to NULL and return 1, to keep layer `i` (and its
+ *    weights) as it is.
+ *
+ * The rebuilt network takes ownership of the replacement layers.  Replaced
+ * layers lose their weights: the parameters of the rebuilt network are only
+ * the weights of the layers that are kept.
+ *
+ * @param model Trained network to rebuild.
+ * @param name Name of the calling function, used in error messages.
+ * @param rebuild Function to call for each group of layers.
+ * @return The rebuilt network.
+ */
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType,
+         typename RebuildFunctionType>
+FFN<OutputLayerType, InitializationRuleType, MatType> RebuildFFN(
+    const FFN<OutputLayerType, InitializationRuleType, MatType>& model,
+    const std::string& name,
+    RebuildFunctionType rebuild)
+{
+  // The dimensions of the layers are only known once the network was used.
+  const std::vector<Layer<MatType>*>& network = model.Network();
+  if (network.empty() || network.front()->InputDimensions().empty() ||
+      model.Parameters().is_empty())
+  {
+    throw std::invalid_argument(name + ": the network must be trained (or "
+        "used for prediction) first!");
+  }
+
+  size_t totalWeightSize = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+    totalWeightSize += network[i]->WeightSize();
+
+  if (model.Parameters().n_elem != totalWeightSize)
+  {
+    throw std::invalid_argument(name + ": the size of the parameters does not "
+        "match the layers of the network!");
+  }
+
+  // Work on copies of the layers, aliasing a copy of the parameters.
+  MatType parameters(model.Parameters());
+  std::vector<Layer<MatType>*> layers(network.size());
+  std::vector<size_t> offsets(network.size());
+  size_t offset = 0;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    layers[i] = network[i]->Clone();
+    layers[i]->Training() = false;
+    layers[i]->SetWeights(parameters.memptr() + offset);
+    offsets[i] = offset;
+    offset += layers[i]->WeightSize();
+  }
+
+  FFN<OutputLayerType, InitializationRuleType, MatType> rebuilt(
+      model.OutputLayer());
+  MatType keptParameters(parameters.n_elem, 1);
+  size_t keptOffset = 0;
+  size_t i = 0;
+  while (i < layers.size())
+  {
+    Layer<MatType>* replacement = NULL;
+    const size_t groupSize = rebuild(layers, i, replacement);
+
+    if (replacement == NULL)
+    {
+      // Keep the layer and its weights.
+      const size_t weightSize = layers[i]->WeightSize();
+      if (weightSize > 0)
+      {
+        keptParameters.rows(keptOffset, keptOffset + weightSize - 1) =
+            parameters.rows(offsets[i], offsets[i] + weightSize - 1);
+        keptOffset += weightSize;
+      }
+
+      rebuilt.Add(layers[i]);
+      ++i;
+      continue;
+    }
+
+    for (size_t j = i; j < i + groupSize; ++j)
+      delete layers[j];
+
+    rebuilt.Add(replacement);
+    i += groupSize;
+  }
+
+  keptParameters.resize(keptOffset, 1);
+  rebuilt.InputDimensions() = model.InputDimensions();
+  rebuilt.Parameters() = std::move(keptParameters);
+
+  return rebuilt;
+}
+
+} // namespace mlpack
+
+#endif
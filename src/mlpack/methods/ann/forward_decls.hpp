@@ -27,6 +27,12 @@ template<typename OutputLayerType,
          typename MatType>
 class RNN;
 
+// See ffn_data_parallel.hpp.
+template<typename OutputLayerType,
+         typename InitializationRuleType,
+         typename MatType>
+class FFNDataParallel;
+
 } // namespace mlpack
 
 #endif
@@ -182,6 +182,12 @@ class BatchNormType : public Layer<MatType>
   //! Get the number of input units / channels.
   size_t InputSize() const { return size; }
 
+  //! Get the min axis along which BatchNorm is applied.
+  size_t MinAxis() const { return minAxis; }
+
+  //! Get the max axis along which BatchNorm is applied.
+  size_t MaxAxis() const { return maxAxis; }
+
   //! Get the epsilon value.
   double Epsilon() const { return eps; }
 
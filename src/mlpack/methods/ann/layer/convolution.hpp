@@ -18,6 +18,7 @@
 #include <mlpack/methods/ann/convolution_rules/naive_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/fft_convolution.hpp>
 #include <mlpack/methods/ann/convolution_rules/svd_convolution.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
 #include <mlpack/core/util/to_lower.hpp>
 
 #include "layer.hpp"
@@ -58,6 +59,12 @@ namespace mlpack {
  * a 2-D image (or object) of the original 196x14 size, using this as the input
  * for the 14 filters of this example.
  *
+ * If `Im2ColConvolution` is used as a convolution rule, the corresponding pass
+ * lowers the whole batch to a matrix of patches and performs a single matrix
+ * multiplication, instead of convolving every pair of input and output maps
+ * separately; this is usually much faster, but needs more memory.  The matrix
+ * of patches is kept between calls.
+ *
  * @tparam ForwardConvolutionRule Convolution to perform forward process.
  * @tparam BackwardConvolutionRule Convolution to perform backward process.
  * @tparam GradientConvolutionRule Convolution to calculate gradient.
@@ -294,6 +301,46 @@ class ConvolutionType : public Layer<MatType>
    */
   void InitializeSamePadding();
 
+  /**
+   * Compute the forward pass for all images of the batch with Im2Col() and a
+   * matrix multiplication, storing the result in `outputTemp`.
+   *
+   * @param input The (padded) input, with `inMaps` slices per image.
+   */
+  void ForwardIm2Col(const CubeType& input);
+
+  /**
+   * Compute the backward pass for all images of the batch with a matrix
+   * multiplication and Col2Im().
+   *
+   * @param mappedError The backpropagated error, with `maps` slices per image.
+   * @param g The (padded) gradient with respect to the input, with `inMaps`
+   *     slices per image; it must be filled with zeros.
+   */
+  void BackwardIm2Col(const CubeType& mappedError, CubeType& g);
+
+  /**
+   * Compute the gradient of the weights and the bias for all images of the
+   * batch with Im2Col() and a matrix multiplication.
+   *
+   * @param input The (padded) input, with `inMaps` slices per image.
+   * @param mappedError The error, with `maps` slices per image.
+   * @param gradient The gradient to add to; it must be filled with zeros.
+   */
+  void GradientIm2Col(const CubeType& input,
+                      const CubeType& mappedError,
+                      MatType& gradient);
+
+  /**
+   * Copy the maps of `numImages` images, stored as slices of `source` starting
+   * at `firstSlice`, to the columns of `mapColumns`, in the layout of the rows
+   * of the patches computed by Im2Col().
+   */
+  void MapsToColumns(const CubeType& source,
+                     const size_t firstSlice,
+                     const size_t numImages,
+                     MatType& mapColumns);
+
   /**
    * Rotates a 3rd-order tensor counterclockwise by 180 degrees.
    *
@@ -394,6 +441,13 @@ class ConvolutionType : public Layer<MatType>
 
   //! Locally-stored apparent height.
   size_t apparentHeight;
+
+  //! Locally-stored patches of the input, used by Im2ColConvolution rules.
+  MatType columns;
+
+  //! Locally-stored output or error of the patches, used by Im2ColConvolution
+  //! rules.
+  MatType columnsOutput;
 }; // class Convolution
 
 // Standard Convolution layer.
@@ -322,6 +322,12 @@ void ConvolutionType<
       this->outputDimensions[1], maps * higherInDimensions * batchSize);
   outputTemp.zeros();
 
+  if (IsIm2ColConvolution<ForwardConvolutionRule>::value)
+  {
+    ForwardIm2Col(inputTemp);
+    return;
+  }
+
   // We "ignore" dimensions higher than the third---that means that we just pass
   // them through and treat them like different input points.
   //
@@ -386,6 +392,28 @@ void ConvolutionType<
   const bool usingPadding =
       (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
 
+  if (IsIm2ColConvolution<BackwardConvolutionRule>::value)
+  {
+    if (usingPadding)
+    {
+      CubeType gPadded(this->inputDimensions[0] + padWLeft + padWRight,
+          this->inputDimensions[1] + padHTop + padHBottom, gTemp.n_slices,
+          arma::fill::zeros);
+      BackwardIm2Col(mappedError, gPadded);
+      gTemp = gPadded.tube(
+          padWLeft,
+          padHTop,
+          padWLeft + gTemp.n_rows - 1,
+          padHTop + gTemp.n_cols - 1);
+    }
+    else
+    {
+      BackwardIm2Col(mappedError, gTemp);
+    }
+
+    return;
+  }
+
   // To perform the backward pass, we need to rotate all the filters.
   CubeType rotatedFilters(weight.n_rows,
       weight.n_cols, weight.n_slices);
@@ -502,6 +530,18 @@ void ConvolutionType<
   const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
   const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
 
+  if (IsIm2ColConvolution<GradientConvolutionRule>::value)
+  {
+    CubeType paddedInput;
+    MakeAlias(paddedInput,
+        const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
+        paddedRows, paddedCols, inMaps * higherInDimensions * batchSize);
+
+    gradient.zeros();
+    GradientIm2Col(paddedInput, mappedError, gradient);
+    return;
+  }
+
   CubeType inputTemp(
       const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
       paddedRows, paddedCols, inMaps * batchSize, false, false);
@@ -672,6 +712,169 @@ void ConvolutionType<
   padHBottom = totalHorizontalPadding - totalHorizontalPadding / 2;
 }
 
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::ForwardIm2Col(const CubeType& input)
+{
+  const size_t outputRows = this->outputDimensions[0];
+  const size_t outputCols = this->outputDimensions[1];
+  const size_t outputSize = outputRows * outputCols;
+  const size_t filterSize = kernelWidth * kernelHeight * inMaps;
+  const size_t numImages = higherInDimensions * batchSize;
+  const size_t imagesPerBlock = Im2ColConvolution<>::ImagesPerBlock(
+      outputSize * filterSize, numImages);
+
+  // Each column holds the filters of one output map, in the same order as the
+  // columns of the patches.
+  MatType filters;
+  MakeAlias(filters, weight.memptr(), filterSize, maps);
+
+  for (size_t first = 0; first < numImages; first += imagesPerBlock)
+  {
+    const size_t blockImages = std::min(imagesPerBlock, numImages - first);
+    Im2ColConvolution<>::Im2Col(input, first * inMaps, inMaps, blockImages,
+        kernelWidth, kernelHeight, outputRows, outputCols, strideWidth,
+        strideHeight, 1, 1, columns);
+
+    columnsOutput = columns * filters;
+    if (useBias)
+      columnsOutput.each_row() += bias.t();
+
+    // Copy each output map to its slice of the output.
+    #pragma omp parallel for
+    for (size_t s = 0; s < (size_t) (blockImages * maps); ++s)
+    {
+      const size_t n = s / maps;
+      const size_t outMap = s % maps;
+      const typename MatType::elem_type* mapPtr =
+          columnsOutput.colptr(outMap) + n * outputSize;
+      std::copy(mapPtr, mapPtr + outputSize,
+          outputTemp.slice_memptr(first * maps + s));
+    }
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::BackwardIm2Col(const CubeType& mappedError, CubeType& g)
+{
+  const size_t outputRows = this->outputDimensions[0];
+  const size_t outputCols = this->outputDimensions[1];
+  const size_t outputSize = outputRows * outputCols;
+  const size_t filterSize = kernelWidth * kernelHeight * inMaps;
+  const size_t numImages = higherInDimensions * batchSize;
+  const size_t imagesPerBlock = Im2ColConvolution<>::ImagesPerBlock(
+      outputSize * filterSize, numImages);
+
+  MatType filters;
+  MakeAlias(filters, weight.memptr(), filterSize, maps);
+
+  for (size_t first = 0; first < numImages; first += imagesPerBlock)
+  {
+    const size_t blockImages = std::min(imagesPerBlock, numImages - first);
+    MapsToColumns(mappedError, first * maps, blockImages, columnsOutput);
+
+    // The error of each patch is scattered back to the input it came from.
+    columns = columnsOutput * filters.t();
+    Im2ColConvolution<>::Col2Im(columns, first * inMaps, inMaps, blockImages,
+        kernelWidth, kernelHeight, outputRows, outputCols, strideWidth,
+        strideHeight, 1, 1, g);
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::GradientIm2Col(const CubeType& input,
+                  const CubeType& mappedError,
+                  MatType& gradient)
+{
+  const size_t outputRows = this->outputDimensions[0];
+  const size_t outputCols = this->outputDimensions[1];
+  const size_t outputSize = outputRows * outputCols;
+  const size_t filterSize = kernelWidth * kernelHeight * inMaps;
+  const size_t numImages = higherInDimensions * batchSize;
+  const size_t imagesPerBlock = Im2ColConvolution<>::ImagesPerBlock(
+      outputSize * filterSize, numImages);
+
+  // This alias covers only the filters; the bias follows them in `gradient`.
+  MatType filterGradient;
+  MakeAlias(filterGradient, gradient.memptr(), filterSize, maps);
+
+  for (size_t first = 0; first < numImages; first += imagesPerBlock)
+  {
+    const size_t blockImages = std::min(imagesPerBlock, numImages - first);
+    Im2ColConvolution<>::Im2Col(input, first * inMaps, inMaps, blockImages,
+        kernelWidth, kernelHeight, outputRows, outputCols, strideWidth,
+        strideHeight, 1, 1, columns);
+    MapsToColumns(mappedError, first * maps, blockImages, columnsOutput);
+
+    filterGradient += columns.t() * columnsOutput;
+    if (useBias)
+    {
+      gradient.rows(filterGradient.n_elem, filterGradient.n_elem + maps - 1) +=
+          arma::sum(columnsOutput).t();
+    }
+  }
+}
+
+template<
+    typename ForwardConvolutionRule,
+    typename BackwardConvolutionRule,
+    typename GradientConvolutionRule,
+    typename MatType
+>
+void ConvolutionType<
+    ForwardConvolutionRule,
+    BackwardConvolutionRule,
+    GradientConvolutionRule,
+    MatType
+>::MapsToColumns(const CubeType& source,
+                 const size_t firstSlice,
+                 const size_t numImages,
+                 MatType& mapColumns)
+{
+  const size_t outputSize = source.n_rows * source.n_cols;
+  mapColumns.set_size(outputSize * numImages, maps);
+
+  #pragma omp parallel for
+  for (size_t s = 0; s < (size_t) (numImages * maps); ++s)
+  {
+    const size_t n = s / maps;
+    const size_t outMap = s % maps;
+    const typename MatType::elem_type* mapPtr =
+        source.slice_memptr(firstSlice + s);
+    std::copy(mapPtr, mapPtr + outputSize,
+        mapColumns.colptr(outMap) + n * outputSize);
+  }
+}
+
 } // namespace mlpack
 
 #endif
@@ -0,0 +1,245 @@
+/**
+ * @file methods/ann/layer/fast_lstm.hpp
+ * @author Marcus Edel
+ *
+ * Definition of the Fast LSTM class, which implements a Fast LSTM network
+ * layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FAST_LSTM_HPP
+#define MLPACK_METHODS_ANN_LAYER_FAST_LSTM_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer.hpp"
+
+namespace mlpack {
+
+/**
+ * An implementation of a faster version of the LSTM network layer.  Basically
+ * by combining the calculation of the input, forget, output gates and hidden
+ * state in a single step. The standard formula changes as follows:
+ *
+ * @f{eqnarray}{
+ * i &=& sigmoid(W \cdot x + W \cdot h + b) \\
+ * f &=& sigmoid(W  \cdot x + W \cdot h + b) \\
+ * z &=& tanh(W \cdot x + W \cdot h + b) \\
+ * c &=& f \cdot c + i \cdot z \\
+ * o &=& sigmoid(W \cdot x + W \cdot h + b) \\
+ * h &=& o \cdot tanh(c)
+ * @f}
+ *
+ * Note that FastLSTM network layer does not use peephole connections between
+ * the cell and gates, and that the sigmoid of the gates is computed with a
+ * cheap rational approximation instead of an exponential.
+ *
+ * Note also that if a FastLSTM layer is desired as the first layer of a neural
+ * network, an IdentityLayer should be added to the network as the first layer,
+ * and then the FastLSTM layer should be added.
+ *
+ * For more information, see the following.
+ *
+ * @code
+ * @article{Hochreiter1997,
+ *   author  = {Hochreiter, Sepp and Schmidhuber, J\"{u}rgen},
+ *   title   = {Long Short-term Memory},
+ *   journal = {Neural Comput.},
+ *   year    = {1997},
+ *   url     = {https://www.bioinf.jku.at/publications/older/2604.pdf}
+ * }
+ * @endcode
+ *
+ * The packed layout of the parameters is: the input weights
+ * (4 * outSize x inSize), the biases (4 * outSize) and the recurrent weights
+ * (4 * outSize x outSize); the rows of the gate matrices are the input gate,
+ * output gate, forget gate and hidden layer, in that order.
+ *
+ * \see LSTM for a standard implementation of the LSTM layer.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class FastLSTMType : public RecurrentLayer<MatType>
+{
+ public:
+  //! Create the FastLSTMType object.
+  FastLSTMType();
+
+  /**
+   * Create the FastLSTM layer object using the specified parameters.
+   *
+   * @param outSize The number of output units.
+   */
+  FastLSTMType(const size_t outSize);
+
+  //! Clone the FastLSTMType object. This handles polymorphism correctly.
+  FastLSTMType* Clone() const { return new FastLSTMType(*this); }
+
+  //! Copy the given FastLSTMType object.
+  FastLSTMType(const FastLSTMType& other);
+  //! Take ownership of the given FastLSTMType object's data.
+  FastLSTMType(FastLSTMType&& other);
+  //! Copy the given FastLSTMType object.
+  FastLSTMType& operator=(const FastLSTMType& other);
+  //! Take ownership of the given FastLSTMType object's data.
+  FastLSTMType& operator=(FastLSTMType&& other);
+
+  virtual ~FastLSTMType() { }
+
+  /**
+   * Reset the layer parameter. The method is called to
+   * assign the allocated memory to the internal learnable parameters.
+   */
+  void SetWeights(typename MatType::elem_type* weightsPtr);
+
+  /**
+   * Ordinary feed-forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param input The input data (x) given to the forward pass.
+   * @param output The propagated data (f(x)) resulting from Forward()
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& gy,
+                MatType& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  void Gradient(const MatType& input,
+                const MatType& error,
+                MatType& gradient);
+
+  /**
+   * Reset the recurrent state of the FastLSTM layer, and allocate enough space
+   * to hold `bpttSteps` of previous passes with a batch size of `batchSize`.
+   *
+   * @param bpttSteps Number of steps of history to allocate space for.
+   * @param batchSize Batch size to prepare for.
+   */
+  void ClearRecurrentState(const size_t bpttSteps, const size_t batchSize);
+
+  //! Get the parameters.
+  const MatType& Parameters() const { return weights; }
+  //! Modify the parameters.
+  MatType& Parameters() { return weights; }
+
+  //! Get the total number of trainable parameters.
+  size_t WeightSize() const
+  {
+    return (4 * outSize * inSize + 4 * outSize + 4 * outSize * outSize);
+  }
+
+  //! Given a properly set InputDimensions(), compute the output dimensions.
+  void ComputeOutputDimensions()
+  {
+    inSize = std::accumulate(this->inputDimensions.begin(),
+        this->inputDimensions.end(), 0);
+    this->outputDimensions = std::vector<size_t>(this->inputDimensions.size(),
+        1);
+
+    // The FastLSTM layer flattens its input.
+    this->outputDimensions[0] = outSize;
+  }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Sigmoid approximation for the given sample: a rational function of the
+   * input that saturates at 0.00494524631327 and 0.99505475368673.
+   *
+   * @param data The given data sample for the sigmoid approximation.
+   * @return The sigmoid approximation.
+   */
+  static typename MatType::elem_type FastSigmoid(
+      const typename MatType::elem_type data);
+
+  /**
+   * Derivative of the sigmoid approximation, computed from the value of the
+   * approximation (so that the input does not need to be kept).
+   *
+   * @param activation Value returned by FastSigmoid().
+   * @return The derivative of the approximation at that point.
+   */
+  static typename MatType::elem_type FastSigmoidDeriv(
+      const typename MatType::elem_type activation);
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored weight object.
+  MatType weights;
+
+  //! Weights between the input and the four gates (4 * outSize x inSize).
+  MatType input2GateWeight;
+
+  //! Bias of the four gates (4 * outSize x 1).
+  MatType input2GateBias;
+
+  //! Weights between the previous output and the four gates
+  //! (4 * outSize x outSize).
+  MatType output2GateWeight;
+
+  // These members store recurrent state.
+
+  //! Locally-stored gate activations (4 * outSize x batchSize x bpttSteps),
+  //! with the rows of the input, output and forget gates and the hidden layer.
+  arma::Cube<typename MatType::elem_type> gateActivation;
+
+  //! Locally-stored cell state.
+  arma::Cube<typename MatType::elem_type> cell;
+
+  //! Locally-stored cell activation (tanh of the cell state).
+  arma::Cube<typename MatType::elem_type> cellActivation;
+
+  //! Locally-stored output parameters.
+  arma::Cube<typename MatType::elem_type> outParameter;
+
+  //! Locally-stored error of the gate inputs of the last backward step.
+  MatType gateError;
+
+  //! Locally-stored error of the cell state passed to the earlier step.
+  MatType cellError;
+}; // class FastLSTMType
+
+// Convenience typedefs.
+
+// Standard FastLSTM layer.
+typedef FastLSTMType<arma::mat> FastLSTM;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "fast_lstm_impl.hpp"
+
+#endif
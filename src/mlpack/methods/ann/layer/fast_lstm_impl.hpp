@@ -0,0 +1,324 @@
+/**
+ * @file methods/ann/layer/fast_lstm_impl.hpp
+ * @author Marcus Edel
+ *
+ * Implementation of the Fast LSTM class, which implements a fast lstm network
+ * layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FAST_LSTM_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FAST_LSTM_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "fast_lstm.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+FastLSTMType<MatType>::FastLSTMType() :
+    RecurrentLayer<MatType>(),
+    inSize(0),
+    outSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+FastLSTMType<MatType>::FastLSTMType(const size_t outSize) :
+    RecurrentLayer<MatType>(),
+    inSize(0),
+    outSize(outSize)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+FastLSTMType<MatType>::FastLSTMType(const FastLSTMType& layer) :
+    RecurrentLayer<MatType>(layer),
+    inSize(layer.inSize),
+    outSize(layer.outSize)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+FastLSTMType<MatType>::FastLSTMType(FastLSTMType&& layer) :
+    RecurrentLayer<MatType>(std::move(layer)),
+    inSize(std::move(layer.inSize)),
+    outSize(std::move(layer.outSize))
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+FastLSTMType<MatType>& FastLSTMType<MatType>::operator=(
+    const FastLSTMType& layer)
+{
+  if (this != &layer)
+  {
+    RecurrentLayer<MatType>::operator=(layer);
+    inSize = layer.inSize;
+    outSize = layer.outSize;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+FastLSTMType<MatType>& FastLSTMType<MatType>::operator=(FastLSTMType&& layer)
+{
+  if (this != &layer)
+  {
+    RecurrentLayer<MatType>::operator=(std::move(layer));
+    inSize = std::move(layer.inSize);
+    outSize = std::move(layer.outSize);
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+void FastLSTMType<MatType>::ClearRecurrentState(
+    const size_t bpttSteps, const size_t batchSize)
+{
+  // Make sure all of the different matrices we will use to hold parameters are
+  // at least as large as we need.
+  gateActivation.set_size(4 * outSize, batchSize, bpttSteps);
+  cellActivation.set_size(outSize, batchSize, bpttSteps);
+
+  // Now reset recurrent values to 0.
+  cell.zeros(outSize, batchSize, bpttSteps);
+  outParameter.zeros(outSize, batchSize, bpttSteps);
+}
+
+template<typename MatType>
+void FastLSTMType<MatType>::SetWeights(
+    typename MatType::elem_type* weightsPtr)
+{
+  MakeAlias(weights, weightsPtr, WeightSize(), 1);
+
+  // The weights of all four gates are stored together.
+  MakeAlias(input2GateWeight, weightsPtr, 4 * outSize, inSize);
+  size_t offset = input2GateWeight.n_elem;
+  MakeAlias(input2GateBias, weightsPtr + offset, 4 * outSize, 1);
+  offset += input2GateBias.n_elem;
+  MakeAlias(output2GateWeight, weightsPtr + offset, 4 * outSize, outSize);
+}
+
+template<typename MatType>
+void FastLSTMType<MatType>::Forward(const MatType& input, MatType& output)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Convenience aliases.
+  const size_t batchSize = input.n_cols;
+  const size_t step = this->CurrentStep();
+  const bool hasPrevious = this->HasPreviousStep();
+
+  // Compute the inputs of all four gates at once, directly in the memory that
+  // holds their activations.
+  MatType gates;
+  MakeAlias(gates, gateActivation.slice_memptr(step), 4 * outSize, batchSize);
+  gates = input2GateWeight * input;
+  if (hasPrevious)
+    gates += output2GateWeight * outParameter.slice(this->PreviousStep());
+  gates.each_col() += input2GateBias;
+
+  // Now apply the activations and update the cell, one element at a time.
+  // Note that the previous step may be the same slice as the current step
+  // (when no history is kept), so each element of the previous cell is read
+  // before the element of the current cell is written.
+  #pragma omp parallel for
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    ElemType* inputGate = gates.colptr(j);
+    ElemType* outputGate = inputGate + outSize;
+    ElemType* forgetGate = inputGate + 2 * outSize;
+    ElemType* hidden = inputGate + 3 * outSize;
+    ElemType* c = cell.slice_colptr(step, j);
+    ElemType* cActivation = cellActivation.slice_colptr(step, j);
+    ElemType* out = outParameter.slice_colptr(step, j);
+    const ElemType* prevCell = hasPrevious ?
+        cell.slice_colptr(this->PreviousStep(), j) : NULL;
+
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      const ElemType cPrev = hasPrevious ? prevCell[k] : ElemType(0);
+      inputGate[k] = FastSigmoid(inputGate[k]);
+      outputGate[k] = FastSigmoid(outputGate[k]);
+      forgetGate[k] = FastSigmoid(forgetGate[k]);
+      hidden[k] = std::tanh(hidden[k]);
+
+      c[k] = forgetGate[k] * cPrev + inputGate[k] * hidden[k];
+      cActivation[k] = std::tanh(c[k]);
+      out[k] = outputGate[k] * cActivation[k];
+    }
+  }
+
+  // We need to preserve the output for the next time step, but we also need to
+  // set `output` to that, so we make a copy.
+  output = outParameter.slice(step);
+}
+
+template<typename MatType>
+void FastLSTMType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& gy,
+    MatType& g)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Convenience aliases.  During the backward pass, the "previous" step is the
+  // step after the current one in time, whose errors flow back into this step.
+  // The step before this one in time is held in the previous slice; the
+  // enclosing network keeps the state before the first step of BPTT (or the
+  // zero state) in slice 0.
+  const size_t batchSize = gy.n_cols;
+  const size_t step = this->CurrentStep();
+  const bool hasNext = this->HasPreviousStep();
+  const bool hasEarlier = (step > 0);
+
+  // The error of the output is the given error plus the error of the next
+  // step's gates, with one matrix product for all four gates.
+  MatType outputError;
+  if (hasNext)
+    outputError = gy + output2GateWeight.t() * gateError;
+  else
+    MakeAlias(outputError, (ElemType*) gy.memptr(), gy.n_rows, gy.n_cols);
+
+  if (!hasNext)
+    cellError.zeros(outSize, batchSize);
+  gateError.set_size(4 * outSize, batchSize);
+
+  #pragma omp parallel for
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    const ElemType* gates = gateActivation.slice_colptr(step, j);
+    const ElemType* inputGate = gates;
+    const ElemType* outputGate = gates + outSize;
+    const ElemType* forgetGate = gates + 2 * outSize;
+    const ElemType* hidden = gates + 3 * outSize;
+    const ElemType* cActivation = cellActivation.slice_colptr(step, j);
+    const ElemType* prevCell = hasEarlier ?
+        cell.slice_colptr(step - 1, j) : NULL;
+    const ElemType* dOut = outputError.colptr(j);
+
+    ElemType* dInputGate = gateError.colptr(j);
+    ElemType* dOutputGate = dInputGate + outSize;
+    ElemType* dForgetGate = dInputGate + 2 * outSize;
+    ElemType* dHidden = dInputGate + 3 * outSize;
+    ElemType* dCell = cellError.colptr(j);
+
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      dOutputGate[k] = dOut[k] * cActivation[k] *
+          FastSigmoidDeriv(outputGate[k]);
+
+      // dCell[k] holds the error passed back from the next step.
+      const ElemType dc = dOut[k] * outputGate[k] *
+          (1 - cActivation[k] * cActivation[k]) + dCell[k];
+
+      dForgetGate[k] = hasEarlier ? dc * prevCell[k] *
+          FastSigmoidDeriv(forgetGate[k]) : ElemType(0);
+      dInputGate[k] = dc * hidden[k] * FastSigmoidDeriv(inputGate[k]);
+      dHidden[k] = dc * inputGate[k] * (1 - hidden[k] * hidden[k]);
+
+      // Now compute the error passed to the cell of the earlier step.
+      dCell[k] = dc * forgetGate[k];
+    }
+  }
+
+  g = input2GateWeight.t() * gateError;
+}
+
+template<typename MatType>
+void FastLSTMType<MatType>::Gradient(
+    const MatType& input,
+    const MatType& /* error */,
+    MatType& gradient)
+{
+  // This implementation depends on Gradient() being called just after
+  // Backward(), which is something we can safely assume.
+  const size_t step = this->CurrentStep();
+
+  // The gradient has the same layout as the weights.
+  MatType inputWeightGrad, biasGrad, outputWeightGrad;
+  MakeAlias(inputWeightGrad, gradient.memptr(), 4 * outSize, inSize);
+  size_t offset = inputWeightGrad.n_elem;
+  MakeAlias(biasGrad, gradient.memptr() + offset, 4 * outSize, 1);
+  offset += biasGrad.n_elem;
+  MakeAlias(outputWeightGrad, gradient.memptr() + offset, 4 * outSize,
+      outSize);
+
+  inputWeightGrad = gateError * input.t();
+  biasGrad = sum(gateError, 1);
+
+  if (step > 0)
+    outputWeightGrad = gateError * outParameter.slice(step - 1).t();
+  else
+    outputWeightGrad.zeros();
+}
+
+template<typename MatType>
+typename MatType::elem_type FastLSTMType<MatType>::FastSigmoid(
+    const typename MatType::elem_type data)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // This computes 0.5 * (s(x / 2) + 1), where s(u) = 1.5 u / (1 + |u|) is a
+  // rational approximation of tanh(u), cut off where it reaches the saturation
+  // value.
+  const ElemType x = std::abs(ElemType(0.5) * data);
+  const ElemType z = std::min(ElemType(1.5) * x / (1 + x),
+      ElemType(0.99505475368673));
+
+  return ElemType(0.5) * ((data >= 0 ? z : -z) + 1);
+}
+
+template<typename MatType>
+typename MatType::elem_type FastLSTMType<MatType>::FastSigmoidDeriv(
+    const typename MatType::elem_type activation)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Recover s(x / 2) from the activation.  Its derivative with respect to
+  // x / 2 is 1.5 / (1 + |u|)^2 = (1.5 - |s|)^2 / 1.5, and zero once the
+  // approximation is saturated.
+  const ElemType z = std::abs(2 * activation - 1);
+  if (z >= ElemType(0.99505475368673) * (1 - ElemType(1e-6)))
+    return ElemType(0);
+
+  return ElemType(0.25) * (ElemType(1.5) - z) * (ElemType(1.5) - z) /
+      ElemType(1.5);
+}
+
+template<typename MatType>
+template<typename Archive>
+void FastLSTMType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<RecurrentLayer<MatType>>(this));
+
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+
+  // Clear recurrent state if we are loading.
+  if (Archive::is_loading::value)
+  {
+    gateActivation.clear();
+    cell.clear();
+    cellActivation.clear();
+    outParameter.clear();
+    gateError.clear();
+    cellError.clear();
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,98 @@
+/**
+ * @file methods/ann/layer/fused_activation.hpp
+ *
+ * The element-wise activation layers that the FusedLinear and FusedConvolution
+ * layers can apply while they write their output.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_ACTIVATION_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_ACTIVATION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/activation_functions/identity_function.hpp>
+
+#include "base_layer.hpp"
+#include "identity.hpp"
+
+namespace mlpack {
+
+/**
+ * Call `visitor(name, ActivationFunction())` for each activation function that
+ * can be fused into the output of a layer, where `name` is the name used to
+ * store the activation in a fused layer.  These are the activation functions
+ * of the parameter-free element-wise layers of base_layer.hpp, and the
+ * identity.
+ *
+ * @param visitor Function object to call for each activation function.
+ */
+template<typename VisitorType>
+void VisitFusedActivations(VisitorType visitor)
+{
+  visitor("identity", IdentityFunction());
+  visitor("sigmoid", LogisticFunction());
+  visitor("relu", RectifierFunction());
+  visitor("tanh", TanhFunction());
+  visitor("softplus", SoftplusFunction());
+  visitor("hard_sigmoid", HardSigmoidFunction());
+  visitor("swish", SwishFunction());
+  visitor("mish", MishFunction());
+  visitor("lisht", LiSHTFunction());
+  visitor("gelu", GELUFunction());
+  visitor("elliot", ElliotFunction());
+  visitor("elish", ElishFunction());
+  visitor("gaussian", GaussianFunction());
+  visitor("hard_swish", HardSwishFunction());
+  visitor("tanh_exp", TanhExpFunction());
+  visitor("silu", SILUFunction());
+  visitor("hyper_sinh", HyperSinhFunction());
+  visitor("bipolar_sigmoid", BipolarSigmoidFunction());
+}
+
+/**
+ * Return whether the given name is the name of an activation that can be
+ * fused.
+ *
+ * @param name Name of the activation.
+ */
+inline bool IsFusedActivation(const std::string& name)
+{
+  bool found = false;
+  VisitFusedActivations([&](const char* activationName, auto /* function */)
+  {
+    found |= (name == activationName);
+  });
+
+  return found;
+}
+
+/**
+ * Return the name of the activation that the given layer computes, if it is an
+ * element-wise layer that can be fused into the layer before it, or an empty
+ * string otherwise.
+ *
+ * @param layer Layer to check.
+ */
+template<typename MatType>
+std::string FusedActivationName(const Layer<MatType>& layer)
+{
+  if (dynamic_cast<const IdentityType<MatType>*>(&layer))
+    return "identity";
+
+  std::string name;
+  VisitFusedActivations([&](const char* activationName, auto function)
+  {
+    typedef BaseLayer<decltype(function), MatType> ActivationLayer;
+    if (dynamic_cast<const ActivationLayer*>(&layer))
+      name = activationName;
+  });
+
+  return name;
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,185 @@
+/**
+ * @file methods/ann/layer/fused_convolution.hpp
+ *
+ * Definition of the FusedConvolution layer, an inference-only convolution
+ * layer that applies an element-wise activation while it writes its output.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+
+#include "layer.hpp"
+#include "convolution.hpp"
+#include "fused_activation.hpp"
+#include "padding.hpp"
+
+namespace mlpack {
+
+/**
+ * The FusedConvolution layer computes the same two-dimensional convolution as
+ * a trained Convolution layer, followed by one of the element-wise activations
+ * of `VisitFusedActivations()`.  The input is lowered to patches in the same
+ * way as `Im2ColConvolution`, and the bias and the activation are applied
+ * while each block of the product of the patches and the filters is copied to
+ * the output maps.  A FusedConvolution layer replaces a Convolution layer, the
+ * BatchNorm layer after it (whose inference-time scale and shift are folded
+ * into the filters and the bias) and the activation layer after that; see
+ * `FuseFFN()`.
+ *
+ * This layer has no trainable parameters, and can only be used for inference:
+ * calling `Backward()` throws an exception.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class FusedConvolutionType : public Layer<MatType>
+{
+ public:
+  typedef typename MatType::elem_type ElemType;
+  typedef typename GetCubeType<MatType>::type CubeType;
+
+  //! Create an empty FusedConvolution object (for serialization).
+  FusedConvolutionType();
+
+  /**
+   * Create the FusedConvolution layer from the filters and bias of the given
+   * trained Convolution layer.  The layer must have been used already (so that
+   * its weights are set).  The filters and the bias can then be modified with
+   * `Weight()` and `Bias()`.
+   *
+   * @param layer Convolution layer to take the filters from.
+   * @param activation Name of the activation to apply to the output (see
+   *     `VisitFusedActivations()`).
+   */
+  template<typename ForwardConvolutionRule,
+           typename BackwardConvolutionRule,
+           typename GradientConvolutionRule>
+  FusedConvolutionType(const ConvolutionType<ForwardConvolutionRule,
+                                             BackwardConvolutionRule,
+                                             GradientConvolutionRule,
+                                             MatType>& layer,
+                       const std::string& activation = "identity");
+
+  virtual ~FusedConvolutionType() { }
+
+  //! Clone the FusedConvolutionType object. This handles polymorphism
+  //! correctly.
+  FusedConvolutionType* Clone() const
+  {
+    return new FusedConvolutionType(*this);
+  }
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * The backward pass is not available for fused layers; this throws a
+   * std::logic_error.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& /* gy */,
+                MatType& /* g */);
+
+  //! Get the number of output maps.
+  size_t Maps() const { return maps; }
+  //! Get the kernel width.
+  size_t KernelWidth() const { return kernelWidth; }
+  //! Get the kernel height.
+  size_t KernelHeight() const { return kernelHeight; }
+  //! Get the stride width.
+  size_t StrideWidth() const { return strideWidth; }
+  //! Get the stride height.
+  size_t StrideHeight() const { return strideHeight; }
+
+  //! Get the filters; each column of the (filter size x maps) matrix holds the
+  //! filters of one output map.
+  const MatType& Weight() const { return weight; }
+  //! Modify the filters.
+  MatType& Weight() { return weight; }
+  //! Get the bias of each output map.
+  const MatType& Bias() const { return bias; }
+  //! Modify the bias of each output map.
+  MatType& Bias() { return bias; }
+  //! Get the name of the activation applied to the output.
+  const std::string& Activation() const { return activation; }
+
+  //! Compute the output dimensions of the layer based on `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of output maps.
+  size_t maps;
+
+  //! Locally-stored number of input maps.
+  size_t inMaps;
+
+  //! Locally-stored filter width.
+  size_t kernelWidth;
+
+  //! Locally-stored filter height.
+  size_t kernelHeight;
+
+  //! Locally-stored stride of the filter in x-direction.
+  size_t strideWidth;
+
+  //! Locally-stored stride of the filter in y-direction.
+  size_t strideHeight;
+
+  //! Locally-stored left-side padding width.
+  size_t padWLeft;
+
+  //! Locally-stored right-side padding width.
+  size_t padWRight;
+
+  //! Locally-stored bottom padding height.
+  size_t padHBottom;
+
+  //! Locally-stored top padding height.
+  size_t padHTop;
+
+  //! Locally-stored filters (kernelWidth * kernelHeight * inMaps x maps).
+  MatType weight;
+
+  //! Locally-stored bias of each output map (maps x 1).
+  MatType bias;
+
+  //! Name of the activation applied to the output.
+  std::string activation;
+
+  //! Locally-stored padding layer.
+  PaddingType<MatType> padding;
+
+  //! Locally-stored product of the input dimensions higher than the third.
+  size_t higherInDimensions;
+}; // class FusedConvolutionType
+
+// Convenience typedefs.
+
+// Standard FusedConvolution layer.
+typedef FusedConvolutionType<arma::mat> FusedConvolution;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "fused_convolution_impl.hpp"
+
+#endif
@@ -0,0 +1,231 @@
+/**
+ * @file methods/ann/layer/fused_convolution_impl.hpp
+ *
+ * Implementation of the FusedConvolution layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "fused_convolution.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+FusedConvolutionType<MatType>::FusedConvolutionType() :
+    Layer<MatType>(),
+    maps(0),
+    inMaps(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(1),
+    strideHeight(1),
+    padWLeft(0),
+    padWRight(0),
+    padHBottom(0),
+    padHTop(0),
+    activation("identity"),
+    higherInDimensions(1)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+template<typename ForwardConvolutionRule,
+         typename BackwardConvolutionRule,
+         typename GradientConvolutionRule>
+FusedConvolutionType<MatType>::FusedConvolutionType(
+    const ConvolutionType<ForwardConvolutionRule,
+                          BackwardConvolutionRule,
+                          GradientConvolutionRule,
+                          MatType>& layer,
+    const std::string& activation) :
+    Layer<MatType>(),
+    maps(layer.Maps()),
+    inMaps(0),
+    kernelWidth(layer.KernelWidth()),
+    kernelHeight(layer.KernelHeight()),
+    strideWidth(layer.StrideWidth()),
+    strideHeight(layer.StrideHeight()),
+    padWLeft(layer.PadWLeft()),
+    padWRight(layer.PadWRight()),
+    padHBottom(layer.PadHBottom()),
+    padHTop(layer.PadHTop()),
+    activation(activation),
+    higherInDimensions(1)
+{
+  const CubeType& filters = layer.Weight();
+  if (filters.is_empty() || maps == 0)
+  {
+    throw std::invalid_argument("FusedConvolutionType::FusedConvolutionType():"
+        " the weights of the convolution layer are not set!");
+  }
+
+  if (!IsFusedActivation(activation))
+  {
+    throw std::invalid_argument("FusedConvolutionType::FusedConvolutionType():"
+        " unknown activation '" + activation + "'!");
+  }
+
+  // The filters of each output map are contiguous in the weights of the
+  // convolution layer, so each column of this matrix holds the filters of one
+  // output map.
+  inMaps = filters.n_slices / maps;
+  weight = MatType(filters.memptr(),
+      kernelWidth * kernelHeight * inMaps, maps);
+
+  if (layer.Bias().is_empty())
+    bias.zeros(maps, 1);
+  else
+    bias = vectorise(layer.Bias());
+}
+
+template<typename MatType>
+void FusedConvolutionType<MatType>::Forward(
+    const MatType& input, MatType& output)
+{
+  const size_t batchSize = input.n_cols;
+
+  // First, perform any padding if necessary.
+  const bool usingPadding =
+      (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
+  const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
+  const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
+  MatType inputPadded;
+  if (usingPadding)
+  {
+    inputPadded.set_size(paddedRows * paddedCols * inMaps * higherInDimensions,
+        batchSize);
+    padding.Forward(input, inputPadded);
+  }
+
+  CubeType inputTemp;
+  MakeAlias(inputTemp,
+      const_cast<MatType&>(usingPadding ? inputPadded : input).memptr(),
+      paddedRows, paddedCols, inMaps * higherInDimensions * batchSize);
+
+  const size_t outputRows = this->outputDimensions[0];
+  const size_t outputCols = this->outputDimensions[1];
+  const size_t outputSize = outputRows * outputCols;
+  const size_t filterSize = kernelWidth * kernelHeight * inMaps;
+  const size_t numImages = higherInDimensions * batchSize;
+  const size_t imagesPerBlock = Im2ColConvolution<>::ImagesPerBlock(
+      outputSize * filterSize, numImages);
+
+  MatType columns, columnsOutput;
+  for (size_t first = 0; first < numImages; first += imagesPerBlock)
+  {
+    const size_t blockImages = std::min(imagesPerBlock, numImages - first);
+    Im2ColConvolution<>::Im2Col(inputTemp, first * inMaps, inMaps, blockImages,
+        kernelWidth, kernelHeight, outputRows, outputCols, strideWidth,
+        strideHeight, 1, 1, columns);
+
+    columnsOutput = columns * weight;
+
+    // Copy each output map to its place in the output, adding the bias and
+    // applying the activation on the way.
+    VisitFusedActivations([&](const char* name, auto function)
+    {
+      typedef decltype(function) ActivationFunction;
+      if (activation != name)
+        return;
+
+      #pragma omp parallel for
+      for (size_t s = 0; s < (size_t) (blockImages * maps); ++s)
+      {
+        const size_t n = s / maps;
+        const size_t outMap = s % maps;
+        const ElemType mapBias = bias[outMap];
+        const ElemType* mapPtr = columnsOutput.colptr(outMap) + n * outputSize;
+        ElemType* outputPtr = output.memptr() + (first * maps + s) * outputSize;
+        for (size_t i = 0; i < outputSize; ++i)
+        {
+          outputPtr[i] = (ElemType) ActivationFunction::Fn(
+              (double) (mapPtr[i] + mapBias));
+        }
+      }
+    });
+  }
+}
+
+template<typename MatType>
+void FusedConvolutionType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& /* gy */,
+    MatType& /* g */)
+{
+  throw std::logic_error("FusedConvolutionType::Backward(): fused layers can "
+      "only be used for inference!");
+}
+
+template<typename MatType>
+void FusedConvolutionType<MatType>::ComputeOutputDimensions()
+{
+  padding = PaddingType<MatType>(padWLeft, padWRight, padHTop, padHBottom);
+  padding.InputDimensions() = this->inputDimensions;
+  padding.ComputeOutputDimensions();
+
+  const size_t inputMaps = (this->inputDimensions.size() >= 3) ?
+      this->inputDimensions[2] : 1;
+  if (inputMaps != inMaps)
+  {
+    std::ostringstream oss;
+    oss << "FusedConvolutionType::ComputeOutputDimensions(): number of input "
+        << "maps (" << inputMaps << ") does not match the number of input maps "
+        << "of the filters (" << inMaps << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // We must ensure that the output has at least 3 dimensions, since we will
+  // be adding some number of maps to the output.
+  this->outputDimensions = std::vector<size_t>(
+      std::max(this->inputDimensions.size(), size_t(3)), 1);
+  this->outputDimensions[0] = (this->inputDimensions[0] + padWLeft +
+      padWRight - kernelWidth) / strideWidth + 1;
+  this->outputDimensions[1] = (this->inputDimensions[1] + padHTop +
+      padHBottom - kernelHeight) / strideHeight + 1;
+
+  // Dimensions higher than the third are passed through as separate images.
+  higherInDimensions = 1;
+  for (size_t i = 3; i < this->inputDimensions.size(); ++i)
+  {
+    higherInDimensions *= this->inputDimensions[i];
+    this->outputDimensions[i] = this->inputDimensions[i];
+  }
+
+  this->outputDimensions[2] = maps;
+}
+
+template<typename MatType>
+template<typename Archive>
+void FusedConvolutionType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(maps));
+  ar(CEREAL_NVP(inMaps));
+  ar(CEREAL_NVP(kernelWidth));
+  ar(CEREAL_NVP(kernelHeight));
+  ar(CEREAL_NVP(strideWidth));
+  ar(CEREAL_NVP(strideHeight));
+  ar(CEREAL_NVP(padWLeft));
+  ar(CEREAL_NVP(padWRight));
+  ar(CEREAL_NVP(padHBottom));
+  ar(CEREAL_NVP(padHTop));
+  ar(CEREAL_NVP(weight));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(activation));
+  ar(CEREAL_NVP(padding));
+  ar(CEREAL_NVP(higherInDimensions));
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,122 @@
+/**
+ * @file methods/ann/layer/fused_linear.hpp
+ *
+ * Definition of the FusedLinear layer, an inference-only linear layer that
+ * applies an element-wise activation while it writes its output.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer.hpp"
+#include "fused_activation.hpp"
+
+namespace mlpack {
+
+/**
+ * The FusedLinear layer computes y = f(Ax + b), where f is one of the
+ * element-wise activations of `VisitFusedActivations()`.  The bias and the
+ * activation are applied in the same pass over the output of the matrix
+ * product, so the output is written only once and no intermediate
+ * activations are stored.  A FusedLinear layer replaces a Linear or
+ * LinearNoBias layer, the BatchNorm layer after it (whose inference-time
+ * scale and shift are folded into A and b) and the activation layer after
+ * that; see `FuseFFN()`.
+ *
+ * This layer has no trainable parameters, and can only be used for inference:
+ * calling `Backward()` throws an exception.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class FusedLinearType : public Layer<MatType>
+{
+ public:
+  typedef typename MatType::elem_type ElemType;
+
+  //! Create an empty FusedLinear object (for serialization).
+  FusedLinearType();
+
+  /**
+   * Create the FusedLinear layer from the given weights, bias and activation.
+   *
+   * @param weight Weights of the layer (outSize x inSize).
+   * @param bias Bias of the layer (outSize x 1).
+   * @param activation Name of the activation to apply to the output (see
+   *     `VisitFusedActivations()`).
+   */
+  FusedLinearType(const MatType& weight,
+                  const MatType& bias,
+                  const std::string& activation = "identity");
+
+  virtual ~FusedLinearType() { }
+
+  //! Clone the FusedLinearType object. This handles polymorphism correctly.
+  FusedLinearType* Clone() const { return new FusedLinearType(*this); }
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * The backward pass is not available for fused layers; this throws a
+   * std::logic_error.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& /* gy */,
+                MatType& /* g */);
+
+  //! Get the number of input units.
+  size_t InSize() const { return weight.n_cols; }
+  //! Get the number of output units.
+  size_t OutSize() const { return weight.n_rows; }
+
+  //! Get the weights.
+  const MatType& Weight() const { return weight; }
+  //! Get the bias.
+  const MatType& Bias() const { return bias; }
+  //! Get the name of the activation applied to the output.
+  const std::string& Activation() const { return activation; }
+
+  //! Compute the output dimensions of the layer given `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored weights (outSize x inSize).
+  MatType weight;
+
+  //! Locally-stored bias (outSize x 1).
+  MatType bias;
+
+  //! Name of the activation applied to the output.
+  std::string activation;
+}; // class FusedLinearType
+
+// Convenience typedefs.
+
+// Standard FusedLinear layer.
+typedef FusedLinearType<arma::mat> FusedLinear;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "fused_linear_impl.hpp"
+
+#endif
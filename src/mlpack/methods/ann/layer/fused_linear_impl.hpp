@@ -0,0 +1,130 @@
+/**
+ * @file methods/ann/layer/fused_linear_impl.hpp
+ *
+ * Implementation of the FusedLinear layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_FUSED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "fused_linear.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+FusedLinearType<MatType>::FusedLinearType() :
+    Layer<MatType>(),
+    activation("identity")
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+FusedLinearType<MatType>::FusedLinearType(
+    const MatType& weight,
+    const MatType& bias,
+    const std::string& activation) :
+    Layer<MatType>(),
+    weight(weight),
+    bias(vectorise(bias)),
+    activation(activation)
+{
+  if (weight.is_empty())
+  {
+    throw std::invalid_argument("FusedLinearType::FusedLinearType(): the "
+        "weights must not be empty!");
+  }
+
+  if (this->bias.n_elem != weight.n_rows)
+  {
+    throw std::invalid_argument("FusedLinearType::FusedLinearType(): the bias "
+        "must have one element per row of the weights!");
+  }
+
+  if (!IsFusedActivation(activation))
+  {
+    throw std::invalid_argument("FusedLinearType::FusedLinearType(): unknown "
+        "activation '" + activation + "'!");
+  }
+}
+
+template<typename MatType>
+void FusedLinearType<MatType>::Forward(
+    const MatType& input, MatType& output)
+{
+  output = weight * input;
+
+  // Add the bias and apply the activation in a single pass over the output.
+  ElemType* outputPtr = output.memptr();
+  const ElemType* biasPtr = bias.memptr();
+  const size_t rows = output.n_rows;
+  const size_t elements = output.n_elem;
+  VisitFusedActivations([&](const char* name, auto function)
+  {
+    typedef decltype(function) ActivationFunction;
+    if (activation != name)
+      return;
+
+    #pragma omp parallel for
+    for (size_t i = 0; i < elements; ++i)
+    {
+      outputPtr[i] = (ElemType) ActivationFunction::Fn(
+          (double) (outputPtr[i] + biasPtr[i % rows]));
+    }
+  });
+}
+
+template<typename MatType>
+void FusedLinearType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& /* gy */,
+    MatType& /* g */)
+{
+  throw std::logic_error("FusedLinearType::Backward(): fused layers can only "
+      "be used for inference!");
+}
+
+template<typename MatType>
+void FusedLinearType<MatType>::ComputeOutputDimensions()
+{
+  size_t totalInputSize = this->inputDimensions[0];
+  for (size_t i = 1; i < this->inputDimensions.size(); ++i)
+    totalInputSize *= this->inputDimensions[i];
+
+  if (totalInputSize != weight.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "FusedLinearType::ComputeOutputDimensions(): input size ("
+        << totalInputSize << ") does not match the number of input units of "
+        << "the weights (" << weight.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  this->outputDimensions = std::vector<size_t>(this->inputDimensions.size(),
+      1);
+
+  // The FusedLinear layer flattens its input.
+  this->outputDimensions[0] = weight.n_rows;
+}
+
+template<typename MatType>
+template<typename Archive>
+void FusedLinearType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(weight));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(activation));
+}
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,220 @@
+/**
+ * @file methods/ann/layer/gru.hpp
+ * @author Sumedh Ghaisas
+ *
+ * Definition of the GRU layer.
+ *
+ * For more information, read the following paper:
+ *
+ * @code
+ * @inproceedings{chung2015gated,
+ *    title     = {Gated Feedback Recurrent Neural Networks.},
+ *    author    = {Chung, Junyoung and G{\"u}l{\c{c}}ehre, Caglar and Cho,
+                  Kyunghyun and Bengio, Yoshua},
+ *    booktitle = {ICML},
+ *    pages     = {2067--2075},
+ *    year      = {2015},
+ *    url       = {https://arxiv.org/abs/1502.02367}
+ * }
+ * @endcode
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_GRU_HPP
+#define MLPACK_METHODS_ANN_LAYER_GRU_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include "layer.hpp"
+
+namespace mlpack {
+
+/**
+ * An implementation of a gru network layer.  The implementation corresponds
+ * to the following algorithm:
+ *
+ * @f{eqnarray}{
+ * z &=& sigmoid(W \cdot x + U \cdot h + b) \\
+ * r &=& sigmoid(W \cdot x + U \cdot h + b) \\
+ * o &=& tanh(W \cdot x + U \cdot (r \odot h) + b) \\
+ * h &=& z \odot h + (1 - z) \odot o
+ * @f}
+ *
+ * This cell can be used in RNN networks.
+ *
+ * The input weights of the three gates are packed into a single matrix, as are
+ * the recurrent weights of the update and reset gates, so that each step
+ * computes the inputs of all gates with one matrix product for the input, one
+ * for the previous output and one for the reset output.  The packed layout of
+ * the parameters is: the input weights (3 * outSize x inSize), the biases
+ * (3 * outSize), the recurrent weights of the update and reset gates
+ * (2 * outSize x outSize) and the recurrent weights of the output
+ * (outSize x outSize); the rows of the gate matrices are the update gate, reset
+ * gate and output, in that order.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class GRUType : public RecurrentLayer<MatType>
+{
+ public:
+  //! Create the GRU object.
+  GRUType();
+
+  /**
+   * Create the GRU layer object using the specified parameters.
+   *
+   * @param outSize The number of output units.
+   */
+  GRUType(const size_t outSize);
+
+  //! Clone the GRUType object. This handles polymorphism correctly.
+  GRUType* Clone() const { return new GRUType(*this); }
+
+  //! Copy the given GRUType object.
+  GRUType(const GRUType& other);
+  //! Take ownership of the given GRUType object's data.
+  GRUType(GRUType&& other);
+  //! Copy the given GRUType object.
+  GRUType& operator=(const GRUType& other);
+  //! Take ownership of the given GRUType object's data.
+  GRUType& operator=(GRUType&& other);
+
+  virtual ~GRUType() { }
+
+  /**
+   * Reset the layer parameter. The method is called to
+   * assign the allocated memory to the internal learnable parameters.
+   */
+  void SetWeights(typename MatType::elem_type* weightsPtr);
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * Ordinary feed backward pass of a neural network, calculating the function
+   * f(x) by propagating x backwards trough f. Using the results from the feed
+   * forward pass.
+   *
+   * @param input The input data (x) given to the forward pass.
+   * @param output The propagated data (f(x)) resulting from Forward()
+   * @param gy The backpropagated error.
+   * @param g The calculated gradient.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& gy,
+                MatType& g);
+
+  /*
+   * Calculate the gradient using the output delta and the input activation.
+   *
+   * @param input The input parameter used for calculating the gradient.
+   * @param error The calculated error.
+   * @param gradient The calculated gradient.
+   */
+  void Gradient(const MatType& input,
+                const MatType& error,
+                MatType& gradient);
+
+  /**
+   * Reset the recurrent state of the GRU layer, and allocate enough space to
+   * hold `bpttSteps` of previous passes with a batch size of `batchSize`.
+   *
+   * @param bpttSteps Number of steps of history to allocate space for.
+   * @param batchSize Batch size to prepare for.
+   */
+  void ClearRecurrentState(const size_t bpttSteps, const size_t batchSize);
+
+  //! Get the parameters.
+  const MatType& Parameters() const { return weights; }
+  //! Modify the parameters.
+  MatType& Parameters() { return weights; }
+
+  //! Get the total number of trainable parameters.
+  size_t WeightSize() const
+  {
+    return (3 * outSize * inSize + 3 * outSize + 3 * outSize * outSize);
+  }
+
+  //! Given a properly set InputDimensions(), compute the output dimensions.
+  void ComputeOutputDimensions()
+  {
+    inSize = std::accumulate(this->inputDimensions.begin(),
+        this->inputDimensions.end(), 0);
+    this->outputDimensions = std::vector<size_t>(this->inputDimensions.size(),
+        1);
+
+    // The GRU layer flattens its input.
+    this->outputDimensions[0] = outSize;
+  }
+
+  /**
+   * Serialize the layer.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Locally-stored weight object.
+  MatType weights;
+
+  //! Weights between the input and the three gates (3 * outSize x inSize).
+  MatType input2GateWeight;
+
+  //! Bias of the three gates (3 * outSize x 1).
+  MatType input2GateBias;
+
+  //! Weights between the previous output and the update and reset gates
+  //! (2 * outSize x outSize).
+  MatType output2GateWeight;
+
+  //! Weights between the reset output and the output (outSize x outSize).
+  MatType outputHidden2GateWeight;
+
+  // These members store recurrent state.
+
+  //! Locally-stored gate activations (3 * outSize x batchSize x bpttSteps),
+  //! with the rows of the update gate, reset gate and output.
+  arma::Cube<typename MatType::elem_type> gateActivation;
+
+  //! Locally-stored reset output (the reset gate times the previous output).
+  arma::Cube<typename MatType::elem_type> resetOutput;
+
+  //! Locally-stored output parameters.
+  arma::Cube<typename MatType::elem_type> outParameter;
+
+  //! Locally-stored error of the gate inputs of the last backward step.
+  MatType gateError;
+
+  //! Locally-stored error of the output passed to the earlier step.
+  MatType outputError;
+}; // class GRUType
+
+// Convenience typedefs.
+
+// Standard GRU layer.
+typedef GRUType<arma::mat> GRU;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "gru_impl.hpp"
+
+#endif
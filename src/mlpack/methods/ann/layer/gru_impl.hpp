@@ -0,0 +1,355 @@
+/**
+ * @file methods/ann/layer/gru_impl.hpp
+ * @author Sumedh Ghaisas
+ *
+ * Implementation of the GRU class, which implements a gru network
+ * layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_GRU_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_GRU_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "gru.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+GRUType<MatType>::GRUType() :
+    RecurrentLayer<MatType>(),
+    inSize(0),
+    outSize(0)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+GRUType<MatType>::GRUType(const size_t outSize) :
+    RecurrentLayer<MatType>(),
+    inSize(0),
+    outSize(outSize)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+GRUType<MatType>::GRUType(const GRUType& layer) :
+    RecurrentLayer<MatType>(layer),
+    inSize(layer.inSize),
+    outSize(layer.outSize)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+GRUType<MatType>::GRUType(GRUType&& layer) :
+    RecurrentLayer<MatType>(std::move(layer)),
+    inSize(std::move(layer.inSize)),
+    outSize(std::move(layer.outSize))
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+GRUType<MatType>& GRUType<MatType>::operator=(const GRUType& layer)
+{
+  if (this != &layer)
+  {
+    RecurrentLayer<MatType>::operator=(layer);
+    inSize = layer.inSize;
+    outSize = layer.outSize;
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+GRUType<MatType>& GRUType<MatType>::operator=(GRUType&& layer)
+{
+  if (this != &layer)
+  {
+    RecurrentLayer<MatType>::operator=(std::move(layer));
+    inSize = std::move(layer.inSize);
+    outSize = std::move(layer.outSize);
+  }
+
+  return *this;
+}
+
+template<typename MatType>
+void GRUType<MatType>::ClearRecurrentState(
+    const size_t bpttSteps, const size_t batchSize)
+{
+  // Make sure all of the different matrices we will use to hold parameters are
+  // at least as large as we need.
+  gateActivation.set_size(3 * outSize, batchSize, bpttSteps);
+  resetOutput.set_size(outSize, batchSize, bpttSteps);
+
+  // Now reset recurrent values to 0.
+  outParameter.zeros(outSize, batchSize, bpttSteps);
+}
+
+template<typename MatType>
+void GRUType<MatType>::SetWeights(typename MatType::elem_type* weightsPtr)
+{
+  MakeAlias(weights, weightsPtr, WeightSize(), 1);
+
+  // The weights of all three gates are stored together.
+  MakeAlias(input2GateWeight, weightsPtr, 3 * outSize, inSize);
+  size_t offset = input2GateWeight.n_elem;
+  MakeAlias(input2GateBias, weightsPtr + offset, 3 * outSize, 1);
+  offset += input2GateBias.n_elem;
+  MakeAlias(output2GateWeight, weightsPtr + offset, 2 * outSize, outSize);
+  offset += output2GateWeight.n_elem;
+  MakeAlias(outputHidden2GateWeight, weightsPtr + offset, outSize, outSize);
+}
+
+template<typename MatType>
+void GRUType<MatType>::Forward(const MatType& input, MatType& output)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Convenience aliases.
+  const size_t batchSize = input.n_cols;
+  const size_t step = this->CurrentStep();
+  const bool hasPrevious = this->HasPreviousStep();
+
+  // Compute the input contribution of all three gates at once, directly in the
+  // memory that holds their activations.
+  MatType gates;
+  MakeAlias(gates, gateActivation.slice_memptr(step), 3 * outSize, batchSize);
+  gates = input2GateWeight * input;
+  gates.each_col() += input2GateBias;
+
+  if (!hasPrevious)
+  {
+    // There is no previous output, so the reset output is zero and the output
+    // only depends on the update gate and the output activation.
+    resetOutput.slice(step).zeros();
+
+    #pragma omp parallel for
+    for (size_t j = 0; j < batchSize; ++j)
+    {
+      ElemType* updateGate = gates.colptr(j);
+      ElemType* resetGate = updateGate + outSize;
+      ElemType* hidden = updateGate + 2 * outSize;
+      ElemType* out = outParameter.slice_colptr(step, j);
+
+      for (size_t k = 0; k < outSize; ++k)
+      {
+        updateGate[k] = 1 / (1 + std::exp(-updateGate[k]));
+        resetGate[k] = 1 / (1 + std::exp(-resetGate[k]));
+        hidden[k] = std::tanh(hidden[k]);
+        out[k] = (1 - updateGate[k]) * hidden[k];
+      }
+    }
+
+    output = outParameter.slice(step);
+    return;
+  }
+
+  // The update and reset gates depend on the previous output.
+  const size_t previous = this->PreviousStep();
+  gates.rows(0, 2 * outSize - 1) += output2GateWeight *
+      outParameter.slice(previous);
+
+  #pragma omp parallel for
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    ElemType* updateGate = gates.colptr(j);
+    ElemType* resetGate = updateGate + outSize;
+    ElemType* reset = resetOutput.slice_colptr(step, j);
+    const ElemType* prevOut = outParameter.slice_colptr(previous, j);
+
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      updateGate[k] = 1 / (1 + std::exp(-updateGate[k]));
+      resetGate[k] = 1 / (1 + std::exp(-resetGate[k]));
+      reset[k] = resetGate[k] * prevOut[k];
+    }
+  }
+
+  // The output activation depends on the reset output.
+  gates.rows(2 * outSize, 3 * outSize - 1) += outputHidden2GateWeight *
+      resetOutput.slice(step);
+
+  // Note that the previous step may be the same slice as the current step
+  // (when no history is kept), so each element of the previous output is read
+  // before the element of the current output is written.
+  #pragma omp parallel for
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    const ElemType* updateGate = gates.colptr(j);
+    ElemType* hidden = gates.colptr(j) + 2 * outSize;
+    ElemType* out = outParameter.slice_colptr(step, j);
+    const ElemType* prevOut = outParameter.slice_colptr(previous, j);
+
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      hidden[k] = std::tanh(hidden[k]);
+      out[k] = updateGate[k] * prevOut[k] + (1 - updateGate[k]) * hidden[k];
+    }
+  }
+
+  // We need to preserve the output for the next time step, but we also need to
+  // set `output` to that, so we make a copy.
+  output = outParameter.slice(step);
+}
+
+template<typename MatType>
+void GRUType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& gy,
+    MatType& g)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  // Convenience aliases.  During the backward pass, the "previous" step is the
+  // step after the current one in time, whose errors flow back into this step.
+  // The step before this one in time is held in the previous slice; the
+  // enclosing network keeps the state before the first step of BPTT (or the
+  // zero state) in slice 0, so `hPrev` is the output that this step actually
+  // used.
+  const size_t batchSize = gy.n_cols;
+  const size_t step = this->CurrentStep();
+  const bool hasNext = this->HasPreviousStep();
+  const bool hasEarlier = (step > 0);
+
+  // The error of the output is the given error plus the error passed back from
+  // the next step.
+  MatType dOutput;
+  if (hasNext)
+    dOutput = gy + outputError;
+  else
+    MakeAlias(dOutput, (ElemType*) gy.memptr(), gy.n_rows, gy.n_cols);
+
+  gateError.set_size(3 * outSize, batchSize);
+  outputError.set_size(outSize, batchSize);
+
+  // First compute the error of the update gate and the output activation, and
+  // the part of the error of the earlier output that goes through the update.
+  #pragma omp parallel for
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    const ElemType* updateGate = gateActivation.slice_colptr(step, j);
+    const ElemType* hidden = updateGate + 2 * outSize;
+    const ElemType* prevOut = hasEarlier ?
+        outParameter.slice_colptr(step - 1, j) : NULL;
+    const ElemType* dOut = dOutput.colptr(j);
+
+    ElemType* dUpdateGate = gateError.colptr(j);
+    ElemType* dHidden = dUpdateGate + 2 * outSize;
+    ElemType* dPrevOut = outputError.colptr(j);
+
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      const ElemType hPrev = hasEarlier ? prevOut[k] : ElemType(0);
+      dHidden[k] = dOut[k] * (1 - updateGate[k]) *
+          (1 - hidden[k] * hidden[k]);
+      dUpdateGate[k] = dOut[k] * (hPrev - hidden[k]) * updateGate[k] *
+          (1 - updateGate[k]);
+      dPrevOut[k] = dOut[k] * updateGate[k];
+    }
+  }
+
+  // The error of the reset output, with one matrix product.
+  const MatType resetError = outputHidden2GateWeight.t() *
+      gateError.rows(2 * outSize, 3 * outSize - 1);
+
+  #pragma omp parallel for
+  for (size_t j = 0; j < batchSize; ++j)
+  {
+    const ElemType* resetGate = gateActivation.slice_colptr(step, j) +
+        outSize;
+    const ElemType* prevOut = hasEarlier ?
+        outParameter.slice_colptr(step - 1, j) : NULL;
+    const ElemType* dReset = resetError.colptr(j);
+
+    ElemType* dResetGate = gateError.colptr(j) + outSize;
+    ElemType* dPrevOut = outputError.colptr(j);
+
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      const ElemType hPrev = hasEarlier ? prevOut[k] : ElemType(0);
+      dResetGate[k] = dReset[k] * hPrev * resetGate[k] * (1 - resetGate[k]);
+      dPrevOut[k] += dReset[k] * resetGate[k];
+    }
+  }
+
+  // Finish the error of the earlier output with the contribution of the update
+  // and reset gates.
+  if (hasEarlier)
+    outputError += output2GateWeight.t() * gateError.rows(0, 2 * outSize - 1);
+
+  g = input2GateWeight.t() * gateError;
+}
+
+template<typename MatType>
+void GRUType<MatType>::Gradient(
+    const MatType& input,
+    const MatType& /* error */,
+    MatType& gradient)
+{
+  // This implementation depends on Gradient() being called just after
+  // Backward(), which is something we can safely assume.
+  const size_t step = this->CurrentStep();
+
+  // The gradient has the same layout as the weights.
+  MatType inputWeightGrad, biasGrad, outputWeightGrad, outputHiddenWeightGrad;
+  MakeAlias(inputWeightGrad, gradient.memptr(), 3 * outSize, inSize);
+  size_t offset = inputWeightGrad.n_elem;
+  MakeAlias(biasGrad, gradient.memptr() + offset, 3 * outSize, 1);
+  offset += biasGrad.n_elem;
+  MakeAlias(outputWeightGrad, gradient.memptr() + offset, 2 * outSize,
+      outSize);
+  offset += outputWeightGrad.n_elem;
+  MakeAlias(outputHiddenWeightGrad, gradient.memptr() + offset, outSize,
+      outSize);
+
+  inputWeightGrad = gateError * input.t();
+  biasGrad = sum(gateError, 1);
+
+  // The reset output of this step was stored by Forward(), and is zero if there
+  // was no previous output.
+  outputHiddenWeightGrad = gateError.rows(2 * outSize, 3 * outSize - 1) *
+      resetOutput.slice(step).t();
+
+  if (step > 0)
+  {
+    outputWeightGrad = gateError.rows(0, 2 * outSize - 1) *
+        outParameter.slice(step - 1).t();
+  }
+  else
+  {
+    outputWeightGrad.zeros();
+  }
+}
+
+template<typename MatType>
+template<typename Archive>
+void GRUType<MatType>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<RecurrentLayer<MatType>>(this));
+
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+
+  // Clear recurrent state if we are loading.
+  if (Archive::is_loading::value)
+  {
+    gateActivation.clear();
+    resetOutput.clear();
+    outParameter.clear();
+    gateError.clear();
+    outputError.clear();
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -48,8 +48,15 @@ namespace mlpack {
  * }
  * @endcode
  *
- * \see FastLSTM for a faster LSTM version which combines the calculation of the
- * input, forget, output gates and hidden state in a single step.
+ * The weights of the four gates are packed into single matrices, so that each
+ * step computes the inputs of all gates with one matrix product for the input
+ * and one for the previous output.  The gate activations, the cell update and
+ * the output are then computed in one pass over the gates, without any
+ * temporaries.  The packed layout of the parameters is: the input weights
+ * (4 * outSize x inSize), the biases (4 * outSize), the recurrent weights
+ * (4 * outSize x outSize) and the peephole weights (outSize x 3); the rows of
+ * the gate matrices are the output gate, forget gate, input gate and hidden
+ * layer, in that order.
  *
  * @tparam MatType Matrix representation to accept as input and use for
  *    computation.
@@ -133,6 +140,21 @@ class LSTMType : public RecurrentLayer<MatType>
    */
   void ClearRecurrentState(const size_t bpttSteps, const size_t batchSize);
 
+  //! Get the number of rows of the product of the input weights of all four
+  //! gates with the input, which the enclosing network can compute for all time
+  //! steps at once.
+  size_t InputProjectionSize() const { return 4 * outSize; }
+
+  /**
+   * Compute the product of the input weights of all four gates with the given
+   * input, which may hold the points of many time steps.
+   *
+   * @param input Input points, one per column.
+   * @param projection Matrix to store the product in (4 * outSize x
+   *     input.n_cols).
+   */
+  void ProjectInput(const MatType& input, MatType& projection);
+
   //! Get the parameters.
   const MatType& Parameters() const { return weights; }
   //! Modify the parameters.
@@ -172,102 +194,40 @@ class LSTMType : public RecurrentLayer<MatType>
   //! Locally-stored weight object.
   MatType weights;
 
-  //! Weights between the output and input gate.
-  MatType output2GateInputWeight;
-
-  //! Weights between the input and gate.
-  MatType input2GateInputWeight;
-
-  //! Bias between the input and input gate.
-  MatType input2GateInputBias;
-
-  //! Weights between the cell and input gate.
-  MatType cell2GateInputWeight;
-
-  //! Weights between the output and forget gate.
-  MatType output2GateForgetWeight;
-
-  //! Weights between the input and gate.
-  MatType input2GateForgetWeight;
-
-  //! Bias between the input and gate.
-  MatType input2GateForgetBias;
-
-  //! Bias between the input and gate.
-  MatType cell2GateForgetWeight;
-
-  //! Weights between the output and gate.
-  MatType output2GateOutputWeight;
-
-  //! Weights between the input and gate.
-  MatType input2GateOutputWeight;
-
-  //! Bias between the input and gate.
-  MatType input2GateOutputBias;
+  //! Weights between the input and the four gates (4 * outSize x inSize).
+  MatType input2GateWeight;
 
-  //! Weights between cell and output gate.
-  MatType cell2GateOutputWeight;
+  //! Bias of the four gates (4 * outSize x 1).
+  MatType input2GateBias;
 
-  // Below here are recurrent state matrices.
+  //! Weights between the previous output and the four gates
+  //! (4 * outSize x outSize).
+  MatType output2GateWeight;
 
-  //! Locally-stored input gate parameter.
-  MatType inputGate;
-
-  //! Locally-stored forget gate parameter.
-  MatType forgetGate;
-
-  //! Locally-stored hidden layer parameter.
-  MatType hiddenLayer;
-
-  //! Locally-stored output gate parameter.
-  MatType outputGate;
-
-  //! Locally-stored input to hidden weight.
-  MatType input2HiddenWeight;
-
-  //! Locally-stored input to hidden bias.
-  MatType input2HiddenBias;
-
-  //! Locally-stored output to hidden weight.
-  MatType output2HiddenWeight;
-
-  //! Locally-stored cell parameter.
-  arma::Cube<typename MatType::elem_type> cell;
+  //! Peephole weights between the cell and the output, forget and input gates
+  //! (outSize x 3, one column per gate).
+  MatType cell2GateWeight;
 
   // These members store recurrent state.
 
-  //! Locally-stored input gate activation.
-  arma::Cube<typename MatType::elem_type> inputGateActivation;
+  //! Locally-stored gate activations (4 * outSize x batchSize x bpttSteps),
+  //! with the rows of the output, forget and input gates and the hidden layer.
+  arma::Cube<typename MatType::elem_type> gateActivation;
 
-  //! Locally-stored forget gate activation.
-  arma::Cube<typename MatType::elem_type> forgetGateActivation;
-
-  //! Locally-stored output gate activation.
-  arma::Cube<typename MatType::elem_type> outputGateActivation;
-
-  //! Locally-stored hidden layer activation.
-  arma::Cube<typename MatType::elem_type> hiddenLayerActivation;
+  //! Locally-stored cell state.
+  arma::Cube<typename MatType::elem_type> cell;
 
-  //! Locally-stored cell activation error.
+  //! Locally-stored cell activation (tanh of the cell state).
   arma::Cube<typename MatType::elem_type> cellActivation;
 
-  //! Locally-stored forget gate error.
-  MatType forgetGateError;
-
-  //! Locally-stored output gate error.
-  MatType outputGateError;
-
   //! Locally-stored output parameters.
   arma::Cube<typename MatType::elem_type> outParameter;
 
-  //! Locally-stored input cell error parameter.
-  MatType inputCellError;
-
-  //! Locally-stored input gate error.
-  MatType inputGateError;
+  //! Locally-stored error of the gate inputs of the last backward step.
+  MatType gateError;
 
-  //! Locally-stored hidden layer error.
-  MatType hiddenError;
+  //! Locally-stored error of the cell state passed to the earlier step.
+  MatType cellError;
 }; // class LSTMType
 
 // Convenience typedefs.
@@ -277,6 +237,10 @@ typedef LSTMType<arma::mat> LSTM;
 
 } // namespace mlpack
 
+// Version 1 packed the weights of the four gates into single matrices.
+CEREAL_TEMPLATE_CLASS_VERSION((typename MatType), (mlpack::LSTMType<MatType>),
+    (1));
+
 // Include implementation.
 #include "lstm_impl.hpp"
 
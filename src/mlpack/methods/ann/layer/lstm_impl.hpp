@@ -35,14 +35,18 @@ LSTMType<MatType>::LSTMType(const size_t outSize) :
 
 template<typename MatType>
 LSTMType<MatType>::LSTMType(const LSTMType& layer) :
-    RecurrentLayer<MatType>(layer)
+    RecurrentLayer<MatType>(layer),
+    inSize(layer.inSize),
+    outSize(layer.outSize)
 {
   // Nothing to do here.
 }
 
 template<typename MatType>
 LSTMType<MatType>::LSTMType(LSTMType&& layer) :
-    RecurrentLayer<MatType>(std::move(layer))
+    RecurrentLayer<MatType>(std::move(layer)),
+    inSize(std::move(layer.inSize)),
+    outSize(std::move(layer.outSize))
 {
   // Nothing to do here.
 }
@@ -53,6 +57,8 @@ LSTMType<MatType>& LSTMType<MatType>::operator=(const LSTMType& layer)
   if (this != &layer)
   {
     RecurrentLayer<MatType>::operator=(layer);
+    inSize = layer.inSize;
+    outSize = layer.outSize;
   }
 
   return *this;
@@ -64,6 +70,8 @@ LSTMType<MatType>& LSTMType<MatType>::operator=(LSTMType&& layer)
   if (this != &layer)
   {
     RecurrentLayer<MatType>::operator=(std::move(layer));
+    inSize = std::move(layer.inSize);
+    outSize = std::move(layer.outSize);
   }
 
   return *this;
@@ -75,165 +83,100 @@ void LSTMType<MatType>::ClearRecurrentState(
 {
   // Make sure all of the different matrices we will use to hold parameters are
   // at least as large as we need.
-  inputGate.set_size(outSize, batchSize);
-  forgetGate.set_size(outSize, batchSize);
-  hiddenLayer.set_size(outSize, batchSize);
-  outputGate.set_size(outSize, batchSize);
-
-  inputGateActivation.set_size(outSize, batchSize, bpttSteps);
-  forgetGateActivation.set_size(outSize, batchSize, bpttSteps);
-  outputGateActivation.set_size(outSize, batchSize, bpttSteps);
-  hiddenLayerActivation.set_size(outSize, batchSize, bpttSteps);
-
+  gateActivation.set_size(4 * outSize, batchSize, bpttSteps);
   cellActivation.set_size(outSize, batchSize, bpttSteps);
-  outParameter.set_size(outSize, batchSize, bpttSteps);
 
   // Now reset recurrent values to 0.
   cell.zeros(outSize, batchSize, bpttSteps);
+  outParameter.zeros(outSize, batchSize, bpttSteps);
 }
 
 template<typename MatType>
 void LSTMType<MatType>::SetWeights(
     typename MatType::elem_type* weightsPtr)
 {
-  // Set the weight parameter for the output gate.
-  MakeAlias(input2GateOutputWeight, weightsPtr, outSize, inSize);
-  size_t offset = input2GateOutputWeight.n_elem;
-  MakeAlias(input2GateOutputBias, weightsPtr + offset, outSize, 1);
-  offset += input2GateOutputBias.n_elem;
-
-  // Set the weight parameter for the forget gate.
-  MakeAlias(input2GateForgetWeight, weightsPtr + offset, outSize, inSize);
-  offset += input2GateForgetWeight.n_elem;
-  MakeAlias(input2GateForgetBias, weightsPtr + offset, outSize, 1);
-  offset += input2GateForgetBias.n_elem;
-
-  // Set the weight parameter for the input gate.
-  MakeAlias(input2GateInputWeight, weightsPtr + offset, outSize, inSize);
-  offset += input2GateInputWeight.n_elem;
-  MakeAlias(input2GateInputBias, weightsPtr + offset, outSize, 1);
-  offset += input2GateInputBias.n_elem;
-
-  // Set the weight parameter for the hidden gate.
-  MakeAlias(input2HiddenWeight, weightsPtr + offset, outSize, inSize);
-  offset += input2HiddenWeight.n_elem;
-  MakeAlias(input2HiddenBias, weightsPtr + offset, outSize, 1);
-  offset += input2HiddenBias.n_elem;
-
-  // Set the weight parameter for the output multiplication.
-  MakeAlias(output2GateOutputWeight, weightsPtr + offset, outSize, outSize);
-  offset += output2GateOutputWeight.n_elem;
-
-  // Set the weight parameter for the output multiplication.
-  MakeAlias(output2GateForgetWeight, weightsPtr + offset, outSize, outSize);
-  offset += output2GateForgetWeight.n_elem;
-
-  // Set the weight parameter for the input multiplication.
-  MakeAlias(output2GateInputWeight, weightsPtr + offset, outSize, outSize);
-  offset += output2GateInputWeight.n_elem;
-
-  // Set the weight parameter for the hidden multiplication.
-  MakeAlias(output2HiddenWeight, weightsPtr + offset, outSize, outSize);
-  offset += output2HiddenWeight.n_elem;
-
-  // Set the weight parameter for the cell multiplication.
-  MakeAlias(cell2GateOutputWeight, weightsPtr + offset, outSize, 1);
-  offset += cell2GateOutputWeight.n_elem;
-
-  // Set the weight parameter for the cell - forget gate multiplication.
-  MakeAlias(cell2GateForgetWeight, weightsPtr + offset, outSize, 1);
-  offset += cell2GateOutputWeight.n_elem;
-
-  // Set the weight parameter for the cell - input gate multiplication.
-  MakeAlias(cell2GateInputWeight, weightsPtr + offset, outSize, 1);
+  MakeAlias(weights, weightsPtr, WeightSize(), 1);
+
+  // The weights of all four gates are stored together.
+  MakeAlias(input2GateWeight, weightsPtr, 4 * outSize, inSize);
+  size_t offset = input2GateWeight.n_elem;
+  MakeAlias(input2GateBias, weightsPtr + offset, 4 * outSize, 1);
+  offset += input2GateBias.n_elem;
+  MakeAlias(output2GateWeight, weightsPtr + offset, 4 * outSize, outSize);
+  offset += output2GateWeight.n_elem;
+  MakeAlias(cell2GateWeight, weightsPtr + offset, outSize, 3);
 }
 
-// Forward when cellState is not needed.
 template<typename MatType>
-void LSTMType<MatType>::Forward(const MatType& input, MatType& output)
+void LSTMType<MatType>::ProjectInput(const MatType& input, MatType& projection)
 {
-  // Convenience alias.
-  const size_t batchSize = input.n_cols;
-
-  inputGate = input2GateInputWeight * input;
-  if (this->HasPreviousStep())
-  {
-    inputGate +=
-        output2GateInputWeight * outParameter.slice(this->PreviousStep());
-  }
-  inputGate.each_col() += input2GateInputBias;
-
-  forgetGate = input2GateForgetWeight * input;
-  if (this->HasPreviousStep())
-  {
-    forgetGate += output2GateForgetWeight * outParameter.slice(
-        this->PreviousStep());
-  }
-  forgetGate.each_col() += input2GateForgetBias;
-
-  if (this->HasPreviousStep())
-  {
-    inputGate += repmat(cell2GateInputWeight, 1, batchSize) %
-        cell.slice(this->PreviousStep());
-
-    forgetGate += repmat(cell2GateForgetWeight, 1, batchSize) %
-        cell.slice(this->PreviousStep());
-  }
-
-  inputGateActivation.slice(this->CurrentStep()) =
-      1.0 / (1.0 + exp(-inputGate));
-  forgetGateActivation.slice(this->CurrentStep()) =
-      1.0 / (1.0 + exp(-forgetGate));
-
-  hiddenLayer = input2HiddenWeight * input;
-  if (this->HasPreviousStep())
-  {
-    hiddenLayer += output2HiddenWeight *
-        outParameter.slice(this->PreviousStep());
-  }
-  hiddenLayer.each_col() += input2HiddenBias;
+  projection = input2GateWeight * input;
+}
 
-  hiddenLayerActivation.slice(this->CurrentStep()) = arma::tanh(hiddenLayer);
+template<typename MatType>
+void LSTMType<MatType>::Forward(const MatType& input, MatType& output)
+{
+  typedef typename MatType::elem_type ElemType;
 
-  if (!this->HasPreviousStep())
-  {
-    cell.slice(this->CurrentStep()) =
-        inputGateActivation.slice(this->CurrentStep()) %
-        hiddenLayerActivation.slice(this->CurrentStep());
-  }
+  // Convenience aliases.
+  const size_t batchSize = input.n_cols;
+  const size_t step = this->CurrentStep();
+  const bool hasPrevious = this->HasPreviousStep();
+
+  // Compute the inputs of all four gates at once, directly in the memory that
+  // holds their activations.  The product with the input weights may already
+  // have been computed for all time steps by the enclosing network.
+  MatType gates;
+  MakeAlias(gates, gateActivation.slice_memptr(step), 4 * outSize, batchSize);
+  if (this->InputProjection() != NULL)
+    gates = *this->InputProjection();
   else
+    gates = input2GateWeight * input;
+  if (hasPrevious)
+    gates += output2GateWeight * outParameter.slice(this->PreviousStep());
+  gates.each_col() += input2GateBias;
+
+  // Now apply the activations and update the cell, one element at a time.
+  // Note that the previous step may be the same slice as the current step
+  // (when no history is kept), so each element of the previous cell is read
+  // before the element of the current cell is written.
+  const ElemType* outputPeephole = cell2GateWeight.colptr(0);
+  const ElemType* forgetPeephole = cell2GateWeight.colptr(1);
+  const ElemType* inputPeephole = cell2GateWeight.colptr(2);
+
+  #pragma omp parallel for
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    cell.slice(this->CurrentStep()) =
-        forgetGateActivation.slice(this->CurrentStep()) %
-        cell.slice(this->PreviousStep()) +
-        inputGateActivation.slice(this->CurrentStep()) %
-        hiddenLayerActivation.slice(this->CurrentStep());
-  }
-
-  outputGate = input2GateOutputWeight * input +
-      cell.slice(this->CurrentStep()).each_col() % cell2GateOutputWeight;
-  if (this->HasPreviousStep())
-  {
-    outputGate +=
-        output2GateOutputWeight * outParameter.slice(this->PreviousStep());
+    ElemType* outputGate = gates.colptr(j);
+    ElemType* forgetGate = outputGate + outSize;
+    ElemType* inputGate = outputGate + 2 * outSize;
+    ElemType* hidden = outputGate + 3 * outSize;
+    ElemType* c = cell.slice_colptr(step, j);
+    ElemType* cActivation = cellActivation.slice_colptr(step, j);
+    ElemType* out = outParameter.slice_colptr(step, j);
+    const ElemType* prevCell = hasPrevious ?
+        cell.slice_colptr(this->PreviousStep(), j) : NULL;
+
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      const ElemType cPrev = hasPrevious ? prevCell[k] : ElemType(0);
+      forgetGate[k] = 1 / (1 + std::exp(-(forgetGate[k] +
+          forgetPeephole[k] * cPrev)));
+      inputGate[k] = 1 / (1 + std::exp(-(inputGate[k] +
+          inputPeephole[k] * cPrev)));
+      hidden[k] = std::tanh(hidden[k]);
+
+      c[k] = forgetGate[k] * cPrev + inputGate[k] * hidden[k];
+      outputGate[k] = 1 / (1 + std::exp(-(outputGate[k] +
+          outputPeephole[k] * c[k])));
+      cActivation[k] = std::tanh(c[k]);
+      out[k] = outputGate[k] * cActivation[k];
+    }
   }
-  outputGate.each_col() += input2GateOutputBias;
-
-  outputGateActivation.slice(this->CurrentStep()) =
-      1.0 / (1.0 + exp(-outputGate));
-
-  cellActivation.slice(this->CurrentStep()) =
-      arma::tanh(cell.slice(this->CurrentStep()));
 
-  // There's a bit of an issue here: we need to preserve the output for the next
-  // time step, but we also need to set `output` to that.  Unfortunately for now
-  // we make a copy, but it's possible that we could instead use an alias here,
-  // or have `outParameter` hold a collection of aliases.
-  outParameter.slice(this->CurrentStep()) =
-      cellActivation.slice(this->CurrentStep()) %
-      outputGateActivation.slice(this->CurrentStep());
-
-  output = outParameter.slice(this->CurrentStep());
+  // We need to preserve the output for the next time step, but we also need to
+  // set `output` to that, so we make a copy.
+  output = outParameter.slice(step);
 }
 
 template<typename MatType>
@@ -243,62 +186,75 @@ void LSTMType<MatType>::Backward(
     const MatType& gy,
     MatType& g)
 {
-  MatType gyLocal;
-  if (this->HasPreviousStep())
-  {
-    gyLocal = gy + output2GateOutputWeight.t() * outputGateError +
-      output2GateForgetWeight.t() * forgetGateError +
-      output2GateInputWeight.t() * inputGateError +
-      output2HiddenWeight.t() * hiddenError;
-  }
+  typedef typename MatType::elem_type ElemType;
+
+  // Convenience aliases.  During the backward pass, the "previous" step is the
+  // step after the current one in time, whose errors flow back into this step.
+  // The step before this one in time is held in the previous slice; the
+  // enclosing network keeps the state before the first step of BPTT (or the
+  // zero state) in slice 0.
+  const size_t batchSize = gy.n_cols;
+  const size_t step = this->CurrentStep();
+  const bool hasNext = this->HasPreviousStep();
+  const bool hasEarlier = (step > 0);
+
+  // The error of the output is the given error plus the error of the next
+  // step's gates, with one matrix product for all four gates.
+  MatType outputError;
+  if (hasNext)
+    outputError = gy + output2GateWeight.t() * gateError;
   else
-  {
-    // Make an alias.
-    gyLocal = MatType(((MatType&) gy).memptr(), gy.n_rows, gy.n_cols,
-        false, false);
-  }
-
-  outputGateError = gyLocal % cellActivation.slice(this->CurrentStep()) %
-      (outputGateActivation.slice(this->CurrentStep()) %
-      (1.0 - outputGateActivation.slice(this->CurrentStep())));
+    MakeAlias(outputError, (ElemType*) gy.memptr(), gy.n_rows, gy.n_cols);
 
-  MatType cellError = gyLocal %
-      outputGateActivation.slice(this->CurrentStep()) %
-      (1 - pow(cellActivation.slice(this->CurrentStep()), 2)) +
-      outputGateError.each_col() % cell2GateOutputWeight;
+  if (!hasNext)
+    cellError.zeros(outSize, batchSize);
+  gateError.set_size(4 * outSize, batchSize);
 
-  if (this->HasPreviousStep())
-  {
-    cellError += inputCellError;
-  }
+  const ElemType* outputPeephole = cell2GateWeight.colptr(0);
+  const ElemType* forgetPeephole = cell2GateWeight.colptr(1);
+  const ElemType* inputPeephole = cell2GateWeight.colptr(2);
 
-  if (this->HasPreviousStep())
-  {
-    forgetGateError = cell.slice(this->PreviousStep()) % cellError %
-        (forgetGateActivation.slice(this->CurrentStep()) %
-        (1.0 - forgetGateActivation.slice(this->CurrentStep())));
-  }
-  else
+  #pragma omp parallel for
+  for (size_t j = 0; j < batchSize; ++j)
   {
-    forgetGateError.zeros(forgetGateActivation.n_rows,
-        forgetGateActivation.n_cols);
+    const ElemType* gates = gateActivation.slice_colptr(step, j);
+    const ElemType* outputGate = gates;
+    const ElemType* forgetGate = gates + outSize;
+    const ElemType* inputGate = gates + 2 * outSize;
+    const ElemType* hidden = gates + 3 * outSize;
+    const ElemType* cActivation = cellActivation.slice_colptr(step, j);
+    const ElemType* prevCell = hasEarlier ?
+        cell.slice_colptr(step - 1, j) : NULL;
+    const ElemType* dOut = outputError.colptr(j);
+
+    ElemType* dOutputGate = gateError.colptr(j);
+    ElemType* dForgetGate = dOutputGate + outSize;
+    ElemType* dInputGate = dOutputGate + 2 * outSize;
+    ElemType* dHidden = dOutputGate + 3 * outSize;
+    ElemType* dCell = cellError.colptr(j);
+
+    for (size_t k = 0; k < outSize; ++k)
+    {
+      dOutputGate[k] = dOut[k] * cActivation[k] * outputGate[k] *
+          (1 - outputGate[k]);
+
+      // dCell[k] holds the error passed back from the next step.
+      const ElemType dc = dOut[k] * outputGate[k] *
+          (1 - cActivation[k] * cActivation[k]) +
+          dOutputGate[k] * outputPeephole[k] + dCell[k];
+
+      dForgetGate[k] = hasEarlier ? dc * prevCell[k] * forgetGate[k] *
+          (1 - forgetGate[k]) : ElemType(0);
+      dInputGate[k] = dc * hidden[k] * inputGate[k] * (1 - inputGate[k]);
+      dHidden[k] = dc * inputGate[k] * (1 - hidden[k] * hidden[k]);
+
+      // Now compute the error passed to the cell of the earlier step.
+      dCell[k] = dc * forgetGate[k] + dForgetGate[k] * forgetPeephole[k] +
+          dInputGate[k] * inputPeephole[k];
+    }
   }
 
-  inputGateError = hiddenLayerActivation.slice(this->CurrentStep()) %
-      cellError % (inputGateActivation.slice(this->CurrentStep()) %
-      (1.0 - inputGateActivation.slice(this->CurrentStep())));
-
-  hiddenError = inputGateActivation.slice(this->CurrentStep()) % cellError %
-      (1 - pow(hiddenLayerActivation.slice(this->CurrentStep()), 2));
-
-  inputCellError = forgetGateActivation.slice(this->CurrentStep()) % cellError +
-      forgetGateError.each_col() % cell2GateForgetWeight +
-      inputGateError.each_col() % cell2GateInputWeight;
-
-  g = input2GateInputWeight.t() * inputGateError +
-      input2HiddenWeight.t() * hiddenError +
-      input2GateForgetWeight.t() * forgetGateError +
-      input2GateOutputWeight.t() * outputGateError;
+  g = input2GateWeight.t() * gateError;
 }
 
 template<typename MatType>
@@ -309,87 +265,53 @@ void LSTMType<MatType>::Gradient(
 {
   // This implementation depends on Gradient() being called just after
   // Backward(), which is something we can safely assume.
-
-  // Input2GateOutputWeight and input2GateOutputBias gradients.
-  gradient.submat(0, 0, input2GateOutputWeight.n_elem - 1, 0) =
-      vectorise(outputGateError * input.t());
-  gradient.submat(input2GateOutputWeight.n_elem, 0,
-      input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem - 1, 0) =
-      sum(outputGateError, 1);
-  size_t offset = input2GateOutputWeight.n_elem + input2GateOutputBias.n_elem;
-
-  // input2GateForgetWeight and input2GateForgetBias gradients.
-  gradient.submat(offset, 0, offset + input2GateForgetWeight.n_elem - 1, 0) =
-      vectorise(forgetGateError * input.t());
-  gradient.submat(offset + input2GateForgetWeight.n_elem, 0,
-      offset + input2GateForgetWeight.n_elem +
-      input2GateForgetBias.n_elem - 1, 0) = sum(forgetGateError, 1);
-  offset += input2GateForgetWeight.n_elem + input2GateForgetBias.n_elem;
-
-  // input2GateInputWeight and input2GateInputBias gradients.
-  gradient.submat(offset, 0, offset + input2GateInputWeight.n_elem - 1, 0) =
-      vectorise(inputGateError * input.t());
-  gradient.submat(offset + input2GateInputWeight.n_elem, 0,
-      offset + input2GateInputWeight.n_elem +
-      input2GateInputBias.n_elem - 1, 0) = sum(inputGateError, 1);
-  offset += input2GateInputWeight.n_elem + input2GateInputBias.n_elem;
-
-  // input2HiddenWeight and input2HiddenBias gradients.
-  gradient.submat(offset, 0, offset + input2HiddenWeight.n_elem - 1, 0) =
-      vectorise(hiddenError * input.t());
-  gradient.submat(offset + input2HiddenWeight.n_elem, 0,
-      offset + input2HiddenWeight.n_elem + input2HiddenBias.n_elem - 1, 0) =
-      sum(hiddenError, 1);
-  offset += input2HiddenWeight.n_elem + input2HiddenBias.n_elem;
-
-  // output2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateOutputWeight.n_elem - 1, 0) =
-      vectorise(outputGateError * outParameter.slice(this->CurrentStep()).t());
-  offset += output2GateOutputWeight.n_elem;
-
-  // output2GateForgetWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateForgetWeight.n_elem - 1, 0) =
-      vectorise(forgetGateError * outParameter.slice(this->CurrentStep()).t());
-  offset += output2GateForgetWeight.n_elem;
-
-  // output2GateInputWeight gradients.
-  gradient.submat(offset, 0, offset + output2GateInputWeight.n_elem - 1, 0) =
-      vectorise(inputGateError * outParameter.slice(this->CurrentStep()).t());
-  offset += output2GateInputWeight.n_elem;
-
-  // output2HiddenWeight gradients.
-  gradient.submat(offset, 0, offset + output2HiddenWeight.n_elem - 1, 0) =
-      vectorise(hiddenError * outParameter.slice(this->CurrentStep()).t());
-  offset += output2HiddenWeight.n_elem;
-
-  // cell2GateOutputWeight gradients.
-  gradient.submat(offset, 0, offset + cell2GateOutputWeight.n_elem - 1, 0) =
-      sum(outputGateError % cell.slice(this->CurrentStep()), 1);
-  offset += cell2GateOutputWeight.n_elem;
-
-  // cell2GateForgetWeight and cell2GateInputWeight gradients.
-  if (this->HasPreviousStep())
+  const size_t step = this->CurrentStep();
+  const bool hasEarlier = (step > 0);
+
+  // The gradient has the same layout as the weights.
+  MatType inputWeightGrad, biasGrad, outputWeightGrad, peepholeGrad;
+  MakeAlias(inputWeightGrad, gradient.memptr(), 4 * outSize, inSize);
+  size_t offset = inputWeightGrad.n_elem;
+  MakeAlias(biasGrad, gradient.memptr() + offset, 4 * outSize, 1);
+  offset += biasGrad.n_elem;
+  MakeAlias(outputWeightGrad, gradient.memptr() + offset, 4 * outSize,
+      outSize);
+  offset += outputWeightGrad.n_elem;
+  MakeAlias(peepholeGrad, gradient.memptr() + offset, outSize, 3);
+
+  inputWeightGrad = gateError * input.t();
+  biasGrad = sum(gateError, 1);
+
+  peepholeGrad.col(0) = sum(gateError.rows(0, outSize - 1) %
+      cell.slice(step), 1);
+  if (hasEarlier)
   {
-    gradient.submat(offset, 0, offset + cell2GateForgetWeight.n_elem - 1, 0) =
-        sum(forgetGateError % cell.slice(this->PreviousStep()), 1);
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem + cell2GateInputWeight.n_elem - 1, 0) =
-        sum(inputGateError % cell.slice(this->PreviousStep()), 1);
+    outputWeightGrad = gateError * outParameter.slice(step - 1).t();
+    peepholeGrad.col(1) = sum(gateError.rows(outSize, 2 * outSize - 1) %
+        cell.slice(step - 1), 1);
+    peepholeGrad.col(2) = sum(gateError.rows(2 * outSize, 3 * outSize - 1) %
+        cell.slice(step - 1), 1);
   }
   else
   {
-    gradient.submat(offset, 0, offset +
-        cell2GateForgetWeight.n_elem - 1, 0).zeros();
-    gradient.submat(offset + cell2GateForgetWeight.n_elem, 0, offset +
-        cell2GateForgetWeight.n_elem +
-        cell2GateInputWeight.n_elem - 1, 0).zeros();
+    outputWeightGrad.zeros();
+    peepholeGrad.cols(1, 2).zeros();
   }
 }
 
 template<typename MatType>
 template<typename Archive>
-void LSTMType<MatType>::serialize(Archive& ar, const uint32_t /* version */)
+void LSTMType<MatType>::serialize(Archive& ar, const uint32_t version)
 {
+  // The weights of the network are stored by the network itself, so the old
+  // layout of the weights of the gates cannot be converted here.
+  if (Archive::is_loading::value && version == 0)
+  {
+    throw std::runtime_error("LSTM::serialize(): cannot load an LSTM layer "
+        "saved by an older version of mlpack, since the layout of its weights "
+        "has changed; the model must be retrained.");
+  }
+
   ar(cereal::base_class<RecurrentLayer<MatType>>(this));
 
   ar(CEREAL_NVP(inSize));
@@ -398,17 +320,12 @@ void LSTMType<MatType>::serialize(Archive& ar, const uint32_t /* version */)
   // Clear recurrent state if we are loading.
   if (Archive::is_loading::value)
   {
-    inputGateActivation.clear();
-    forgetGateActivation.clear();
-    outputGateActivation.clear();
-    hiddenLayerActivation.clear();
+    gateActivation.clear();
+    cell.clear();
     cellActivation.clear();
-    forgetGateError.clear();
-    outputGateError.clear();
     outParameter.clear();
-    inputCellError.clear();
-    inputGateError.clear();
-    hiddenError.clear();
+    gateError.clear();
+    cellError.clear();
   }
 }
 
@@ -14,6 +14,7 @@
 
 #include "../make_alias.hpp"
 #include "layer.hpp"
+#include "recurrent_layer.hpp"
 
 namespace mlpack {
 
@@ -63,6 +64,14 @@ class MultiLayer : public Layer<MatType>
    * have the correct size (e.g. number of rows equal to `OutputSize()` of the
    * last held layer; number of columns equal to `input.n_cols`).
    *
+   * In inference mode (when `Training()` is false), the outputs of
+   * intermediate layers are not all kept: since each output is only needed as
+   * the input of the next layer, intermediate layers alternate between two
+   * buffers, each the size of the largest intermediate output (unless a held
+   * layer, or a layer nested in a held MultiLayer, is a `RecurrentLayer`).
+   * If `Backward()` or `Gradient()` is called after such a pass, the
+   * intermediate outputs are recomputed first.
+   *
    * @param input Input data to pass through the MultiLayer.
    * @param output Matrix to store output in.
    */
@@ -195,6 +204,13 @@ class MultiLayer : public Layer<MatType>
   //! careful!
   std::vector<Layer<MatType>*>& Network() { return network; }
 
+  /**
+   * Get every `RecurrentLayer` held by this MultiLayer, including the ones held
+   * by nested MultiLayers (such as `AddMerge` or `Concat` layers), in the
+   * order of the network.
+   */
+  std::vector<RecurrentLayer<MatType>*> RecurrentLayers() const;
+
   //! Serialize the MultiLayer.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
@@ -209,6 +225,33 @@ class MultiLayer : public Layer<MatType>
    */
   void InitializeForwardPassMemory(const size_t batchSize);
 
+  /**
+   * Initialize memory that will be used by layers `start` to `end - 1` for an
+   * inference-mode forward pass, assuming that the input will have the given
+   * `batchSize`.  The output of layer `i` is only used as the input of layer
+   * `i + 1`, so the aliases in `layerOutputs` alternate between two regions of
+   * `layerOutputMatrix`, each large enough to hold the largest of those
+   * outputs.  `layerOutputMatrix` is never shrunk here, so that switching
+   * between training and inference does not cause reallocations.
+   *
+   * If alternating between two regions would not use less memory than storing
+   * every output, or if any layer (or layer nested in a held MultiLayer) is a
+   * `RecurrentLayer`, whose forward pass cannot be repeated without changing
+   * its state, then
+   * `InitializeForwardPassMemory()` is used instead.  Returns true if the
+   * regions are shared between layers.
+   */
+  bool InitializeInferencePassMemory(const size_t batchSize,
+                                     const size_t start,
+                                     const size_t end);
+
+  /**
+   * Recompute and store the output of every layer except the last, for the
+   * given input.  This is needed before `Backward()` or `Gradient()` if the
+   * last forward pass shared output memory between layers.
+   */
+  void RecomputeLayerOutputs(const MatType& input);
+
   /**
    * Initialize memory that will be used by each layer for the backwards pass,
    * assuming that the input will have the given `batchSize`.  When `Backward()`
@@ -241,6 +284,9 @@ class MultiLayer : public Layer<MatType>
   MatType layerOutputMatrix;
   //! These are aliases of `layerOutputMatrix` for each layer.
   std::vector<MatType> layerOutputs;
+  //! If true, the last forward pass shared memory between the outputs in
+  //! `layerOutputs`, so they do not hold the output of every layer.
+  bool sharedOutputMemory;
 
   //! This matrix stores all of the backwards pass results of each layer when
   //! Backward() is called.  See `InitializeBackwardPassMemory()`.
@@ -22,7 +22,8 @@ MultiLayer<MatType>::MultiLayer() :
     Layer<MatType>(),
     inSize(0),
     totalInputSize(0),
-    totalOutputSize(0)
+    totalOutputSize(0),
+    sharedOutputMemory(false)
 {
   // Nothing to do.
 }
@@ -34,6 +35,7 @@ MultiLayer<MatType>::MultiLayer(const MultiLayer& other) :
     totalInputSize(other.totalInputSize),
     totalOutputSize(other.totalOutputSize),
     layerOutputMatrix(other.layerOutputMatrix),
+    sharedOutputMemory(false),
     layerDeltaMatrix(other.layerDeltaMatrix)
 {
   // Copy each layer.
@@ -57,6 +59,7 @@ MultiLayer<MatType>::MultiLayer(MultiLayer&& other) :
     totalInputSize(std::move(other.totalInputSize)),
     totalOutputSize(std::move(other.totalOutputSize)),
     layerOutputMatrix(std::move(other.layerOutputMatrix)),
+    sharedOutputMemory(false),
     layerDeltaMatrix(std::move(other.layerDeltaMatrix))
 {
   // Ensure that the aliases for layers during passes have the right size.
@@ -90,6 +93,7 @@ MultiLayer<MatType>& MultiLayer<MatType>::operator=(const MultiLayer& other)
 
     layerOutputMatrix = other.layerOutputMatrix;
     layerDeltaMatrix = other.layerDeltaMatrix;
+    sharedOutputMemory = false;
 
     for (size_t i = 0; i < other.network.size(); ++i)
       network.push_back(other.network[i]->Clone());
@@ -117,6 +121,7 @@ MultiLayer<MatType>& MultiLayer<MatType>::operator=(MultiLayer&& other)
     inSize = std::move(other.inSize);
     totalInputSize = std::move(other.totalInputSize);
     totalOutputSize = std::move(other.totalOutputSize);
+    sharedOutputMemory = false;
 
     network = std::move(other.network);
 
@@ -154,8 +159,19 @@ void MultiLayer<MatType>::Forward(
   // intermediate values between layers.
   if ((end - start) > 0)
   {
-    // Initialize memory for the forward pass (if needed).
-    InitializeForwardPassMemory(input.n_cols);
+    // Initialize memory for the forward pass (if needed).  In inference mode,
+    // no backward pass needs the intermediate outputs, so they can share
+    // memory.
+    if (this->training)
+    {
+      InitializeForwardPassMemory(input.n_cols);
+      sharedOutputMemory = false;
+    }
+    else
+    {
+      sharedOutputMemory = InitializeInferencePassMemory(input.n_cols, start,
+          end);
+    }
 
     network[start]->Forward(input, layerOutputs[start]);
     for (size_t i = start + 1; i < end; ++i)
@@ -182,6 +198,11 @@ void MultiLayer<MatType>::Backward(
 {
   if (network.size() > 1)
   {
+    // The intermediate outputs are needed; recompute them if the forward pass
+    // did not keep them.
+    if (sharedOutputMemory)
+      RecomputeLayerOutputs(input);
+
     // Initialize memory for the backward pass (if needed).
     InitializeBackwardPassMemory(input.n_cols);
 
@@ -212,6 +233,9 @@ void MultiLayer<MatType>::Gradient(
   // Pass gradients through each layer.
   if (network.size() > 1)
   {
+    if (sharedOutputMemory)
+      RecomputeLayerOutputs(input);
+
     // Initialize memory for the gradient pass (if needed).
     InitializeGradientPassMemory(gradient);
 
@@ -361,6 +385,7 @@ void MultiLayer<MatType>::serialize(
     layerOutputMatrix.clear();
     layerDeltaMatrix.clear();
     layerGradients.clear();
+    sharedOutputMemory = false;
     layerOutputs.resize(network.size(), MatType());
     layerDeltas.resize(network.size(), MatType());
     layerGradients.resize(network.size(), MatType());
@@ -394,6 +419,92 @@ void MultiLayer<MatType>::InitializeForwardPassMemory(const size_t batchSize)
   }
 }
 
+template<typename MatType>
+std::vector<RecurrentLayer<MatType>*>
+MultiLayer<MatType>::RecurrentLayers() const
+{
+  std::vector<RecurrentLayer<MatType>*> recurrentLayers;
+  for (size_t i = 0; i < network.size(); ++i)
+  {
+    RecurrentLayer<MatType>* r =
+        dynamic_cast<RecurrentLayer<MatType>*>(network[i]);
+    if (r != nullptr)
+    {
+      recurrentLayers.push_back(r);
+      continue;
+    }
+
+    // Layers like AddMerge and Concat hold their own networks.
+    const MultiLayer<MatType>* m =
+        dynamic_cast<const MultiLayer<MatType>*>(network[i]);
+    if (m != nullptr)
+    {
+      const std::vector<RecurrentLayer<MatType>*> nested = m->RecurrentLayers();
+      recurrentLayers.insert(recurrentLayers.end(), nested.begin(),
+          nested.end());
+    }
+  }
+
+  return recurrentLayers;
+}
+
+template<typename MatType>
+bool MultiLayer<MatType>::InitializeInferencePassMemory(
+    const size_t batchSize,
+    const size_t start,
+    const size_t end)
+{
+  // Only the outputs of layers `start` to `end - 1` are stored; the last layer
+  // writes into the output given to Forward().
+  size_t maxLayerOutputSize = 0;
+  size_t sumLayerOutputSize = 0;
+  for (size_t i = start; i < end; ++i)
+  {
+    maxLayerOutputSize = std::max(maxLayerOutputSize,
+        network[i]->OutputSize());
+    sumLayerOutputSize += network[i]->OutputSize();
+  }
+
+  // Recurrent layers may also be nested inside other layers.
+  const bool recurrent = !RecurrentLayers().empty();
+
+  // The input and output of a layer must not overlap, so two regions are
+  // needed, unless there is only one intermediate output.
+  const size_t regions = (end - start > 1) ? 2 : 1;
+  if (recurrent || regions * maxLayerOutputSize >= sumLayerOutputSize)
+  {
+    InitializeForwardPassMemory(batchSize);
+    return false;
+  }
+
+  if (batchSize * regions * maxLayerOutputSize > layerOutputMatrix.n_elem)
+    layerOutputMatrix = MatType(1, batchSize * regions * maxLayerOutputSize);
+
+  // Layer `start` writes into the first region, layer `start + 1` into the
+  // second, layer `start + 2` into the first again, and so on.
+  for (size_t i = start; i < end; ++i)
+  {
+    const size_t regionStart = ((i - start) % 2) * batchSize *
+        maxLayerOutputSize;
+    MakeAlias(layerOutputs[i], layerOutputMatrix.colptr(regionStart),
+        network[i]->OutputSize(), batchSize);
+  }
+
+  return true;
+}
+
+template<typename MatType>
+void MultiLayer<MatType>::RecomputeLayerOutputs(const MatType& input)
+{
+  InitializeForwardPassMemory(input.n_cols);
+
+  network[0]->Forward(input, layerOutputs[0]);
+  for (size_t i = 1; i < network.size() - 1; ++i)
+    network[i]->Forward(layerOutputs[i - 1], layerOutputs[i]);
+
+  sharedOutputMemory = false;
+}
+
 template<typename MatType>
 void MultiLayer<MatType>::InitializeBackwardPassMemory(
     const size_t batchSize)
@@ -58,6 +58,16 @@ namespace mlpack {
  * [embedDim * (2 * srcSeqLen + tgtSeqLen), batchSize].  The
  * output data will always be of size (embedDim * tgtSeqLen, batchSize)
  *
+ * By default, the attention scores of all heads are computed and stored as one
+ * cube of size (tgtSeqLen, srcSeqLen, numHeads * batchSize), which takes memory
+ * quadratic in the sequence length.  If a nonzero `blockSize` is given, the
+ * scores are instead computed for blocks of `blockSize` source positions at a
+ * time, and are never stored: the forward pass only keeps the projected
+ * query, key and value, and the backward pass and gradient computation
+ * recompute the scores of each block.  This takes memory linear in the
+ * sequence length (plus tgtSeqLen * blockSize per thread), so it is preferable
+ * for long sequences; the results are the same.
+ *
  * @tparam MatType Type of the input/output data (arma::colvec, arma::mat,
  *         arma::sp_mat or arma::cube).
  * @tparam RegularizerType Type of the regularizer to be used.
@@ -85,12 +95,16 @@ class MultiheadAttentionType : public Layer<MatType>
    * @param keyPaddingMask Key Padding Mask.  Takes the values [-Inf, 0]
    * @param selfAttention Use self-attention; source key, query, and value all
    *     come from the same inputs
+   * @param blockSize Number of source positions to compute the attention scores
+   *     of at a time; if 0, the scores of the whole sequence are computed and
+   *     stored at once.
    */
   MultiheadAttentionType(const size_t tgtSeqLen,
                          const size_t numHeads,
                          const MatType& attnMask = MatType(),
                          const MatType& keyPaddingMask = MatType(),
-                         const bool selfAttention = false);
+                         const bool selfAttention = false,
+                         const size_t blockSize = 0);
 
   //! Clone the MultiheadAttentionType object. This handles polymorphism
   //! correctly.
@@ -146,7 +160,7 @@ class MultiheadAttentionType : public Layer<MatType>
    * Serialize the layer.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
   //! Get the parameters.
   MatType const& Parameters() const override { return weights; }
@@ -190,6 +204,13 @@ class MultiheadAttentionType : public Layer<MatType>
   //! all come from the same input).
   bool& SelfAttention() { return selfAttention; }
 
+  //! Get the number of source positions the attention scores are computed for
+  //! at a time (0 if all scores are stored at once).
+  size_t BlockSize() const { return blockSize; }
+  //! Modify the number of source positions the attention scores are computed
+  //! for at a time (0 to store all scores at once).
+  size_t& BlockSize() { return blockSize; }
+
   void ComputeOutputDimensions() override
   {
     if (this->inputDimensions.size() < 2)
@@ -267,6 +288,45 @@ class MultiheadAttentionType : public Layer<MatType>
   //! Element Type of the output.
   typedef typename MatType::elem_type ElemType;
 
+  /**
+   * Compute the masked attention scores of the given head (slice of `qProj`)
+   * for the source positions `begin` to `end` (inclusive), using the projected
+   * query and key of the last forward pass.
+   *
+   * @param slice Index of the head (in `[0, numHeads * batchSize)`).
+   * @param begin First source position.
+   * @param end Last source position.
+   * @param block Matrix to store the scores in (tgtSeqLen x end - begin + 1).
+   */
+  void ScoreBlock(const size_t slice,
+                  const size_t begin,
+                  const size_t end,
+                  MatType& block) const;
+
+  /**
+   * Compute `attnOut` from the projected query, key and value one block of
+   * source positions at a time, without storing the scores.
+   */
+  void BlockedForward();
+
+  /**
+   * Compute the error of the projected query, key and value of each head from
+   * the error of the attention output.  If `blockSize` is not 0, the scores
+   * are recomputed one block of source positions at a time.  The error of the
+   * query is returned without the scaling by 1 / sqrt(headDim).
+   *
+   * @param gy Error of the attention output
+   *     (tgtSeqLen, headDim, numHeads * batchSize).
+   * @param dq Error of the projected query (same shape as `gy`).
+   * @param dk Error of the projected key
+   *     (srcSeqLen, headDim, numHeads * batchSize).
+   * @param dv Error of the projected value (same shape as `dk`).
+   */
+  void AttentionBackward(const arma::Cube<ElemType>& gy,
+                         arma::Cube<ElemType>& dq,
+                         arma::Cube<ElemType>& dk,
+                         arma::Cube<ElemType>& dv);
+
   //! Target sequence length.
   size_t tgtSeqLen;
 
@@ -293,6 +353,10 @@ class MultiheadAttentionType : public Layer<MatType>
   //! come from the same input).
   bool selfAttention;
 
+  //! Number of source positions the attention scores are computed for at a
+  //! time (0 if all scores are stored at once).
+  size_t blockSize;
+
   //! Locally-stored weight matrix associated with query.
   MatType queryWt;
 
@@ -329,7 +393,7 @@ class MultiheadAttentionType : public Layer<MatType>
   //! Locally-stored projected value matrix over linear layer.
   arma::Cube<ElemType> vProj;
 
-  //! Locally-stored result of output of dropout layer.
+  //! Locally-stored attention probabilities (only if blockSize is 0).
   arma::Cube<ElemType> scores;
 
   //! Locally-stored attention output weight to be fed to last linear layer.
@@ -347,6 +411,10 @@ typedef MultiheadAttentionType<arma::mat, NoRegularizer> MultiheadAttention;
 
 } // namespace mlpack
 
+// Version 1 added the block size.
+CEREAL_TEMPLATE_CLASS_VERSION((typename MatType, typename RegularizerType),
+    (mlpack::MultiheadAttentionType<MatType, RegularizerType>), (1));
+
 // Include implementation.
 #include "multihead_attention_impl.hpp"
 
@@ -0,0 +1,190 @@
+/**
+ * @file methods/ann/layer/quantized_convolution.hpp
+ *
+ * Definition of the QuantizedConvolution layer, an inference-only version of
+ * the Convolution layer with int8 weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/quantization.hpp>
+#include <mlpack/methods/ann/convolution_rules/im2col_convolution.hpp>
+
+#include "layer.hpp"
+#include "convolution.hpp"
+#include "padding.hpp"
+
+namespace mlpack {
+
+/**
+ * The QuantizedConvolution layer computes the same two-dimensional convolution
+ * as a trained Convolution layer, but with the filters stored as int8 values.
+ * The filters of each output map have their own scale.
+ *
+ * In the forward pass the (padded) input is quantized to int8 with a fixed
+ * scale that was chosen during calibration (see `QuantizeFFN()`), and lowered
+ * to patches in the same way as `Im2ColConvolution`, so that the convolution
+ * becomes one int8 x int8 -> int32 matrix product per block of images.  Each
+ * sum is converted back to a floating-point value as
+ * sum * inputScale * scale(map) + bias(map).
+ *
+ * This layer has no trainable parameters, and can only be used for inference:
+ * calling `Backward()` throws an exception.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class QuantizedConvolutionType : public Layer<MatType>
+{
+ public:
+  typedef typename MatType::elem_type ElemType;
+  typedef typename GetCubeType<MatType>::type CubeType;
+
+  //! Create an empty QuantizedConvolution object (for serialization).
+  QuantizedConvolutionType();
+
+  /**
+   * Create the QuantizedConvolution layer by quantizing the filters of the
+   * given trained Convolution layer.  The layer must have been used already
+   * (so that its weights and its padding are set).
+   *
+   * @param layer Layer to quantize.
+   * @param inputScale Scale to quantize the input of the layer with; inputs are
+   *     stored as round(x / inputScale).
+   */
+  template<typename ForwardConvolutionRule,
+           typename BackwardConvolutionRule,
+           typename GradientConvolutionRule>
+  QuantizedConvolutionType(const ConvolutionType<ForwardConvolutionRule,
+                                                 BackwardConvolutionRule,
+                                                 GradientConvolutionRule,
+                                                 MatType>& layer,
+                           const ElemType inputScale);
+
+  virtual ~QuantizedConvolutionType() { }
+
+  //! Clone the QuantizedConvolutionType object. This handles polymorphism
+  //! correctly.
+  QuantizedConvolutionType* Clone() const
+  {
+    return new QuantizedConvolutionType(*this);
+  }
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * The backward pass is not available for quantized layers; this throws a
+   * std::logic_error.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& /* gy */,
+                MatType& /* g */);
+
+  //! Get the number of output maps.
+  size_t Maps() const { return maps; }
+  //! Get the kernel width.
+  size_t KernelWidth() const { return kernelWidth; }
+  //! Get the kernel height.
+  size_t KernelHeight() const { return kernelHeight; }
+  //! Get the stride width.
+  size_t StrideWidth() const { return strideWidth; }
+  //! Get the stride height.
+  size_t StrideHeight() const { return strideHeight; }
+
+  //! Get the quantized filters; each column of the (filter size x maps) matrix
+  //! holds the filters of one output map.
+  const std::vector<int8_t>& QuantizedWeight() const { return weight; }
+  //! Get the scale of the filters of each output map.
+  const MatType& WeightScales() const { return weightScales; }
+  //! Get the bias (empty if the layer has no bias).
+  const MatType& Bias() const { return bias; }
+
+  //! Get the scale used to quantize the input.
+  ElemType InputScale() const { return inputScale; }
+  //! Modify the scale used to quantize the input.
+  ElemType& InputScale() { return inputScale; }
+
+  //! Compute the output dimensions of the layer based on `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Locally-stored number of output maps.
+  size_t maps;
+
+  //! Locally-stored number of input maps.
+  size_t inMaps;
+
+  //! Locally-stored filter width.
+  size_t kernelWidth;
+
+  //! Locally-stored filter height.
+  size_t kernelHeight;
+
+  //! Locally-stored stride of the filter in x-direction.
+  size_t strideWidth;
+
+  //! Locally-stored stride of the filter in y-direction.
+  size_t strideHeight;
+
+  //! Locally-stored left-side padding width.
+  size_t padWLeft;
+
+  //! Locally-stored right-side padding width.
+  size_t padWRight;
+
+  //! Locally-stored bottom padding height.
+  size_t padHBottom;
+
+  //! Locally-stored top padding height.
+  size_t padHTop;
+
+  //! Quantized filters (kernelWidth * kernelHeight * inMaps x maps,
+  //! column-major).
+  std::vector<int8_t> weight;
+
+  //! Scale of the filters of each output map (maps x 1).
+  MatType weightScales;
+
+  //! Bias of each output map (maps x 1), or empty.
+  MatType bias;
+
+  //! Scale used to quantize the input.
+  ElemType inputScale;
+
+  //! Locally-stored padding layer.
+  PaddingType<MatType> padding;
+
+  //! Locally-stored product of the input dimensions higher than the third.
+  size_t higherInDimensions;
+}; // class QuantizedConvolutionType
+
+// Convenience typedefs.
+
+// Standard QuantizedConvolution layer.
+typedef QuantizedConvolutionType<arma::mat> QuantizedConvolution;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_convolution_impl.hpp"
+
+#endif
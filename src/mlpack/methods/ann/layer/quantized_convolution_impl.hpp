@@ -0,0 +1,247 @@
+/**
+ * @file methods/ann/layer/quantized_convolution_impl.hpp
+ *
+ * Implementation of the QuantizedConvolution layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_CONVOLUTION_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_convolution.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+QuantizedConvolutionType<MatType>::QuantizedConvolutionType() :
+    Layer<MatType>(),
+    maps(0),
+    inMaps(0),
+    kernelWidth(0),
+    kernelHeight(0),
+    strideWidth(1),
+    strideHeight(1),
+    padWLeft(0),
+    padWRight(0),
+    padHBottom(0),
+    padHTop(0),
+    inputScale(1),
+    higherInDimensions(1)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+template<typename ForwardConvolutionRule,
+         typename BackwardConvolutionRule,
+         typename GradientConvolutionRule>
+QuantizedConvolutionType<MatType>::QuantizedConvolutionType(
+    const ConvolutionType<ForwardConvolutionRule,
+                          BackwardConvolutionRule,
+                          GradientConvolutionRule,
+                          MatType>& layer,
+    const ElemType inputScale) :
+    Layer<MatType>(),
+    maps(layer.Maps()),
+    inMaps(0),
+    kernelWidth(layer.KernelWidth()),
+    kernelHeight(layer.KernelHeight()),
+    strideWidth(layer.StrideWidth()),
+    strideHeight(layer.StrideHeight()),
+    padWLeft(layer.PadWLeft()),
+    padWRight(layer.PadWRight()),
+    padHBottom(layer.PadHBottom()),
+    padHTop(layer.PadHTop()),
+    inputScale(inputScale),
+    higherInDimensions(1)
+{
+  const CubeType& floatWeight = layer.Weight();
+  if (floatWeight.is_empty() || maps == 0)
+  {
+    throw std::invalid_argument("QuantizedConvolutionType::"
+        "QuantizedConvolutionType(): the weights of the layer to quantize are "
+        "not set!");
+  }
+
+  if (!(inputScale > 0))
+  {
+    throw std::invalid_argument("QuantizedConvolutionType::"
+        "QuantizedConvolutionType(): the input scale must be positive!");
+  }
+
+  // The filters of each output map are contiguous in the weights, so each
+  // column of this alias holds the filters of one output map.
+  inMaps = floatWeight.n_slices / maps;
+  MatType filters;
+  MakeAlias(filters, const_cast<ElemType*>(floatWeight.memptr()),
+      kernelWidth * kernelHeight * inMaps, maps);
+  QuantizeInt8Columns(filters, weight, weightScales);
+
+  bias = vectorise(layer.Bias());
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::Forward(
+    const MatType& input, MatType& output)
+{
+  const size_t batchSize = input.n_cols;
+
+  // First, perform any padding if necessary, and quantize the input.
+  const bool usingPadding =
+      (padWLeft != 0 || padWRight != 0 || padHTop != 0 || padHBottom != 0);
+  const size_t paddedRows = this->inputDimensions[0] + padWLeft + padWRight;
+  const size_t paddedCols = this->inputDimensions[1] + padHTop + padHBottom;
+  std::vector<int8_t> quantizedInput;
+  if (usingPadding)
+  {
+    MatType inputPadded(paddedRows * paddedCols * inMaps * higherInDimensions,
+        batchSize);
+    padding.Forward(input, inputPadded);
+    QuantizeInt8(inputPadded, inputScale, quantizedInput);
+  }
+  else
+  {
+    QuantizeInt8(input, inputScale, quantizedInput);
+  }
+
+  const size_t outputRows = this->outputDimensions[0];
+  const size_t outputCols = this->outputDimensions[1];
+  const size_t outputSize = outputRows * outputCols;
+  const size_t paddedSize = paddedRows * paddedCols;
+  const size_t filterSize = kernelWidth * kernelHeight * inMaps;
+  const size_t numImages = higherInDimensions * batchSize;
+  const size_t imagesPerBlock = Im2ColConvolution<>::ImagesPerBlock(
+      outputSize * filterSize, numImages);
+
+  const ElemType* scales = weightScales.memptr();
+  const ElemType* biasPtr = bias.is_empty() ? NULL : bias.memptr();
+  const ElemType scale = inputScale;
+  const size_t outMaps = maps;
+  ElemType* outputPtr = output.memptr();
+
+  std::vector<int8_t> patches;
+  for (size_t first = 0; first < numImages; first += imagesPerBlock)
+  {
+    const size_t blockImages = std::min(imagesPerBlock, numImages - first);
+    const size_t numPatches = outputSize * blockImages;
+
+    // Lower the block of images to one (quantized) patch per column, with the
+    // same element order as the columns of the filters (and as the rows of the
+    // patches of Im2ColConvolution).
+    patches.resize(filterSize * numPatches);
+    #pragma omp parallel for
+    for (size_t p = 0; p < numPatches; ++p)
+    {
+      const size_t n = first + p / outputSize;
+      const size_t i = (p % outputSize) % outputRows;
+      const size_t j = (p % outputSize) / outputRows;
+
+      int8_t* patchPtr = patches.data() + p * filterSize;
+      for (size_t map = 0; map < inMaps; ++map)
+      {
+        const int8_t* slicePtr = quantizedInput.data() +
+            (n * inMaps + map) * paddedSize;
+        for (size_t kj = 0; kj < kernelHeight; ++kj)
+        {
+          const int8_t* inputPtr = slicePtr +
+              (j * strideHeight + kj) * paddedRows + i * strideWidth;
+          std::copy(inputPtr, inputPtr + kernelWidth, patchPtr);
+          patchPtr += kernelWidth;
+        }
+      }
+    }
+
+    // Compute the product of the filters and the patches, and store each
+    // element in the slice of its output map.
+    QuantizedMatMul(weight.data(), patches.data(), filterSize, maps,
+        numPatches, [=](const size_t m, const size_t p, const int32_t sum)
+        {
+          const size_t n = first + p / outputSize;
+          outputPtr[(n * outMaps + m) * outputSize + (p % outputSize)] =
+              ElemType(sum) * scale * scales[m] +
+              (biasPtr ? biasPtr[m] : ElemType(0));
+        });
+  }
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& /* gy */,
+    MatType& /* g */)
+{
+  throw std::logic_error("QuantizedConvolutionType::Backward(): quantized "
+      "layers can only be used for inference!");
+}
+
+template<typename MatType>
+void QuantizedConvolutionType<MatType>::ComputeOutputDimensions()
+{
+  padding = PaddingType<MatType>(padWLeft, padWRight, padHTop, padHBottom);
+  padding.InputDimensions() = this->inputDimensions;
+  padding.ComputeOutputDimensions();
+
+  const size_t inputMaps = (this->inputDimensions.size() >= 3) ?
+      this->inputDimensions[2] : 1;
+  if (inputMaps != inMaps)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedConvolutionType::ComputeOutputDimensions(): number of "
+        << "input maps (" << inputMaps << ") does not match the number of "
+        << "input maps of the quantized filters (" << inMaps << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  // We must ensure that the output has at least 3 dimensions, since we will
+  // be adding some number of maps to the output.
+  this->outputDimensions = std::vector<size_t>(
+      std::max(this->inputDimensions.size(), size_t(3)), 1);
+  this->outputDimensions[0] = (this->inputDimensions[0] + padWLeft +
+      padWRight - kernelWidth) / strideWidth + 1;
+  this->outputDimensions[1] = (this->inputDimensions[1] + padHTop +
+      padHBottom - kernelHeight) / strideHeight + 1;
+
+  // Dimensions higher than the third are passed through as separate images.
+  higherInDimensions = 1;
+  for (size_t i = 3; i < this->inputDimensions.size(); ++i)
+  {
+    higherInDimensions *= this->inputDimensions[i];
+    this->outputDimensions[i] = this->inputDimensions[i];
+  }
+
+  this->outputDimensions[2] = maps;
+}
+
+template<typename MatType>
+template<typename Archive>
+void QuantizedConvolutionType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(maps));
+  ar(CEREAL_NVP(inMaps));
+  ar(CEREAL_NVP(kernelWidth));
+  ar(CEREAL_NVP(kernelHeight));
+  ar(CEREAL_NVP(strideWidth));
+  ar(CEREAL_NVP(strideHeight));
+  ar(CEREAL_NVP(padWLeft));
+  ar(CEREAL_NVP(padWRight));
+  ar(CEREAL_NVP(padHBottom));
+  ar(CEREAL_NVP(padHTop));
+  ar(CEREAL_NVP(weight));
+  ar(CEREAL_NVP(weightScales));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(inputScale));
+  ar(CEREAL_NVP(padding));
+  ar(CEREAL_NVP(higherInDimensions));
+}
+
+} // namespace mlpack
+
+#endif
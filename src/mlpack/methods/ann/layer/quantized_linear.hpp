@@ -0,0 +1,170 @@
+/**
+ * @file methods/ann/layer/quantized_linear.hpp
+ *
+ * Definition of the QuantizedLinear layer, an inference-only version of the
+ * Linear and LinearNoBias layers with int8 weights.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/methods/ann/quantization.hpp>
+
+#include "layer.hpp"
+#include "linear.hpp"
+#include "linear_no_bias.hpp"
+
+namespace mlpack {
+
+/**
+ * The QuantizedLinear layer computes the same affine transformation y = Ax + b
+ * as a trained Linear or LinearNoBias layer, but with the weights A stored as
+ * int8 values.  Each row of A (each output unit) has its own scale, so
+ * A(i, j) is approximately scale(i) * q(i, j).
+ *
+ * In the forward pass the input is quantized to int8 with a fixed scale that
+ * was chosen during calibration (see `QuantizeFFN()`); values larger than the
+ * calibrated range saturate.  The products of the int8 weights and inputs are
+ * accumulated in int32, and each sum is converted back to a floating-point
+ * value as sum * inputScale * scale(i) + b(i).
+ *
+ * This layer has no trainable parameters, and can only be used for inference:
+ * calling `Backward()` throws an exception.
+ *
+ * @tparam MatType Matrix representation to accept as input and use for
+ *    computation.
+ */
+template<typename MatType = arma::mat>
+class QuantizedLinearType : public Layer<MatType>
+{
+ public:
+  typedef typename MatType::elem_type ElemType;
+
+  //! Create an empty QuantizedLinear object (for serialization).
+  QuantizedLinearType();
+
+  /**
+   * Create the QuantizedLinear layer by quantizing the weights of the given
+   * trained Linear layer.
+   *
+   * @param layer Layer to quantize.  Its weights must be set.
+   * @param inputScale Scale to quantize the input of the layer with; inputs are
+   *     stored as round(x / inputScale).
+   */
+  template<typename RegularizerType>
+  QuantizedLinearType(const LinearType<MatType, RegularizerType>& layer,
+                      const ElemType inputScale);
+
+  /**
+   * Create the QuantizedLinear layer by quantizing the weights of the given
+   * trained LinearNoBias layer.
+   *
+   * @param layer Layer to quantize.  Its weights must be set.
+   * @param inputScale Scale to quantize the input of the layer with; inputs are
+   *     stored as round(x / inputScale).
+   */
+  template<typename RegularizerType>
+  QuantizedLinearType(const LinearNoBiasType<MatType, RegularizerType>& layer,
+                      const ElemType inputScale);
+
+  /**
+   * Create the QuantizedLinear layer from the given weights and bias.
+   *
+   * @param weight Weights of the layer (outSize x inSize).
+   * @param bias Bias of the layer (outSize x 1), or an empty matrix for no
+   *     bias.
+   * @param inputScale Scale to quantize the input of the layer with; inputs are
+   *     stored as round(x / inputScale).
+   */
+  QuantizedLinearType(const MatType& weight,
+                      const MatType& bias,
+                      const ElemType inputScale);
+
+  virtual ~QuantizedLinearType() { }
+
+  //! Clone the QuantizedLinearType object. This handles polymorphism correctly.
+  QuantizedLinearType* Clone() const { return new QuantizedLinearType(*this); }
+
+  /**
+   * Ordinary feed forward pass of a neural network, evaluating the function
+   * f(x) by propagating the activity forward through f.
+   *
+   * @param input Input data used for evaluating the specified function.
+   * @param output Resulting output activation.
+   */
+  void Forward(const MatType& input, MatType& output);
+
+  /**
+   * The backward pass is not available for quantized layers; this throws a
+   * std::logic_error.
+   */
+  void Backward(const MatType& /* input */,
+                const MatType& /* output */,
+                const MatType& /* gy */,
+                MatType& /* g */);
+
+  //! Get the number of input units.
+  size_t InSize() const { return inSize; }
+  //! Get the number of output units.
+  size_t OutSize() const { return outSize; }
+
+  //! Get the quantized weights; element (j, i) is the weight between input j
+  //! and output i.
+  const std::vector<int8_t>& QuantizedWeight() const { return weight; }
+  //! Get the scale of the weights of each output unit.
+  const MatType& WeightScales() const { return weightScales; }
+  //! Get the bias (empty if the layer has no bias).
+  const MatType& Bias() const { return bias; }
+
+  //! Get the scale used to quantize the input.
+  ElemType InputScale() const { return inputScale; }
+  //! Modify the scale used to quantize the input.
+  ElemType& InputScale() { return inputScale; }
+
+  //! Compute the output dimensions of the layer given `InputDimensions()`.
+  void ComputeOutputDimensions();
+
+  //! Serialize the layer.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! Quantize the given weights and store the bias.
+  void Initialize(const MatType& floatWeight, const MatType& floatBias);
+
+  //! Locally-stored number of input units.
+  size_t inSize;
+
+  //! Locally-stored number of output units.
+  size_t outSize;
+
+  //! Quantized weights, stored transposed (inSize x outSize, column-major), so
+  //! that the weights of each output unit are contiguous.
+  std::vector<int8_t> weight;
+
+  //! Scale of the weights of each output unit (outSize x 1).
+  MatType weightScales;
+
+  //! Bias of the layer (outSize x 1), or empty.
+  MatType bias;
+
+  //! Scale used to quantize the input.
+  ElemType inputScale;
+}; // class QuantizedLinearType
+
+// Convenience typedefs.
+
+// Standard QuantizedLinear layer.
+typedef QuantizedLinearType<arma::mat> QuantizedLinear;
+
+} // namespace mlpack
+
+// Include implementation.
+#include "quantized_linear_impl.hpp"
+
+#endif
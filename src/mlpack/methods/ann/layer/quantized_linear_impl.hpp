@@ -0,0 +1,171 @@
+/**
+ * @file methods/ann/layer/quantized_linear_impl.hpp
+ *
+ * Implementation of the QuantizedLinear layer.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+#define MLPACK_METHODS_ANN_LAYER_QUANTIZED_LINEAR_IMPL_HPP
+
+// In case it hasn't yet been included.
+#include "quantized_linear.hpp"
+
+namespace mlpack {
+
+template<typename MatType>
+QuantizedLinearType<MatType>::QuantizedLinearType() :
+    Layer<MatType>(),
+    inSize(0),
+    outSize(0),
+    inputScale(1)
+{
+  // Nothing to do here.
+}
+
+template<typename MatType>
+template<typename RegularizerType>
+QuantizedLinearType<MatType>::QuantizedLinearType(
+    const LinearType<MatType, RegularizerType>& layer,
+    const ElemType inputScale) :
+    Layer<MatType>(),
+    inSize(0),
+    outSize(0),
+    inputScale(inputScale)
+{
+  Initialize(layer.Weight(), layer.Bias());
+}
+
+template<typename MatType>
+template<typename RegularizerType>
+QuantizedLinearType<MatType>::QuantizedLinearType(
+    const LinearNoBiasType<MatType, RegularizerType>& layer,
+    const ElemType inputScale) :
+    Layer<MatType>(),
+    inSize(0),
+    outSize(0),
+    inputScale(inputScale)
+{
+  Initialize(layer.Parameters(), MatType());
+}
+
+template<typename MatType>
+QuantizedLinearType<MatType>::QuantizedLinearType(
+    const MatType& weight,
+    const MatType& bias,
+    const ElemType inputScale) :
+    Layer<MatType>(),
+    inSize(0),
+    outSize(0),
+    inputScale(inputScale)
+{
+  Initialize(weight, bias);
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::Initialize(const MatType& floatWeight,
+                                              const MatType& floatBias)
+{
+  if (floatWeight.is_empty())
+  {
+    throw std::invalid_argument("QuantizedLinearType::QuantizedLinearType(): "
+        "the weights of the layer to quantize are not set!");
+  }
+
+  if (!floatBias.is_empty() && floatBias.n_elem != floatWeight.n_rows)
+  {
+    throw std::invalid_argument("QuantizedLinearType::QuantizedLinearType(): "
+        "the bias must have one element per row of the weights!");
+  }
+
+  if (!(inputScale > 0))
+  {
+    throw std::invalid_argument("QuantizedLinearType::QuantizedLinearType(): "
+        "the input scale must be positive!");
+  }
+
+  inSize = floatWeight.n_cols;
+  outSize = floatWeight.n_rows;
+
+  // Each column of the transposed weights holds the weights of one output unit,
+  // which get their own scale.
+  QuantizeInt8Columns(MatType(floatWeight.t()), weight, weightScales);
+  bias = vectorise(floatBias);
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::Forward(
+    const MatType& input, MatType& output)
+{
+  std::vector<int8_t> quantizedInput;
+  QuantizeInt8(input, inputScale, quantizedInput);
+
+  // Scale each sum back with the scales of the input and the output unit.
+  const ElemType* scales = weightScales.memptr();
+  const ElemType* biasPtr = bias.is_empty() ? NULL : bias.memptr();
+  const ElemType scale = inputScale;
+  ElemType* outputPtr = output.memptr();
+  const size_t rows = outSize;
+  QuantizedMatMul(weight.data(), quantizedInput.data(), inSize, outSize,
+      input.n_cols, [=](const size_t i, const size_t j, const int32_t sum)
+      {
+        outputPtr[i + j * rows] = ElemType(sum) * scale * scales[i] +
+            (biasPtr ? biasPtr[i] : ElemType(0));
+      });
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::Backward(
+    const MatType& /* input */,
+    const MatType& /* output */,
+    const MatType& /* gy */,
+    MatType& /* g */)
+{
+  throw std::logic_error("QuantizedLinearType::Backward(): quantized layers "
+      "can only be used for inference!");
+}
+
+template<typename MatType>
+void QuantizedLinearType<MatType>::ComputeOutputDimensions()
+{
+  size_t totalInputSize = this->inputDimensions[0];
+  for (size_t i = 1; i < this->inputDimensions.size(); ++i)
+    totalInputSize *= this->inputDimensions[i];
+
+  if (totalInputSize != inSize)
+  {
+    std::ostringstream oss;
+    oss << "QuantizedLinearType::ComputeOutputDimensions(): input size ("
+        << totalInputSize << ") does not match the number of input units of "
+        << "the quantized weights (" << inSize << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  this->outputDimensions = std::vector<size_t>(this->inputDimensions.size(),
+      1);
+
+  // The QuantizedLinear layer flattens its input.
+  this->outputDimensions[0] = outSize;
+}
+
+template<typename MatType>
+template<typename Archive>
+void QuantizedLinearType<MatType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  ar(cereal::base_class<Layer<MatType>>(this));
+
+  ar(CEREAL_NVP(inSize));
+  ar(CEREAL_NVP(outSize));
+  ar(CEREAL_NVP(weight));
+  ar(CEREAL_NVP(weightScales));
+  ar(CEREAL_NVP(bias));
+  ar(CEREAL_NVP(inputScale));
+}
+
+} // namespace mlpack
+
+#endif
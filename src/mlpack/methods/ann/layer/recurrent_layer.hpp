@@ -58,7 +58,11 @@ class RecurrentLayer : public Layer<MatType>
    * to store `bpttSteps` steps of previous forward and backward passes, with a
    * batch size of `batchSize`.
    *
-   * Any internal state of the recurrent layer should be set to 0.
+   * Any internal state of the recurrent layer should be set to 0.  During
+   * training, `RNN` asks for one more step than the number of BPTT steps: step
+   * 0 holds the state just before the first step that is backpropagated
+   * through (or the zero state, if there is no such step), so that the
+   * backward pass of step `i > 0` can always use the state of step `i - 1`.
    */
   virtual void ClearRecurrentState(
       const size_t bpttSteps,
@@ -85,6 +89,40 @@ class RecurrentLayer : public Layer<MatType>
   //! state should be considered in computations.
   bool HasPreviousStep() const { return previousStep != size_t(-1); }
 
+  /**
+   * Return the number of rows of the projection of the input that the layer
+   * computes before anything else in its forward pass (e.g., for an LSTM, the
+   * product of the input weights of all gates with the input), or 0 if the
+   * layer does not support precomputed input projections.
+   *
+   * When such a layer is the first layer of an `RNN`, the input of every time
+   * step is known in advance, so the `RNN` computes the projections of all time
+   * steps with one call to `ProjectInput()`, and hands each step its part with
+   * `InputProjection()` before calling `Forward()`.
+   */
+  virtual size_t InputProjectionSize() const { return 0; }
+
+  /**
+   * Compute the projection of the given input (which may hold the points of
+   * many time steps) into `projection`, which is already of size
+   * `InputProjectionSize()` x `input.n_cols`.  This is only called if
+   * `InputProjectionSize()` is not 0.
+   *
+   * @param input Input points, one per column.
+   * @param projection Matrix to store the projection of the input in.
+   */
+  virtual void ProjectInput(const MatType& /* input */,
+                            MatType& /* projection */) { }
+
+  //! Get the precomputed projection of the input of the current step, or NULL
+  //! if Forward() must compute it.
+  const MatType* InputProjection() const { return inputProjection; }
+  //! Modify the precomputed projection of the input of the current step.
+  //! (Don't do this inside of your recurrent layer's implementation!  This is
+  //! meant to be done by the enclosing network, which must set it back to NULL
+  //! once the projection is no longer valid.)
+  const MatType*& InputProjection() { return inputProjection; }
+
   //! Serialize the recurrent layer.
   template<typename Archive>
   void serialize(Archive& ar, const uint32_t /* version */);
@@ -96,6 +134,9 @@ class RecurrentLayer : public Layer<MatType>
   //! The previous index of the step.  This is set by the enclosing network
   //! during forward and backward passes.
   size_t previousStep;
+  //! The precomputed projection of the input of the current step, if any.
+  //! This is set by the enclosing network during forward passes.
+  const MatType* inputProjection;
 };
 
 } // namespace mlpack
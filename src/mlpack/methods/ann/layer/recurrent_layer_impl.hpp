@@ -21,21 +21,24 @@ template<typename MatType>
 RecurrentLayer<MatType>::RecurrentLayer() :
     Layer<MatType>(),
     currentStep(0),
-    previousStep(0)
+    previousStep(0),
+    inputProjection(NULL)
 { /* Nothing to do. */ }
 
 template<typename MatType>
 RecurrentLayer<MatType>::RecurrentLayer(const RecurrentLayer& other) :
     Layer<MatType>(other),
     currentStep(other.currentStep),
-    previousStep(other.previousStep)
+    previousStep(other.previousStep),
+    inputProjection(NULL)
 { /* Nothing else to do. */ }
 
 template<typename MatType>
 RecurrentLayer<MatType>::RecurrentLayer(RecurrentLayer&& other) :
     Layer<MatType>(std::move(other)),
     currentStep(std::move(other.currentStep)),
-    previousStep(std::move(other.previousStep))
+    previousStep(std::move(other.previousStep)),
+    inputProjection(NULL)
 { /* Nothing else to do. */ }
 
 template<typename MatType>
@@ -47,6 +50,7 @@ RecurrentLayer<MatType>::operator=(const RecurrentLayer& other)
     Layer<MatType>::operator=(other);
     currentStep = other.currentStep;
     previousStep = other.previousStep;
+    inputProjection = NULL;
   }
 
   return *this;
@@ -61,6 +65,7 @@ RecurrentLayer<MatType>::operator=(RecurrentLayer&& other)
     Layer<MatType>::operator=(std::move(other));
     currentStep = std::move(other.currentStep);
     previousStep = std::move(other.previousStep);
+    inputProjection = NULL;
   }
 
   return *this;
@@ -45,17 +45,26 @@
         mlpack::NaiveConvolution<mlpack::FullConvolution>, \
         mlpack::NaiveConvolution<mlpack::ValidConvolution>, \
         __VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::ConvolutionType< \
+        mlpack::Im2ColConvolution<mlpack::ValidConvolution>, \
+        mlpack::Im2ColConvolution<mlpack::FullConvolution>, \
+        mlpack::Im2ColConvolution<mlpack::ValidConvolution>, \
+        __VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::CELUType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::CReLUType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::DropConnectType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::DropoutType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ELUType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::FastLSTMType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::FlexibleReLUType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::FusedConvolutionType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::FusedLinearType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::GroupedConvolutionType< \
         mlpack::NaiveConvolution<mlpack::ValidConvolution>, \
         mlpack::NaiveConvolution<mlpack::FullConvolution>, \
         mlpack::NaiveConvolution<mlpack::ValidConvolution>, \
         __VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::GRUType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::IdentityType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::LeakyReLUType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::LayerNormType<__VA_ARGS__>); \
@@ -70,6 +79,8 @@
     CEREAL_REGISTER_TYPE(mlpack::NoisyLinearType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::PaddingType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::PReLUType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::QuantizedConvolutionType<__VA_ARGS__>); \
+    CEREAL_REGISTER_TYPE(mlpack::QuantizedLinearType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::RBFType<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::ReLU6Type<__VA_ARGS__>); \
     CEREAL_REGISTER_TYPE(mlpack::RepeatType<__VA_ARGS__>); \
@@ -80,4 +91,11 @@
 
 CEREAL_REGISTER_MLPACK_LAYERS(arma::mat);
 
+// Registering the layers for a second matrix type doubles the compilation
+// overhead, so single-precision layers are only registered if
+// MLPACK_ENABLE_ANN_SERIALIZATION_FMAT is also defined.
+#ifdef MLPACK_ENABLE_ANN_SERIALIZATION_FMAT
+CEREAL_REGISTER_MLPACK_LAYERS(arma::fmat);
+#endif
+
 #endif
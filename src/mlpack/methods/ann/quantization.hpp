@@ -0,0 +1,155 @@
+/**
+ * @file methods/ann/quantization.hpp
+ *
+ * Symmetric int8 quantization of matrices, and an int8 x int8 -> int32 matrix
+ * product.  These are the building blocks of the quantized layers, which store
+ * their weights as int8 values with one scale per output channel, so that
+ * inference reads a quarter of the memory that single-precision weights need.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_ANN_QUANTIZATION_HPP
+#define MLPACK_METHODS_ANN_QUANTIZATION_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * Return the scale that maps the range [-maxAbs, maxAbs] onto the int8 range
+ * [-127, 127].  If `maxAbs` is zero, every value quantizes to zero, and 1 is
+ * returned so that the scale can still be inverted.
+ *
+ * @param maxAbs Largest absolute value to represent.
+ */
+template<typename ElemType>
+ElemType QuantizationScale(const ElemType maxAbs)
+{
+  return (maxAbs > 0) ? maxAbs / ElemType(127) : ElemType(1);
+}
+
+/**
+ * Round the given (already scaled) value to the nearest int8 value, saturating
+ * at -127 and 127.  (-128 is not used, so that the range is symmetric.)
+ *
+ * @param value Value to round.
+ */
+template<typename ElemType>
+int8_t RoundToInt8(const ElemType value)
+{
+  const ElemType rounded = std::round(value);
+  if (rounded >= ElemType(127))
+    return int8_t(127);
+  else if (rounded <= ElemType(-127))
+    return int8_t(-127);
+  else if (std::isnan(rounded))
+    return int8_t(0);
+
+  return (int8_t) rounded;
+}
+
+/**
+ * Quantize every element of the given matrix with the given scale, storing the
+ * int8 values in `output` in the same (column-major) order.
+ *
+ * @param input Matrix to quantize.
+ * @param scale Scale of the quantized values; x is stored as round(x / scale).
+ * @param output Vector to store the quantized values in.
+ */
+template<typename MatType>
+void QuantizeInt8(const MatType& input,
+                  const typename MatType::elem_type scale,
+                  std::vector<int8_t>& output)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  output.resize(input.n_elem);
+  const ElemType invScale = 1 / scale;
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < (size_t) input.n_elem; ++i)
+    output[i] = RoundToInt8(input[i] * invScale);
+}
+
+/**
+ * Quantize each column of the given matrix with its own scale, chosen so that
+ * the largest absolute value of the column maps to 127.  This is used for
+ * per-channel quantization of weights, where each column holds the weights of
+ * one output channel.
+ *
+ * @param input Matrix to quantize.
+ * @param output Vector to store the quantized values in (column-major).
+ * @param scales Column vector to store the scale of each column in.
+ */
+template<typename MatType>
+void QuantizeInt8Columns(const MatType& input,
+                         std::vector<int8_t>& output,
+                         MatType& scales)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  output.resize(input.n_elem);
+  scales.set_size(input.n_cols, 1);
+
+  #pragma omp parallel for
+  for (size_t j = 0; j < (size_t) input.n_cols; ++j)
+  {
+    const ElemType scale = QuantizationScale(
+        (ElemType) arma::max(arma::abs(input.col(j))));
+    scales[j] = scale;
+
+    const ElemType invScale = 1 / scale;
+    int8_t* outputPtr = output.data() + j * input.n_rows;
+    for (size_t i = 0; i < (size_t) input.n_rows; ++i)
+      outputPtr[i] = RoundToInt8(input(i, j) * invScale);
+  }
+}
+
+/**
+ * Compute the product a^T * b of two int8 matrices, accumulating in int32.
+ * Both matrices are column-major with `k` rows, so each element of the result
+ * is the dot product of two contiguous columns.  Instead of storing the result,
+ * `store(i, j, sum)` is called for each element (i, j) of the (m x n) product,
+ * so that the caller can dequantize it directly into its output; calls for
+ * different columns j may run in parallel.
+ *
+ * The accumulation cannot overflow as long as k is less than 2^31 / 127^2,
+ * i.e. for dot products of up to about 133000 elements.
+ *
+ * @param a First matrix (k x m), column-major.
+ * @param b Second matrix (k x n), column-major.
+ * @param k Number of rows of both matrices.
+ * @param m Number of columns of `a`.
+ * @param n Number of columns of `b`.
+ * @param store Function to call with each element of the product.
+ */
+template<typename StoreFunctionType>
+void QuantizedMatMul(const int8_t* a,
+                     const int8_t* b,
+                     const size_t k,
+                     const size_t m,
+                     const size_t n,
+                     StoreFunctionType store)
+{
+  #pragma omp parallel for
+  for (size_t j = 0; j < n; ++j)
+  {
+    const int8_t* bCol = b + j * k;
+    for (size_t i = 0; i < m; ++i)
+    {
+      const int8_t* aCol = a + i * k;
+      int32_t sum = 0;
+      for (size_t l = 0; l < k; ++l)
+        sum += int32_t(aCol[l]) * int32_t(bCol[l]);
+
+      store(i, j, sum);
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -356,6 +356,34 @@ class RNN
   //! Set the current step index of all recurrent layers to `step`.
   void SetCurrentStep(const size_t step);
 
+  //! Return the first layer of the network if it is a recurrent layer that
+  //! supports precomputed input projections (see
+  //! `RecurrentLayer::InputProjectionSize()`), or NULL otherwise.
+  RecurrentLayer<MatType>* ProjectingLayer();
+
+  /**
+   * If the first layer of the network supports precomputed input projections,
+   * compute the projection of the points `begin` to `begin + batchSize - 1` of
+   * every time step of `data`, with one matrix product for the whole sequence.
+   * The projection of each time step can then be handed to the layer with
+   * `SetInputProjection()`.
+   *
+   * @param data Input sequences.
+   * @param begin Index of the first point of the batch.
+   * @param batchSize Number of points in the batch.
+   */
+  void ProjectInputs(const arma::Cube<typename MatType::elem_type>& data,
+                     const size_t begin,
+                     const size_t batchSize);
+
+  //! Give the first layer the projection of the input of time step `t`
+  //! computed by the last call to `ProjectInputs()`, if any, for its next
+  //! forward pass.
+  void SetInputProjection(const size_t t);
+
+  //! Make the first layer compute the projection of its input itself again.
+  void ClearInputProjection();
+
   //! Number of timesteps to consider for backpropagation through time (BPTT).
   size_t bpttSteps;
   //! Whether the network expects only one single response per sequence, or one
@@ -375,6 +403,18 @@ class RNN
   //! The matrix of responses to the input data points.  This member is empty,
   //! except during training.
   arma::Cube<typename MatType::elem_type> responses;
+
+  //! The inputs of all time steps of a batch, if they are not contiguous in the
+  //! data.
+  MatType projectionInput;
+  //! The projections of the inputs of all time steps of a batch, computed by
+  //! the first layer (one block of columns per time step).
+  MatType inputProjection;
+  //! The projection of the input of the current time step (an alias of a block
+  //! of `inputProjection`).
+  MatType stepProjection;
+  //! Number of points in the batch of `inputProjection`.
+  size_t projectionBatchSize;
 }; // class RNNType
 
 } // namespace mlpack
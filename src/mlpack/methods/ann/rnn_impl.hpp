@@ -34,7 +34,8 @@ RNN<
     InitializationRuleType initializeRule) :
     bpttSteps(bpttSteps),
     single(single),
-    network(std::move(outputLayer), std::move(initializeRule))
+    network(std::move(outputLayer), std::move(initializeRule)),
+    projectionBatchSize(0)
 {
   /* Nothing to do here */
 }
@@ -52,7 +53,8 @@ RNN<
     const RNN& network) :
     bpttSteps(network.bpttSteps),
     single(network.single),
-    network(network.network)
+    network(network.network),
+    projectionBatchSize(0)
 {
   // Nothing else to do.
 }
@@ -70,7 +72,8 @@ RNN<
     RNN&& network) :
     bpttSteps(std::move(network.bpttSteps)),
     single(std::move(network.single)),
-    network(std::move(network.network))
+    network(std::move(network.network)),
+    projectionBatchSize(0)
 {
   // Nothing to do here.
 }
@@ -230,6 +233,7 @@ void RNN<
     ResetMemoryState(1, effectiveBatchSize);
     SetPreviousStep(size_t(-1));
     SetCurrentStep(size_t(0));
+    ProjectInputs(predictors, i, effectiveBatchSize);
 
     // Iterate over all time steps.
     for (size_t t = 0; t < predictors.n_slices; ++t)
@@ -237,6 +241,7 @@ void RNN<
       // If it is after the first step, we have a previous state.
       if (t == 1)
         SetPreviousStep(size_t(0));
+      SetInputProjection(t);
 
       // Create aliases for the input and output.
       MakeAlias(inputAlias,
@@ -248,6 +253,8 @@ void RNN<
       network.Forward(inputAlias, outputAlias);
     }
   }
+
+  ClearInputProjection();
 }
 
 template<
@@ -301,6 +308,17 @@ void RNN<
           "build options\" section of the README for more information.");
     #endif
   #else
+    #if !defined(MLPACK_ENABLE_ANN_SERIALIZATION_FMAT) && \
+        !defined(MLPACK_IGNORE_ANN_SERIALIZATION_WARNING)
+      if (std::is_same<MatType, arma::fmat>::value)
+      {
+        throw std::runtime_error("Cannot serialize a neural network of "
+            "arma::fmat unless MLPACK_ENABLE_ANN_SERIALIZATION_FMAT is "
+            "defined!  See the \"Additional build options\" section of the "
+            "README for more information.");
+      }
+    #endif
+
     ar(CEREAL_NVP(bpttSteps));
     ar(CEREAL_NVP(single));
     ar(CEREAL_NVP(network));
@@ -338,6 +356,7 @@ typename MatType::elem_type RNN<
   ResetMemoryState(1, batchSize);
   SetCurrentStep(0);
   SetPreviousStep(size_t(-1));
+  ProjectInputs(predictors, begin, batchSize);
   MatType output(network.network.OutputSize(), batchSize);
 
   typename MatType::elem_type loss = 0.0;
@@ -346,6 +365,7 @@ typename MatType::elem_type RNN<
   {
     if (t == 1)
       SetPreviousStep(0);
+    SetInputProjection(t);
 
     // Manually reset the data of the network to be an alias of the current time
     // step.
@@ -358,6 +378,7 @@ typename MatType::elem_type RNN<
     loss += network.Evaluate(output, begin, batchSize);
   }
 
+  ClearInputProjection();
   return loss;
 }
 
@@ -403,24 +424,30 @@ typename MatType::elem_type RNN<
   const size_t effectiveBPTTSteps = std::max(size_t(1),
       std::min(bpttSteps, size_t(predictors.n_slices)));
 
-  ResetMemoryState(effectiveBPTTSteps, batchSize);
+  // The steps that BPTT goes through are held in slots 1 to
+  // `effectiveBPTTSteps`.  Slot 0 holds the state of the step just before
+  // them, since the first of them depends on it; if there is no such step, it
+  // holds the initial (zero) state.
+  ResetMemoryState(effectiveBPTTSteps + 1, batchSize);
   SetPreviousStep(size_t(-1));
   arma::Cube<typename MatType::elem_type> outputs(
-      network.network.OutputSize(), batchSize, effectiveBPTTSteps);
+      network.network.OutputSize(), batchSize, effectiveBPTTSteps + 1);
 
   // If `bpttSteps` is less than the number of time steps in the data, then for
   // the first few steps, we won't actually need to hold onto any historical
   // information, since BPTT will never go back that far.
-  const size_t extraSteps = (predictors.n_slices - effectiveBPTTSteps + 1);
+  const size_t extraSteps = (predictors.n_slices - effectiveBPTTSteps);
   MatType stepData, outputData, responseData;
-  for (size_t t = 0; t < std::min(size_t(predictors.n_slices), extraSteps); ++t)
+  ProjectInputs(predictors, begin, batchSize);
+  for (size_t t = 0; t < extraSteps; ++t)
   {
     SetCurrentStep(0);
+    SetInputProjection(t);
 
     // Make an alias of the step's data.
     MakeAlias(stepData, predictors.slice(t).colptr(begin), predictors.n_rows,
         batchSize);
-    MakeAlias(outputData, outputs.slice(t).memptr(), outputs.n_rows,
+    MakeAlias(outputData, outputs.slice(0).memptr(), outputs.n_rows,
         outputs.n_cols);
     network.network.Forward(stepData, outputData);
 
@@ -434,16 +461,18 @@ typename MatType::elem_type RNN<
   }
 
   // Next, we reach the time steps that will be used for BPTT, for which we must
-  // preserve step data.
+  // preserve step data.  The data of time step t is held in slot
+  // t - extraSteps + 1.
   for (size_t t = extraSteps; t < predictors.n_slices; ++t)
   {
     SetCurrentStep(t - extraSteps + 1);
+    SetInputProjection(t);
 
     // Wrap a matrix around our data to avoid a copy.
     MakeAlias(stepData, predictors.slice(t).colptr(begin), predictors.n_rows,
         batchSize);
-    MakeAlias(outputData, outputs.slice(t).memptr(), outputs.n_rows,
-        outputs.n_cols);
+    MakeAlias(outputData, outputs.slice(t - extraSteps + 1).memptr(),
+        outputs.n_rows, outputs.n_cols);
     network.network.Forward(stepData, outputData);
 
     const size_t responseStep = (single) ? 0 : t;
@@ -454,6 +483,7 @@ typename MatType::elem_type RNN<
 
     SetPreviousStep(t - extraSteps + 1);
   }
+  ClearInputProjection();
 
   // Add loss (this is not dependent on time steps, and should only be added
   // once).
@@ -466,10 +496,11 @@ typename MatType::elem_type RNN<
       network.Parameters().n_cols);
 
   SetPreviousStep(size_t(-1));
-  const size_t minStep = predictors.n_slices - effectiveBPTTSteps + 1;
-  for (size_t t = predictors.n_slices; t >= minStep; --t)
+  for (size_t t = predictors.n_slices; t > extraSteps; --t)
   {
-    SetCurrentStep(t - 1);
+    // Time step t - 1 is held in slot t - extraSteps.
+    const size_t slot = t - extraSteps;
+    SetCurrentStep(slot);
 
     currentGradient.zeros();
     MatType error(outputs.n_rows, outputs.n_cols);
@@ -484,7 +515,7 @@ typename MatType::elem_type RNN<
     }
     else
     {
-      MakeAlias(outputData, outputs.slice(t - 1).colptr(0), outputs.n_rows,
+      MakeAlias(outputData, outputs.slice(slot).colptr(0), outputs.n_rows,
           outputs.n_cols);
       const size_t respStep = (single) ? 0 : t - 1;
       MakeAlias(responseData, responses.slice(respStep).colptr(begin),
@@ -495,7 +526,7 @@ typename MatType::elem_type RNN<
     // Now pass that error backwards through the network.
     MakeAlias(stepData, predictors.slice(t - 1).colptr(begin),
         predictors.n_rows, batchSize);
-    MakeAlias(outputData, outputs.slice(t - 1).colptr(0), outputs.n_rows,
+    MakeAlias(outputData, outputs.slice(slot).colptr(0), outputs.n_rows,
         outputs.n_cols);
 
     MatType networkDelta;
@@ -504,7 +535,7 @@ typename MatType::elem_type RNN<
     network.network.Gradient(stepData, error, currentGradient);
     gradient += currentGradient;
 
-    SetPreviousStep(t - 1);
+    SetPreviousStep(slot);
   }
 
   return loss;
@@ -571,15 +602,10 @@ void RNN<
     MatType
 >::ResetMemoryState(const size_t memorySize, const size_t batchSize)
 {
-  // Iterate over all layers and set the memory size.
-  for (Layer<MatType>* l : network.Network())
-  {
-    // We can only call ClearRecurrentState() on RecurrentLayers.
-    RecurrentLayer<MatType>* r =
-        dynamic_cast<RecurrentLayer<MatType>*>(l);
-    if (r != nullptr)
-      r->ClearRecurrentState(memorySize, batchSize);
-  }
+  // Iterate over all recurrent layers (including nested ones) and set the
+  // memory size.
+  for (RecurrentLayer<MatType>* r : network.network.RecurrentLayers())
+    r->ClearRecurrentState(memorySize, batchSize);
 }
 
 template<
@@ -593,15 +619,9 @@ void RNN<
     MatType
 >::SetPreviousStep(const size_t step)
 {
-  // Iterate over all layers and set the memory size.
-  for (Layer<MatType>* l : network.Network())
-  {
-    // We can only call SetPreviousStep() on RecurrentLayers.
-    RecurrentLayer<MatType>* r =
-        dynamic_cast<RecurrentLayer<MatType>*>(l);
-    if (r != nullptr)
-      r->PreviousStep() = step;
-  }
+  // Iterate over all recurrent layers (including nested ones).
+  for (RecurrentLayer<MatType>* r : network.network.RecurrentLayers())
+    r->PreviousStep() = step;
 }
 
 template<
@@ -615,15 +635,115 @@ void RNN<
     MatType
 >::SetCurrentStep(const size_t step)
 {
-  // Iterate over all layers and set the memory size.
-  for (Layer<MatType>* l : network.Network())
+  // Iterate over all recurrent layers (including nested ones).
+  for (RecurrentLayer<MatType>* r : network.network.RecurrentLayers())
+    r->CurrentStep() = step;
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+RecurrentLayer<MatType>* RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ProjectingLayer()
+{
+  if (network.network.Network().empty())
+    return NULL;
+
+  RecurrentLayer<MatType>* layer = dynamic_cast<RecurrentLayer<MatType>*>(
+      network.network.Network().front());
+  if (layer == NULL || layer->InputProjectionSize() == 0)
+    return NULL;
+
+  return layer;
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ProjectInputs(
+    const arma::Cube<typename MatType::elem_type>& data,
+    const size_t begin,
+    const size_t batchSize)
+{
+  typedef typename MatType::elem_type ElemType;
+
+  RecurrentLayer<MatType>* layer = ProjectingLayer();
+  if (layer == NULL)
   {
-    // We can only call SetPreviousStep() on RecurrentLayers.
-    RecurrentLayer<MatType>* r =
-        dynamic_cast<RecurrentLayer<MatType>*>(l);
-    if (r != nullptr)
-      r->CurrentStep() = step;
+    inputProjection.clear();
+    return;
+  }
+
+  // The first layer sees the raw input of every time step, so the projections
+  // of all steps can be computed with one product.  If the batch holds all
+  // points, the inputs of all steps are already contiguous; otherwise, gather
+  // them.
+  if (batchSize == data.n_cols)
+  {
+    MakeAlias(projectionInput, (ElemType*) data.memptr(), data.n_rows,
+        batchSize * data.n_slices);
+  }
+  else
+  {
+    projectionInput.set_size(data.n_rows, batchSize * data.n_slices);
+    for (size_t t = 0; t < data.n_slices; ++t)
+    {
+      projectionInput.cols(t * batchSize, (t + 1) * batchSize - 1) =
+          data.slice(t).cols(begin, begin + batchSize - 1);
+    }
   }
+
+  inputProjection.set_size(layer->InputProjectionSize(),
+      batchSize * data.n_slices);
+  layer->ProjectInput(projectionInput, inputProjection);
+  projectionBatchSize = batchSize;
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::SetInputProjection(const size_t t)
+{
+  RecurrentLayer<MatType>* layer = ProjectingLayer();
+  if (layer == NULL || inputProjection.is_empty())
+    return;
+
+  MakeAlias(stepProjection, inputProjection.colptr(t * projectionBatchSize),
+      inputProjection.n_rows, projectionBatchSize);
+  layer->InputProjection() = &stepProjection;
+}
+
+template<
+    typename OutputLayerType,
+    typename InitializationRuleType,
+    typename MatType
+>
+void RNN<
+    OutputLayerType,
+    InitializationRuleType,
+    MatType
+>::ClearInputProjection()
+{
+  RecurrentLayer<MatType>* layer = ProjectingLayer();
+  if (layer != NULL)
+    layer->InputProjection() = NULL;
 }
 
 } // namespace mlpack
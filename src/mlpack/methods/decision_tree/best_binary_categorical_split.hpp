@@ -0,0 +1,249 @@
+/**
+ * @file methods/decision_tree/best_binary_categorical_split.hpp
+ *
+ * A tree splitter that splits a categorical feature into two children by
+ * ordering its categories and finding the best binary partition of that order.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BEST_BINARY_CATEGORICAL_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_BEST_BINARY_CATEGORICAL_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "best_binary_numeric_split.hpp"
+
+namespace mlpack {
+
+/**
+ * The BestBinaryCategoricalSplit is a splitting function for decision trees
+ * that splits a categorical feature into two children, each of which holds a
+ * set of categories.  Unlike AllCategoricalSplit, the number of children does
+ * not grow with the number of categories, so this split can be used for
+ * features with very many categories (for instance, zip codes).
+ *
+ * Instead of searching all 2^(k - 1) partitions of the k categories, the
+ * categories are sorted by a statistic of the points that hold them, and only
+ * the k - 1 partitions of that order are considered (Fisher's grouping).  For
+ * regression, categories are sorted by their mean response; this finds the
+ * optimal partition for the mean squared error.  For classification, the
+ * categories are sorted by the fraction of their points in each class; for
+ * two classes this finds the optimal partition for the Gini impurity and the
+ * information gain, and for more classes the best partition of all of the
+ * orders is taken.  Finding the split takes O(n + k log k) time for regression
+ * and two classes, where n is the number of points.
+ *
+ * Categories that are not held by any point of the node being split are sent
+ * to the child with the most points.
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class BestBinaryCategoricalSplit
+{
+ public:
+  /**
+   * The auxiliary information of the split holds the child of each category.
+   */
+  class AuxiliarySplitInfo
+  {
+   public:
+    //! The child that each category is sent to (0 for left, 1 for right).
+    std::vector<bool> categoryDirections;
+
+    //! Serialize the auxiliary split information.
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(categoryDirections));
+    }
+  };
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return DBL_MAX.  If a split is made, then splitInfo and aux are modified:
+   * splitInfo will hold the child of categories that are not in the node, and
+   * aux will hold the child of each category.
+   *
+   * This overload is used only for classification.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param numCategories Number of categories in the categorical data.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename LabelsType,
+           typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const size_t numCategories,
+      const LabelsType& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      AuxiliarySplitInfo& aux);
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return DBL_MAX.  If a split is made, then splitInfo and aux are modified.
+   *
+   * This overload is used only for regression, with fitness functions that do
+   * not implement BinaryScanInitialize(), BinaryStep() and BinaryGains().
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param numCategories Number of categories in the categorical data.
+   * @param responses Responses for each point.
+   * @param weights Weights associated with responses.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   * @param fitnessFunction The FitnessFunction object instance. It is used to
+   *      evaluate the gain for the split.
+   */
+  template<bool UseWeights, typename VecType, typename ResponsesType,
+           typename WeightVecType>
+  static typename std::enable_if<
+      !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+      double>::type
+  SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const size_t numCategories,
+      const ResponsesType& responses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      double& splitInfo,
+      AuxiliarySplitInfo& aux,
+      FitnessFunction& fitnessFunction);
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return DBL_MAX.  If a split is made, then splitInfo and aux are modified.
+   *
+   * This overload is specialized for any fitness function that implements
+   * BinaryScanInitialize(), BinaryStep() and BinaryGains() functions.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param numCategories Number of categories in the categorical data.
+   * @param responses Responses for each point.
+   * @param weights Weights associated with responses.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   * @param fitnessFunction The FitnessFunction object instance. It is used to
+   *      evaluate the gain for the split.
+   */
+  template<bool UseWeights, typename VecType, typename ResponsesType,
+           typename WeightVecType>
+  static typename std::enable_if<
+      HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+      double>::type
+  SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const size_t numCategories,
+      const ResponsesType& responses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      double& splitInfo,
+      AuxiliarySplitInfo& aux,
+      FitnessFunction& fitnessFunction);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  static size_t NumChildren(const double& /* splitInfo */,
+                            const AuxiliarySplitInfo& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param splitInfo The child of categories not seen when splitting.
+   * @param aux Auxiliary information for the split.
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const double& splitInfo,
+      const AuxiliarySplitInfo& aux);
+
+ private:
+  /**
+   * Sort the points of a regression node by the mean response of their
+   * category, so that the points of each category are contiguous.  Returns
+   * false if the points have fewer than two categories.
+   *
+   * @param data The dimension of data points to check for a split in.
+   * @param numCategories Number of categories in the categorical data.
+   * @param responses Responses for each point.
+   * @param weights Weights associated with responses.
+   * @param categoryOrder Will hold the categories of the points, in order.
+   * @param categoryEnds Will hold the index after the last sorted point of
+   *      each category in categoryOrder.
+   * @param sortedResponses Will hold the sorted responses.
+   * @param sortedWeights Will hold the sorted weights, if UseWeights is true.
+   */
+  template<bool UseWeights, typename VecType, typename ResponsesType,
+           typename WeightVecType>
+  static bool SortByMeanResponse(
+      const VecType& data,
+      const size_t numCategories,
+      const ResponsesType& responses,
+      const WeightVecType& weights,
+      arma::uvec& categoryOrder,
+      arma::uvec& categoryEnds,
+      arma::Row<typename ResponsesType::elem_type>& sortedResponses,
+      arma::Row<typename WeightVecType::elem_type>& sortedWeights);
+
+  /**
+   * Store the given split in aux: the first numLeft categories of
+   * categoryOrder go to the left child, and the other categories in
+   * categoryOrder go to the right child.  All other categories go to the given
+   * default child.
+   */
+  static void SetDirections(const arma::uvec& categoryOrder,
+                            const size_t numLeft,
+                            const size_t numCategories,
+                            const size_t defaultDirection,
+                            AuxiliarySplitInfo& aux);
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "best_binary_categorical_split_impl.hpp"
+
+#endif
@@ -0,0 +1,451 @@
+/**
+ * @file methods/decision_tree/best_binary_categorical_split_impl.hpp
+ *
+ * Implementation of the BestBinaryCategoricalSplit categorical split class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_BEST_BINARY_CATEGORICAL_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_BEST_BINARY_CATEGORICAL_SPLIT_IMPL_HPP
+
+namespace mlpack {
+
+// Overload used for classification.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename LabelsType,
+         typename WeightVecType>
+double BestBinaryCategoricalSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const size_t numCategories,
+    const LabelsType& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    AuxiliarySplitInfo& aux)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Count the number of points and the weight of each class in each category.
+  // Without weights, the class weights are the class counts.
+  arma::Col<size_t> counts(numCategories, arma::fill::zeros);
+  arma::mat classSums(numClasses, numCategories, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t category = (size_t) data[i];
+    ++counts[category];
+    classSums(labels[i], category) += UseWeights ? (double) weights[i] : 1.0;
+  }
+
+  // Only the categories held by points in this node can be partitioned.
+  const arma::uvec present = arma::find(counts > 0);
+  if (present.n_elem < 2)
+    return DBL_MAX;
+
+  const arma::mat presentSums = classSums.cols(present);
+  const arma::rowvec presentWeights = arma::sum(presentSums, 0);
+  const arma::vec totalSums = arma::sum(presentSums, 1);
+  const double totalWeight = arma::accu(presentWeights);
+
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0) *
+      totalWeight;
+  bool improved = false;
+  arma::uvec bestOrder;
+  size_t bestNumLeft = 0;
+  double bestLeftWeight = 0.0;
+
+  // Sort the categories by the fraction of their weight in each class in turn,
+  // and try every split of each order.  With two classes, both orders give the
+  // same splits.
+  const size_t numOrders = (numClasses == 2) ? 1 : numClasses;
+  arma::vec leftSums(numClasses);
+  arma::vec rightSums(numClasses);
+  for (size_t c = 0; c < numOrders; ++c)
+  {
+    // Categories whose points all have zero weight have no class fractions.
+    arma::rowvec fractions = presentSums.row(c) / presentWeights;
+    fractions.replace(arma::datum::nan, 0.0);
+    const arma::uvec order = arma::stable_sort_index(fractions);
+
+    leftSums.zeros();
+    rightSums = totalSums;
+    size_t leftCount = 0;
+    double leftWeight = 0.0;
+    bool perfect = false;
+    for (size_t j = 0; j + 1 < order.n_elem; ++j)
+    {
+      // Move the next category to the left child.
+      const size_t p = order[j];
+      leftSums += presentSums.col(p);
+      rightSums -= presentSums.col(p);
+      leftCount += counts[present[p]];
+      leftWeight += presentWeights[p];
+
+      if (leftCount < minimum || data.n_elem - leftCount < minimum)
+        continue;
+
+      const double rightWeight = totalWeight - leftWeight;
+      const double gain = leftWeight *
+          FitnessFunction::template EvaluatePtr<UseWeights>(leftSums.memptr(),
+              numClasses, leftWeight) + rightWeight *
+          FitnessFunction::template EvaluatePtr<UseWeights>(rightSums.memptr(),
+              numClasses, rightWeight);
+
+      if (gain > bestFoundGain)
+      {
+        bestFoundGain = gain;
+        bestOrder = present.elem(order);
+        bestNumLeft = j + 1;
+        bestLeftWeight = leftWeight;
+        improved = true;
+
+        // If this is the best possible split, no need to keep looking.
+        if (gain >= 0.0)
+        {
+          perfect = true;
+          break;
+        }
+      }
+    }
+
+    if (perfect)
+      break;
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  // Categories not seen here go to the heavier child.
+  const size_t defaultDirection =
+      (bestLeftWeight >= totalWeight - bestLeftWeight) ? 0 : 1;
+  splitInfo.set_size(1);
+  splitInfo[0] = (double) defaultDirection;
+  SetDirections(bestOrder, bestNumLeft, numCategories, defaultDirection, aux);
+
+  return bestFoundGain / totalWeight;
+}
+
+// Overload used for regression.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+typename std::enable_if<
+    !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+    double>::type
+BestBinaryCategoricalSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const size_t numCategories,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& splitInfo,
+    AuxiliarySplitInfo& aux,
+    FitnessFunction& fitnessFunction)
+{
+  typedef typename ResponsesType::elem_type RType;
+  typedef typename WeightVecType::elem_type WType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  arma::uvec categoryOrder, categoryEnds;
+  arma::Row<RType> sortedResponses;
+  arma::Row<WType> sortedWeights;
+  if (!SortByMeanResponse<UseWeights>(data, numCategories, responses, weights,
+      categoryOrder, categoryEnds, sortedResponses, sortedWeights))
+    return DBL_MAX;
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  double totalWeight = (double) data.n_elem;
+  if (UseWeights)
+    totalWeight = (double) arma::accu(sortedWeights);
+  bestFoundGain *= totalWeight;
+
+  size_t bestNumLeft = 0;
+  double bestLeftWeight = 0.0;
+  double leftWeight = 0.0;
+
+  // Loop through the splits between consecutive categories.
+  for (size_t j = 0; j + 1 < categoryOrder.n_elem; ++j)
+  {
+    const size_t start = (j == 0) ? 0 : categoryEnds[j - 1];
+    const size_t index = categoryEnds[j];
+    if (UseWeights)
+      leftWeight += (double) arma::accu(sortedWeights.subvec(start, index - 1));
+    else
+      leftWeight = (double) index;
+
+    if (index < minimum || data.n_elem - index < minimum)
+      continue;
+
+    // Calculate the gain for the left and right child.
+    const double leftGain = fitnessFunction.template
+        Evaluate<UseWeights>(sortedResponses, sortedWeights, 0, index);
+    const double rightGain = fitnessFunction.template
+        Evaluate<UseWeights>(sortedResponses, sortedWeights, index,
+            sortedResponses.n_elem);
+    const double gain = leftWeight * leftGain +
+        (totalWeight - leftWeight) * rightGain;
+
+    if (gain > bestFoundGain)
+    {
+      bestFoundGain = gain;
+      bestNumLeft = j + 1;
+      bestLeftWeight = leftWeight;
+      improved = true;
+
+      // If this is the best possible split, no need to keep looking.
+      if (gain >= 0.0)
+        break;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  // Categories not seen here go to the heavier child.
+  const size_t defaultDirection =
+      (bestLeftWeight >= totalWeight - bestLeftWeight) ? 0 : 1;
+  splitInfo = (double) defaultDirection;
+  SetDirections(categoryOrder, bestNumLeft, numCategories, defaultDirection,
+      aux);
+
+  return bestFoundGain / totalWeight;
+}
+
+// Optimized version for any fitness function that implements
+// BinaryScanInitialize(), BinaryStep() and BinaryGains() functions.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+typename std::enable_if<
+    HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+    double>::type
+BestBinaryCategoricalSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const size_t numCategories,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& splitInfo,
+    AuxiliarySplitInfo& aux,
+    FitnessFunction& fitnessFunction)
+{
+  typedef typename ResponsesType::elem_type RType;
+  typedef typename WeightVecType::elem_type WType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  arma::uvec categoryOrder, categoryEnds;
+  arma::Row<RType> sortedResponses;
+  arma::Row<WType> sortedWeights;
+  if (!SortByMeanResponse<UseWeights>(data, numCategories, responses, weights,
+      categoryOrder, categoryEnds, sortedResponses, sortedWeights))
+    return DBL_MAX;
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  double totalWeight = (double) data.n_elem;
+  double leftChildWeight = 0.0;
+  if (UseWeights)
+  {
+    totalWeight = (double) arma::accu(sortedWeights);
+    for (size_t i = 0; i < minimum - 1; ++i)
+      leftChildWeight += sortedWeights[i];
+  }
+  bestFoundGain *= totalWeight;
+
+  size_t bestNumLeft = 0;
+  double bestLeftWeight = 0.0;
+
+  // Initialize and precompute various statistics to efficiently compute gain
+  // values for all possible splits.
+  fitnessFunction.template BinaryScanInitialize<UseWeights>(sortedResponses,
+      sortedWeights, minimum);
+
+  // Loop through all points, but only evaluate the splits between consecutive
+  // categories.
+  size_t j = 0;
+  for (size_t index = minimum; index < data.n_elem - minimum + 1; ++index)
+  {
+    if (UseWeights)
+      leftChildWeight += sortedWeights[index - 1];
+    else
+      leftChildWeight = (double) index;
+
+    // Steps through the current index and updates the cached data.
+    fitnessFunction.template BinaryStep<UseWeights>(sortedResponses,
+        sortedWeights, index - 1);
+
+    // The last category always ends after index, so j stays in bounds.
+    while (categoryEnds[j] < index)
+      ++j;
+    if (categoryEnds[j] != index)
+      continue;
+
+    // Calculate the gain for the left and right child.
+    std::tuple<double, double> binaryGains = fitnessFunction.BinaryGains();
+    const double leftGain = std::get<0>(binaryGains);
+    const double rightGain = std::get<1>(binaryGains);
+    const double gain = leftChildWeight * leftGain +
+        (totalWeight - leftChildWeight) * rightGain;
+
+    if (gain > bestFoundGain)
+    {
+      bestFoundGain = gain;
+      bestNumLeft = j + 1;
+      bestLeftWeight = leftChildWeight;
+      improved = true;
+
+      // If this is the best possible split, no need to keep looking.
+      if (gain >= 0.0)
+        break;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  // Categories not seen here go to the heavier child.
+  const size_t defaultDirection =
+      (bestLeftWeight >= totalWeight - bestLeftWeight) ? 0 : 1;
+  splitInfo = (double) defaultDirection;
+  SetDirections(categoryOrder, bestNumLeft, numCategories, defaultDirection,
+      aux);
+
+  return bestFoundGain / totalWeight;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t BestBinaryCategoricalSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const double& splitInfo,
+    const AuxiliarySplitInfo& aux)
+{
+  const size_t category = (size_t) point;
+  if (category < aux.categoryDirections.size())
+    return aux.categoryDirections[category] ? 1 : 0;
+
+  // This category was not known when the split was made.
+  return (size_t) splitInfo;
+}
+
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+bool BestBinaryCategoricalSplit<FitnessFunction>::SortByMeanResponse(
+    const VecType& data,
+    const size_t numCategories,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    arma::uvec& categoryOrder,
+    arma::uvec& categoryEnds,
+    arma::Row<typename ResponsesType::elem_type>& sortedResponses,
+    arma::Row<typename WeightVecType::elem_type>& sortedWeights)
+{
+  // Compute the number of points, the weight and the weighted response sum of
+  // each category.
+  arma::uvec counts(numCategories, arma::fill::zeros);
+  arma::vec weightSums(numCategories, arma::fill::zeros);
+  arma::vec responseSums(numCategories, arma::fill::zeros);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t category = (size_t) data[i];
+    const double w = UseWeights ? (double) weights[i] : 1.0;
+    ++counts[category];
+    weightSums[category] += w;
+    responseSums[category] += w * (double) responses[i];
+  }
+
+  const arma::uvec present = arma::find(counts > 0);
+  if (present.n_elem < 2)
+    return false;
+
+  // Categories whose points all have zero weight have no mean; they are put
+  // with the categories whose mean is zero.
+  arma::vec means = responseSums.elem(present) / weightSums.elem(present);
+  means.replace(arma::datum::nan, 0.0);
+  categoryOrder = present.elem(arma::stable_sort_index(means));
+
+  // Now sort the points with a counting sort on the position of their category
+  // in the order.
+  arma::uvec position(numCategories);
+  arma::uvec next(categoryOrder.n_elem);
+  categoryEnds.set_size(categoryOrder.n_elem);
+  size_t end = 0;
+  for (size_t j = 0; j < categoryOrder.n_elem; ++j)
+  {
+    position[categoryOrder[j]] = j;
+    next[j] = end;
+    end += counts[categoryOrder[j]];
+    categoryEnds[j] = end;
+  }
+
+  sortedResponses.set_size(data.n_elem);
+  if (UseWeights)
+    sortedWeights.set_size(data.n_elem);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const size_t j = position[(size_t) data[i]];
+    sortedResponses[next[j]] = responses[i];
+    if (UseWeights)
+      sortedWeights[next[j]] = weights[i];
+    ++next[j];
+  }
+
+  return true;
+}
+
+template<typename FitnessFunction>
+void BestBinaryCategoricalSplit<FitnessFunction>::SetDirections(
+    const arma::uvec& categoryOrder,
+    const size_t numLeft,
+    const size_t numCategories,
+    const size_t defaultDirection,
+    AuxiliarySplitInfo& aux)
+{
+  aux.categoryDirections.assign(numCategories, (defaultDirection == 1));
+  for (size_t j = 0; j < categoryOrder.n_elem; ++j)
+    aux.categoryDirections[categoryOrder[j]] = (j >= numLeft);
+}
+
+} // namespace mlpack
+
+#endif
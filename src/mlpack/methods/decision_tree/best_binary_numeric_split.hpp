@@ -42,14 +42,43 @@ struct HasOptimizedBinarySplitForms
  * The BestBinaryNumericSplit is a splitting function for decision trees that
  * will exhaustively search a numeric dimension for the best binary split.
  *
+ * Missing values (NaN) are handled natively: points with a missing value are
+ * left out of the search for the split point, and each candidate split is
+ * evaluated with all of those points sent to the left child and then to the
+ * right child.  The better direction is stored in the auxiliary split
+ * information, and CalculateDirection() sends points with a missing value that
+ * way.  If the node being split has no missing values in the dimension, points
+ * with a missing value are sent to the child with more training points.  So,
+ * the data does not need to be imputed before training.
+ *
  * @tparam FitnessFunction Fitness function to use to calculate gain.
  */
 template<typename FitnessFunction>
 class BestBinaryNumericSplit
 {
  public:
-  // No extra info needed for split.
-  class AuxiliarySplitInfo { };
+  /**
+   * The auxiliary information of the split holds the child that points with a
+   * missing value are sent to.
+   */
+  class AuxiliarySplitInfo
+  {
+   public:
+    //! Create the auxiliary information.  By default, points with a missing
+    //! value go to the right child.
+    AuxiliarySplitInfo() : missingDirection(1) { }
+
+    //! The child that points with a missing value go to (0 for left, 1 for
+    //! right).
+    size_t missingDirection;
+
+    //! Serialize the auxiliary split information.
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(missingDirection));
+    }
+  };
 
   /**
    * Check if we can split a node.  If we can split a node in a way that
@@ -142,6 +171,8 @@ class BestBinaryNumericSplit
    * @param splitInfo Stores split information on a successful split.
    * @param aux Auxiliary split information, which may be modified on a
    *      successful split.
+   * @param fitnessFunction The FitnessFunction object instance. It is used to
+   *      evaluate the gain for the split.
    */
   template<bool UseWeights, typename VecType, typename ResponsesType,
           typename WeightVecType>
@@ -156,7 +187,7 @@ class BestBinaryNumericSplit
       const size_t minimumLeafSize,
       const double minimumGainSplit,
       double& splitInfo,
-      AuxiliarySplitInfo& /* aux */,
+      AuxiliarySplitInfo& aux,
       FitnessFunction& fitnessFunction);
 
   /**
@@ -173,13 +204,14 @@ class BestBinaryNumericSplit
    *
    * @param point Point to calculate direction of.
    * @param splitInfo Auxiliary information for the split.
-   * @param * (aux) Auxiliary information for the split (Unused).
+   * @param aux Auxiliary information for the split, holding the child of
+   *      points with a missing value.
    */
   template<typename ElemType>
   static size_t CalculateDirection(
       const ElemType& point,
       const double& splitInfo,
-      const AuxiliarySplitInfo& /* aux */);
+      const AuxiliarySplitInfo& aux);
 };
 
 } // namespace mlpack
@@ -26,7 +26,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     arma::vec& splitInfo,
-    AuxiliarySplitInfo& /* aux */)
+    AuxiliarySplitInfo& aux)
 {
   // First sanity check: if we don't have enough points, we can't split.
   if (data.n_elem < (minimumLeafSize * 2))
@@ -34,8 +34,20 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   if (bestGain == 0.0)
     return DBL_MAX; // It can't be outperformed.
 
-  // Next, sort the data.
-  arma::uvec sortedIndices = arma::sort_index(data);
+  // Loop through all possible split points, choosing the best one.  Also, force
+  // a minimum leaf size of 1 (empty children don't make sense).
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // Next, sort the data.  Points with a missing value are not sorted; they are
+  // placed after all other points.
+  arma::uvec sortedIndices;
+  const size_t numMissing = SortIndicesWithMissing(data, sortedIndices);
+  const size_t numPresent = data.n_elem - numMissing;
+  if (numPresent < (minimum * 2))
+    return DBL_MAX;
+
   arma::Row<size_t> sortedLabels(labels.n_elem);
   arma::rowvec sortedWeights;
   for (size_t i = 0; i < sortedLabels.n_elem; ++i)
@@ -43,7 +55,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
 
   // Sanity check: if the first element is the same as the last, we can't split
   // in this dimension.
-  if (data[sortedIndices[0]] == data[sortedIndices[sortedIndices.n_elem - 1]])
+  if (data[sortedIndices[0]] == data[sortedIndices[numPresent - 1]])
     return DBL_MAX;
 
   // Only initialize if we are using weights.
@@ -55,21 +67,19 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       sortedWeights[i] = weights[sortedIndices[i]];
   }
 
-  // Loop through all possible split points, choosing the best one.  Also, force
-  // a minimum leaf size of 1 (empty children don't make sense).
-  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
-  bool improved = false;
-  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
-
-  // We need to count the number of points for each class.
+  // We need to count the number of points for each class.  The columns hold
+  // the counts of the left child, the right child, and the points with a
+  // missing value; the last column is scratch space for
+  // BinaryGainWithMissing().
   arma::Mat<size_t> classCounts;
   arma::mat classWeightSums;
   double totalWeight = 0.0;
   double totalLeftWeight = 0.0;
   double totalRightWeight = 0.0;
+  double totalMissingWeight = 0.0;
   if (UseWeights)
   {
-    classWeightSums.zeros(numClasses, 2);
+    classWeightSums.zeros(numClasses, 4);
     totalWeight = arma::accu(sortedWeights);
     bestFoundGain *= totalWeight;
 
@@ -82,15 +92,21 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     }
 
     // These points have to be on the right.
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < numPresent; ++i)
     {
       classWeightSums(sortedLabels[i], 1) += sortedWeights[i];
       totalRightWeight += sortedWeights[i];
     }
+
+    for (size_t i = numPresent; i < data.n_elem; ++i)
+    {
+      classWeightSums(sortedLabels[i], 2) += sortedWeights[i];
+      totalMissingWeight += sortedWeights[i];
+    }
   }
   else
   {
-    classCounts.zeros(numClasses, 2);
+    classCounts.zeros(numClasses, 4);
     bestFoundGain *= data.n_elem;
 
     // Initialize the counts.
@@ -99,11 +115,14 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       ++classCounts(sortedLabels[i], 0);
 
     // These points have to be on the right.
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < numPresent; ++i)
       ++classCounts(sortedLabels[i], 1);
+
+    for (size_t i = numPresent; i < data.n_elem; ++i)
+      ++classCounts(sortedLabels[i], 2);
   }
 
-  for (size_t index = minimum; index < data.n_elem - minimum; ++index)
+  for (size_t index = minimum; index < numPresent - minimum; ++index)
   {
     // Update class weight sums or counts.
     if (UseWeights)
@@ -123,30 +142,15 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     if (data[sortedIndices[index]] == data[sortedIndices[index - 1]])
       continue;
 
-    // Calculate the gain for the left and right child.  Only use weights if
-    // needed.
-    const double leftGain = UseWeights ?
-        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(0),
-            numClasses, totalLeftWeight) :
-        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(0),
-            numClasses, index);
-    const double rightGain = UseWeights ?
-        FitnessFunction::template EvaluatePtr<true>(classWeightSums.colptr(1),
-            numClasses, totalRightWeight) :
-        FitnessFunction::template EvaluatePtr<false>(classCounts.colptr(1),
-            numClasses, size_t(sortedLabels.n_elem - index));
-
-    double gain;
-    if (UseWeights)
-    {
-      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
-    }
-    else
-    {
-      // Calculate the gain at this split point.
-      gain = double(index) * leftGain +
-          double(sortedLabels.n_elem - index) * rightGain;
-    }
+    // Calculate the gain at this split point, sending the points with a
+    // missing value to the better child.  Only use weights if needed.
+    size_t missingDirection;
+    const double gain = UseWeights ?
+        BinaryGainWithMissing<true, FitnessFunction>(classWeightSums,
+            numClasses, totalLeftWeight, totalRightWeight, totalMissingWeight,
+            missingDirection) :
+        BinaryGainWithMissing<false, FitnessFunction>(classCounts, numClasses,
+            index, numPresent - index, numMissing, missingDirection);
 
     // Corner case: is this the best possible split?
     if (gain >= 0.0)
@@ -157,6 +161,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       splitInfo.set_size(1);
       splitInfo[0] = (data[sortedIndices[index - 1]] +
           data[sortedIndices[index]]) / 2.0;
+      aux.missingDirection = missingDirection;
 
       return gain;
     }
@@ -167,6 +172,7 @@ double BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       splitInfo.set_size(1);
       splitInfo[0] = (data[sortedIndices[index - 1]] +
           data[sortedIndices[index]]) / 2.0;
+      aux.missingDirection = missingDirection;
       improved = true;
     }
   }
@@ -199,7 +205,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     double& splitInfo,
-    AuxiliarySplitInfo& /* aux */,
+    AuxiliarySplitInfo& aux,
     FitnessFunction& fitnessFunction)
 {
   typedef typename ResponsesType::elem_type RType;
@@ -211,8 +217,19 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   if (bestGain == 0.0)
     return DBL_MAX; // It can't be outperformed.
 
-  // Next, sort the data.
-  arma::uvec sortedIndices = arma::sort_index(data);
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // Next, sort the data.  Points with a missing value are not sorted; they are
+  // placed after all other points.
+  arma::uvec sortedIndices;
+  const size_t numMissing = SortIndicesWithMissing(data, sortedIndices);
+  const size_t numPresent = data.n_elem - numMissing;
+  if (numPresent < (minimum * 2))
+    return DBL_MAX;
+
   arma::Row<RType> sortedResponses(responses.n_elem);
   arma::Row<WType> sortedWeights;
   for (size_t i = 0; i < sortedResponses.n_elem; ++i)
@@ -220,7 +237,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
 
   // Sanity check: if the first element is the same as the last, we can't split
   // in this dimension.
-  if (data[sortedIndices[0]] == data[sortedIndices[sortedIndices.n_elem - 1]])
+  if (data[sortedIndices[0]] == data[sortedIndices[numPresent - 1]])
     return DBL_MAX;
 
   // Only initialize if we are using weights.
@@ -232,14 +249,26 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       sortedWeights[i] = weights[sortedIndices[i]];
   }
 
-  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
-  bool improved = false;
-  // Force a minimum leaf size of 1 (empty children don't make sense).
-  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+  // To send the points with a missing value to the left child, the fitness
+  // function needs them before the other points, so that each child is still
+  // a contiguous range.
+  arma::Row<RType> missingFirstResponses;
+  arma::Row<WType> missingFirstWeights;
+  if (numMissing > 0)
+  {
+    missingFirstResponses = arma::join_rows(
+        sortedResponses.tail(numMissing), sortedResponses.head(numPresent));
+    if (UseWeights)
+    {
+      missingFirstWeights = arma::join_rows(sortedWeights.tail(numMissing),
+          sortedWeights.head(numPresent));
+    }
+  }
 
   WType totalWeight = 0.0;
   WType totalLeftWeight = 0.0;
   WType totalRightWeight = 0.0;
+  WType totalMissingWeight = 0.0;
 
   if (UseWeights)
   {
@@ -249,8 +278,11 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     for (size_t i = 0; i < minimum - 1; ++i)
       totalLeftWeight += sortedWeights[i];
 
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < numPresent; ++i)
       totalRightWeight += sortedWeights[i];
+
+    for (size_t i = numPresent; i < data.n_elem; ++i)
+      totalMissingWeight += sortedWeights[i];
   }
   else
   {
@@ -258,7 +290,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   }
 
   // Loop through all possible split points, choosing the best one.
-  for (size_t index = minimum; index < data.n_elem - minimum + 1; ++index)
+  for (size_t index = minimum; index < numPresent - minimum + 1; ++index)
   {
     if (UseWeights)
     {
@@ -269,7 +301,8 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     if (data[sortedIndices[index]] == data[sortedIndices[index - 1]])
       continue;
 
-    // Calculate the gain for the left and right child.
+    // Calculate the gain for the left and right child, with the points with a
+    // missing value (if any) in the right child.
     const double leftGain = fitnessFunction.template
         Evaluate<UseWeights>(sortedResponses, sortedWeights, 0, index);
     const double rightGain = fitnessFunction.template
@@ -279,7 +312,8 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     double gain;
     if (UseWeights)
     {
-      gain = totalLeftWeight * leftGain + totalRightWeight * rightGain;
+      gain = totalLeftWeight * leftGain +
+          (totalRightWeight + totalMissingWeight) * rightGain;
     }
     else
     {
@@ -288,6 +322,35 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
           double(sortedResponses.n_elem - index) * rightGain;
     }
 
+    // The points with a missing value go to the right child, unless they
+    // do better in the left child.  If there are none, points with a missing
+    // value at prediction time go to the child with more points.
+    size_t missingDirection = 1;
+    if (numMissing > 0)
+    {
+      const double missingLeftGain = fitnessFunction.template
+          Evaluate<UseWeights>(missingFirstResponses, missingFirstWeights, 0,
+              numMissing + index);
+      const double missingRightGain = fitnessFunction.template
+          Evaluate<UseWeights>(missingFirstResponses, missingFirstWeights,
+              numMissing + index, responses.n_elem);
+      const double missingGain = UseWeights ?
+          (totalLeftWeight + totalMissingWeight) * missingLeftGain +
+              totalRightWeight * missingRightGain :
+          double(numMissing + index) * missingLeftGain +
+              double(numPresent - index) * missingRightGain;
+      if (missingGain > gain)
+      {
+        gain = missingGain;
+        missingDirection = 0;
+      }
+    }
+    else if (UseWeights ? (totalLeftWeight > totalRightWeight) :
+        (index > numPresent - index))
+    {
+      missingDirection = 0;
+    }
+
     // Corner case: is this the best possible split?
     if (gain >= 0.0)
     {
@@ -296,15 +359,17 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       // value at index - 1 and index.
       splitInfo = (data[sortedIndices[index - 1]] +
           data[sortedIndices[index]]) / 2.0;
+      aux.missingDirection = missingDirection;
 
       return gain;
     }
-     if (gain > bestFoundGain)
+    if (gain > bestFoundGain)
     {
       // We still have a better split.
       bestFoundGain = gain;
       splitInfo = (data[sortedIndices[index - 1]] +
           data[sortedIndices[index]]) / 2.0;
+      aux.missingDirection = missingDirection;
       improved = true;
     }
   }
@@ -338,7 +403,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     double& splitInfo,
-    AuxiliarySplitInfo& /* aux */,
+    AuxiliarySplitInfo& aux,
     FitnessFunction& fitnessFunction)
 {
   typedef typename ResponsesType::elem_type RType;
@@ -350,8 +415,19 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   if (bestGain == 0.0)
     return DBL_MAX; // It can't be outperformed.
 
-  // Next, sort the data.
-  arma::uvec sortedIndices = arma::sort_index(data);
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // Next, sort the data.  Points with a missing value are not sorted; they are
+  // placed after all other points.
+  arma::uvec sortedIndices;
+  const size_t numMissing = SortIndicesWithMissing(data, sortedIndices);
+  const size_t numPresent = data.n_elem - numMissing;
+  if (numPresent < (minimum * 2))
+    return DBL_MAX;
+
   arma::Row<RType> sortedResponses(responses.n_elem);
   arma::Row<WType> sortedWeights;
   for (size_t i = 0; i < sortedResponses.n_elem; ++i)
@@ -359,7 +435,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
 
   // Sanity check: if the first element is the same as the last, we can't split
   // in this dimension.
-  if (data[sortedIndices[0]] == data[sortedIndices[sortedIndices.n_elem - 1]])
+  if (data[sortedIndices[0]] == data[sortedIndices[numPresent - 1]])
     return DBL_MAX;
 
   // Only initialize if we are using weights.
@@ -371,14 +447,10 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       sortedWeights[i] = weights[sortedIndices[i]];
   }
 
-  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
-  bool improved = false;
-  // Force a minimum leaf size of 1 (empty children don't make sense).
-  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
-
   WType totalWeight = 0.0;
   WType leftChildWeight = 0.0;
   WType rightChildWeight = 0.0;
+  WType missingWeight = 0.0;
 
   if (UseWeights)
   {
@@ -388,8 +460,11 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     for (size_t i = 0; i < minimum - 1; ++i)
       leftChildWeight += sortedWeights[i];
 
-    for (size_t i = minimum - 1; i < data.n_elem; ++i)
+    for (size_t i = minimum - 1; i < numPresent; ++i)
       rightChildWeight += sortedWeights[i];
+
+    for (size_t i = numPresent; i < data.n_elem; ++i)
+      missingWeight += sortedWeights[i];
   }
   else
   {
@@ -397,12 +472,32 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
   }
 
   // Initialize and precompute various statistics to efficiently compute gain
-  // values for all possible splits.
+  // values for all possible splits.  The points with a missing value (if any)
+  // are at the end, so they are in the right child.
   fitnessFunction.template BinaryScanInitialize<UseWeights>(sortedResponses,
       sortedWeights, minimum);
 
+  // A second scan keeps the points with a missing value in the left child, by
+  // placing them before all other points.
+  FitnessFunction missingLeftFitness(fitnessFunction);
+  arma::Row<RType> missingFirstResponses;
+  arma::Row<WType> missingFirstWeights;
+  if (numMissing > 0)
+  {
+    missingFirstResponses = arma::join_rows(
+        sortedResponses.tail(numMissing), sortedResponses.head(numPresent));
+    if (UseWeights)
+    {
+      missingFirstWeights = arma::join_rows(sortedWeights.tail(numMissing),
+          sortedWeights.head(numPresent));
+    }
+
+    missingLeftFitness.template BinaryScanInitialize<UseWeights>(
+        missingFirstResponses, missingFirstWeights, numMissing + minimum);
+  }
+
   // Loop through all possible split points, choosing the best one.
-  for (size_t index = minimum; index < data.n_elem - minimum + 1; ++index)
+  for (size_t index = minimum; index < numPresent - minimum + 1; ++index)
   {
     if (UseWeights)
     {
@@ -413,6 +508,11 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     // Steps through the current index and updates the cached data.
     fitnessFunction.template BinaryStep<UseWeights>(sortedResponses,
         sortedWeights, index - 1);
+    if (numMissing > 0)
+    {
+      missingLeftFitness.template BinaryStep<UseWeights>(
+          missingFirstResponses, missingFirstWeights, numMissing + index - 1);
+    }
 
     // Make sure that the value has changed.
     if (data[sortedIndices[index]] == data[sortedIndices[index - 1]])
@@ -426,7 +526,8 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
     double gain;
     if (UseWeights)
     {
-      gain = leftChildWeight * leftGain + rightChildWeight * rightGain;
+      gain = leftChildWeight * leftGain +
+          (rightChildWeight + missingWeight) * rightGain;
     }
     else
     {
@@ -435,6 +536,30 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
           double(sortedResponses.n_elem - index) * rightGain;
     }
 
+    // The points with a missing value go to the right child, unless they
+    // do better in the left child.  If there are none, points with a missing
+    // value at prediction time go to the child with more points.
+    size_t missingDirection = 1;
+    if (numMissing > 0)
+    {
+      binaryGains = missingLeftFitness.BinaryGains();
+      const double missingGain = UseWeights ?
+          (leftChildWeight + missingWeight) * std::get<0>(binaryGains) +
+              rightChildWeight * std::get<1>(binaryGains) :
+          double(numMissing + index) * std::get<0>(binaryGains) +
+              double(numPresent - index) * std::get<1>(binaryGains);
+      if (missingGain > gain)
+      {
+        gain = missingGain;
+        missingDirection = 0;
+      }
+    }
+    else if (UseWeights ? (leftChildWeight > rightChildWeight) :
+        (index > numPresent - index))
+    {
+      missingDirection = 0;
+    }
+
     // Corner case: is this the best possible split?
     if (gain >= 0.0)
     {
@@ -443,6 +568,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       // value at index - 1 and index.
       splitInfo = (data[sortedIndices[index - 1]] +
           data[sortedIndices[index]]) / 2.0;
+      aux.missingDirection = missingDirection;
 
       return gain;
     }
@@ -452,6 +578,7 @@ BestBinaryNumericSplit<FitnessFunction>::SplitIfBetter(
       bestFoundGain = gain;
       splitInfo = (data[sortedIndices[index - 1]] +
           data[sortedIndices[index]]) / 2.0;
+      aux.missingDirection = missingDirection;
       improved = true;
     }
   }
@@ -473,9 +600,12 @@ template<typename ElemType>
 size_t BestBinaryNumericSplit<FitnessFunction>::CalculateDirection(
     const ElemType& point,
     const double& splitInfo,
-    const AuxiliarySplitInfo& /* aux */)
+    const AuxiliarySplitInfo& aux)
 {
-  if (point <= splitInfo)
+  // Points with a missing value go to the child learned during training.
+  if (std::isnan((double) point))
+    return aux.missingDirection;
+  else if (point <= splitInfo)
     return 0; // Go left.
   else
     return 1; // Go right.
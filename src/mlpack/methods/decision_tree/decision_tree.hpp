@@ -22,8 +22,10 @@
 
 #include "best_binary_numeric_split.hpp"
 #include "random_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
 
 #include "all_categorical_split.hpp"
+#include "best_binary_categorical_split.hpp"
 
 #include "all_dimension_select.hpp"
 #include "random_dimension_select.hpp"
@@ -37,6 +39,14 @@ namespace mlpack {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * When OpenMP is enabled, a single tree is trained in parallel: for large
+ * nodes, the candidate dimensions of the split search are evaluated in
+ * separate OpenMP tasks, and the children are trained in separate tasks.  With
+ * a deterministic dimension selector (such as AllDimensionSelect), the trained
+ * tree is the same as with a single thread.  If the tree is trained inside an
+ * existing parallel region (as in RandomForest), its tasks are run by the
+ * threads of that region.
  */
 template<typename FitnessFunction = GiniGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -404,6 +414,129 @@ class DecisionTree :
                const std::enable_if_t<arma::is_arma_type<typename
                    std::remove_reference<WeightsType>::type>::value>* = 0);
 
+  /**
+   * Train the decision tree on the points of the given data with the given
+   * indices.  The data is not copied or modified; instead, the list of indices
+   * is reordered as the points are assigned to nodes.  An index may appear more
+   * than once (as in a bootstrap sample), in which case the point is used once
+   * for every time it appears.  This will overwrite the existing model.  The
+   * data may have numeric and categorical types, specified by the datasetInfo
+   * parameter.
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Type information for each dimension.
+   * @param indices Indices of the points in the dataset to train on.
+   * @param labels Labels for each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const data::DatasetInfo& datasetInfo,
+               arma::uvec indices,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Train the decision tree on the points of the given data with the given
+   * indices, assuming that all dimensions are numeric.  The data is not copied
+   * or modified; an index may appear more than once.  This will overwrite the
+   * existing model.
+   *
+   * @param data Dataset to train on.
+   * @param indices Indices of the points in the dataset to train on.
+   * @param labels Labels for each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               arma::uvec indices,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType());
+
+  /**
+   * Train the decision tree on the weighted points of the given data with the
+   * given indices.  The data is not copied or modified; an index may appear
+   * more than once.  This will overwrite the existing model.  The data may have
+   * numeric and categorical types, specified by the datasetInfo parameter.
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Type information for each dimension.
+   * @param indices Indices of the points in the dataset to train on.
+   * @param labels Labels for each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of each point in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType, typename WeightsType>
+  double Train(const MatType& data,
+               const data::DatasetInfo& datasetInfo,
+               arma::uvec indices,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const WeightsType& weights,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType(),
+               const std::enable_if_t<
+                   arma::is_arma_type<WeightsType>::value>* = 0);
+
+  /**
+   * Train the decision tree on the weighted points of the given data with the
+   * given indices, assuming that all dimensions are numeric.  The data is not
+   * copied or modified; an index may appear more than once.  This will
+   * overwrite the existing model.
+   *
+   * @param data Dataset to train on.
+   * @param indices Indices of the points in the dataset to train on.
+   * @param labels Labels for each point in the dataset.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights of each point in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType, typename WeightsType>
+  double Train(const MatType& data,
+               arma::uvec indices,
+               const arma::Row<size_t>& labels,
+               const size_t numClasses,
+               const WeightsType& weights,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType(),
+               const std::enable_if_t<
+                   arma::is_arma_type<WeightsType>::value>* = 0);
+
   /**
    * Classify the given point, using the entire tree.  The predicted label is
    * returned.
@@ -457,7 +590,7 @@ class DecisionTree :
    * Serialize the tree.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
   //! Get the number of children.
   size_t NumChildren() const { return children.size(); }
@@ -470,6 +603,12 @@ class DecisionTree :
   //! Get the split dimension (only meaningful if this is a non-leaf in a
   //! trained tree).
   size_t SplitDimension() const { return splitDimension; }
+  //! Get the type of the split dimension (only meaningful if this is a
+  //! non-leaf in a trained tree).
+  data::Datatype SplitDimensionType() const
+  {
+    return (data::Datatype) dimensionType;
+  }
 
   //! Get the class probabilities, if this is a leaf node in the trained tree.
   //! Note that if this is not a leaf, then this may contain arbitrary
@@ -536,8 +675,10 @@ class DecisionTree :
    * train children.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param indices Indices of the points in the dataset; the points of this
+   *      node are reordered so that the points of each child are contiguous.
+   * @param begin Index of the first element of indices that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param datasetInfo Type information for each dimension.
    * @param labels Labels for each training point.
@@ -548,13 +689,14 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType, typename WeightsType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::uvec& indices,
                const size_t begin,
                const size_t count,
                const data::DatasetInfo& datasetInfo,
-               arma::Row<size_t>& labels,
+               const arma::Row<size_t>& labels,
                const size_t numClasses,
-               WeightsType& weights,
+               const WeightsType& weights,
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
@@ -566,8 +708,10 @@ class DecisionTree :
    * training children.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param indices Indices of the points in the dataset; the points of this
+   *      node are reordered so that the points of each child are contiguous.
+   * @param begin Index of the first element of indices that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param labels Labels for each training point.
    * @param numClasses Number of classes in the dataset.
@@ -577,12 +721,13 @@ class DecisionTree :
    * @return The final entropy of decision tree.
    */
   template<bool UseWeights, typename MatType, typename WeightsType>
-  double Train(MatType& data,
+  double Train(const MatType& data,
+               arma::uvec& indices,
                const size_t begin,
                const size_t count,
-               arma::Row<size_t>& labels,
+               const arma::Row<size_t>& labels,
                const size_t numClasses,
-               WeightsType& weights,
+               const WeightsType& weights,
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
@@ -613,6 +758,13 @@ typedef DecisionTree<InformationGain,
                      true> ID3DecisionStump;
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename DimensionSelectionType, bool NoRecursion),
+    (mlpack::DecisionTree<FitnessFunction, NumericSplitType,
+        CategoricalSplitType, DimensionSelectionType, NoRecursion>), (1));
+
 // Include implementation.
 #include "decision_tree_impl.hpp"
 
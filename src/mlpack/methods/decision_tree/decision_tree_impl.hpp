@@ -13,6 +13,7 @@
 #define MLPACK_METHODS_DECISION_TREE_DECISION_TREE_IMPL_HPP
 
 #include "decision_tree.hpp"
+#include "utils.hpp"
 
 namespace mlpack {
 
@@ -47,10 +48,14 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  Train<false>(tmpData, indices, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -84,10 +89,15 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, weights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  Train<false>(tmpData, indices, 0, tmpData.n_cols, tmpLabels, numClasses,
+      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct and train with weights.
@@ -126,9 +136,13 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -167,9 +181,14 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, tmpLabels, numClasses,
+      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct and train with weights.
@@ -206,9 +225,13 @@ DecisionTree<FitnessFunction,
   TrueLabelsType tmpLabels(std::move(labels));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels, numClasses,
-              tmpWeights, minimumLeafSize, minimumGainSplit);
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, datasetInfo, tmpLabels,
+      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
 //! Construct and train with weights.
@@ -250,9 +273,14 @@ DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses, tmpWeights,
-      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, tmpLabels, numClasses,
+      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
 }
 
 //! Construct, don't train.
@@ -468,11 +496,15 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
-      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+  return Train<false>(tmpData, indices, 0, tmpData.n_cols, datasetInfo,
+      tmpLabels, numClasses, weights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
 }
 
 //! Train on the given data, assuming all dimensions are numeric.
@@ -508,10 +540,14 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
-      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  return Train<false>(tmpData, indices, 0, tmpData.n_cols, tmpLabels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
@@ -556,10 +592,14 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpLabels,
-      numClasses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
-      dimensionSelector);
+  return Train<true>(tmpData, indices, 0, tmpData.n_cols, datasetInfo,
+      tmpLabels, numClasses, tmpWeights, minimumLeafSize, minimumGainSplit,
+      maximumDepth, dimensionSelector);
 }
 
 //! Train on the given weighted data.
@@ -602,12 +642,163 @@ double DecisionTree<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, tmpLabels, numClasses,
+  return Train<true>(tmpData, indices, 0, tmpData.n_cols, tmpLabels, numClasses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
 
+//! Train on the given subset of the data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    arma::uvec indices,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(data, labels, "DecisionTree::Train()");
+  CheckIndices(data, indices, "DecisionTree::Train()");
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  arma::rowvec weights; // Fake weights, not used.
+  return Train<false>(data, indices, 0, indices.n_elem, datasetInfo, labels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
+}
+
+//! Train on the given subset of the data, assuming all dimensions are numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename MatType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    arma::uvec indices,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(data, labels, "DecisionTree::Train()");
+  CheckIndices(data, indices, "DecisionTree::Train()");
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  arma::rowvec weights; // Fake weights, not used.
+  return Train<false>(data, indices, 0, indices.n_elem, labels, numClasses,
+      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
+}
+
+//! Train on the given weighted subset of the data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename MatType, typename WeightsType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    arma::uvec indices,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightsType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector,
+    const std::enable_if_t<arma::is_arma_type<WeightsType>::value>*)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(data, labels, "DecisionTree::Train()");
+  util::CheckSameSizes(data, weights, "DecisionTree::Train()", "weights");
+  CheckIndices(data, indices, "DecisionTree::Train()");
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  return Train<true>(data, indices, 0, indices.n_elem, datasetInfo, labels,
+      numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
+}
+
+//! Train on the given weighted subset of the data, assuming all dimensions are
+//! numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename MatType, typename WeightsType>
+double DecisionTree<FitnessFunction,
+                    NumericSplitType,
+                    CategoricalSplitType,
+                    DimensionSelectionType,
+                    NoRecursion>::Train(
+    const MatType& data,
+    arma::uvec indices,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightsType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector,
+    const std::enable_if_t<arma::is_arma_type<WeightsType>::value>*)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(data, labels, "DecisionTree::Train()");
+  util::CheckSameSizes(data, weights, "DecisionTree::Train()", "weights");
+  CheckIndices(data, indices, "DecisionTree::Train()");
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  return Train<true>(data, indices, 0, indices.n_elem, labels, numClasses,
+      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector);
+}
+
 //! Train on the given data, assuming all dimensions are numeric.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
@@ -620,66 +811,151 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     NoRecursion>::Train(
-    MatType& data,
+    const MatType& data,
+    arma::uvec& indices,
     const size_t begin,
     const size_t count,
     const data::DatasetInfo& datasetInfo,
-    arma::Row<size_t>& labels,
+    const arma::Row<size_t>& labels,
     const size_t numClasses,
-    WeightsType& weights,
+    const WeightsType& weights,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
     DimensionSelectionType& dimensionSelector)
 {
+  // If we are not yet inside a parallel region, open one so that the split
+  // search and the children of this tree can be handled by OpenMP tasks.
+  if (OpenParallelNodeTraining(count))
+  {
+    double gain = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = Train<UseWeights>(data, indices, begin, count, datasetInfo, labels,
+          numClasses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector);
+    }
+    return gain;
+  }
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
   children.clear();
 
+  // Gather the labels (and weights) of the points in this node, so that the
+  // fitness function and the splitters see contiguous vectors.
+  arma::Row<size_t> nodeLabels =
+      labels.cols(indices.subvec(begin, begin + count - 1));
+  WeightsType nodeWeights;
+  if (UseWeights)
+    nodeWeights = weights.cols(indices.subvec(begin, begin + count - 1));
+
+  // Evaluate the split of dimension i, if it is better than the given gain.
+  auto splitIfBetter = [&](const size_t i,
+                           const double gain,
+                           arma::vec& splitInfo,
+                           NumericAuxiliarySplitInfo& numericAux,
+                           CategoricalAuxiliarySplitInfo& categoricalAux)
+  {
+    // Gather the values of dimension i for the points in this node.
+    arma::Row<typename MatType::elem_type> values(count);
+    for (size_t j = 0; j < count; ++j)
+      values[j] = data(i, indices[begin + j]);
+
+    double dimGain = DBL_MAX;
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(gain,
+          values,
+          datasetInfo.NumMappings(i),
+          nodeLabels,
+          numClasses,
+          nodeWeights,
+          minimumLeafSize,
+          minimumGainSplit,
+          splitInfo,
+          categoricalAux);
+    }
+    else if (datasetInfo.Type(i) == data::Datatype::numeric)
+    {
+      dimGain = NumericSplit::template SplitIfBetter<UseWeights>(gain,
+          values,
+          nodeLabels,
+          numClasses,
+          nodeWeights,
+          minimumLeafSize,
+          minimumGainSplit,
+          splitInfo,
+          numericAux);
+    }
+
+    return dimGain;
+  };
+
   // Look through the list of dimensions and obtain the gain of the best split.
   // We'll cache the best numeric and categorical split auxiliary information in
   // numericAux and categoricalAux (and clear them later if we make no split),
   // and use classProbabilities as auxiliary information.  Later we'll overwrite
   // classProbabilities to the empirical class probabilities if we do not split.
-  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
-      labels.subvec(begin, begin + count - 1),
-      numClasses,
-      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  double bestGain = FitnessFunction::template Evaluate<UseWeights>(nodeLabels,
+      numClasses, nodeWeights);
   size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
   const size_t end = dimensionSelector.End();
 
-  if (maximumDepth != 1)
+  if (maximumDepth != 1 && UseParallelNodeTraining(count))
   {
+    // Collect the candidate dimensions first, so that the dimension selector is
+    // used in the same way as in the serial search.
+    std::vector<size_t> dims;
     for (size_t i = dimensionSelector.Begin(); i != end;
          i = dimensionSelector.Next())
+      dims.push_back(i);
+
+    // Evaluate each dimension against the gain of this node in its own task,
+    // with its own split information.
+    std::vector<double> dimGains(dims.size());
+    std::vector<arma::vec> splitInfos(dims.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAuxs(dims.size());
+    std::vector<CategoricalAuxiliarySplitInfo> categoricalAuxs(dims.size());
+    for (size_t d = 0; d < dims.size(); ++d)
     {
-      double dimGain = -DBL_MAX;
-      if (datasetInfo.Type(i) == data::Datatype::categorical)
-      {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            datasetInfo.NumMappings(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
-      }
-      else if (datasetInfo.Type(i) == data::Datatype::numeric)
-      {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            labels.subvec(begin, begin + count - 1),
-            numClasses,
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            classProbabilities,
-            *this);
-      }
+      #pragma omp task default(shared) firstprivate(d)
+      dimGains[d] = splitIfBetter(dims[d], bestGain, splitInfos[d],
+          numericAuxs[d], categoricalAuxs[d]);
+    }
+    #pragma omp taskwait
+
+    // Now pick the split that the serial search would have picked: a dimension
+    // is only taken if it improves on the best split of the dimensions before
+    // it (or if it is perfect).
+    for (size_t d = 0; d < dims.size(); ++d)
+    {
+      if (dimGains[d] == DBL_MAX || (dimGains[d] < 0.0 &&
+          dimGains[d] <= std::min(bestGain + minimumGainSplit, 0.0)))
+        continue;
+
+      bestDim = dims[d];
+      bestGain = dimGains[d];
+      classProbabilities = std::move(splitInfos[d]);
+      if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+        CategoricalAuxiliarySplitInfo::operator=(categoricalAuxs[d]);
+      else
+        NumericAuxiliarySplitInfo::operator=(numericAuxs[d]);
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+  }
+  else if (maximumDepth != 1)
+  {
+    for (size_t i = dimensionSelector.Begin(); i != end;
+         i = dimensionSelector.Next())
+    {
+      const double dimGain = splitIfBetter(i, bestGain, classProbabilities,
+          *this, *this);
 
       // If the splitter reported that it did not split, move to the next
       // dimension.
@@ -702,6 +978,13 @@ double DecisionTree<FitnessFunction,
     dimensionType = (size_t) datasetInfo.Type(bestDim);
     splitDimension = bestDim;
 
+    // Only keep the auxiliary information of the split that was made; the
+    // other one may hold a split of an earlier dimension.
+    if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+      NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    else
+      CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+
     // Get the number of children we will have.
     size_t numChildren = 0;
     if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
@@ -715,14 +998,14 @@ double DecisionTree<FitnessFunction,
     {
       for (size_t j = begin; j < begin + count; ++j)
         childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities[0], *this);
+            data(bestDim, indices[j]), classProbabilities[0], *this);
     }
     else
     {
       for (size_t j = begin; j < begin + count; ++j)
       {
         childAssignments[j - begin] = NumericSplit::CalculateDirection(
-            data(bestDim, j), classProbabilities[0], *this);
+            data(bestDim, indices[j]), classProbabilities[0], *this);
       }
     }
 
@@ -731,49 +1014,55 @@ double DecisionTree<FitnessFunction,
     for (size_t i = begin; i < begin + count; ++i)
       childCounts[childAssignments[i - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
-
     // Split into children.
+    arma::Row<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          labels.swap_cols(currentCol, j);
-          if (UseWeights)
-            weights.swap_cols(currentCol, j);
+          std::swap(indices[currentCol], indices[j]);
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
-      }
-      else
+    // The gathered labels and weights of this node are not needed anymore, so
+    // free them before the (possibly deep) recursion.
+    nodeLabels.reset();
+    nodeWeights.reset();
+    childAssignments.reset();
+
+    // Now build the children recursively.  The children hold disjoint ranges
+    // of the index list, so each can be trained in its own task, with its own
+    // copy of the dimension selector.
+    const bool parallel = UseParallelNodeTraining(count);
+    arma::vec childGains(numChildren, arma::fill::zeros);
+    for (size_t i = 0; i < numChildren; ++i)
+      children.push_back(new DecisionTree());
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      #pragma omp task default(shared) firstprivate(i) if(parallel)
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, labels, numClasses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        DimensionSelectionType childDimensionSelector(dimensionSelector);
+        childGains[i] = children[i]->Train<UseWeights>(data, indices,
+            childBegins[i], childCounts[i], datasetInfo, labels, numClasses,
+            weights, NoRecursion ? childCounts[i] : minimumLeafSize,
+            minimumGainSplit, maximumDepth - 1, childDimensionSelector);
       }
-      children.push_back(child);
+    }
+    #pragma omp taskwait
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      bestGain = 0.0;
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -783,10 +1072,8 @@ double DecisionTree<FitnessFunction,
     CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
 
     // Calculate class probabilities because we are a leaf.
-    CalculateClassProbabilities<UseWeights>(
-        labels.subvec(begin, begin + count - 1),
-        numClasses,
-        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+    CalculateClassProbabilities<UseWeights>(nodeLabels, numClasses,
+        nodeWeights);
   }
 
   return -bestGain;
@@ -804,53 +1091,129 @@ double DecisionTree<FitnessFunction,
                     CategoricalSplitType,
                     DimensionSelectionType,
                     NoRecursion>::Train(
-    MatType& data,
+    const MatType& data,
+    arma::uvec& indices,
     const size_t begin,
     const size_t count,
-    arma::Row<size_t>& labels,
+    const arma::Row<size_t>& labels,
     const size_t numClasses,
-    WeightsType& weights,
+    const WeightsType& weights,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
     DimensionSelectionType& dimensionSelector)
 {
+  // If we are not yet inside a parallel region, open one so that the split
+  // search and the children of this tree can be handled by OpenMP tasks.
+  if (OpenParallelNodeTraining(count))
+  {
+    double gain = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = Train<UseWeights>(data, indices, begin, count, labels, numClasses,
+          weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector);
+    }
+    return gain;
+  }
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
   children.clear();
 
+  // Gather the labels (and weights) of the points in this node, so that the
+  // fitness function and the splitters see contiguous vectors.
+  arma::Row<size_t> nodeLabels =
+      labels.cols(indices.subvec(begin, begin + count - 1));
+  WeightsType nodeWeights;
+  if (UseWeights)
+    nodeWeights = weights.cols(indices.subvec(begin, begin + count - 1));
+
   // We won't be using these members, so reset them.
   CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
 
+  // Evaluate the split of dimension i, if it is better than the given gain.
+  auto splitIfBetter = [&](const size_t i,
+                           const double gain,
+                           arma::vec& splitInfo,
+                           NumericAuxiliarySplitInfo& numericAux)
+  {
+    // Gather the values of dimension i for the points in this node.
+    arma::Row<typename MatType::elem_type> values(count);
+    for (size_t j = 0; j < count; ++j)
+      values[j] = data(i, indices[begin + j]);
+
+    return NumericSplitType<FitnessFunction>::template
+        SplitIfBetter<UseWeights>(gain,
+                                  values,
+                                  nodeLabels,
+                                  numClasses,
+                                  nodeWeights,
+                                  minimumLeafSize,
+                                  minimumGainSplit,
+                                  splitInfo,
+                                  numericAux);
+  };
+
   // Look through the list of dimensions and obtain the best split.  We'll cache
   // the best numeric split auxiliary information in numericAux (and clear it
   // later if we don't make a split), and use classProbabilities as auxiliary
   // information.  Later we'll overwrite classProbabilities to the empirical
   // class probabilities if we do not split.
-  double bestGain = FitnessFunction::template Evaluate<UseWeights>(
-      labels.subvec(begin, begin + count - 1),
-      numClasses,
-      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+  double bestGain = FitnessFunction::template Evaluate<UseWeights>(nodeLabels,
+      numClasses, nodeWeights);
   size_t bestDim = data.n_rows; // This means "no split".
 
-  if (maximumDepth != 1)
+  if (maximumDepth != 1 && UseParallelNodeTraining(count))
+  {
+    // Collect the candidate dimensions first, so that the dimension selector is
+    // used in the same way as in the serial search.
+    std::vector<size_t> dims;
+    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+         i = dimensionSelector.Next())
+      dims.push_back(i);
+
+    // Evaluate each dimension against the gain of this node in its own task,
+    // with its own split information.
+    std::vector<double> dimGains(dims.size());
+    std::vector<arma::vec> splitInfos(dims.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAuxs(dims.size());
+    for (size_t d = 0; d < dims.size(); ++d)
+    {
+      #pragma omp task default(shared) firstprivate(d)
+      dimGains[d] = splitIfBetter(dims[d], bestGain, splitInfos[d],
+          numericAuxs[d]);
+    }
+    #pragma omp taskwait
+
+    // Now pick the split that the serial search would have picked: a dimension
+    // is only taken if it improves on the best split of the dimensions before
+    // it (or if it is perfect).
+    for (size_t d = 0; d < dims.size(); ++d)
+    {
+      if (dimGains[d] == DBL_MAX || (dimGains[d] < 0.0 &&
+          dimGains[d] <= std::min(bestGain + minimumGainSplit, 0.0)))
+        continue;
+
+      bestDim = dims[d];
+      bestGain = dimGains[d];
+      classProbabilities = std::move(splitInfos[d]);
+      NumericAuxiliarySplitInfo::operator=(numericAuxs[d]);
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+  }
+  else if (maximumDepth != 1)
   {
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
     {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
-                                    labels.cols(begin, begin + count - 1),
-                                    numClasses,
-                                    UseWeights ?
-                                        weights.cols(begin, begin + count - 1) :
-                                        weights,
-                                    minimumLeafSize,
-                                    minimumGainSplit,
-                                    classProbabilities,
-                                    *this);
+      const double dimGain = splitIfBetter(i, bestGain, classProbabilities,
+          *this);
 
       // If the splitter did not report that it improved, then move to the next
       // dimension.
@@ -881,7 +1244,7 @@ double DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
     {
       childAssignments[j - begin] = NumericSplit::CalculateDirection(
-          data(bestDim, j), classProbabilities[0], *this);
+          data(bestDim, indices[j]), classProbabilities[0], *this);
     }
 
     // Calculate counts of children in each node.
@@ -890,48 +1253,56 @@ double DecisionTree<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
       childCounts[childAssignments[j - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
-
+    // Split into children.
+    arma::Row<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          labels.swap_cols(currentCol, j);
-          if (UseWeights)
-            weights.swap_cols(currentCol, j);
+          std::swap(indices[currentCol], indices[j]);
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTree* child = new DecisionTree();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-      }
-      else
+    // The gathered labels and weights of this node are not needed anymore, so
+    // free them before the (possibly deep) recursion.
+    nodeLabels.reset();
+    nodeWeights.reset();
+    childAssignments.reset();
+
+    // Now build the children recursively.  The children hold disjoint ranges
+    // of the index list, so each can be trained in its own task, with its own
+    // copy of the dimension selector.
+    const bool parallel = UseParallelNodeTraining(count);
+    arma::vec childGains(numChildren, arma::fill::zeros);
+    for (size_t i = 0; i < numChildren; ++i)
+      children.push_back(new DecisionTree());
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      #pragma omp task default(shared) firstprivate(i) if(parallel)
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, labels, numClasses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        DimensionSelectionType childDimensionSelector(dimensionSelector);
+        childGains[i] = children[i]->Train<UseWeights>(data, indices,
+            childBegins[i],
+            childCounts[i], labels, numClasses, weights,
+            NoRecursion ? childCounts[i] : minimumLeafSize, minimumGainSplit,
+            maximumDepth - 1, childDimensionSelector);
       }
-      children.push_back(child);
+    }
+    #pragma omp taskwait
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      bestGain = 0.0;
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -940,10 +1311,8 @@ double DecisionTree<FitnessFunction,
     NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
 
     // Calculate class probabilities because we are a leaf.
-    CalculateClassProbabilities<UseWeights>(
-        labels.subvec(begin, begin + count - 1),
-        numClasses,
-        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+    CalculateClassProbabilities<UseWeights>(nodeLabels, numClasses,
+        nodeWeights);
   }
 
   return -bestGain;
@@ -1072,7 +1441,7 @@ void DecisionTree<FitnessFunction,
                   CategoricalSplitType,
                   DimensionSelectionType,
                   NoRecursion>::serialize(Archive& ar,
-                                          const uint32_t /* version */)
+                                          const uint32_t version)
 {
   // Clean memory if needed.
   if (cereal::is_loading<Archive>())
@@ -1089,6 +1458,17 @@ void DecisionTree<FitnessFunction,
   // Since dimensionType and majorityClass are a union, we only need to serialize one.
   ar(CEREAL_NVP(dimensionType));
   ar(CEREAL_NVP(classProbabilities));
+
+  // Version 1 added the auxiliary split information, for split types that need
+  // it to compute the direction of a point (such as
+  // BestBinaryCategoricalSplit).
+  if (version >= 1)
+  {
+    SerializeAuxiliarySplitInfo(ar,
+        static_cast<NumericAuxiliarySplitInfo&>(*this), "numericAux");
+    SerializeAuxiliarySplitInfo(ar,
+        static_cast<CategoricalAuxiliarySplitInfo&>(*this), "categoricalAux");
+  }
 }
 
 template<typename FitnessFunction,
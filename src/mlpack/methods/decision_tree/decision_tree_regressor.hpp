@@ -19,7 +19,9 @@
 #include "mse_gain.hpp"
 #include "best_binary_numeric_split.hpp"
 #include "all_categorical_split.hpp"
+#include "best_binary_categorical_split.hpp"
 #include "random_binary_numeric_split.hpp"
+#include "histogram_numeric_split.hpp"
 #include "all_dimension_select.hpp"
 
 namespace mlpack {
@@ -30,6 +32,14 @@ namespace mlpack {
  *
  * The class inherits from the auxiliary split information in order to prevent
  * an empty auxiliary split information struct from taking any extra size.
+ *
+ * When OpenMP is enabled, a single tree is trained in parallel: for large
+ * nodes, the candidate dimensions of the split search are evaluated in
+ * separate OpenMP tasks, and the children are trained in separate tasks.  With
+ * a deterministic dimension selector (such as AllDimensionSelect), the trained
+ * tree is the same as with a single thread.  If the tree is trained inside an
+ * existing parallel region (as in RandomForest), its tasks are run by the
+ * threads of that region.
  */
 template<typename FitnessFunction = MSEGain,
          template<typename> class NumericSplitType = BestBinaryNumericSplit,
@@ -386,6 +396,75 @@ class DecisionTreeRegressor :
                const std::enable_if_t<arma::is_arma_type<typename
                    std::remove_reference<WeightsType>::type>::value>* = 0);
 
+  /**
+   * Train the decision tree on the weighted points of the given data with the
+   * given indices.  The data is not copied or modified; instead, the list of
+   * indices is reordered as the points are assigned to nodes.  An index may
+   * appear more than once, in which case the point is used once for every time
+   * it appears.  This will overwrite the existing model.  The data may have
+   * numeric and categorical types, specified by the datasetInfo parameter.
+   * (For unweighted training, pass weights of one.)
+   *
+   * @param data Dataset to train on.
+   * @param datasetInfo Type information for each dimension.
+   * @param indices Indices of the points in the dataset to train on.
+   * @param responses Responses for each point in the dataset.
+   * @param weights Weights of each point in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @param fitnessFunction Instantiated fitnessFunction. It is used to
+   *      evaluate the fitness score for splitting each node.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType, typename ResponsesType, typename WeightsType>
+  double Train(const MatType& data,
+               const data::DatasetInfo& datasetInfo,
+               arma::uvec indices,
+               const ResponsesType& responses,
+               const WeightsType& weights,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType(),
+               FitnessFunction fitnessFunction = FitnessFunction(),
+               const std::enable_if_t<
+                   arma::is_arma_type<WeightsType>::value>* = 0);
+
+  /**
+   * Train the decision tree on the weighted points of the given data with the
+   * given indices, assuming that all dimensions are numeric.  The data is not
+   * copied or modified; an index may appear more than once.  This will
+   * overwrite the existing model.
+   *
+   * @param data Dataset to train on.
+   * @param indices Indices of the points in the dataset to train on.
+   * @param responses Responses for each point in the dataset.
+   * @param weights Weights of each point in the dataset.
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for the node to split.
+   * @param maximumDepth Maximum depth for the tree.
+   * @param dimensionSelector Instantiated dimension selection policy.
+   * @param fitnessFunction Instantiated fitnessFunction. It is used to
+   *      evaluate the fitness score for splitting each node.
+   * @return The final entropy of decision tree.
+   */
+  template<typename MatType, typename ResponsesType, typename WeightsType>
+  double Train(const MatType& data,
+               arma::uvec indices,
+               const ResponsesType& responses,
+               const WeightsType& weights,
+               const size_t minimumLeafSize = 10,
+               const double minimumGainSplit = 1e-7,
+               const size_t maximumDepth = 0,
+               DimensionSelectionType dimensionSelector =
+                   DimensionSelectionType(),
+               FitnessFunction fitnessFunction = FitnessFunction(),
+               const std::enable_if_t<
+                   arma::is_arma_type<WeightsType>::value>* = 0);
+
   /**
    * Make prediction for the given point, using the entire tree.  The predicted
    * label is returned.
@@ -410,7 +489,7 @@ class DecisionTreeRegressor :
    * Serialize the tree.
    */
   template<typename Archive>
-  void serialize(Archive& ar, const uint32_t /* version */);
+  void serialize(Archive& ar, const uint32_t version);
 
   //! Get the number of children.
   size_t NumChildren() const { return children.size(); }
@@ -471,11 +550,14 @@ class DecisionTreeRegressor :
    * train children.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param indices Indices of the points in the dataset; the points of this
+   *      node are reordered so that the points of each child are contiguous.
+   * @param begin Index of the first element of indices that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param datasetInfo Type information for each dimension.
    * @param responses Responses for each training point.
+   * @param weights Weights of each training point.
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
@@ -483,13 +565,17 @@ class DecisionTreeRegressor :
    *      evaluate the fitness score for splitting each node.
    * @return The final entropy of decision tree.
    */
-  template<bool UseWeights, typename MatType, typename ResponsesType>
-  double Train(MatType& data,
+  template<bool UseWeights,
+           typename MatType,
+           typename ResponsesType,
+           typename WeightsType>
+  double Train(const MatType& data,
+               arma::uvec& indices,
                const size_t begin,
                const size_t count,
                const data::DatasetInfo& datasetInfo,
-               ResponsesType& responses,
-               arma::rowvec& weights,
+               const ResponsesType& responses,
+               const WeightsType& weights,
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
@@ -502,10 +588,13 @@ class DecisionTreeRegressor :
    * training children.
    *
    * @param data Dataset to train on.
-   * @param begin Index of the starting point in the dataset that belongs to
-   *      this node.
+   * @param indices Indices of the points in the dataset; the points of this
+   *      node are reordered so that the points of each child are contiguous.
+   * @param begin Index of the first element of indices that belongs to this
+   *      node.
    * @param count Number of points in this node.
    * @param responses Responses for each training point.
+   * @param weights Weights of each training point.
    * @param minimumLeafSize Minimum number of points in each leaf node.
    * @param minimumGainSplit Minimum gain for the node to split.
    * @param maximumDepth Maximum depth for the tree.
@@ -513,12 +602,16 @@ class DecisionTreeRegressor :
    *      evaluate the fitness score for splitting each node.
    * @return The final entropy of decision tree.
    */
-  template<bool UseWeights, typename MatType, typename ResponsesType>
-  double Train(MatType& data,
+  template<bool UseWeights,
+           typename MatType,
+           typename ResponsesType,
+           typename WeightsType>
+  double Train(const MatType& data,
+               arma::uvec& indices,
                const size_t begin,
                const size_t count,
-               ResponsesType& responses,
-               arma::rowvec& weights,
+               const ResponsesType& responses,
+               const WeightsType& weights,
                const size_t minimumLeafSize,
                const double minimumGainSplit,
                const size_t maximumDepth,
@@ -529,6 +622,13 @@ class DecisionTreeRegressor :
 
 } // namespace mlpack
 
+CEREAL_TEMPLATE_CLASS_VERSION((typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType,
+    typename DimensionSelectionType, bool NoRecursion),
+    (mlpack::DecisionTreeRegressor<FitnessFunction, NumericSplitType,
+        CategoricalSplitType, DimensionSelectionType, NoRecursion>), (1));
+
 // Include implementation.
 #include "decision_tree_regressor_impl.hpp"
 
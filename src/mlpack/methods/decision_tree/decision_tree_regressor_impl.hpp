@@ -65,9 +65,13 @@ DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
+  Train<false>(tmpData, indices, 0, tmpData.n_cols, datasetInfo, tmpResponses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -101,9 +105,13 @@ DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  Train<false>(tmpData, 0, tmpData.n_cols, tmpResponses, weights,
+  Train<false>(tmpData, indices, 0, tmpData.n_cols, tmpResponses, weights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -141,8 +149,12 @@ DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, datasetInfo, tmpResponses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector);
 }
@@ -183,8 +195,12 @@ DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpResponses, tmpWeights,
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, tmpResponses, tmpWeights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -221,9 +237,13 @@ DecisionTreeRegressor<FitnessFunction,
   TrueResponsesType tmpResponses(std::move(responses));
   TrueWeightsType tmpWeights(std::move(weights));
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
-              tmpWeights, minimumLeafSize, minimumGainSplit);
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, datasetInfo, tmpResponses,
+      tmpWeights, minimumLeafSize, minimumGainSplit);
 }
 
 //! Take ownership of another tree and train with weights.
@@ -264,8 +284,12 @@ DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the weighted Train() method.
-  Train<true>(tmpData, 0, tmpData.n_cols, tmpResponses, tmpWeights,
+  Train<true>(tmpData, indices, 0, tmpData.n_cols, tmpResponses, tmpWeights,
       minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector);
 }
 
@@ -461,10 +485,14 @@ double DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
-      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  return Train<false>(tmpData, indices, 0, tmpData.n_cols, datasetInfo,
+      tmpResponses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
 
@@ -501,9 +529,13 @@ double DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
   arma::rowvec weights; // Fake weights, not used.
-  return Train<false>(tmpData, 0, tmpData.n_cols, tmpResponses,
+  return Train<false>(tmpData, indices, 0, tmpData.n_cols, tmpResponses,
       weights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
@@ -549,9 +581,13 @@ double DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, datasetInfo, tmpResponses,
-      tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
+  return Train<true>(tmpData, indices, 0, tmpData.n_cols, datasetInfo,
+      tmpResponses, tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
 
@@ -595,83 +631,259 @@ double DecisionTreeRegressor<FitnessFunction,
   // Set the correct dimensionality for the dimension selector.
   dimensionSelector.Dimensions() = tmpData.n_rows;
 
+  // Points are assigned to nodes by reordering this list of indices.
+  arma::uvec indices = arma::linspace<arma::uvec>(0, tmpData.n_cols - 1,
+      tmpData.n_cols);
+
   // Pass off work to the Train() method.
-  return Train<true>(tmpData, 0, tmpData.n_cols, tmpResponses,
+  return Train<true>(tmpData, indices, 0, tmpData.n_cols, tmpResponses,
       tmpWeights, minimumLeafSize, minimumGainSplit, maximumDepth,
       dimensionSelector, fitnessFunction);
 }
 
+//! Train on the given weighted subset of the data.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename MatType, typename ResponsesType, typename WeightsType>
+double DecisionTreeRegressor<FitnessFunction,
+                             NumericSplitType,
+                             CategoricalSplitType,
+                             DimensionSelectionType,
+                             NoRecursion>::Train(
+    const MatType& data,
+    const data::DatasetInfo& datasetInfo,
+    arma::uvec indices,
+    const ResponsesType& responses,
+    const WeightsType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector,
+    FitnessFunction fitnessFunction,
+    const std::enable_if_t<arma::is_arma_type<WeightsType>::value>*)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(data, responses, "DecisionTreeRegressor::Train()");
+  util::CheckSameSizes(data, weights, "DecisionTreeRegressor::Train()",
+      "weights");
+  CheckIndices(data, indices, "DecisionTreeRegressor::Train()");
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  return Train<true>(data, indices, 0, indices.n_elem, datasetInfo, responses,
+      weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+      dimensionSelector, fitnessFunction);
+}
+
+//! Train on the given weighted subset of the data, assuming all dimensions are
+//! numeric.
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+template<typename MatType, typename ResponsesType, typename WeightsType>
+double DecisionTreeRegressor<FitnessFunction,
+                             NumericSplitType,
+                             CategoricalSplitType,
+                             DimensionSelectionType,
+                             NoRecursion>::Train(
+    const MatType& data,
+    arma::uvec indices,
+    const ResponsesType& responses,
+    const WeightsType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const size_t maximumDepth,
+    DimensionSelectionType dimensionSelector,
+    FitnessFunction fitnessFunction,
+    const std::enable_if_t<arma::is_arma_type<WeightsType>::value>*)
+{
+  // Sanity check on data.
+  util::CheckSameSizes(data, responses, "DecisionTreeRegressor::Train()");
+  util::CheckSameSizes(data, weights, "DecisionTreeRegressor::Train()",
+      "weights");
+  CheckIndices(data, indices, "DecisionTreeRegressor::Train()");
+
+  // Set the correct dimensionality for the dimension selector.
+  dimensionSelector.Dimensions() = data.n_rows;
+
+  // Pass off work to the Train() method.
+  return Train<true>(data, indices, 0, indices.n_elem, responses, weights,
+      minimumLeafSize, minimumGainSplit, maximumDepth, dimensionSelector,
+      fitnessFunction);
+}
+
 //! Train on the given data.
 template<typename FitnessFunction,
          template<typename> class NumericSplitType,
          template<typename> class CategoricalSplitType,
          typename DimensionSelectionType,
          bool NoRecursion>
-template<bool UseWeights, typename MatType, typename ResponsesType>
+template<bool UseWeights,
+         typename MatType,
+         typename ResponsesType,
+         typename WeightsType>
 double DecisionTreeRegressor<FitnessFunction,
                              NumericSplitType,
                              CategoricalSplitType,
                              DimensionSelectionType,
                              NoRecursion>::Train(
-    MatType& data,
+    const MatType& data,
+    arma::uvec& indices,
     const size_t begin,
     const size_t count,
     const data::DatasetInfo& datasetInfo,
-    ResponsesType& responses,
-    arma::rowvec& weights,
+    const ResponsesType& responses,
+    const WeightsType& weights,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
     DimensionSelectionType& dimensionSelector,
     FitnessFunction fitnessFunction)
 {
+  // If we are not yet inside a parallel region, open one so that the split
+  // search and the children of this tree can be handled by OpenMP tasks.
+  if (OpenParallelNodeTraining(count))
+  {
+    double gain = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = Train<UseWeights>(data, indices, begin, count, datasetInfo,
+          responses, weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector, fitnessFunction);
+    }
+    return gain;
+  }
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
   children.clear();
 
+  // Gather the responses (and weights) of the points in this node, so that the
+  // fitness function and the splitters see contiguous vectors.
+  ResponsesType nodeResponses =
+      responses.cols(indices.subvec(begin, begin + count - 1));
+  WeightsType nodeWeights;
+  if (UseWeights)
+    nodeWeights = weights.cols(indices.subvec(begin, begin + count - 1));
+
+  // Evaluate the split of dimension i, if it is better than the given gain.
+  auto splitIfBetter = [&](const size_t i,
+                           const double gain,
+                           double& dimSplitPoint,
+                           NumericAuxiliarySplitInfo& numericAux,
+                           CategoricalAuxiliarySplitInfo& categoricalAux,
+                           FitnessFunction& dimFitnessFunction)
+  {
+    // Gather the values of dimension i for the points in this node.
+    arma::Row<typename MatType::elem_type> values(count);
+    for (size_t j = 0; j < count; ++j)
+      values[j] = data(i, indices[begin + j]);
+
+    double dimGain = DBL_MAX;
+    if (datasetInfo.Type(i) == data::Datatype::categorical)
+    {
+      dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(gain,
+          values,
+          datasetInfo.NumMappings(i),
+          nodeResponses,
+          nodeWeights,
+          minimumLeafSize,
+          minimumGainSplit,
+          dimSplitPoint,
+          categoricalAux,
+          dimFitnessFunction);
+    }
+    else if (datasetInfo.Type(i) == data::Datatype::numeric)
+    {
+      dimGain = NumericSplit::template SplitIfBetter<UseWeights>(gain,
+          values,
+          nodeResponses,
+          nodeWeights,
+          minimumLeafSize,
+          minimumGainSplit,
+          dimSplitPoint,
+          numericAux,
+          dimFitnessFunction);
+    }
+
+    return dimGain;
+  };
+
   // Look through the list of dimensions and obtain the gain of the best split.
   // We'll cache the best numeric and categorical split auxiliary information
   // in numericAux and categoricalAux (and clear them later if we make no
   // split). The split point is stored in splitPointOrPrediction for all
   // internal nodes of the tree.
   double bestGain = fitnessFunction.template Evaluate<UseWeights>(
-      responses.cols(begin, begin + count - 1),
-      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+      nodeResponses, nodeWeights);
   size_t bestDim = datasetInfo.Dimensionality(); // This means "no split".
   const size_t end = dimensionSelector.End();
 
-  if (maximumDepth != 1)
+  if (maximumDepth != 1 && UseParallelNodeTraining(count))
   {
+    // Collect the candidate dimensions first, so that the dimension selector is
+    // used in the same way as in the serial search.
+    std::vector<size_t> dims;
     for (size_t i = dimensionSelector.Begin(); i != end;
          i = dimensionSelector.Next())
+      dims.push_back(i);
+
+    // Evaluate each dimension against the gain of this node in its own task.
+    // The fitness function may hold the state of a split scan, so every task
+    // gets its own copy of it, along with its own split information.
+    std::vector<double> dimGains(dims.size());
+    std::vector<double> splitPoints(dims.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAuxs(dims.size());
+    std::vector<CategoricalAuxiliarySplitInfo> categoricalAuxs(dims.size());
+    for (size_t d = 0; d < dims.size(); ++d)
     {
-      double dimGain = -DBL_MAX;
-      if (datasetInfo.Type(i) == data::Datatype::categorical)
+      #pragma omp task default(shared) firstprivate(d)
       {
-        dimGain = CategoricalSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            datasetInfo.NumMappings(i),
-            responses.cols(begin, begin + count - 1),
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            splitPoint,
-            *this,
-            fitnessFunction);
-      }
-      else if (datasetInfo.Type(i) == data::Datatype::numeric)
-      {
-        dimGain = NumericSplit::template SplitIfBetter<UseWeights>(bestGain,
-            data.cols(begin, begin + count - 1).row(i),
-            responses.cols(begin, begin + count - 1),
-            UseWeights ? weights.subvec(begin, begin + count - 1) : weights,
-            minimumLeafSize,
-            minimumGainSplit,
-            splitPoint,
-            *this,
-            fitnessFunction);
+        FitnessFunction dimFitnessFunction(fitnessFunction);
+        dimGains[d] = splitIfBetter(dims[d], bestGain, splitPoints[d],
+            numericAuxs[d], categoricalAuxs[d], dimFitnessFunction);
       }
+    }
+    #pragma omp taskwait
+
+    // Now pick the split that the serial search would have picked: a dimension
+    // is only taken if it improves on the best split of the dimensions before
+    // it (or if it is perfect).
+    for (size_t d = 0; d < dims.size(); ++d)
+    {
+      if (dimGains[d] == DBL_MAX || (dimGains[d] < 0.0 &&
+          dimGains[d] <= std::min(bestGain + minimumGainSplit, 0.0)))
+        continue;
+
+      bestDim = dims[d];
+      bestGain = dimGains[d];
+      splitPoint = splitPoints[d];
+      if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+        CategoricalAuxiliarySplitInfo::operator=(categoricalAuxs[d]);
+      else
+        NumericAuxiliarySplitInfo::operator=(numericAuxs[d]);
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+  }
+  else if (maximumDepth != 1)
+  {
+    for (size_t i = dimensionSelector.Begin(); i != end;
+         i = dimensionSelector.Next())
+    {
+      const double dimGain = splitIfBetter(i, bestGain, splitPoint, *this,
+          *this, fitnessFunction);
 
       // If the splitter reported that it did not split, move to the next
       // dimension.
@@ -694,6 +906,13 @@ double DecisionTreeRegressor<FitnessFunction,
     dimensionType = (size_t) datasetInfo.Type(bestDim);
     splitDimension = bestDim;
 
+    // Only keep the auxiliary information of the split that was made; the
+    // other one may hold a split of an earlier dimension.
+    if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
+      NumericAuxiliarySplitInfo::operator=(NumericAuxiliarySplitInfo());
+    else
+      CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
+
     // Get the number of children we will have.
     size_t numChildren = 0;
     if (datasetInfo.Type(bestDim) == data::Datatype::categorical)
@@ -707,14 +926,14 @@ double DecisionTreeRegressor<FitnessFunction,
     {
       for (size_t j = begin; j < begin + count; ++j)
         childAssignments[j - begin] = CategoricalSplit::CalculateDirection(
-            data(bestDim, j), splitPoint, *this);
+            data(bestDim, indices[j]), splitPoint, *this);
     }
     else
     {
       for (size_t j = begin; j < begin + count; ++j)
       {
         childAssignments[j - begin] = NumericSplit::CalculateDirection(
-            data(bestDim, j), splitPoint, *this);
+            data(bestDim, indices[j]), splitPoint, *this);
       }
     }
 
@@ -723,49 +942,55 @@ double DecisionTreeRegressor<FitnessFunction,
     for (size_t i = begin; i < begin + count; ++i)
       childCounts[childAssignments[i - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
-
     // Split into children.
+    arma::Row<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          responses.swap_cols(currentCol, j);
-          if (UseWeights)
-            weights.swap_cols(currentCol, j);
+          std::swap(indices[currentCol], indices[j]);
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTreeRegressor* child = new DecisionTreeRegressor();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, responses,
-            weights, currentCol - currentChildBegin, minimumGainSplit,
-            maximumDepth - 1, dimensionSelector);
-      }
-      else
+    // The gathered responses and weights of this node are not needed anymore,
+    // so free them before the (possibly deep) recursion.
+    nodeResponses.reset();
+    nodeWeights.reset();
+    childAssignments.reset();
+
+    // Now build the children recursively.  The children hold disjoint ranges
+    // of the index list, so each can be trained in its own task, with its own
+    // copy of the dimension selector.
+    const bool parallel = UseParallelNodeTraining(count);
+    arma::vec childGains(numChildren, arma::fill::zeros);
+    for (size_t i = 0; i < numChildren; ++i)
+      children.push_back(new DecisionTreeRegressor());
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      #pragma omp task default(shared) firstprivate(i) if(parallel)
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, datasetInfo, responses,
-            weights, minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        DimensionSelectionType childDimensionSelector(dimensionSelector);
+        childGains[i] = children[i]->Train<UseWeights>(data, indices,
+            childBegins[i], childCounts[i], datasetInfo, responses, weights,
+            NoRecursion ? childCounts[i] : minimumLeafSize, minimumGainSplit,
+            maximumDepth - 1, childDimensionSelector, fitnessFunction);
       }
-      children.push_back(child);
+    }
+    #pragma omp taskwait
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      bestGain = 0.0;
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -776,8 +1001,7 @@ double DecisionTreeRegressor<FitnessFunction,
 
     // Calculate prediction value because we are a leaf.
     prediction = fitnessFunction.template OutputLeafValue<UseWeights>(
-        responses.cols(begin, begin + count - 1),
-        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+        nodeResponses, nodeWeights);
   }
 
   return -bestGain;
@@ -789,23 +1013,42 @@ template<typename FitnessFunction,
          template<typename> class CategoricalSplitType,
          typename DimensionSelectionType,
          bool NoRecursion>
-template<bool UseWeights, typename MatType, typename ResponsesType>
+template<bool UseWeights,
+         typename MatType,
+         typename ResponsesType,
+         typename WeightsType>
 double DecisionTreeRegressor<FitnessFunction,
                              NumericSplitType,
                              CategoricalSplitType,
                              DimensionSelectionType,
                              NoRecursion>::Train(
-    MatType& data,
+    const MatType& data,
+    arma::uvec& indices,
     const size_t begin,
     const size_t count,
-    ResponsesType& responses,
-    arma::rowvec& weights,
+    const ResponsesType& responses,
+    const WeightsType& weights,
     const size_t minimumLeafSize,
     const double minimumGainSplit,
     const size_t maximumDepth,
     DimensionSelectionType& dimensionSelector,
     FitnessFunction fitnessFunction)
 {
+  // If we are not yet inside a parallel region, open one so that the split
+  // search and the children of this tree can be handled by OpenMP tasks.
+  if (OpenParallelNodeTraining(count))
+  {
+    double gain = 0.0;
+    #pragma omp parallel
+    {
+      #pragma omp single
+      gain = Train<UseWeights>(data, indices, begin, count, responses,
+          weights, minimumLeafSize, minimumGainSplit, maximumDepth,
+          dimensionSelector, fitnessFunction);
+    }
+    return gain;
+  }
+
   // Clear children if needed.
   for (size_t i = 0; i < children.size(); ++i)
     delete children[i];
@@ -814,32 +1057,98 @@ double DecisionTreeRegressor<FitnessFunction,
   // We won't be using these members, so reset them.
   CategoricalAuxiliarySplitInfo::operator=(CategoricalAuxiliarySplitInfo());
 
+  // Gather the responses (and weights) of the points in this node, so that the
+  // fitness function and the splitters see contiguous vectors.
+  ResponsesType nodeResponses =
+      responses.cols(indices.subvec(begin, begin + count - 1));
+  WeightsType nodeWeights;
+  if (UseWeights)
+    nodeWeights = weights.cols(indices.subvec(begin, begin + count - 1));
+
+  // Evaluate the split of dimension i, if it is better than the given gain.
+  auto splitIfBetter = [&](const size_t i,
+                           const double gain,
+                           double& dimSplitPoint,
+                           NumericAuxiliarySplitInfo& numericAux,
+                           FitnessFunction& dimFitnessFunction)
+  {
+    // Gather the values of dimension i for the points in this node.
+    arma::Row<typename MatType::elem_type> values(count);
+    for (size_t j = 0; j < count; ++j)
+      values[j] = data(i, indices[begin + j]);
+
+    return NumericSplitType<FitnessFunction>::template
+        SplitIfBetter<UseWeights>(gain,
+                                  values,
+                                  nodeResponses,
+                                  nodeWeights,
+                                  minimumLeafSize,
+                                  minimumGainSplit,
+                                  dimSplitPoint,
+                                  numericAux,
+                                  dimFitnessFunction);
+  };
+
   // Look through the list of dimensions and obtain the best split. We'll cache
   // the best numeric split auxiliary information in numericAux (and clear it
   // later if we don't make a split). The split point is stored in
   // splitPointOrPrediction for all internal nodes of the tree.
   double bestGain = fitnessFunction.template Evaluate<UseWeights>(
-      responses.cols(begin, begin + count - 1),
-      UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+      nodeResponses, nodeWeights);
   size_t bestDim = data.n_rows; // This means "no split".
 
-  if (maximumDepth != 1)
+  if (maximumDepth != 1 && UseParallelNodeTraining(count))
+  {
+    // Collect the candidate dimensions first, so that the dimension selector is
+    // used in the same way as in the serial search.
+    std::vector<size_t> dims;
+    for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
+         i = dimensionSelector.Next())
+      dims.push_back(i);
+
+    // Evaluate each dimension against the gain of this node in its own task.
+    // The fitness function may hold the state of a split scan, so every task
+    // gets its own copy of it, along with its own split information.
+    std::vector<double> dimGains(dims.size());
+    std::vector<double> splitPoints(dims.size());
+    std::vector<NumericAuxiliarySplitInfo> numericAuxs(dims.size());
+    for (size_t d = 0; d < dims.size(); ++d)
+    {
+      #pragma omp task default(shared) firstprivate(d)
+      {
+        FitnessFunction dimFitnessFunction(fitnessFunction);
+        dimGains[d] = splitIfBetter(dims[d], bestGain, splitPoints[d],
+            numericAuxs[d], dimFitnessFunction);
+      }
+    }
+    #pragma omp taskwait
+
+    // Now pick the split that the serial search would have picked: a dimension
+    // is only taken if it improves on the best split of the dimensions before
+    // it (or if it is perfect).
+    for (size_t d = 0; d < dims.size(); ++d)
+    {
+      if (dimGains[d] == DBL_MAX || (dimGains[d] < 0.0 &&
+          dimGains[d] <= std::min(bestGain + minimumGainSplit, 0.0)))
+        continue;
+
+      bestDim = dims[d];
+      bestGain = dimGains[d];
+      splitPoint = splitPoints[d];
+      NumericAuxiliarySplitInfo::operator=(numericAuxs[d]);
+
+      // If the gain is the best possible, no need to keep looking.
+      if (bestGain >= 0.0)
+        break;
+    }
+  }
+  else if (maximumDepth != 1)
   {
     for (size_t i = dimensionSelector.Begin(); i != dimensionSelector.End();
          i = dimensionSelector.Next())
     {
-      const double dimGain = NumericSplitType<FitnessFunction>::template
-          SplitIfBetter<UseWeights>(bestGain,
-                                    data.cols(begin, begin + count - 1).row(i),
-                                    responses.cols(begin, begin + count - 1),
-                                    UseWeights ?
-                                        weights.cols(begin, begin + count - 1) :
-                                        weights,
-                                    minimumLeafSize,
-                                    minimumGainSplit,
-                                    splitPoint,
-                                    *this,
-                                    fitnessFunction);
+      const double dimGain = splitIfBetter(i, bestGain, splitPoint, *this,
+          fitnessFunction);
 
       // If the splitter did not report that it improved, then move to the next
       // dimension.
@@ -869,7 +1178,7 @@ double DecisionTreeRegressor<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
     {
       childAssignments[j - begin] = NumericSplit::CalculateDirection(
-          data(bestDim, j), splitPoint, *this);
+          data(bestDim, indices[j]), splitPoint, *this);
     }
 
     // Calculate counts of children in each node.
@@ -878,48 +1187,55 @@ double DecisionTreeRegressor<FitnessFunction,
     for (size_t j = begin; j < begin + count; ++j)
       childCounts[childAssignments[j - begin]]++;
 
-    // Initialize bestGain if recursive split is allowed.
-    if (!NoRecursion)
-    {
-      bestGain = 0.0;
-    }
-
+    // Split into children.
+    arma::Row<size_t> childBegins(numChildren);
     size_t currentCol = begin;
     for (size_t i = 0; i < numChildren; ++i)
     {
-      size_t currentChildBegin = currentCol;
-      for (size_t j = currentChildBegin; j < begin + count; ++j)
+      childBegins[i] = currentCol;
+      for (size_t j = currentCol; j < begin + count; ++j)
       {
         if (childAssignments[j - begin] == i)
         {
           childAssignments.swap_cols(currentCol - begin, j - begin);
-          data.swap_cols(currentCol, j);
-          responses.swap_cols(currentCol, j);
-          if (UseWeights)
-            weights.swap_cols(currentCol, j);
+          std::swap(indices[currentCol], indices[j]);
           ++currentCol;
         }
       }
+    }
 
-      // Now build the child recursively.
-      DecisionTreeRegressor* child = new DecisionTreeRegressor();
-      if (NoRecursion)
-      {
-        child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, responses, weights,
-            currentCol - currentChildBegin, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-      }
-      else
+    // The gathered responses and weights of this node are not needed anymore,
+    // so free them before the (possibly deep) recursion.
+    nodeResponses.reset();
+    nodeWeights.reset();
+    childAssignments.reset();
+
+    // Now build the children recursively.  The children hold disjoint ranges
+    // of the index list, so each can be trained in its own task, with its own
+    // copy of the dimension selector.
+    const bool parallel = UseParallelNodeTraining(count);
+    arma::vec childGains(numChildren, arma::fill::zeros);
+    for (size_t i = 0; i < numChildren; ++i)
+      children.push_back(new DecisionTreeRegressor());
+    for (size_t i = 0; i < numChildren; ++i)
+    {
+      #pragma omp task default(shared) firstprivate(i) if(parallel)
       {
-        // During recursion entropy of child node may change.
-        double childGain = child->Train<UseWeights>(data, currentChildBegin,
-            currentCol - currentChildBegin, responses, weights,
-            minimumLeafSize, minimumGainSplit, maximumDepth - 1,
-            dimensionSelector);
-        bestGain += double(childCounts[i]) / double(count) * (-childGain);
+        DimensionSelectionType childDimensionSelector(dimensionSelector);
+        childGains[i] = children[i]->Train<UseWeights>(data, indices,
+            childBegins[i], childCounts[i], responses, weights,
+            NoRecursion ? childCounts[i] : minimumLeafSize, minimumGainSplit,
+            maximumDepth - 1, childDimensionSelector, fitnessFunction);
       }
-      children.push_back(child);
+    }
+    #pragma omp taskwait
+
+    // During recursion entropy of child node may change.
+    if (!NoRecursion)
+    {
+      bestGain = 0.0;
+      for (size_t i = 0; i < numChildren; ++i)
+        bestGain += double(childCounts[i]) / double(count) * (-childGains[i]);
     }
   }
   else
@@ -929,8 +1245,7 @@ double DecisionTreeRegressor<FitnessFunction,
 
     // Calculate prediction value because we are a leaf.
     prediction = fitnessFunction.template OutputLeafValue<UseWeights>(
-        responses.cols(begin, begin + count - 1),
-        UseWeights ? weights.subvec(begin, begin + count - 1) : weights);
+        nodeResponses, nodeWeights);
   }
 
   return -bestGain;
@@ -1023,7 +1338,7 @@ void DecisionTreeRegressor<FitnessFunction,
                            CategoricalSplitType,
                            DimensionSelectionType,
                            NoRecursion
->::serialize(Archive& ar, const uint32_t /* version */)
+>::serialize(Archive& ar, const uint32_t version)
 {
   // Clean memory if needed.
   if (cereal::is_loading<Archive>())
@@ -1041,6 +1356,17 @@ void DecisionTreeRegressor<FitnessFunction,
   ar(CEREAL_NVP(splitPoint));
   // Since splitPoint and prediction are a union, we only need to serialize one of them.
   ar(CEREAL_NVP(splitPoint));
+
+  // Version 1 added the auxiliary split information, for split types that need
+  // it to compute the direction of a point (such as
+  // BestBinaryCategoricalSplit).
+  if (version >= 1)
+  {
+    SerializeAuxiliarySplitInfo(ar,
+        static_cast<NumericAuxiliarySplitInfo&>(*this), "numericAux");
+    SerializeAuxiliarySplitInfo(ar,
+        static_cast<CategoricalAuxiliarySplitInfo&>(*this), "categoricalAux");
+  }
 }
 
 //! Return the number of leaves.
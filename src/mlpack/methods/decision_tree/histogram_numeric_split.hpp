@@ -0,0 +1,262 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split.hpp
+ *
+ * A tree splitter that finds the best binary numeric split on a histogram of
+ * the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include "best_binary_numeric_split.hpp"
+
+namespace mlpack {
+
+/**
+ * The HistogramNumericSplit is a splitting function for decision trees that
+ * searches for the best binary split of a numeric dimension, like
+ * BestBinaryNumericSplit, but only considers split points between the bins of
+ * a histogram of the data instead of between every pair of sorted values.
+ *
+ * The values of the dimension are quantized into at most MaxBins bins (so each
+ * bin index fits in a uint8_t) without sorting.  The bins are bounded by
+ * quantiles of the values at the node, found with repeated partial selection
+ * in O(n log MaxBins) time, so each bin holds about the same number of points,
+ * and a few outliers cannot squeeze all other values into a few bins (as they
+ * would with equal-width bins).  For classification, per-bin class counts (or
+ * class weight sums) are then accumulated in a single pass, and the split is
+ * found by scanning the bins; this costs O(n log MaxBins + MaxBins *
+ * numClasses) per dimension instead of O(n log n).  For regression, the points
+ * are ordered by bin with a counting sort, and the fitness function is then
+ * only evaluated at bin boundaries.
+ *
+ * The split point is placed halfway between the largest value of the last bin
+ * on the left and the smallest value of the first bin on the right.  If a
+ * dimension has at most MaxBins distinct values, each value gets its own bin,
+ * so the split is the same as the one BestBinaryNumericSplit would find.
+ *
+ * Missing values (NaN) are handled as by BestBinaryNumericSplit: they are not
+ * put in any bin, and the child that points with a missing value are sent to
+ * is learned for each split and stored in the auxiliary split information.
+ *
+ * @tparam FitnessFunction Fitness function to use to calculate gain.
+ */
+template<typename FitnessFunction>
+class HistogramNumericSplit
+{
+ public:
+  /**
+   * The auxiliary information of the split holds the child that points with a
+   * missing value are sent to.
+   */
+  class AuxiliarySplitInfo
+  {
+   public:
+    //! Create the auxiliary information.  By default, points with a missing
+    //! value go to the right child.
+    AuxiliarySplitInfo() : missingDirection(1) { }
+
+    //! The child that points with a missing value go to (0 for left, 1 for
+    //! right).
+    size_t missingDirection;
+
+    //! Serialize the auxiliary split information.
+    template<typename Archive>
+    void serialize(Archive& ar, const uint32_t /* version */)
+    {
+      ar(CEREAL_NVP(missingDirection));
+    }
+  };
+
+  //! The maximum number of bins in each histogram.
+  static const size_t MaxBins = 256;
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
+   * may be modified.
+   *
+   * This overload is used only for classification tasks.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param labels Labels for each point.
+   * @param numClasses Number of classes in the dataset.
+   * @param weights Weights associated with labels.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  static double SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const arma::Row<size_t>& labels,
+      const size_t numClasses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      arma::vec& splitInfo,
+      AuxiliarySplitInfo& aux);
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
+   * may be modified.
+   *
+   * This overload is used only for regression tasks, with fitness functions
+   * that do not implement BinaryScanInitialize(), BinaryStep() and
+   * BinaryGains().
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param responses Responses for each point.
+   * @param weights Weights associated with responses.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   * @param fitnessFunction The FitnessFunction object instance. It is used to
+   *      evaluate the gain for the split.
+   */
+  template<bool UseWeights, typename VecType, typename ResponsesType,
+           typename WeightVecType>
+  static typename std::enable_if<
+      !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+      double>::type
+  SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const ResponsesType& responses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      double& splitInfo,
+      AuxiliarySplitInfo& aux,
+      FitnessFunction& fitnessFunction);
+
+  /**
+   * Check if we can split a node.  If we can split a node in a way that
+   * improves on 'bestGain', then we return the improved gain.  Otherwise we
+   * return the value 'bestGain'.  If a split is made, then splitInfo and aux
+   * may be modified.
+   *
+   * This overload is specialized for any fitness function that implements
+   * BinaryScanInitialize(), BinaryStep() and BinaryGains() functions.
+   *
+   * @param bestGain Best gain seen so far (we'll only split if we find gain
+   *      better than this).
+   * @param data The dimension of data points to check for a split in.
+   * @param responses Responses for each point.
+   * @param weights Weights associated with responses.
+   * @param minimumLeafSize Minimum number of points in a leaf node for
+   *      splitting.
+   * @param minimumGainSplit Minimum gain split.
+   * @param splitInfo Stores split information on a successful split.
+   * @param aux Auxiliary split information, which may be modified on a
+   *      successful split.
+   * @param fitnessFunction The FitnessFunction object instance. It is used to
+   *      evaluate the gain for the split.
+   */
+  template<bool UseWeights, typename VecType, typename ResponsesType,
+           typename WeightVecType>
+  static typename std::enable_if<
+      HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+      double>::type
+  SplitIfBetter(
+      const double bestGain,
+      const VecType& data,
+      const ResponsesType& responses,
+      const WeightVecType& weights,
+      const size_t minimumLeafSize,
+      const double minimumGainSplit,
+      double& splitInfo,
+      AuxiliarySplitInfo& aux,
+      FitnessFunction& fitnessFunction);
+
+  /**
+   * Returns 2, since the binary split always has two children.
+   */
+  static size_t NumChildren(const double& /* splitInfo */,
+                            const AuxiliarySplitInfo& /* aux */)
+  {
+    return 2;
+  }
+
+  /**
+   * Given a point, calculate which child it should go to (left or right).
+   *
+   * @param point Point to calculate direction of.
+   * @param splitInfo Auxiliary information for the split.
+   * @param aux Auxiliary information for the split, holding the child of
+   *      points with a missing value.
+   */
+  template<typename ElemType>
+  static size_t CalculateDirection(
+      const ElemType& point,
+      const double& splitInfo,
+      const AuxiliarySplitInfo& aux);
+
+ private:
+  /**
+   * Quantize the given data into at most MaxBins bins, bounded by quantiles of
+   * the data (or one bin per value, if there are at most MaxBins distinct
+   * values).  The bin of each point, the number of points in each bin, and the
+   * smallest and largest value in each bin are computed.  Missing values are
+   * not put in any bin; their number is stored in numMissing.  If all other
+   * values are the same (so no split is possible), false is returned.
+   */
+  template<typename VecType>
+  static bool Quantize(const VecType& data,
+                       std::vector<uint8_t>& bins,
+                       arma::Col<size_t>& binCounts,
+                       arma::vec& binMin,
+                       arma::vec& binMax,
+                       size_t& numMissing);
+
+  /**
+   * Select the values of the given ranks (in increasing order) of the
+   * elements begin to end - 1 of values, which are reordered in the process.
+   * Only ranks firstRank to lastRank - 1 are selected, and they must all lie
+   * in the range; the value of rank ranks[k] is stored in quantiles[k].
+   */
+  static void SelectQuantiles(std::vector<double>& values,
+                              const size_t begin,
+                              const size_t end,
+                              const arma::Col<size_t>& ranks,
+                              const size_t firstRank,
+                              const size_t lastRank,
+                              std::vector<double>& quantiles);
+
+  /**
+   * Compute an ordering of the points such that points are grouped by bin, in
+   * increasing order of bins, with a counting sort.  Points with a missing
+   * value are placed after all bins.
+   */
+  template<typename VecType>
+  static void SortByBin(const VecType& data,
+                        const std::vector<uint8_t>& bins,
+                        const arma::Col<size_t>& binCounts,
+                        arma::uvec& sortedIndices);
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "histogram_numeric_split_impl.hpp"
+
+#endif
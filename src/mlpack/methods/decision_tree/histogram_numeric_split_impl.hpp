@@ -0,0 +1,767 @@
+/**
+ * @file methods/decision_tree/histogram_numeric_split_impl.hpp
+ *
+ * Implementation of strategy that finds the best binary numeric split on a
+ * histogram of the data.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+#define MLPACK_METHODS_DECISION_TREE_HISTOGRAM_NUMERIC_SPLIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "histogram_numeric_split.hpp"
+
+namespace mlpack {
+
+// Overload used for classification.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename WeightVecType>
+double HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const arma::Row<size_t>& labels,
+    const size_t numClasses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    arma::vec& splitInfo,
+    AuxiliarySplitInfo& aux)
+{
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Quantize the data.  If all values are the same, we can't split in this
+  // dimension.  Points with a missing value are not put in any bin.
+  std::vector<uint8_t> bins;
+  arma::Col<size_t> binCounts;
+  arma::vec binMin, binMax;
+  size_t numMissing;
+  if (!Quantize(data, bins, binCounts, binMin, binMax, numMissing))
+    return DBL_MAX;
+  const size_t numPresent = data.n_elem - numMissing;
+
+  // We need to count the number of points for each class in each child; the
+  // columns hold the left child, the right child, and the points with a
+  // missing value, and the last column is scratch space for
+  // BinaryGainWithMissing().  Initially, all points are on the right.
+  arma::Mat<size_t> classCounts;
+  arma::mat classWeightSums;
+  double totalWeight = 0.0;
+  double totalLeftWeight = 0.0;
+  double totalRightWeight = 0.0;
+  double totalMissingWeight = 0.0;
+
+  // Build the histogram of class counts (or class weight sums) of each bin in
+  // a single pass.
+  arma::Mat<size_t> binClassCounts;
+  arma::mat binClassWeightSums;
+  if (UseWeights)
+  {
+    classWeightSums.zeros(numClasses, 4);
+    binClassWeightSums.zeros(numClasses, MaxBins);
+    for (size_t i = 0; i < data.n_elem; ++i)
+    {
+      if (std::isnan((double) data[i]))
+        classWeightSums(labels[i], 2) += weights[i];
+      else
+        binClassWeightSums(labels[i], bins[i]) += weights[i];
+    }
+  }
+  else
+  {
+    classCounts.zeros(numClasses, 4);
+    binClassCounts.zeros(numClasses, MaxBins);
+    for (size_t i = 0; i < data.n_elem; ++i)
+    {
+      if (std::isnan((double) data[i]))
+        ++classCounts(labels[i], 2);
+      else
+        ++binClassCounts(labels[i], bins[i]);
+    }
+  }
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  if (UseWeights)
+  {
+    classWeightSums.col(1) = arma::sum(binClassWeightSums, 1);
+    totalRightWeight = arma::accu(classWeightSums.col(1));
+    totalMissingWeight = arma::accu(classWeightSums.col(2));
+    totalWeight = totalRightWeight + totalMissingWeight;
+    bestFoundGain *= totalWeight;
+  }
+  else
+  {
+    classCounts.col(1) = arma::sum(binClassCounts, 1);
+    bestFoundGain *= data.n_elem;
+  }
+
+  // Loop through the boundaries between non-empty bins.
+  size_t leftCount = 0;
+  for (size_t bin = 0; bin < MaxBins; ++bin)
+  {
+    if (binCounts[bin] == 0)
+      continue;
+
+    // Move the points of this bin to the left child.
+    if (UseWeights)
+    {
+      const double binWeight = arma::accu(binClassWeightSums.col(bin));
+      classWeightSums.col(0) += binClassWeightSums.col(bin);
+      classWeightSums.col(1) -= binClassWeightSums.col(bin);
+      totalLeftWeight += binWeight;
+      totalRightWeight -= binWeight;
+    }
+    else
+    {
+      classCounts.col(0) += binClassCounts.col(bin);
+      classCounts.col(1) -= binClassCounts.col(bin);
+    }
+    leftCount += binCounts[bin];
+
+    if (leftCount < minimum)
+      continue;
+    if (numPresent - leftCount < minimum)
+      break;
+
+    // Find the first non-empty bin on the right.
+    size_t nextBin = bin + 1;
+    while (nextBin < MaxBins && binCounts[nextBin] == 0)
+      ++nextBin;
+    if (nextBin == MaxBins)
+      break;
+
+    // Calculate the gain at this split point, sending the points with a
+    // missing value to the better child.  Only use weights if needed.
+    size_t missingDirection;
+    const double gain = UseWeights ?
+        BinaryGainWithMissing<true, FitnessFunction>(classWeightSums,
+            numClasses, totalLeftWeight, totalRightWeight, totalMissingWeight,
+            missingDirection) :
+        BinaryGainWithMissing<false, FitnessFunction>(classCounts, numClasses,
+            leftCount, numPresent - leftCount, numMissing, missingDirection);
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just
+      // take this one.  The actual split value will be halfway between the
+      // two bins.
+      splitInfo.set_size(1);
+      splitInfo[0] = (binMax[bin] + binMin[nextBin]) / 2.0;
+      aux.missingDirection = missingDirection;
+
+      return gain;
+    }
+    else if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      splitInfo.set_size(1);
+      splitInfo[0] = (binMax[bin] + binMin[nextBin]) / 2.0;
+      aux.missingDirection = missingDirection;
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= data.n_elem;
+
+  return bestFoundGain;
+}
+
+// Overload used for regression.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+typename std::enable_if<
+    !HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+    double>::type
+HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& splitInfo,
+    AuxiliarySplitInfo& aux,
+    FitnessFunction& fitnessFunction)
+{
+  typedef typename ResponsesType::elem_type RType;
+  typedef typename WeightVecType::elem_type WType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Quantize the data.  If all values are the same, we can't split in this
+  // dimension.  Points with a missing value are not put in any bin.
+  std::vector<uint8_t> bins;
+  arma::Col<size_t> binCounts;
+  arma::vec binMin, binMax;
+  size_t numMissing;
+  if (!Quantize(data, bins, binCounts, binMin, binMax, numMissing))
+    return DBL_MAX;
+  const size_t numPresent = data.n_elem - numMissing;
+  if (numPresent < (minimumLeafSize * 2))
+    return DBL_MAX;
+
+  // Group the responses by bin, with the points with a missing value last.
+  arma::uvec sortedIndices;
+  SortByBin(data, bins, binCounts, sortedIndices);
+  arma::Row<RType> sortedResponses(responses.n_elem);
+  arma::Row<WType> sortedWeights;
+  for (size_t i = 0; i < sortedResponses.n_elem; ++i)
+    sortedResponses[i] = responses[sortedIndices[i]];
+
+  // Only initialize if we are using weights.
+  if (UseWeights)
+  {
+    sortedWeights.set_size(sortedResponses.n_elem);
+    // The weights must keep the same order as the responses.
+    for (size_t i = 0; i < sortedResponses.n_elem; ++i)
+      sortedWeights[i] = weights[sortedIndices[i]];
+  }
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  // To send the points with a missing value to the left child, the fitness
+  // function needs them before the other points, so that each child is still
+  // a contiguous range.
+  arma::Row<RType> missingFirstResponses;
+  arma::Row<WType> missingFirstWeights;
+  if (numMissing > 0)
+  {
+    missingFirstResponses = arma::join_rows(
+        sortedResponses.tail(numMissing), sortedResponses.head(numPresent));
+    if (UseWeights)
+    {
+      missingFirstWeights = arma::join_rows(sortedWeights.tail(numMissing),
+          sortedWeights.head(numPresent));
+    }
+  }
+
+  WType totalWeight = 0.0;
+  WType totalLeftWeight = 0.0;
+  WType totalRightWeight = 0.0;
+  WType totalMissingWeight = 0.0;
+
+  if (UseWeights)
+  {
+    totalWeight = arma::accu(sortedWeights);
+    bestFoundGain *= totalWeight;
+
+    for (size_t i = 0; i < minimum - 1; ++i)
+      totalLeftWeight += sortedWeights[i];
+
+    for (size_t i = minimum - 1; i < numPresent; ++i)
+      totalRightWeight += sortedWeights[i];
+
+    for (size_t i = numPresent; i < data.n_elem; ++i)
+      totalMissingWeight += sortedWeights[i];
+  }
+  else
+  {
+    bestFoundGain *= data.n_elem;
+  }
+
+  // Loop through all bin boundaries, choosing the best one.
+  for (size_t index = minimum; index < numPresent - minimum + 1; ++index)
+  {
+    if (UseWeights)
+    {
+      totalLeftWeight += sortedWeights[index - 1];
+      totalRightWeight -= sortedWeights[index - 1];
+    }
+
+    // Make sure that the bin has changed.
+    const size_t leftBin = bins[sortedIndices[index - 1]];
+    const size_t rightBin = bins[sortedIndices[index]];
+    if (leftBin == rightBin)
+      continue;
+
+    // Calculate the gain for the left and right child, with the points with a
+    // missing value (if any) in the right child.
+    const double leftGain = fitnessFunction.template
+        Evaluate<UseWeights>(sortedResponses, sortedWeights, 0, index);
+    const double rightGain = fitnessFunction.template
+        Evaluate<UseWeights>(sortedResponses, sortedWeights, index,
+            responses.n_elem);
+
+    double gain;
+    if (UseWeights)
+    {
+      gain = totalLeftWeight * leftGain +
+          (totalRightWeight + totalMissingWeight) * rightGain;
+    }
+    else
+    {
+      // Calculate the gain at this split point.
+      gain = double(index) * leftGain +
+          double(sortedResponses.n_elem - index) * rightGain;
+    }
+
+    // The points with a missing value go to the right child, unless they
+    // do better in the left child.  If there are none, points with a missing
+    // value at prediction time go to the child with more points.
+    size_t missingDirection = 1;
+    if (numMissing > 0)
+    {
+      const double missingLeftGain = fitnessFunction.template
+          Evaluate<UseWeights>(missingFirstResponses, missingFirstWeights, 0,
+              numMissing + index);
+      const double missingRightGain = fitnessFunction.template
+          Evaluate<UseWeights>(missingFirstResponses, missingFirstWeights,
+              numMissing + index, responses.n_elem);
+      const double missingGain = UseWeights ?
+          (totalLeftWeight + totalMissingWeight) * missingLeftGain +
+              totalRightWeight * missingRightGain :
+          double(numMissing + index) * missingLeftGain +
+              double(numPresent - index) * missingRightGain;
+      if (missingGain > gain)
+      {
+        gain = missingGain;
+        missingDirection = 0;
+      }
+    }
+    else if (UseWeights ? (totalLeftWeight > totalRightWeight) :
+        (index > numPresent - index))
+    {
+      missingDirection = 0;
+    }
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just
+      // take this one.  The actual split value will be halfway between the
+      // two bins.
+      splitInfo = (binMax[leftBin] + binMin[rightBin]) / 2.0;
+      aux.missingDirection = missingDirection;
+
+      return gain;
+    }
+    if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      splitInfo = (binMax[leftBin] + binMin[rightBin]) / 2.0;
+      aux.missingDirection = missingDirection;
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= data.n_elem;
+
+  return bestFoundGain;
+}
+
+// Optimized version for any fitness function that implements
+// BinaryScanInitialize(), BinaryStep() and BinaryGains() functions.
+template<typename FitnessFunction>
+template<bool UseWeights, typename VecType, typename ResponsesType,
+         typename WeightVecType>
+typename std::enable_if<
+    HasOptimizedBinarySplitForms<FitnessFunction, UseWeights>::value,
+    double>::type
+HistogramNumericSplit<FitnessFunction>::SplitIfBetter(
+    const double bestGain,
+    const VecType& data,
+    const ResponsesType& responses,
+    const WeightVecType& weights,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    double& splitInfo,
+    AuxiliarySplitInfo& aux,
+    FitnessFunction& fitnessFunction)
+{
+  typedef typename ResponsesType::elem_type RType;
+  typedef typename WeightVecType::elem_type WType;
+
+  // First sanity check: if we don't have enough points, we can't split.
+  if (data.n_elem < (minimumLeafSize * 2))
+    return DBL_MAX;
+  if (bestGain == 0.0)
+    return DBL_MAX; // It can't be outperformed.
+
+  // Quantize the data.  If all values are the same, we can't split in this
+  // dimension.  Points with a missing value are not put in any bin.
+  std::vector<uint8_t> bins;
+  arma::Col<size_t> binCounts;
+  arma::vec binMin, binMax;
+  size_t numMissing;
+  if (!Quantize(data, bins, binCounts, binMin, binMax, numMissing))
+    return DBL_MAX;
+  const size_t numPresent = data.n_elem - numMissing;
+  if (numPresent < (minimumLeafSize * 2))
+    return DBL_MAX;
+
+  // Group the responses by bin, with the points with a missing value last.
+  arma::uvec sortedIndices;
+  SortByBin(data, bins, binCounts, sortedIndices);
+  arma::Row<RType> sortedResponses(responses.n_elem);
+  arma::Row<WType> sortedWeights;
+  for (size_t i = 0; i < sortedResponses.n_elem; ++i)
+    sortedResponses[i] = responses[sortedIndices[i]];
+
+  // Only initialize if we are using weights.
+  if (UseWeights)
+  {
+    sortedWeights.set_size(sortedResponses.n_elem);
+    // The weights must keep the same order as the responses.
+    for (size_t i = 0; i < sortedResponses.n_elem; ++i)
+      sortedWeights[i] = weights[sortedIndices[i]];
+  }
+
+  double bestFoundGain = std::min(bestGain + minimumGainSplit, 0.0);
+  bool improved = false;
+  // Force a minimum leaf size of 1 (empty children don't make sense).
+  const size_t minimum = std::max(minimumLeafSize, (size_t) 1);
+
+  WType totalWeight = 0.0;
+  WType leftChildWeight = 0.0;
+  WType rightChildWeight = 0.0;
+  WType missingWeight = 0.0;
+
+  if (UseWeights)
+  {
+    totalWeight = arma::accu(sortedWeights);
+    bestFoundGain *= totalWeight;
+
+    for (size_t i = 0; i < minimum - 1; ++i)
+      leftChildWeight += sortedWeights[i];
+
+    for (size_t i = minimum - 1; i < numPresent; ++i)
+      rightChildWeight += sortedWeights[i];
+
+    for (size_t i = numPresent; i < data.n_elem; ++i)
+      missingWeight += sortedWeights[i];
+  }
+  else
+  {
+    bestFoundGain *= data.n_elem;
+  }
+
+  // Initialize and precompute various statistics to efficiently compute gain
+  // values for all possible splits.  The points with a missing value (if any)
+  // are at the end, so they are in the right child.
+  fitnessFunction.template BinaryScanInitialize<UseWeights>(sortedResponses,
+      sortedWeights, minimum);
+
+  // A second scan keeps the points with a missing value in the left child, by
+  // placing them before all other points.
+  FitnessFunction missingLeftFitness(fitnessFunction);
+  arma::Row<RType> missingFirstResponses;
+  arma::Row<WType> missingFirstWeights;
+  if (numMissing > 0)
+  {
+    missingFirstResponses = arma::join_rows(
+        sortedResponses.tail(numMissing), sortedResponses.head(numPresent));
+    if (UseWeights)
+    {
+      missingFirstWeights = arma::join_rows(sortedWeights.tail(numMissing),
+          sortedWeights.head(numPresent));
+    }
+
+    missingLeftFitness.template BinaryScanInitialize<UseWeights>(
+        missingFirstResponses, missingFirstWeights, numMissing + minimum);
+  }
+
+  // Loop through all bin boundaries, choosing the best one.
+  for (size_t index = minimum; index < numPresent - minimum + 1; ++index)
+  {
+    if (UseWeights)
+    {
+      leftChildWeight += sortedWeights[index - 1];
+      rightChildWeight -= sortedWeights[index - 1];
+    }
+
+    // Steps through the current index and updates the cached data.
+    fitnessFunction.template BinaryStep<UseWeights>(sortedResponses,
+        sortedWeights, index - 1);
+    if (numMissing > 0)
+    {
+      missingLeftFitness.template BinaryStep<UseWeights>(
+          missingFirstResponses, missingFirstWeights, numMissing + index - 1);
+    }
+
+    // Make sure that the bin has changed.
+    const size_t leftBin = bins[sortedIndices[index - 1]];
+    const size_t rightBin = bins[sortedIndices[index]];
+    if (leftBin == rightBin)
+      continue;
+
+    // Calculate the gain for the left and right child.
+    std::tuple<double, double> binaryGains = fitnessFunction.BinaryGains();
+    const double leftGain = std::get<0>(binaryGains);
+    const double rightGain = std::get<1>(binaryGains);
+
+    double gain;
+    if (UseWeights)
+    {
+      gain = leftChildWeight * leftGain +
+          (rightChildWeight + missingWeight) * rightGain;
+    }
+    else
+    {
+      // Calculate the gain at this split point.
+      gain = double(index) * leftGain +
+          double(sortedResponses.n_elem - index) * rightGain;
+    }
+
+    // The points with a missing value go to the right child, unless they
+    // do better in the left child.  If there are none, points with a missing
+    // value at prediction time go to the child with more points.
+    size_t missingDirection = 1;
+    if (numMissing > 0)
+    {
+      binaryGains = missingLeftFitness.BinaryGains();
+      const double missingGain = UseWeights ?
+          (leftChildWeight + missingWeight) * std::get<0>(binaryGains) +
+              rightChildWeight * std::get<1>(binaryGains) :
+          double(numMissing + index) * std::get<0>(binaryGains) +
+              double(numPresent - index) * std::get<1>(binaryGains);
+      if (missingGain > gain)
+      {
+        gain = missingGain;
+        missingDirection = 0;
+      }
+    }
+    else if (UseWeights ? (leftChildWeight > rightChildWeight) :
+        (index > numPresent - index))
+    {
+      missingDirection = 0;
+    }
+
+    // Corner case: is this the best possible split?
+    if (gain >= 0.0)
+    {
+      // We can take a shortcut: no split will be better than this, so just
+      // take this one.  The actual split value will be halfway between the
+      // two bins.
+      splitInfo = (binMax[leftBin] + binMin[rightBin]) / 2.0;
+      aux.missingDirection = missingDirection;
+
+      return gain;
+    }
+    if (gain > bestFoundGain)
+    {
+      // We still have a better split.
+      bestFoundGain = gain;
+      splitInfo = (binMax[leftBin] + binMin[rightBin]) / 2.0;
+      aux.missingDirection = missingDirection;
+      improved = true;
+    }
+  }
+
+  // If we didn't improve, return the original gain exactly as we got it
+  // (without introducing floating point errors).
+  if (!improved)
+    return DBL_MAX;
+
+  if (UseWeights)
+    bestFoundGain /= totalWeight;
+  else
+    bestFoundGain /= data.n_elem;
+
+  return bestFoundGain;
+}
+
+template<typename FitnessFunction>
+template<typename ElemType>
+size_t HistogramNumericSplit<FitnessFunction>::CalculateDirection(
+    const ElemType& point,
+    const double& splitInfo,
+    const AuxiliarySplitInfo& aux)
+{
+  // Points with a missing value go to the child learned during training.
+  if (std::isnan((double) point))
+    return aux.missingDirection;
+  else if (point <= splitInfo)
+    return 0; // Go left.
+  else
+    return 1; // Go right.
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+bool HistogramNumericSplit<FitnessFunction>::Quantize(
+    const VecType& data,
+    std::vector<uint8_t>& bins,
+    arma::Col<size_t>& binCounts,
+    arma::vec& binMin,
+    arma::vec& binMax,
+    size_t& numMissing)
+{
+  // Collect the values that are not missing.  While there are at most MaxBins
+  // distinct values, keep them (sorted) too, so that each can get its own bin.
+  std::vector<double> values, distinctValues;
+  values.reserve(data.n_elem);
+  bool fewDistinctValues = true;
+  numMissing = 0;
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const double value = (double) data[i];
+    if (std::isnan(value))
+    {
+      ++numMissing;
+      continue;
+    }
+
+    values.push_back(value);
+    if (fewDistinctValues)
+    {
+      std::vector<double>::iterator it = std::lower_bound(
+          distinctValues.begin(), distinctValues.end(), value);
+      if (it == distinctValues.end() || *it != value)
+      {
+        if (distinctValues.size() == MaxBins)
+          fewDistinctValues = false;
+        else
+          distinctValues.insert(it, value);
+      }
+    }
+  }
+
+  if (fewDistinctValues && distinctValues.size() < 2)
+    return false;
+
+  // Find the largest value of each bin but the last.  With few distinct values,
+  // each value is a bin; otherwise the bins are bounded by quantiles of the
+  // values, so that they hold about the same number of points wherever the
+  // values lie (a few outliers do not squeeze all other values into a few
+  // bins).  Tied quantiles are merged, so that a bin holds all copies of a
+  // value.
+  std::vector<double> edges;
+  if (fewDistinctValues)
+  {
+    edges.assign(distinctValues.begin(), distinctValues.end() - 1);
+  }
+  else
+  {
+    // There are more values than bins here, so the ranks are distinct.
+    arma::Col<size_t> ranks(MaxBins - 1);
+    for (size_t k = 0; k < MaxBins - 1; ++k)
+      ranks[k] = (k + 1) * values.size() / MaxBins - 1;
+
+    edges.resize(MaxBins - 1);
+    SelectQuantiles(values, 0, values.size(), ranks, 0, MaxBins - 1, edges);
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+  }
+
+  bins.resize(data.n_elem);
+  binCounts.zeros(MaxBins);
+  binMin.set_size(MaxBins);
+  binMin.fill(DBL_MAX);
+  binMax.set_size(MaxBins);
+  binMax.fill(-DBL_MAX);
+  for (size_t i = 0; i < data.n_elem; ++i)
+  {
+    const double value = (double) data[i];
+    if (std::isnan(value))
+    {
+      bins[i] = 0;
+      continue;
+    }
+
+    // The bin of a value is the first bin whose largest value is not smaller.
+    const size_t bin = std::lower_bound(edges.begin(), edges.end(), value) -
+        edges.begin();
+
+    bins[i] = (uint8_t) bin;
+    ++binCounts[bin];
+    binMin[bin] = std::min(binMin[bin], value);
+    binMax[bin] = std::max(binMax[bin], value);
+  }
+
+  return true;
+}
+
+template<typename FitnessFunction>
+void HistogramNumericSplit<FitnessFunction>::SelectQuantiles(
+    std::vector<double>& values,
+    const size_t begin,
+    const size_t end,
+    const arma::Col<size_t>& ranks,
+    const size_t firstRank,
+    const size_t lastRank,
+    std::vector<double>& quantiles)
+{
+  if (firstRank >= lastRank)
+    return;
+
+  // Select the middle rank; this partitions the values around it, so the
+  // smaller and larger ranks can be selected in each side separately.
+  const size_t middle = (firstRank + lastRank) / 2;
+  const size_t rank = ranks[middle];
+  std::nth_element(values.begin() + begin, values.begin() + rank,
+      values.begin() + end);
+  quantiles[middle] = values[rank];
+
+  SelectQuantiles(values, begin, rank, ranks, firstRank, middle, quantiles);
+  SelectQuantiles(values, rank + 1, end, ranks, middle + 1, lastRank,
+      quantiles);
+}
+
+template<typename FitnessFunction>
+template<typename VecType>
+void HistogramNumericSplit<FitnessFunction>::SortByBin(
+    const VecType& data,
+    const std::vector<uint8_t>& bins,
+    const arma::Col<size_t>& binCounts,
+    arma::uvec& sortedIndices)
+{
+  // Compute the position of the first point of each bin.
+  arma::Col<size_t> offsets(MaxBins);
+  size_t offset = 0;
+  for (size_t bin = 0; bin < MaxBins; ++bin)
+  {
+    offsets[bin] = offset;
+    offset += binCounts[bin];
+  }
+
+  // The points with a missing value go after all bins.
+  sortedIndices.set_size(bins.size());
+  for (size_t i = 0; i < bins.size(); ++i)
+  {
+    if (std::isnan((double) data[i]))
+      sortedIndices[offset++] = i;
+    else
+      sortedIndices[offsets[bins[i]]++] = i;
+  }
+}
+
+} // namespace mlpack
+
+#endif
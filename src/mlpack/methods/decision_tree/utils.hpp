@@ -134,6 +134,194 @@ inline void Sum(const VecType& values,
   mean = total[0];
 }
 
+/**
+ * Make sure that every index in the given list refers to a point of the
+ * dataset, throwing std::invalid_argument if not.
+ */
+template<typename MatType>
+inline void CheckIndices(const MatType& data,
+                         const arma::uvec& indices,
+                         const std::string& callerDescription)
+{
+  if (indices.n_elem > 0 && indices.max() >= data.n_cols)
+  {
+    std::ostringstream oss;
+    oss << callerDescription << ": index " << indices.max() << " is out of "
+        << "bounds for dataset with " << data.n_cols << " points!";
+    throw std::invalid_argument(oss.str());
+  }
+}
+
+/**
+ * The minimum number of points a node must hold before the evaluation of its
+ * candidate split dimensions and the training of its children are done in
+ * separate OpenMP tasks.  Smaller nodes are not worth the tasking overhead.
+ */
+static const size_t minimumParallelNodeSize = 1024;
+
+/**
+ * Return whether a node holding the given number of points should be trained
+ * with OpenMP tasks.  This is only the case when the caller is inside a
+ * parallel region with more than one thread; otherwise all tasks are executed
+ * immediately, in order, so training is exactly the same as with a serial
+ * build.
+ */
+inline bool UseParallelNodeTraining(const size_t count)
+{
+  #ifdef MLPACK_USE_OPENMP
+  return (count >= minimumParallelNodeSize) && omp_in_parallel() &&
+      (omp_get_num_threads() > 1);
+  #else
+  (void) count;
+  return false;
+  #endif
+}
+
+/**
+ * Return whether a tree training on the given number of points should open its
+ * own parallel region for intra-tree parallelism.  This is not done when the
+ * tree is already being trained inside a parallel region (for instance, by
+ * RandomForest).
+ */
+inline bool OpenParallelNodeTraining(const size_t count)
+{
+  #ifdef MLPACK_USE_OPENMP
+  return (count >= minimumParallelNodeSize) && !omp_in_parallel() &&
+      (omp_get_max_threads() > 1);
+  #else
+  (void) count;
+  return false;
+  #endif
+}
+
+/**
+ * Serialize the given auxiliary split information of a decision tree node, if
+ * the split type stores anything in it (that is, if it has a serialize()
+ * function).
+ */
+template<typename Archive, typename AuxiliarySplitInfoType>
+inline void SerializeAuxiliarySplitInfo(
+    Archive& ar,
+    AuxiliarySplitInfoType& aux,
+    const char* name,
+    const typename std::enable_if_t<
+        data::HasSerialize<AuxiliarySplitInfoType>::value>* = 0)
+{
+  ar(cereal::make_nvp(name, aux));
+}
+
+/**
+ * Auxiliary split information without a serialize() function holds nothing, so
+ * there is nothing to serialize.
+ */
+template<typename Archive, typename AuxiliarySplitInfoType>
+inline void SerializeAuxiliarySplitInfo(
+    Archive& /* ar */,
+    AuxiliarySplitInfoType& /* aux */,
+    const char* /* name */,
+    const typename std::enable_if_t<
+        !data::HasSerialize<AuxiliarySplitInfoType>::value>* = 0)
+{
+  // Nothing to do.
+}
+
+/**
+ * Sort the indices of the given values, placing the indices of the values
+ * that are missing (NaN) after all other indices, in their original order.
+ * The number of missing values is returned.
+ */
+template<typename VecType>
+inline size_t SortIndicesWithMissing(const VecType& values,
+                                     arma::uvec& sortedIndices)
+{
+  size_t numMissing = 0;
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    if (std::isnan((double) values[i]))
+      ++numMissing;
+  }
+
+  if (numMissing == 0)
+  {
+    sortedIndices = arma::sort_index(values);
+    return 0;
+  }
+
+  // Sort only the values that are present.
+  const size_t numPresent = values.n_elem - numMissing;
+  arma::uvec presentIndices(numPresent);
+  arma::Col<typename VecType::elem_type> presentValues(numPresent);
+  sortedIndices.set_size(values.n_elem);
+  size_t present = 0;
+  size_t missing = numPresent;
+  for (size_t i = 0; i < values.n_elem; ++i)
+  {
+    if (std::isnan((double) values[i]))
+    {
+      sortedIndices[missing++] = i;
+    }
+    else
+    {
+      presentIndices[present] = i;
+      presentValues[present++] = values[i];
+    }
+  }
+
+  const arma::uvec order = arma::sort_index(presentValues);
+  for (size_t i = 0; i < numPresent; ++i)
+    sortedIndices[i] = presentIndices[order[i]];
+
+  return numMissing;
+}
+
+/**
+ * Compute the (unnormalized) gain of a binary split for classification, where
+ * the points with a missing value are sent to whichever child gives the larger
+ * gain.  The first three columns of counts must hold the class counts (or
+ * class weight sums) of the left child, the right child and the points with a
+ * missing value; the fourth column is used as scratch space.  The child that
+ * the points with a missing value go to is stored in missingDirection (0 for
+ * left, 1 for right).  If there are no such points, missingDirection is set to
+ * the child with the larger total, so that points with a missing value at
+ * prediction time follow the majority of the training points.
+ */
+template<bool UseWeights, typename FitnessFunction, typename CountType>
+inline double BinaryGainWithMissing(arma::Mat<CountType>& counts,
+                                    const size_t numClasses,
+                                    const CountType leftTotal,
+                                    const CountType rightTotal,
+                                    const CountType missingTotal,
+                                    size_t& missingDirection)
+{
+  if (missingTotal == CountType(0))
+  {
+    missingDirection = (leftTotal > rightTotal) ? 0 : 1;
+    return double(leftTotal) * FitnessFunction::template
+        EvaluatePtr<UseWeights>(counts.colptr(0), numClasses, leftTotal) +
+        double(rightTotal) * FitnessFunction::template
+        EvaluatePtr<UseWeights>(counts.colptr(1), numClasses, rightTotal);
+  }
+
+  // Send the points with a missing value to the right child.
+  counts.col(3) = counts.col(1) + counts.col(2);
+  const double rightGain = double(leftTotal) * FitnessFunction::template
+      EvaluatePtr<UseWeights>(counts.colptr(0), numClasses, leftTotal) +
+      double(rightTotal + missingTotal) * FitnessFunction::template
+      EvaluatePtr<UseWeights>(counts.colptr(3), numClasses,
+          CountType(rightTotal + missingTotal));
+
+  // Send the points with a missing value to the left child.
+  counts.col(3) = counts.col(0) + counts.col(2);
+  const double leftGain = double(leftTotal + missingTotal) *
+      FitnessFunction::template EvaluatePtr<UseWeights>(counts.colptr(3),
+          numClasses, CountType(leftTotal + missingTotal)) +
+      double(rightTotal) * FitnessFunction::template
+      EvaluatePtr<UseWeights>(counts.colptr(1), numClasses, rightTotal);
+
+  missingDirection = (leftGain > rightGain) ? 0 : 1;
+  return std::max(leftGain, rightGain);
+}
+
 } // namespace mlpack
 
 #endif
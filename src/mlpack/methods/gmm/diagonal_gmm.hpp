@@ -20,6 +20,8 @@
 
 // This is the default fitting method class.
 #include "em_fit.hpp"
+// Online fitting method, for use with Update().
+#include "online_em_fit.hpp"
 
 // This is the default covariance matrix constraint.
 #include "diagonal_constraint.hpp"
@@ -279,6 +281,36 @@ class DiagonalGMM
                const bool useExistingModel = false,
                FittingType fitter = FittingType());
 
+  /**
+   * Update the model with a single batch of observations, using an online
+   * fitting method (such as OnlineEMFit<>) that keeps its own state between
+   * calls.  This can be used to train on data that does not fit in memory, or
+   * that arrives continuously: each call consumes one batch, and the fitter
+   * must be reused between calls.  The FittingType class must provide the
+   * following function:
+   *
+   * @code
+   * void Update(const arma::mat& observations,
+   *             std::vector<DiagonalGaussianDistribution>& dists,
+   *             arma::vec& weights,
+   *             const bool useInitialModel);
+   * @endcode
+   *
+   * When the fitter has not seen any data yet, the existing model is used as
+   * the starting point if useExistingModel is true; otherwise, the fitter's
+   * initial clustering is run on the first batch.
+   *
+   * @param observations Batch of observations.
+   * @param fitter The online fitter to use; it will be modified.
+   * @param useExistingModel If true, the existing model is used as an initial
+   *     model for the first update.
+   * @return The log-likelihood of the batch under the updated model.
+   */
+  template<typename FittingType>
+  double Update(const arma::mat& observations,
+                FittingType& fitter,
+                const bool useExistingModel = false);
+
   /**
    * Classify the given observations as being from an individual component in
    * this DiagonalGMM. The resultant classifications are stored in the 'labels'
@@ -400,6 +400,16 @@ double DiagonalGMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+//! Update the DiagonalGMM with a single batch of observations.
+template<typename FittingType>
+double DiagonalGMM::Update(const arma::mat& observations,
+                           FittingType& fitter,
+                           const bool useExistingModel)
+{
+  fitter.Update(observations, dists, weights, useExistingModel);
+  return LogLikelihood(observations, dists, weights);
+}
+
 //! Serialize the object.
 template<typename Archive>
 void DiagonalGMM::serialize(Archive& ar, const uint32_t /* version */)
@@ -413,6 +413,18 @@ double GMM::Train(const arma::mat& observations,
   return bestLikelihood;
 }
 
+/**
+ * Update the GMM with a single batch of observations, using an online fitter.
+ */
+template<typename FittingType>
+double GMM::Update(const arma::mat& observations,
+                   FittingType& fitter,
+                   const bool useExistingModel)
+{
+  fitter.Update(observations, dists, weights, useExistingModel);
+  return LogLikelihood(observations, dists, weights);
+}
+
 /**
  * Serialize the object.
  */
@@ -83,7 +83,16 @@ BINDING_LONG_DESC(
     "will avoid the checks after each iteration of the EM algorithm which "
     "ensure that the covariance matrices are positive definite.  Specifying "
     "the flag can cause faster runtime, but may also cause non-positive "
-    "definite covariance matrices, which will cause the program to crash.");
+    "definite covariance matrices, which will cause the program to crash."
+    "\n\n"
+    "If the " + PRINT_PARAM_STRING("batch_size") + " parameter is given a "
+    "positive value, the model is trained with online (mini-batch) EM instead "
+    "of batch EM: each step only uses a batch of that many points, and the "
+    "running sufficient statistics are updated with a step size that decays "
+    "according to " + PRINT_PARAM_STRING("step_size_decay") + ".  In this "
+    "mode, " + PRINT_PARAM_STRING("max_iterations") + " is the maximum number "
+    "of passes over the data.  This is useful for very large datasets, where "
+    "each iteration of batch EM is expensive.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -125,6 +134,12 @@ PARAM_INT_IN("max_iterations", "Maximum number of iterations of EM algorithm "
 PARAM_FLAG("diagonal_covariance", "Force the covariance of the Gaussians to "
     "be diagonal.  This can accelerate training time significantly.", "d");
 
+// Parameters for online EM.
+PARAM_INT_IN("batch_size", "If greater than 0, use online EM with batches of "
+    "this many points instead of batch EM.", "b", 0);
+PARAM_DOUBLE_IN("step_size_decay", "Decay rate of the online EM step size "
+    "(between 0.5 and 1; only used if --batch_size is positive).", "D", 0.6);
+
 // Parameters for dataset modification.
 PARAM_DOUBLE_IN("noise", "Variance of zero-mean Gaussian noise to add to data.",
     "N", 0);
@@ -145,6 +160,63 @@ PARAM_MODEL_IN(GMM, "input_model", "Initial input GMM model to start training "
     "with.", "m");
 PARAM_MODEL_OUT(GMM, "output_model", "Output for trained GMM model.", "M");
 
+// Train the GMM with online EM, choosing the covariance constraint that matches
+// the user's options.
+template<typename KMeansType>
+double OnlineTrain(GMM& gmm,
+                   const arma::mat& dataPoints,
+                   const size_t trials,
+                   const size_t maxIterations,
+                   const double tolerance,
+                   const size_t batchSize,
+                   const double stepSizeDecay,
+                   const bool forcePositive,
+                   const bool diagonalCovariance,
+                   const KMeansType& k)
+{
+  if (diagonalCovariance)
+  {
+    // Convert the GMM into a DiagonalGMM, so that only the diagonals of the
+    // covariances and second moments are computed.
+    DiagonalGMM dgmm(gmm.Gaussians(), gmm.Dimensionality());
+    for (size_t i = 0; i < gmm.Gaussians(); ++i)
+    {
+      dgmm.Component(i).Mean() = gmm.Component(i).Mean();
+      dgmm.Component(i).Covariance(
+          std::move(arma::diagvec(gmm.Component(i).Covariance())));
+    }
+    dgmm.Weights() = gmm.Weights();
+
+    OnlineEMFit<KMeansType, PositiveDefiniteConstraint,
+        DiagonalGaussianDistribution> em(maxIterations, tolerance, batchSize,
+        stepSizeDecay, true, k);
+    const double likelihood = dgmm.Train(dataPoints, trials, false, em);
+
+    // Convert the DiagonalGMM back into a GMM.
+    for (size_t i = 0; i < gmm.Gaussians(); ++i)
+    {
+      gmm.Component(i).Mean() = dgmm.Component(i).Mean();
+      gmm.Component(i).Covariance(
+          arma::diagmat(dgmm.Component(i).Covariance()));
+    }
+    gmm.Weights() = dgmm.Weights();
+
+    return likelihood;
+  }
+  else if (forcePositive)
+  {
+    OnlineEMFit<KMeansType> em(maxIterations, tolerance, batchSize,
+        stepSizeDecay, true, k);
+    return gmm.Train(dataPoints, trials, false, em);
+  }
+  else
+  {
+    OnlineEMFit<KMeansType, NoConstraint> em(maxIterations, tolerance,
+        batchSize, stepSizeDecay, true, k);
+    return gmm.Train(dataPoints, trials, false, em);
+  }
+}
+
 void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 {
   // Check parameters and load data.
@@ -174,6 +246,12 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
       [](int x) { return x >= 0; }, true,
       "kmeans_max_iterations must be greater than or equal to 0");
 
+  RequireParamValue<int>(params, "batch_size", [](int x) { return x >= 0; },
+      true, "batch_size must be greater than or equal to 0");
+  RequireParamValue<double>(params, "step_size_decay",
+      [](double x) { return x > 0.5 && x <= 1.0; }, true,
+      "step_size_decay must be greater than 0.5 and less than or equal to 1");
+
   arma::mat dataPoints = std::move(params.Get<arma::mat>("input"));
 
   // Do we need to add noise to the dataset?
@@ -208,6 +286,13 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   const bool diagonalCovariance = params.Has("diagonal_covariance");
   const size_t kmeansMaxIterations =
       (size_t) params.Get<int>("kmeans_max_iterations");
+  const size_t batchSize = (size_t) params.Get<int>("batch_size");
+  const double stepSizeDecay = params.Get<double>("step_size_decay");
+  if (batchSize == 0)
+  {
+    ReportIgnoredParam(params, "step_size_decay",
+        "online EM is not used (batch_size is 0)");
+  }
 
   // This gets a bit weird because we need different types depending on whether
   // --refined_start is specified.
@@ -235,7 +320,15 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     // Depending on the value of forcePositive and diagonalCovariance, we have
     // to use different types.
-    if (diagonalCovariance)
+    if (batchSize > 0)
+    {
+      timers.Start("em");
+      likelihood = OnlineTrain(*gmm, dataPoints, params.Get<int>("trials"),
+          maxIterations, tolerance, batchSize, stepSizeDecay, forcePositive,
+          diagonalCovariance, k);
+      timers.Stop("em");
+    }
+    else if (diagonalCovariance)
     {
       // Convert GMMs into DiagonalGMMs.
       DiagonalGMM dgmm(gmm->Gaussians(), gmm->Dimensionality());
@@ -292,7 +385,15 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     // Depending on the value of forcePositive and diagonalCovariance, we have
     // to use different types.
-    if (diagonalCovariance)
+    if (batchSize > 0)
+    {
+      timers.Start("em");
+      likelihood = OnlineTrain(*gmm, dataPoints, params.Get<int>("trials"),
+          maxIterations, tolerance, batchSize, stepSizeDecay, forcePositive,
+          diagonalCovariance, KMeans<>(kmeansMaxIterations));
+      timers.Stop("em");
+    }
+    else if (diagonalCovariance)
     {
       // Convert GMMs into DiagonalGMMs.
       DiagonalGMM dgmm(gmm->Gaussians(), gmm->Dimensionality());
@@ -0,0 +1,336 @@
+/**
+ * @file methods/gmm/online_em_fit.hpp
+ *
+ * Utility class to fit a GMM using the online (stochastic) EM algorithm of
+ * Cappé and Moulines.  This can be used by GMM::Train<>() as a drop-in
+ * replacement for EMFit, or by GMM::Update<>() to train on a stream of batches.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_HPP
+
+#include <mlpack/prereqs.hpp>
+#include <mlpack/core/dists/dists.hpp>
+
+// Default clustering mechanism.
+#include <mlpack/methods/kmeans/kmeans.hpp>
+// Default covariance matrix constraint.
+#include "positive_definite_constraint.hpp"
+
+namespace mlpack {
+
+/**
+ * This class fits a GMM to observations using the online EM algorithm, as
+ * described in the following paper:
+ *
+ * @code
+ * @article{cappe2009online,
+ *   title={On-line expectation-maximization algorithm for latent data models},
+ *   author={Capp{\'e}, O. and Moulines, E.},
+ *   journal={Journal of the Royal Statistical Society: Series B (Statistical
+ *       Methodology)},
+ *   volume={71},
+ *   number={3},
+ *   pages={593--613},
+ *   year={2009}
+ * }
+ * @endcode
+ *
+ * Instead of computing the sufficient statistics of the model (the component
+ * masses, first moments, and second moments) over the whole dataset, each
+ * batch of points is used to compute the sufficient statistics of the batch,
+ * and these are blended into a running average with a decreasing step size
+ * (t + 1)^(-kappa).  The M-step is then performed on the running averages.
+ * Memory usage only depends on the batch size and the model size, so this is
+ * suitable for training on data that arrives continuously.
+ *
+ * The class can be used in two ways.  Estimate() satisfies the FittingType
+ * API expected by GMM::Train(), and makes a number of passes over the given
+ * dataset in batches.  Update() performs a single online step with one batch,
+ * and keeps the sufficient statistics inside the OnlineEMFit object so that
+ * the next call to Update() continues where the last one left off.
+ *
+ * Like EMFit, the initial model can be obtained with the InitialClusteringType
+ * (by default KMeans), which must implement the following method:
+ *
+ *  - void Cluster(const arma::mat& observations,
+ *                 const size_t clusters,
+ *                 arma::Row<size_t>& assignments);
+ *
+ * @tparam InitialClusteringType Clustering used to produce an initial model.
+ * @tparam CovarianceConstraintPolicy Constraint applied to each covariance.
+ * @tparam Distribution Type of each mixture component.
+ */
+template<typename InitialClusteringType = KMeans<>,
+         typename CovarianceConstraintPolicy = PositiveDefiniteConstraint,
+         typename Distribution = GaussianDistribution>
+class OnlineEMFit
+{
+ public:
+  //! Diagonal distributions store their covariance as a vector.
+  typedef typename std::conditional<
+      std::is_same<Distribution, DiagonalGaussianDistribution>::value,
+      arma::vec, arma::mat>::type CovarianceType;
+
+  /**
+   * Construct the OnlineEMFit object.  Setting the maximum number of
+   * iterations to 0 means that Estimate() will make passes over the data until
+   * the log-likelihood changes by less than the given tolerance.
+   *
+   * @param maxIterations Maximum number of passes over the data in Estimate().
+   * @param tolerance Log-likelihood tolerance required for convergence.
+   * @param batchSize Number of points in each batch used by Estimate().
+   * @param kappa Step size decay; must be in (0.5, 1].
+   * @param shuffle If true, the order of points is shuffled in each pass.
+   * @param clusterer Object which will perform the initial clustering.
+   * @param constraint Constraint policy of covariance.
+   */
+  OnlineEMFit(const size_t maxIterations = 100,
+              const double tolerance = 1e-5,
+              const size_t batchSize = 1000,
+              const double kappa = 0.6,
+              const bool shuffle = true,
+              InitialClusteringType clusterer = InitialClusteringType(),
+              CovarianceConstraintPolicy constraint =
+                  CovarianceConstraintPolicy());
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) using online EM,
+   * making passes over the dataset in batches of size BatchSize().  The size
+   * of the vectors (indicating the number of components) must already be set.
+   * Any sufficient statistics from earlier calls to Update() are discarded.
+   *
+   * @param observations List of observations to train on.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Fit the observations to a Gaussian mixture model (GMM) using online EM,
+   * taking into account the probabilities of each point being from this
+   * mixture.  The size of the vectors (indicating the number of components)
+   * must already be set.
+   *
+   * @param observations List of observations to train on.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions to store model in.
+   * @param weights Vector to store a priori weights in.
+   * @param useInitialModel If true, the given model is used for the initial
+   *      clustering.
+   */
+  void Estimate(const arma::mat& observations,
+                const arma::vec& probabilities,
+                std::vector<Distribution>& dists,
+                arma::vec& weights,
+                const bool useInitialModel = false);
+
+  /**
+   * Perform one online EM step on the given batch of observations.  If no
+   * batch has been seen yet (Steps() == 0), the sufficient statistics are
+   * initialized either from the given model (if useInitialModel is true) or by
+   * running the initial clustering on this batch.
+   *
+   * @param observations Batch of observations.
+   * @param dists Distributions of the model; these will be updated.
+   * @param weights A priori weights of the model; these will be updated.
+   * @param useInitialModel If true and this is the first step, the given model
+   *      is used to initialize the sufficient statistics.
+   */
+  void Update(const arma::mat& observations,
+              std::vector<Distribution>& dists,
+              arma::vec& weights,
+              const bool useInitialModel = false);
+
+  /**
+   * Perform one online EM step on the given batch of observations, taking into
+   * account the probability of each point being from this mixture.
+   *
+   * @param observations Batch of observations.
+   * @param probabilities Probability of each point being from this model.
+   * @param dists Distributions of the model; these will be updated.
+   * @param weights A priori weights of the model; these will be updated.
+   * @param useInitialModel If true and this is the first step, the given model
+   *      is used to initialize the sufficient statistics.
+   */
+  void Update(const arma::mat& observations,
+              const arma::vec& probabilities,
+              std::vector<Distribution>& dists,
+              arma::vec& weights,
+              const bool useInitialModel = false);
+
+  //! Forget all sufficient statistics, so the next Update() starts afresh.
+  void Reset();
+
+  //! Get the clusterer.
+  const InitialClusteringType& Clusterer() const { return clusterer; }
+  //! Modify the clusterer.
+  InitialClusteringType& Clusterer() { return clusterer; }
+
+  //! Get the covariance constraint policy class.
+  const CovarianceConstraintPolicy& Constraint() const { return constraint; }
+  //! Modify the covariance constraint policy class.
+  CovarianceConstraintPolicy& Constraint() { return constraint; }
+
+  //! Get the maximum number of passes over the data in Estimate().
+  size_t MaxIterations() const { return maxIterations; }
+  //! Modify the maximum number of passes over the data in Estimate().
+  size_t& MaxIterations() { return maxIterations; }
+
+  //! Get the tolerance for the convergence of Estimate().
+  double Tolerance() const { return tolerance; }
+  //! Modify the tolerance for the convergence of Estimate().
+  double& Tolerance() { return tolerance; }
+
+  //! Get the batch size used by Estimate().
+  size_t BatchSize() const { return batchSize; }
+  //! Modify the batch size used by Estimate().
+  size_t& BatchSize() { return batchSize; }
+
+  //! Get the step size decay.
+  double Kappa() const { return kappa; }
+  //! Modify the step size decay.
+  double& Kappa() { return kappa; }
+
+  //! Get whether or not points are shuffled in each pass of Estimate().
+  bool Shuffle() const { return shuffle; }
+  //! Modify whether or not points are shuffled in each pass of Estimate().
+  bool& Shuffle() { return shuffle; }
+
+  //! Get the number of online steps taken since the last Reset().
+  size_t Steps() const { return steps; }
+
+  //! Serialize the fitter, including the current sufficient statistics.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t version);
+
+ private:
+  /**
+   * Compute the (possibly weighted) posterior probability of each point
+   * belonging to each component under the current model.  The result is
+   * stored with one row per point and one column per component.
+   */
+  void Responsibilities(const arma::mat& observations,
+                        const std::vector<Distribution>& dists,
+                        const arma::vec& weights,
+                        arma::mat& responsibilities) const;
+
+  /**
+   * Run the initial clustering on the given observations and turn it into
+   * hard responsibilities (each row contains a single 1).
+   */
+  void InitialResponsibilities(const arma::mat& observations,
+                               const size_t clusters,
+                               arma::mat& responsibilities);
+
+  /**
+   * Initialize the running sufficient statistics, either from the given model
+   * or by running the initial clustering on the given observations (in which
+   * case the model is also recomputed).  Afterwards, Steps() is 1.
+   */
+  void Initialize(const arma::mat& observations,
+                  const arma::vec& probabilities,
+                  std::vector<Distribution>& dists,
+                  arma::vec& weights,
+                  const bool useInitialModel);
+
+  /**
+   * Initialize the running sufficient statistics from the given model.
+   */
+  void StatisticsFromModel(const std::vector<Distribution>& dists,
+                           const arma::vec& weights);
+
+  /**
+   * Blend the sufficient statistics of the given batch (described by its
+   * responsibilities) into the running statistics with the given step size.
+   */
+  void AccumulateStatistics(const arma::mat& observations,
+                            const arma::mat& responsibilities,
+                            const double stepSize);
+
+  /**
+   * Recompute the model from the running sufficient statistics (M-step).
+   */
+  void MaximizationStep(std::vector<Distribution>& dists,
+                        arma::vec& weights);
+
+  /**
+   * Shared implementation of both Update() overloads; if probabilities is
+   * empty, every point is given probability 1.
+   */
+  void Step(const arma::mat& observations,
+            const arma::vec& probabilities,
+            std::vector<Distribution>& dists,
+            arma::vec& weights,
+            const bool useInitialModel);
+
+  /**
+   * Shared implementation of both Estimate() overloads.
+   */
+  void EstimateInternal(const arma::mat& observations,
+                        const arma::vec& probabilities,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights,
+                        const bool useInitialModel);
+
+  //! Compute the weighted second moment x * x^T of the given points.
+  static void SecondMoment(const arma::mat& observations,
+                           const arma::vec& resp,
+                           arma::mat& moment);
+  //! Compute the weighted second moment diag(x * x^T) of the given points.
+  static void SecondMoment(const arma::mat& observations,
+                           const arma::vec& resp,
+                           arma::vec& moment);
+
+  //! Compute the (full) outer product of a mean.
+  static void OuterProduct(const arma::vec& mean, arma::mat& product);
+  //! Compute the diagonal of the outer product of a mean.
+  static void OuterProduct(const arma::vec& mean, arma::vec& product);
+
+  /**
+   * Calculate the log-likelihood of a model.
+   */
+  double LogLikelihood(const arma::mat& data,
+                       const std::vector<Distribution>& dists,
+                       const arma::vec& weights) const;
+
+  //! Maximum number of passes over the data in Estimate().
+  size_t maxIterations;
+  //! Tolerance for convergence of Estimate().
+  double tolerance;
+  //! Number of points in each batch of Estimate().
+  size_t batchSize;
+  //! Step size decay.
+  double kappa;
+  //! Whether or not to shuffle the data in each pass of Estimate().
+  bool shuffle;
+  //! Object which will perform the clustering.
+  InitialClusteringType clusterer;
+  //! Object which applies constraints to the covariance matrix.
+  CovarianceConstraintPolicy constraint;
+
+  //! Number of online steps taken since the last Reset().
+  size_t steps;
+  //! Running average of the mass of each component.
+  arma::vec massStats;
+  //! Running average of the first moment of each component (one per column).
+  arma::mat meanStats;
+  //! Running average of the second moment of each component.
+  std::vector<CovarianceType> covStats;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "online_em_fit_impl.hpp"
+
+#endif
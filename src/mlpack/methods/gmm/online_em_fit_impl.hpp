@@ -0,0 +1,478 @@
+/**
+ * @file methods/gmm/online_em_fit_impl.hpp
+ *
+ * Implementation of the online EM algorithm for fitting GMMs.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+#define MLPACK_METHODS_GMM_ONLINE_EM_FIT_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_em_fit.hpp"
+#include <mlpack/core/math/log_add.hpp>
+
+namespace mlpack {
+
+//! Constructor.
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy, Distribution>::
+OnlineEMFit(const size_t maxIterations,
+            const double tolerance,
+            const size_t batchSize,
+            const double kappa,
+            const bool shuffle,
+            InitialClusteringType clusterer,
+            CovarianceConstraintPolicy constraint) :
+    maxIterations(maxIterations),
+    tolerance(tolerance),
+    batchSize(batchSize),
+    kappa(kappa),
+    shuffle(shuffle),
+    clusterer(clusterer),
+    constraint(constraint),
+    steps(0)
+{
+  if (kappa <= 0.5 || kappa > 1.0)
+  {
+    Log::Warn << "OnlineEMFit::OnlineEMFit(): step size decay " << kappa
+        << " is outside of (0.5, 1]; convergence is not guaranteed."
+        << std::endl;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  EstimateInternal(observations, arma::vec(), dists, weights,
+      useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Estimate(const arma::mat& observations,
+                            const arma::vec& probabilities,
+                            std::vector<Distribution>& dists,
+                            arma::vec& weights,
+                            const bool useInitialModel)
+{
+  EstimateInternal(observations, probabilities, dists, weights,
+      useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& observations,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights,
+                          const bool useInitialModel)
+{
+  Step(observations, arma::vec(), dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Update(const arma::mat& observations,
+                          const arma::vec& probabilities,
+                          std::vector<Distribution>& dists,
+                          arma::vec& weights,
+                          const bool useInitialModel)
+{
+  if (probabilities.n_elem != observations.n_cols)
+  {
+    std::ostringstream oss;
+    oss << "OnlineEMFit::Update(): number of probabilities ("
+        << probabilities.n_elem << ") does not match number of points ("
+        << observations.n_cols << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  Step(observations, probabilities, dists, weights, useInitialModel);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Reset()
+{
+  steps = 0;
+  massStats.clear();
+  meanStats.clear();
+  covStats.clear();
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Initialize(const arma::mat& observations,
+                              const arma::vec& probabilities,
+                              std::vector<Distribution>& dists,
+                              arma::vec& weights,
+                              const bool useInitialModel)
+{
+  if (useInitialModel)
+  {
+    StatisticsFromModel(dists, weights);
+  }
+  else
+  {
+    // Turn the initial clustering into hard responsibilities and use those as
+    // the first batch; a step size of 1 means nothing else is blended in.
+    arma::mat responsibilities;
+    InitialResponsibilities(observations, dists.size(), responsibilities);
+    if (!probabilities.is_empty())
+      responsibilities.each_col() %= probabilities;
+
+    AccumulateStatistics(observations, responsibilities, 1.0);
+    MaximizationStep(dists, weights);
+  }
+
+  steps = 1;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Step(const arma::mat& observations,
+                        const arma::vec& probabilities,
+                        std::vector<Distribution>& dists,
+                        arma::vec& weights,
+                        const bool useInitialModel)
+{
+  if (steps == 0)
+  {
+    Initialize(observations, probabilities, dists, weights, useInitialModel);
+
+    // If we clustered this batch, it has already been used.
+    if (!useInitialModel)
+      return;
+  }
+
+  // E-step on the batch only.
+  arma::mat responsibilities;
+  Responsibilities(observations, dists, weights, responsibilities);
+  if (!probabilities.is_empty())
+    responsibilities.each_col() %= probabilities;
+
+  // Blend the batch statistics into the running averages, then M-step.
+  const double stepSize = std::pow((double) steps + 1.0, -kappa);
+  AccumulateStatistics(observations, responsibilities, stepSize);
+  MaximizationStep(dists, weights);
+
+  ++steps;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::EstimateInternal(const arma::mat& observations,
+                                    const arma::vec& probabilities,
+                                    std::vector<Distribution>& dists,
+                                    arma::vec& weights,
+                                    const bool useInitialModel)
+{
+  // Statistics from a previous Estimate() or Update() do not belong to this
+  // dataset.
+  Reset();
+  Initialize(observations, probabilities, dists, weights, useInitialModel);
+
+  double l = LogLikelihood(observations, dists, weights);
+
+  Log::Debug << "OnlineEMFit::Estimate(): initial clustering log-likelihood: "
+      << l << std::endl;
+
+  const size_t n = observations.n_cols;
+  const size_t effectiveBatchSize = (batchSize == 0 || batchSize > n) ? n :
+      batchSize;
+  arma::uvec ordering = arma::linspace<arma::uvec>(0, n - 1, n);
+
+  double lOld = -DBL_MAX;
+  size_t iteration = 1;
+  while (std::abs(l - lOld) > tolerance &&
+      (maxIterations == 0 || iteration <= maxIterations))
+  {
+    Log::Info << "OnlineEMFit::Estimate(): pass " << iteration << ", "
+        << "log-likelihood " << l << "." << std::endl;
+
+    if (shuffle)
+      ordering = arma::shuffle(ordering);
+
+    for (size_t begin = 0; begin < n; begin += effectiveBatchSize)
+    {
+      const size_t end = std::min(begin + effectiveBatchSize, n) - 1;
+      const arma::uvec batch = ordering.subvec(begin, end);
+      const arma::mat batchObservations = observations.cols(batch);
+
+      if (probabilities.is_empty())
+      {
+        Step(batchObservations, arma::vec(), dists, weights, true);
+      }
+      else
+      {
+        const arma::vec batchProbabilities = probabilities.elem(batch);
+        Step(batchObservations, batchProbabilities, dists, weights, true);
+      }
+    }
+
+    // Update values of l; calculate new log-likelihood.
+    lOld = l;
+    l = LogLikelihood(observations, dists, weights);
+
+    iteration++;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::Responsibilities(const arma::mat& observations,
+                                    const std::vector<Distribution>& dists,
+                                    const arma::vec& weights,
+                                    arma::mat& responsibilities) const
+{
+  responsibilities.set_size(observations.n_cols, dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Store conditional log probabilities directly into the column.
+    arma::vec alias(responsibilities.colptr(i), observations.n_cols, false,
+        true);
+    dists[i].LogProbability(observations, alias);
+    alias += std::log(weights[i]);
+  }
+
+  // Normalize row-wise.
+  for (size_t i = 0; i < responsibilities.n_rows; ++i)
+  {
+    // Avoid dividing by zero; if the probability for everything is 0, we
+    // don't want to make it NaN.
+    const double probSum = AccuLog(responsibilities.row(i));
+    if (probSum != -std::numeric_limits<double>::infinity())
+      responsibilities.row(i) -= probSum;
+  }
+
+  responsibilities = arma::exp(responsibilities);
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::InitialResponsibilities(const arma::mat& observations,
+                                           const size_t clusters,
+                                           arma::mat& responsibilities)
+{
+  // Assignments from clustering.
+  arma::Row<size_t> assignments;
+  clusterer.Cluster(observations, clusters, assignments);
+
+  responsibilities.zeros(observations.n_cols, clusters);
+  for (size_t i = 0; i < observations.n_cols; ++i)
+    responsibilities(i, assignments[i]) = 1.0;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::StatisticsFromModel(const std::vector<Distribution>& dists,
+                                       const arma::vec& weights)
+{
+  massStats = weights;
+  meanStats.set_size(dists[0].Mean().n_elem, dists.size());
+  covStats.resize(dists.size());
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    meanStats.col(i) = weights[i] * dists[i].Mean();
+
+    // E[x x^T] = Sigma + mu mu^T.
+    OuterProduct(dists[i].Mean(), covStats[i]);
+    covStats[i] = weights[i] * (dists[i].Covariance() + covStats[i]);
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::AccumulateStatistics(const arma::mat& observations,
+                                        const arma::mat& responsibilities,
+                                        const double stepSize)
+{
+  // All statistics are normalized by the total mass of the batch, so that the
+  // running averages do not depend on the batch size.
+  const double total = arma::accu(responsibilities);
+  if (total <= 0.0)
+  {
+    Log::Warn << "OnlineEMFit: batch has zero total probability; skipping."
+        << std::endl;
+    return;
+  }
+
+  arma::vec batchMass = arma::trans(arma::sum(responsibilities, 0)) / total;
+  arma::mat batchMean = observations * responsibilities / total;
+
+  const bool first = (stepSize == 1.0 || massStats.is_empty());
+  if (first)
+  {
+    massStats = std::move(batchMass);
+    meanStats = std::move(batchMean);
+    covStats.resize(responsibilities.n_cols);
+  }
+  else
+  {
+    massStats = (1.0 - stepSize) * massStats + stepSize * batchMass;
+    meanStats = (1.0 - stepSize) * meanStats + stepSize * batchMean;
+  }
+
+  for (size_t i = 0; i < responsibilities.n_cols; ++i)
+  {
+    CovarianceType batchCov;
+    SecondMoment(observations, responsibilities.col(i) / total, batchCov);
+
+    if (first)
+      covStats[i] = std::move(batchCov);
+    else
+      covStats[i] = (1.0 - stepSize) * covStats[i] + stepSize * batchCov;
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::MaximizationStep(std::vector<Distribution>& dists,
+                                    arma::vec& weights)
+{
+  weights = massStats / arma::accu(massStats);
+
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    // Don't update if there's no probability of the Gaussian having points.
+    if (massStats[i] <= 0.0)
+      continue;
+
+    dists[i].Mean() = meanStats.col(i) / massStats[i];
+
+    // Sigma = E[x x^T] - mu mu^T.
+    CovarianceType outer;
+    OuterProduct(dists[i].Mean(), outer);
+    CovarianceType covariance = covStats[i] / massStats[i] - outer;
+
+    // Apply covariance constraint.
+    constraint.ApplyConstraint(covariance);
+    dists[i].Covariance(std::move(covariance));
+  }
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::SecondMoment(const arma::mat& observations,
+                                const arma::vec& resp,
+                                arma::mat& moment)
+{
+  moment = (observations.each_row() % resp.t()) * observations.t();
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::SecondMoment(const arma::mat& observations,
+                                const arma::vec& resp,
+                                arma::vec& moment)
+{
+  moment = (observations % observations) * resp;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::OuterProduct(const arma::vec& mean, arma::mat& product)
+{
+  product = mean * mean.t();
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::OuterProduct(const arma::vec& mean, arma::vec& product)
+{
+  product = mean % mean;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+double OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::LogLikelihood(const arma::mat& observations,
+                                 const std::vector<Distribution>& dists,
+                                 const arma::vec& weights) const
+{
+  double logLikelihood = 0;
+
+  arma::vec logPhis;
+  arma::mat logLikelihoods(dists.size(), observations.n_cols);
+
+  // It has to be LogProbability() otherwise Probability() would overflow easily
+  for (size_t i = 0; i < dists.size(); ++i)
+  {
+    dists[i].LogProbability(observations, logPhis);
+    logLikelihoods.row(i) = std::log(weights(i)) + trans(logPhis);
+  }
+
+  // Now sum over every point.
+  for (size_t j = 0; j < observations.n_cols; ++j)
+    logLikelihood += AccuLog(logLikelihoods.col(j));
+
+  return logLikelihood;
+}
+
+template<typename InitialClusteringType,
+         typename CovarianceConstraintPolicy,
+         typename Distribution>
+template<typename Archive>
+void OnlineEMFit<InitialClusteringType, CovarianceConstraintPolicy,
+    Distribution>::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(maxIterations));
+  ar(CEREAL_NVP(tolerance));
+  ar(CEREAL_NVP(batchSize));
+  ar(CEREAL_NVP(kappa));
+  ar(CEREAL_NVP(shuffle));
+  ar(CEREAL_NVP(clusterer));
+  ar(CEREAL_NVP(constraint));
+  ar(CEREAL_NVP(steps));
+  ar(CEREAL_NVP(massStats));
+  ar(CEREAL_NVP(meanStats));
+  ar(CEREAL_NVP(covStats));
+}
+
+} // namespace mlpack
+
+#endif
@@ -164,6 +164,10 @@ class HMM
    * is called, it uses the current parameters of the HMM as a starting point
    * for training.
    *
+   * If OpenMP is enabled, the forward-backward passes over the sequences are
+   * run in parallel, with each thread accumulating its own transition and
+   * initial-state statistics that are combined once per iteration.
+   *
    * @param dataSeq Vector of observation sequences.
    * @return Log-likelihood of state sequence.
    */
@@ -547,4 +551,7 @@ class HMM
 // Include implementation.
 #include "hmm_impl.hpp"
 
+// Include online Viterbi decoding.
+#include "online_viterbi.hpp"
+
 #endif
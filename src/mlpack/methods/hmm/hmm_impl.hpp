@@ -113,10 +113,24 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
   }
 
   // These are used later for training of each distribution.  We initialize it
-  // all now so we don't have to do any allocation later on.
+  // all now so we don't have to do any allocation later on.  Each sequence
+  // owns a contiguous block of columns starting at seqOffsets[seq], so that
+  // sequences can be processed independently (and in parallel).
   std::vector<arma::vec> emissionProb(logTransition.n_cols,
       arma::vec(totalLength));
   arma::mat emissionList(dimensionality, totalLength);
+  std::vector<size_t> seqOffsets(dataSeq.size());
+  size_t sumTime = 0;
+  for (size_t seq = 0; seq < dataSeq.size(); seq++)
+  {
+    seqOffsets[seq] = sumTime;
+    if (dataSeq[seq].n_cols > 0)
+    {
+      emissionList.cols(sumTime, sumTime + dataSeq[seq].n_cols - 1) =
+          dataSeq[seq];
+    }
+    sumTime += dataSeq[seq].n_cols;
+  }
 
   // This should be the Baum-Welch algorithm (EM for HMM estimation). This
   // follows the procedure outlined in Elliot, Aggoun, and Moore's book "Hidden
@@ -132,70 +146,114 @@ double HMM<Distribution>::Train(const std::vector<arma::mat>& dataSeq)
     // Reset log likelihood.
     loglik = 0;
 
-    // Sum over time.
-    size_t sumTime = 0;
+    // Make sure the log-space parameters are up to date before any thread
+    // reads them; ConvertToLogSpace() is not safe to call concurrently.
+    ConvertToLogSpace();
 
-    // Loop over each sequence.
-    for (size_t seq = 0; seq < dataSeq.size(); seq++)
+    // Loop over each sequence.  Each thread accumulates its own sufficient
+    // statistics, and these are combined at the end of the E-step.
+    #pragma omp parallel
     {
-      arma::mat stateLogProb;
-      arma::mat forwardLog;
-      arma::mat backwardLog;
-      arma::vec logScales;
-
-      // Add the log-likelihood of this sequence.  This is the E-step.
-      loglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
-          backwardLog, logScales);
-
-      // Add to estimate of initial probability for state j.
-      LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
-          newLogInitial);
-
-      // Define a variable to store the value of log-probability for data.
-      arma::mat logProbs(dataSeq[seq].n_cols, logTransition.n_rows);
-      // Save the values of log-probability to logProbs.
-      for (size_t i = 0; i < logTransition.n_rows; i++)
+      arma::vec localLogInitial(logTransition.n_rows);
+      localLogInitial.fill(-std::numeric_limits<double>::infinity());
+      arma::mat localLogTransition(logTransition.n_rows, logTransition.n_cols);
+      localLogTransition.fill(-std::numeric_limits<double>::infinity());
+      double localLoglik = 0;
+
+      #pragma omp for schedule(dynamic)
+      for (size_t seq = 0; seq < dataSeq.size(); seq++)
       {
-        // Define alias of desired column.
-        arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
-        // Use advanced constructor for using logProbs directly.
-        emission[i].LogProbability(dataSeq[seq], alias);
-      }
+        arma::mat stateLogProb;
+        arma::mat forwardLog;
+        arma::mat backwardLog;
+        arma::vec logScales;
+
+        // Add the log-likelihood of this sequence.  This is the E-step.
+        localLoglik += LogEstimate(dataSeq[seq], stateLogProb, forwardLog,
+            backwardLog, logScales);
+
+        // Add to estimate of initial probability for state j.
+        LogSumExp<arma::vec, true>(stateLogProb.unsafe_col(0),
+            localLogInitial);
+
+        // Define a variable to store the value of log-probability for data.
+        arma::mat logProbs(dataSeq[seq].n_cols, logTransition.n_rows);
+        // Save the values of log-probability to logProbs.
+        for (size_t i = 0; i < logTransition.n_rows; i++)
+        {
+          // Define alias of desired column.
+          arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
+          // Use advanced constructor for using logProbs directly.
+          emission[i].LogProbability(dataSeq[seq], alias);
+        }
 
-      // Now re-estimate the parameters.  This is the M-step.
-      //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
-      //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t]) b(i,
-      //           t + 1)))
-      //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t) b(i, t)
-      // We store the new estimates in a different matrix.
-      for (size_t t = 0; t < dataSeq[seq].n_cols; ++t)
-      {
-        // Assemble temporary vector that's used in log-sum computation.
-        if (t < dataSeq[seq].n_cols - 1)
+        // Now re-estimate the parameters.  This is the M-step.
+        //   pi_i = sum_d ((1 / P(seq[d])) sum_t (f(i, 0) b(i, 0))
+        //   T_ij = sum_d ((1 / P(seq[d])) sum_t (f(i, t) T_ij E_i(seq[d][t])
+        //           b(i, t + 1)))
+        //   E_ij = sum_d ((1 / P(seq[d])) sum_{t | seq[d][t] = j} f(i, t)
+        //           b(i, t)
+        // We store the new estimates in a different matrix.
+        // The transition estimate sums, over time, the outer product of the
+        // (scaled) backward-emission term at time t + 1 and the forward
+        // probabilities at time t.  Instead of a log-sum-exp for every state
+        // at every time step, we take those terms out of log space and compute
+        // the whole sum with a single matrix multiplication.  The backward-
+        // emission term is not bounded (the old T_ij is factored out of it,
+        // and emission densities can be arbitrarily large or small), so before
+        // exp() we subtract the maximum over time of each state's terms, and
+        // add the maxima back after log().
+        const size_t seqLength = dataSeq[seq].n_cols;
+        if (seqLength > 1)
         {
-          // This term is the same across all states, so compute it once and
-          // cache it.
-          const arma::vec tmp = backwardLog.col(t + 1) +
-              logProbs.row(t + 1).t() - logScales[t + 1];
-          arma::vec output;
-          LogSumExp(tmp, output);
-
-          for (size_t j = 0; j < logTransition.n_cols; ++j)
+          arma::mat nextLogProb = backwardLog.cols(1, seqLength - 1) +
+              logProbs.rows(1, seqLength - 1).t();
+          for (size_t t = 1; t < seqLength; ++t)
+          {
+            if (std::isfinite(logScales[t]))
+              nextLogProb.col(t - 1) -= logScales[t];
+          }
+
+          arma::mat prevLogProb = forwardLog.cols(0, seqLength - 2);
+          arma::vec nextMax = arma::max(nextLogProb, 1);
+          arma::vec prevMax = arma::max(prevLogProb, 1);
+          nextMax.elem(arma::find_nonfinite(nextMax)).zeros();
+          prevMax.elem(arma::find_nonfinite(prevMax)).zeros();
+          nextLogProb.each_col() -= nextMax;
+          prevLogProb.each_col() -= prevMax;
+
+          // We postpone multiplication of the old T_ij until later.
+          arma::mat seqLogTransition = arma::log(arma::exp(nextLogProb) *
+              arma::exp(prevLogProb).t());
+          seqLogTransition.each_col() += nextMax;
+          seqLogTransition.each_row() += prevMax.t();
+          for (size_t i = 0; i < localLogTransition.n_elem; ++i)
           {
-            // Compute the estimate of T_ij (probability of transition from
-            // state j to state i).  We postpone multiplication of the old T_ij
-            // until later.
-            arma::vec tmp2 = output + forwardLog(j, t);
-            arma::vec alias = newLogTransition.unsafe_col(j);
-            LogSumExp<arma::vec, true>(tmp2, alias);
+            localLogTransition[i] = LogAdd(localLogTransition[i],
+                seqLogTransition[i]);
           }
         }
 
-        // Add to list of emission observations, for Distribution::Train().
+        // Add to list of emission probabilities, for Distribution::Train().
         for (size_t j = 0; j < logTransition.n_cols; ++j)
-          emissionProb[j][sumTime] = std::exp(stateLogProb(j, t));
-        emissionList.col(sumTime) = dataSeq[seq].col(t);
-        sumTime++;
+        {
+          emissionProb[j].subvec(seqOffsets[seq],
+              seqOffsets[seq] + seqLength - 1) =
+              arma::exp(stateLogProb.row(j).t());
+        }
+      }
+
+      // Combine the statistics from each thread.
+      #pragma omp critical
+      {
+        loglik += localLoglik;
+        for (size_t i = 0; i < newLogInitial.n_elem; ++i)
+          newLogInitial[i] = LogAdd(newLogInitial[i], localLogInitial[i]);
+        for (size_t i = 0; i < newLogTransition.n_elem; ++i)
+        {
+          newLogTransition[i] = LogAdd(newLogTransition[i],
+              localLogTransition[i]);
+        }
       }
     }
 
@@ -491,24 +549,10 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
   // calculate the log-likelihood at the end of it all.
   stateSeq.set_size(dataSeq.n_cols);
   arma::mat logStateProb(logTransition.n_rows, dataSeq.n_cols);
-  arma::mat stateSeqBack(logTransition.n_rows, dataSeq.n_cols);
+  arma::Mat<size_t> stateSeqBack(logTransition.n_rows, dataSeq.n_cols);
 
   ConvertToLogSpace();
 
-  // The calculation of the first state is slightly different; the probability
-  // of the first state being state j is the maximum probability that the state
-  // came to be j from another state.
-  logStateProb.col(0).zeros();
-  for (size_t state = 0; state < logTransition.n_rows; state++)
-  {
-    logStateProb(state, 0) = logInitial[state] +
-        emission[state].LogProbability(dataSeq.unsafe_col(0));
-    stateSeqBack(state, 0) = state;
-  }
-
-  // Store the best first state.
-  arma::uword index;
-
   // Define a variable to store the value of log-probability for dataSeq.
   arma::mat logProbs(dataSeq.n_cols, logTransition.n_rows);
 
@@ -521,20 +565,38 @@ double HMM<Distribution>::Predict(const arma::mat& dataSeq,
     emission[i].LogProbability(dataSeq, alias);
   }
 
+  // The calculation of the first state is slightly different; the probability
+  // of the first state being state j is the maximum probability that the state
+  // came to be j from another state.
+  logStateProb.col(0) = logInitial + logProbs.row(0).t();
+  for (size_t state = 0; state < logTransition.n_rows; state++)
+    stateSeqBack(state, 0) = state;
+
+  // Column j of the transposed transition matrix holds the log-probabilities
+  // of transitioning into state j from every state, so the maximization over
+  // the previous state is a reduction over contiguous columns.  The candidate
+  // matrix is allocated once and refilled at every time step.
+  const arma::mat logTransitionT = logTransition.t();
+  arma::mat prob(logTransition.n_rows, logTransition.n_cols);
+
   for (size_t t = 1; t < dataSeq.n_cols; t++)
   {
     // Assemble the state probability for this element.
     // Given that we are in state j, we use state with the highest probability
     // of being the previous state.
+    prob = logTransitionT;
+    prob.each_col() += logStateProb.col(t - 1);
+    const arma::urowvec best = arma::index_max(prob, 0);
+
     for (size_t j = 0; j < logTransition.n_rows; j++)
     {
-      arma::vec prob = logStateProb.col(t - 1) + logTransition.row(j).t();
-      logStateProb(j, t) = prob.max(index) + logProbs(t, j);
-      stateSeqBack(j, t) = index;
+      logStateProb(j, t) = prob(best[j], j) + logProbs(t, j);
+      stateSeqBack(j, t) = best[j];
     }
   }
 
   // Backtrack to find the most probable state sequence.
+  arma::uword index;
   logStateProb.unsafe_col(dataSeq.n_cols - 1).max(index);
   stateSeq[dataSeq.n_cols - 1] = index;
   for (size_t t = 2; t <= dataSeq.n_cols; t++)
@@ -746,12 +808,22 @@ arma::vec HMM<Distribution>::ForwardAtTn(const arma::vec& emissionLogProb,
 
   // The forward probability of state j at time t is the sum over all states of
   // the probability of the previous state transitioning to the current state
-  // and emitting the given observation.  To do this computation in log-space,
-  // we can use LogSumExp().
-  arma::vec forwardLogProb;
-  arma::mat tmp = logTransition + repmat(prevForwardLogProb.t(),
-      logTransition.n_rows, 1);
-  LogSumExp(tmp, forwardLogProb);
+  // and emitting the given observation.  Rather than a log-sum-exp over every
+  // element of the transition matrix, we shift the previous forward
+  // probabilities by their maximum, leave log space, and compute the sum as a
+  // single matrix-vector product.
+  arma::vec forwardLogProb(logTransition.n_rows);
+  const double maxLogProb = prevForwardLogProb.max();
+  if (std::isfinite(maxLogProb))
+  {
+    forwardLogProb = arma::log(transitionProxy *
+        arma::exp(prevForwardLogProb - maxLogProb)) + maxLogProb;
+  }
+  else
+  {
+    forwardLogProb.fill(-std::numeric_limits<double>::infinity());
+  }
+
   forwardLogProb += emissionLogProb;
 
   // Normalize probability.
@@ -814,13 +886,17 @@ void HMM<Distribution>::Backward(const arma::mat& dataSeq,
     // The backward probability of state j at time t is the sum over all
     // states of the probability of the next state having been a transition
     // from the current state multiplied by the probability of each of those
-    // states emitting the given observation.  To compute this in log-space, we
-    // can use LogSumExpT().
-    const arma::mat tmp = logTransition +
-        repmat(backwardLogProb.col(t + 1), 1, logTransition.n_cols) +
-        repmat(logProbs.row(t + 1).t(), 1, logTransition.n_cols);
-    arma::vec alias = backwardLogProb.unsafe_col(t);
-    LogSumExpT<arma::mat, true>(tmp, alias);
+    // states emitting the given observation.  As in the forward pass, we
+    // shift by the maximum and compute the sum as one matrix-vector product
+    // with the transposed transition matrix.
+    const arma::vec tmp = backwardLogProb.col(t + 1) +
+        logProbs.row(t + 1).t();
+    const double maxLogProb = tmp.max();
+    if (!std::isfinite(maxLogProb))
+      continue;
+
+    backwardLogProb.col(t) = arma::log(transitionProxy.t() *
+        arma::exp(tmp - maxLogProb)) + maxLogProb;
 
     // Normalize by the weights from the forward algorithm.
     if (std::isfinite(logScales[t + 1]))
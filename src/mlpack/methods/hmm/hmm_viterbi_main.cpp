@@ -44,7 +44,17 @@ BINDING_LONG_DESC(
     "hidden state sequence of a given sequence of observations (specified as "
     "'" + PRINT_PARAM_STRING("input") + ", using the Viterbi algorithm.  The "
     "computed state sequence may be saved using the " +
-    PRINT_PARAM_STRING("output") + " output parameter.");
+    PRINT_PARAM_STRING("output") + " output parameter."
+    "\n\n"
+    "If the observation sequence is very long, the " +
+    PRINT_PARAM_STRING("online") + " flag may be specified; in this case the "
+    "sequence is decoded incrementally, and only the part of the Viterbi "
+    "trellis whose most probable states are not yet known is kept in memory.  "
+    "The result is identical to the regular Viterbi algorithm.  To strictly "
+    "bound the memory usage, " + PRINT_PARAM_STRING("max_delay") + " may be "
+    "set to the maximum number of undecided time steps to keep; when this "
+    "limit is reached, the oldest states are decided along the currently most "
+    "probable path, which may differ from the exact Viterbi path.");
 
 // Example.
 BINDING_EXAMPLE(
@@ -67,6 +77,10 @@ BINDING_SEE_ALSO("HMM class documentation", "@src/mlpack/methods/hmm/hmm.hpp");
 PARAM_MATRIX_IN_REQ("input", "Matrix containing observations,", "i");
 PARAM_MODEL_IN_REQ(HMMModel, "input_model", "Trained HMM to use.", "m");
 PARAM_UMATRIX_OUT("output", "File to save predicted state sequence to.", "o");
+PARAM_FLAG("online", "If set, decode the sequence incrementally with bounded "
+    "memory.", "O");
+PARAM_INT_IN("max_delay", "Maximum number of undecided time steps to keep when "
+    "--online is specified (0 means no limit).", "D", 0);
 
 // Because we don't know what the type of our HMM is, we need to write a
 // function that can take arbitrary HMM types.
@@ -95,7 +109,36 @@ struct Viterbi
     }
 
     arma::Row<size_t> sequence;
-    hmm.Predict(dataSeq, sequence);
+    if (params.Has("online"))
+    {
+      // Feed the observations in blocks, so that only the emission
+      // probabilities of one block have to be computed at a time.
+      const size_t blockSize = 1024;
+      OnlineViterbi<HMMType> viterbi(hmm,
+          (size_t) params.Get<int>("max_delay"));
+
+      sequence.set_size(dataSeq.n_cols);
+      size_t decided = 0;
+      arma::Row<size_t> states;
+      for (size_t begin = 0; begin < dataSeq.n_cols; begin += blockSize)
+      {
+        const size_t end = std::min(begin + blockSize, (size_t) dataSeq.n_cols);
+        viterbi.Update(arma::mat(dataSeq.cols(begin, end - 1)), states);
+        if (states.n_elem > 0)
+        {
+          sequence.subvec(decided, decided + states.n_elem - 1) = states;
+          decided += states.n_elem;
+        }
+      }
+
+      viterbi.Finish(states);
+      if (states.n_elem > 0)
+        sequence.subvec(decided, decided + states.n_elem - 1) = states;
+    }
+    else
+    {
+      hmm.Predict(dataSeq, sequence);
+    }
 
     // Save output.
     params.Get<arma::Mat<size_t>>("output") = std::move(sequence);
@@ -107,6 +150,10 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& /* timers */)
   RequireAtLeastOnePassed(params, { "output" }, false,
       "no results will be saved");
 
+  RequireParamValue<int>(params, "max_delay", [](int x) { return x >= 0; },
+      true, "maximum delay must be nonnegative");
+  ReportIgnoredParam(params, {{ "online", false }}, "max_delay");
+
   params.Get<HMMModel*>("input_model")->PerformAction<Viterbi>(
       params, (void*) NULL);
 }
@@ -0,0 +1,180 @@
+/**
+ * @file methods/hmm/online_viterbi.hpp
+ *
+ * Definition of the OnlineViterbi class, which decodes the most probable
+ * hidden state sequence of an HMM incrementally, with bounded memory.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_ONLINE_VITERBI_HPP
+#define MLPACK_METHODS_HMM_ONLINE_VITERBI_HPP
+
+#include <mlpack/prereqs.hpp>
+
+#include <deque>
+
+namespace mlpack {
+
+/**
+ * An online implementation of the Viterbi algorithm.  HMM::Predict() needs the
+ * whole observation sequence and stores a backpointer for every state at every
+ * time step; for very long sequences, this is prohibitive.  OnlineViterbi
+ * instead consumes observations one at a time (or in blocks), and only keeps
+ * the backpointers for the time steps whose most probable state is not yet
+ * known.
+ *
+ * After each observation, the survivor paths of every current state are traced
+ * backwards.  As soon as they all pass through a single state at some time
+ * step, every state up to and including that time step is part of the final
+ * Viterbi path, no matter what the future observations are; those states are
+ * returned to the caller and the corresponding backpointers are discarded.
+ * This is the traceback approach described in, e.g.,
+ *
+ * @code
+ * @article{sramek2007online,
+ *   title={On-line {V}iterbi algorithm for analysis of long biological
+ *       sequences},
+ *   author={{\v{S}}r{\'a}mek, R. and Brejov{\'a}, B. and Vina{\v{r}}, T.},
+ *   journal={Algorithms in Bioinformatics},
+ *   pages={240--251},
+ *   year={2007}
+ * }
+ * @endcode
+ *
+ * In the worst case the survivor paths may not merge for a long time.  If
+ * maxDelay is nonzero, at most maxDelay undecided time steps are kept; when
+ * that limit is exceeded, the oldest states are decided by tracing back from
+ * the currently most probable state.  This bounds memory exactly, at the cost
+ * of possibly deviating from the exact Viterbi path.
+ *
+ * Example use:
+ *
+ * @code
+ * HMM<GaussianDistribution> hmm = ...; // A trained HMM.
+ * OnlineViterbi<HMM<GaussianDistribution>> viterbi(hmm);
+ *
+ * arma::Row<size_t> states;
+ * while (moreObservations)
+ * {
+ *   arma::mat block = ...; // Next block of observations.
+ *   viterbi.Update(block, states);
+ *   // 'states' holds the next decided states of the sequence.
+ * }
+ *
+ * // Decide the remaining states.
+ * viterbi.Finish(states);
+ * @endcode
+ *
+ * @tparam HMMType Type of HMM to decode with.
+ */
+template<typename HMMType>
+class OnlineViterbi
+{
+ public:
+  /**
+   * Create the OnlineViterbi object for the given HMM.  The HMM's parameters
+   * are read once during construction; the HMM must outlive this object, since
+   * its emission distributions are used during decoding.
+   *
+   * @param hmm HMM to decode with.
+   * @param maxDelay Maximum number of undecided time steps to keep (0 means
+   *     no limit, which gives the exact Viterbi path).
+   */
+  OnlineViterbi(const HMMType& hmm, const size_t maxDelay = 0);
+
+  /**
+   * Consume a single observation.  Any states that can be decided are stored
+   * in the given vector (which will be empty if no states were decided).
+   *
+   * @param observation Next observation of the sequence.
+   * @param decoded Vector to store newly decided states in.
+   */
+  void Update(const arma::vec& observation, arma::Row<size_t>& decoded);
+
+  /**
+   * Consume a block of observations (one per column).  Any states that can be
+   * decided are stored in the given vector.
+   *
+   * @param observations Next observations of the sequence.
+   * @param decoded Vector to store newly decided states in.
+   */
+  void Update(const arma::mat& observations, arma::Row<size_t>& decoded);
+
+  /**
+   * Signal the end of the sequence: all remaining states are decided by
+   * tracing back from the most probable final state, and stored in the given
+   * vector.  After this call, the object is reset and can decode a new
+   * sequence.
+   *
+   * @param decoded Vector to store the remaining states in.
+   * @return Log-likelihood of the most probable state sequence.
+   */
+  double Finish(arma::Row<size_t>& decoded);
+
+  //! Forget the current sequence, so that a new one can be decoded.
+  void Reset();
+
+  //! Get the number of observations consumed for the current sequence.
+  size_t Time() const { return time; }
+  //! Get the number of states that have been decided so far.
+  size_t Decided() const { return decidedTime; }
+  //! Get the number of time steps whose state is not yet decided.
+  size_t Pending() const { return time - decidedTime; }
+
+  //! Get the maximum number of undecided time steps (0 means no limit).
+  size_t MaxDelay() const { return maxDelay; }
+  //! Modify the maximum number of undecided time steps (0 means no limit).
+  size_t& MaxDelay() { return maxDelay; }
+
+ private:
+  //! Perform one Viterbi step with the given emission log-probabilities.
+  void Step(const arma::vec& emissionLogProb, std::vector<size_t>& decoded);
+
+  /**
+   * Trace back the survivor paths of the current states, and decide every state
+   * up to the point where they merge (or as many states as needed to respect
+   * maxDelay).
+   */
+  void Decide(std::vector<size_t>& decoded);
+
+  /**
+   * Decide the states from decidedTime up to and including lastTime, given
+   * that the state at lastTime is lastState.
+   */
+  void Emit(const size_t lastTime,
+            const size_t lastState,
+            std::vector<size_t>& decoded);
+
+  //! The HMM used for decoding.
+  const HMMType& hmm;
+  //! Maximum number of undecided time steps (0 means no limit).
+  size_t maxDelay;
+
+  //! Log of the initial state probabilities.
+  arma::vec logInitial;
+  //! Transposed log transition matrix (column j: transitions into state j).
+  arma::mat logTransitionT;
+
+  //! Number of observations consumed.
+  size_t time;
+  //! Number of states decided.
+  size_t decidedTime;
+  //! Log-probability of the best path ending in each state (shifted).
+  arma::vec logStateProb;
+  //! Total shift removed from logStateProb to keep it bounded.
+  double logOffset;
+  //! Backpointers for times decidedTime + 1 through time - 1.
+  std::deque<arma::uvec> backpointers;
+  //! Workspace for the candidate matrix of each step.
+  arma::mat candidates;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "online_viterbi_impl.hpp"
+
+#endif
@@ -0,0 +1,208 @@
+/**
+ * @file methods/hmm/online_viterbi_impl.hpp
+ *
+ * Implementation of the OnlineViterbi class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_HMM_ONLINE_VITERBI_IMPL_HPP
+#define MLPACK_METHODS_HMM_ONLINE_VITERBI_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "online_viterbi.hpp"
+
+namespace mlpack {
+
+template<typename HMMType>
+OnlineViterbi<HMMType>::OnlineViterbi(const HMMType& hmm,
+                                      const size_t maxDelay) :
+    hmm(hmm),
+    maxDelay(maxDelay),
+    logInitial(arma::log(hmm.Initial())),
+    logTransitionT(arma::log(hmm.Transition()).t()),
+    time(0),
+    decidedTime(0),
+    logOffset(0.0)
+{
+  // Nothing else to do.
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::Update(const arma::vec& observation,
+                                    arma::Row<size_t>& decoded)
+{
+  const size_t states = logInitial.n_elem;
+  arma::vec emissionLogProb(states);
+  for (size_t j = 0; j < states; ++j)
+    emissionLogProb(j) = hmm.Emission()[j].LogProbability(observation);
+
+  std::vector<size_t> buffer;
+  Step(emissionLogProb, buffer);
+  decoded = arma::conv_to<arma::Row<size_t>>::from(buffer);
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::Update(const arma::mat& observations,
+                                    arma::Row<size_t>& decoded)
+{
+  const size_t states = logInitial.n_elem;
+
+  // Compute the emission log-probabilities of the whole block at once.
+  arma::mat logProbs(observations.n_cols, states);
+  for (size_t i = 0; i < states; ++i)
+  {
+    // Define alias of desired column.
+    arma::vec alias(logProbs.colptr(i), logProbs.n_rows, false, true);
+    // Use advanced constructor for using logProbs directly.
+    hmm.Emission()[i].LogProbability(observations, alias);
+  }
+
+  std::vector<size_t> buffer;
+  arma::vec emissionLogProb(states);
+  for (size_t t = 0; t < observations.n_cols; ++t)
+  {
+    emissionLogProb = logProbs.row(t).t();
+    Step(emissionLogProb, buffer);
+  }
+
+  decoded = arma::conv_to<arma::Row<size_t>>::from(buffer);
+}
+
+template<typename HMMType>
+double OnlineViterbi<HMMType>::Finish(arma::Row<size_t>& decoded)
+{
+  if (time == 0)
+  {
+    decoded.clear();
+    return -std::numeric_limits<double>::infinity();
+  }
+
+  // The remaining states are found by tracing back from the most probable
+  // final state, exactly like the backtrace of HMM::Predict().
+  const arma::uword best = logStateProb.index_max();
+  const double logLikelihood = logStateProb(best) + logOffset;
+
+  std::vector<size_t> buffer;
+  if (Pending() > 0)
+    Emit(time - 1, best, buffer);
+  decoded = arma::conv_to<arma::Row<size_t>>::from(buffer);
+
+  Reset();
+  return logLikelihood;
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::Reset()
+{
+  time = 0;
+  decidedTime = 0;
+  logOffset = 0.0;
+  logStateProb.clear();
+  backpointers.clear();
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::Step(const arma::vec& emissionLogProb,
+                                  std::vector<size_t>& decoded)
+{
+  if (time == 0)
+  {
+    logStateProb = logInitial + emissionLogProb;
+  }
+  else
+  {
+    // Same recursion as HMM::Predict(): column j of the candidate matrix holds
+    // the log-probability of reaching state j from every previous state.
+    candidates = logTransitionT;
+    candidates.each_col() += logStateProb;
+    const arma::uvec best = arma::index_max(candidates, 0).t();
+
+    for (size_t j = 0; j < logStateProb.n_elem; ++j)
+      logStateProb(j) = candidates(best[j], j) + emissionLogProb(j);
+
+    backpointers.push_back(best);
+  }
+
+  // Keep the log-probabilities bounded for long sequences; the shift is the
+  // same for every state, so the argmax is not affected.
+  const double shift = logStateProb.max();
+  if (std::isfinite(shift))
+  {
+    logStateProb -= shift;
+    logOffset += shift;
+  }
+
+  ++time;
+  Decide(decoded);
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::Decide(std::vector<size_t>& decoded)
+{
+  // Only states that can still be reached take part in the traceback; an
+  // unreachable state can never be on the final Viterbi path.
+  arma::uvec survivors = arma::find_finite(logStateProb);
+  if (survivors.n_elem == 0)
+    survivors = arma::regspace<arma::uvec>(0, logStateProb.n_elem - 1);
+
+  if (survivors.n_elem == 1)
+  {
+    Emit(time - 1, survivors[0], decoded);
+    return;
+  }
+
+  // Walk the survivor paths backwards until they merge.  backpointers[k] maps
+  // the states at time decidedTime + k + 1 to the states at the previous time.
+  for (size_t k = backpointers.size(); k > 0; --k)
+  {
+    survivors = arma::unique(backpointers[k - 1].elem(survivors));
+    if (survivors.n_elem == 1)
+    {
+      Emit(decidedTime + k - 1, survivors[0], decoded);
+      break;
+    }
+  }
+
+  // If the paths have not merged in time, force a decision along the currently
+  // most probable path.
+  if (maxDelay > 0 && Pending() > maxDelay)
+  {
+    const size_t lastTime = time - maxDelay - 1;
+    size_t state = logStateProb.index_max();
+    for (size_t t = time - 1; t > lastTime; --t)
+      state = backpointers[t - decidedTime - 1][state];
+
+    Emit(lastTime, state, decoded);
+  }
+}
+
+template<typename HMMType>
+void OnlineViterbi<HMMType>::Emit(const size_t lastTime,
+                                  const size_t lastState,
+                                  std::vector<size_t>& decoded)
+{
+  // Trace back from lastState to the first undecided time step.
+  const size_t count = lastTime - decidedTime + 1;
+  const size_t start = decoded.size();
+  decoded.resize(start + count);
+
+  size_t state = lastState;
+  decoded[start + count - 1] = state;
+  for (size_t t = lastTime; t > decidedTime; --t)
+  {
+    state = backpointers[t - decidedTime - 1][state];
+    decoded[start + (t - 1 - decidedTime)] = state;
+  }
+
+  // The backpointers into the decided time steps are no longer needed.
+  const size_t discard = std::min(count, backpointers.size());
+  backpointers.erase(backpointers.begin(), backpointers.begin() + discard);
+  decidedTime = lastTime + 1;
+}
+
+} // namespace mlpack
+
+#endif
@@ -460,6 +460,9 @@ class HoeffdingTree
   //! Get the number of classes the tree is trained on.
   size_t NumClasses() const { return numClasses; }
 
+  //! Get the information on the dimensions of the data the tree is trained on.
+  const data::DatasetInfo& DatasetInfo() const { return *datasetInfo; }
+
   /**
    * Given a point and that this node is not a leaf, calculate the index of the
    * child node this point would go towards.  This method is primarily used by
@@ -551,6 +554,10 @@ class HoeffdingTree
   void serialize(Archive& ar, const uint32_t /* version */);
 
  private:
+  //! The minimum number of split statistic updates (or routed points) for
+  //! streaming training to use multiple threads.
+  static const size_t minimumParallelUpdates = 4096;
+
   // We need to keep some information for before we have split.
 
   //! Information for splitting of numeric features (used before split).
@@ -605,6 +612,22 @@ class HoeffdingTree
                      const arma::Row<size_t>& labels,
                      const bool batchTraining);
 
+  /**
+   * Train in streaming mode on the points indices[begin] to
+   * indices[begin + count - 1] of the data, in that order.  The points are
+   * taken in mini-batches that end at each split check; within a mini-batch,
+   * the statistics of all dimensions are updated in parallel.  Points that
+   * arrive after a split are routed to the children.  The resulting tree is
+   * the same as if each point was passed to Train(point, label) in turn.
+   * indices may be reordered.
+   */
+  template<typename MatType>
+  void TrainStream(const MatType& data,
+                   const arma::Row<size_t>& labels,
+                   arma::uvec& indices,
+                   const size_t begin,
+                   const size_t count);
+
   /**
    * Reset the tree.  This assumes datasetInfo is set correctly.
    */
@@ -1351,11 +1351,125 @@ void HoeffdingTree<
       }
     }
   }
-  else
+  else if (data.n_cols > 0)
   {
-    // We aren't training in batch mode; loop through the points.
-    for (size_t i = 0; i < data.n_cols; ++i)
-      Train(data.col(i), labels[i]);
+    // We aren't training in batch mode; stream the points through the tree in
+    // order.
+    arma::uvec indices = arma::linspace<arma::uvec>(0, data.n_cols - 1,
+        data.n_cols);
+    TrainStream(data, labels, indices, 0, data.n_cols);
+  }
+}
+
+template<
+    typename FitnessFunction,
+    template<typename> class NumericSplitType,
+    template<typename> class CategoricalSplitType
+>
+template<typename MatType>
+void HoeffdingTree<
+    FitnessFunction,
+    NumericSplitType,
+    CategoricalSplitType
+>::TrainStream(const MatType& data,
+               const arma::Row<size_t>& labels,
+               arma::uvec& indices,
+               const size_t begin,
+               const size_t count)
+{
+  const size_t end = begin + count;
+  size_t i = begin;
+  while (i < end && splitDimension == size_t(-1))
+  {
+    // Take the points up to the next split check; the statistics of each
+    // dimension do not depend on the other dimensions, so they are updated in
+    // parallel, each with the points in their original order.
+    const size_t segmentSize = std::min(end - i,
+        checkInterval - (numSamples % checkInterval));
+    const size_t numDimensions = categoricalSplits.size() +
+        numericSplits.size();
+    const bool parallel = (numDimensions > 1) && (numDimensions * segmentSize >=
+        (size_t) minimumParallelUpdates);
+
+    #pragma omp parallel for schedule(dynamic) if (parallel)
+    for (size_t d = 0; d < numDimensions; ++d)
+    {
+      const size_t type = dimensionMappings->at(d).first;
+      const size_t index = dimensionMappings->at(d).second;
+      if (type == data::Datatype::categorical)
+      {
+        for (size_t j = i; j < i + segmentSize; ++j)
+          categoricalSplits[index].Train(data(d, indices[j]),
+              labels[indices[j]]);
+      }
+      else if (type == data::Datatype::numeric)
+      {
+        for (size_t j = i; j < i + segmentSize; ++j)
+          numericSplits[index].Train(data(d, indices[j]), labels[indices[j]]);
+      }
+    }
+
+    numSamples += segmentSize;
+    i += segmentSize;
+
+    // Grab majority class from splits.
+    if (categoricalSplits.size() > 0)
+    {
+      majorityClass = categoricalSplits[0].MajorityClass();
+      majorityProbability = categoricalSplits[0].MajorityProbability();
+    }
+    else
+    {
+      majorityClass = numericSplits[0].MajorityClass();
+      majorityProbability = numericSplits[0].MajorityProbability();
+    }
+
+    // Check for a split, if we should.
+    if (numSamples % checkInterval == 0)
+    {
+      const size_t numChildren = SplitCheck();
+      if (numChildren > 0)
+      {
+        // We need to add a bunch of children.
+        // Delete children, if we have them.
+        children.clear();
+        CreateChildren();
+      }
+    }
+  }
+
+  if (i == end)
+    return;
+
+  // We have split, so the remaining points are routed to the children.  The
+  // points of each child keep their order, so each child sees the same
+  // sequence of points as if they had been passed one at a time.
+  const size_t remaining = end - i;
+  arma::uvec directions(remaining);
+  #pragma omp parallel for if (remaining >= (size_t) minimumParallelUpdates)
+  for (size_t j = 0; j < remaining; ++j)
+    directions[j] = CalculateDirection(data.col(indices[i + j]));
+
+  std::vector<size_t> childBegins(children.size() + 1, 0);
+  for (size_t j = 0; j < remaining; ++j)
+    ++childBegins[directions[j] + 1];
+  for (size_t c = 0; c < children.size(); ++c)
+    childBegins[c + 1] += childBegins[c];
+
+  arma::uvec routed(remaining);
+  std::vector<size_t> positions(childBegins.begin(), childBegins.end() - 1);
+  for (size_t j = 0; j < remaining; ++j)
+    routed[positions[directions[j]]++] = indices[i + j];
+  indices.subvec(i, end - 1) = routed;
+
+  for (size_t c = 0; c < children.size(); ++c)
+  {
+    const size_t childCount = childBegins[c + 1] - childBegins[c];
+    if (childCount > 0)
+    {
+      children[c]->TrainStream(data, labels, indices, i + childBegins[c],
+          childCount);
+    }
   }
 }
 
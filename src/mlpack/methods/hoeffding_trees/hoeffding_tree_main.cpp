@@ -56,6 +56,19 @@ BINDING_LONG_DESC(
     PRINT_PARAM_STRING("batch_mode") + " option, but this may not be the best "
     "option for large datasets."
     "\n\n"
+    "For datasets that do not fit in memory, the training set may instead be "
+    "streamed from a file (.csv, .tsv, .txt or Armadillo binary .bin) given "
+    "with the " + PRINT_PARAM_STRING("training_file") + " parameter; then "
+    "only " + PRINT_PARAM_STRING("chunk_size") + " points are held in memory "
+    "at a time, and the labels must be the last dimension of the file.  If the "
+    "file has categorical dimensions, or " + PRINT_PARAM_STRING("num_classes") +
+    " is not given, the file is read one extra time before training to find "
+    "every category and the number of classes.  While training "
+    "on a file, the model can be saved to the file given by " +
+    PRINT_PARAM_STRING("checkpoint_file") + " every " +
+    PRINT_PARAM_STRING("checkpoint_interval") + " points; a checkpoint may "
+    "later be given as " + PRINT_PARAM_STRING("input_model") + "."
+    "\n\n"
     "When a model is trained, it may be saved via the " +
     PRINT_PARAM_STRING("output_model") + " output parameter.  A model may be "
     "loaded from file for further training or testing with the " +
@@ -98,6 +111,18 @@ PARAM_MATRIX_AND_INFO_IN("training", "Training dataset (may be categorical).",
     "t");
 PARAM_UROW_IN("labels", "Labels for training dataset.", "l");
 
+PARAM_STRING_IN("training_file", "File to stream the training dataset from in "
+    "chunks, instead of loading it into memory; the labels must be the last "
+    "dimension.", "f", "");
+PARAM_INT_IN("chunk_size", "Number of points to read at a time from the file "
+    "given with 'training_file'.", "C", 10000);
+PARAM_INT_IN("num_classes", "Number of classes in the file given with "
+    "'training_file'; if 0, it is determined from the file.", "k", 0);
+PARAM_STRING_IN("checkpoint_file", "File to save the model to periodically "
+    "while training on the file given with 'training_file'.", "K", "");
+PARAM_INT_IN("checkpoint_interval", "Number of points between saves of the "
+    "model to the checkpoint file (0 means no checkpoints).", "e", 0);
+
 PARAM_DOUBLE_IN("confidence", "Confidence before splitting (between 0 and 1).",
     "c", 0.95);
 PARAM_INT_IN("max_samples", "Maximum number of samples before splitting.", "n",
@@ -141,7 +166,9 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   const string numericSplitStrategy =
       params.Get<string>("numeric_split_strategy");
 
-  RequireAtLeastOnePassed(params, { "training", "input_model" }, true);
+  RequireAtLeastOnePassed(params, { "training", "training_file",
+      "input_model" }, true);
+  RequireOnlyOnePassed(params, { "training", "training_file" }, true, "", true);
 
   RequireAtLeastOnePassed(params, { "output_model", "predictions",
       "probabilities", "test_labels" }, false, "no output will be given");
@@ -150,7 +177,30 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
   ReportIgnoredParam(params, {{ "test", false }}, "predictions");
 
   ReportIgnoredParam(params, {{ "training", false }}, "batch_mode");
-  ReportIgnoredParam(params, {{ "training", false }}, "passes");
+  ReportIgnoredParam(params, {{ "training", false },
+      { "training_file", false }}, "passes");
+
+  ReportIgnoredParam(params, {{ "training_file", false }}, "chunk_size");
+  ReportIgnoredParam(params, {{ "training_file", false }}, "num_classes");
+  ReportIgnoredParam(params, {{ "training_file", false }}, "checkpoint_file");
+  ReportIgnoredParam(params, {{ "training_file", false }},
+      "checkpoint_interval");
+
+  if (params.Has("training_file"))
+  {
+    RequireParamValue<int>(params, "chunk_size", [](int x) { return x > 0; },
+        true, "chunk size must be positive");
+    RequireParamValue<int>(params, "num_classes", [](int x) { return x >= 0; },
+        true, "number of classes must not be negative");
+    RequireParamValue<int>(params, "checkpoint_interval",
+        [](int x) { return x >= 0; }, true,
+        "checkpoint interval must not be negative");
+    if (params.Get<int>("checkpoint_interval") > 0)
+    {
+      RequireAtLeastOnePassed(params, { "checkpoint_file" }, true,
+          "no checkpoints can be saved");
+    }
+  }
 
   if (params.Has("test"))
   {
@@ -251,6 +301,48 @@ void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
 
     timers.Stop("tree_training");
   }
+  else if (params.Has("training_file"))
+  {
+    // Load necessary parameters for training.
+    const double confidence = params.Get<double>("confidence");
+    const size_t maxSamples = (size_t) params.Get<int>("max_samples");
+    const size_t minSamples = (size_t) params.Get<int>("min_samples");
+    const size_t bins = (size_t) params.Get<int>("bins");
+    const size_t observationsBeforeBinning = (size_t)
+        params.Get<int>("observations_before_binning");
+    size_t passes = (size_t) params.Get<int>("passes");
+    const size_t chunkSize = (size_t) params.Get<int>("chunk_size");
+    const size_t checkpointInterval =
+        (size_t) params.Get<int>("checkpoint_interval");
+    const string checkpointFile = params.Get<string>("checkpoint_file");
+
+    // Only one chunk of the training set is held in memory at a time.
+    ChunkedReader reader(params.Get<string>("training_file"), chunkSize);
+
+    timers.Start("tree_training");
+
+    size_t points = 0;
+    if (!params.Has("input_model"))
+    {
+      // Build the model from the first chunk, then stream over the rest.
+      points = model->BuildModel(reader, datasetInfo,
+          (size_t) params.Get<int>("num_classes"), confidence, maxSamples, 100,
+          minSamples, bins, observationsBeforeBinning, checkpointInterval,
+          checkpointFile);
+      --passes; // This model-building takes one pass.
+    }
+
+    for (size_t p = 0; p < passes; ++p)
+    {
+      reader.Reset();
+      points = model->Train(reader, checkpointInterval, checkpointFile);
+    }
+
+    timers.Stop("tree_training");
+
+    Log::Info << "Trained on " << points << " points in each pass, in chunks "
+        << "of " << chunkSize << " points." << endl;
+  }
 
   // Do we need to evaluate the training set error?
   if (params.Has("training"))
@@ -135,6 +135,71 @@ class HoeffdingTreeModel
              const arma::Row<size_t>& labels,
              const bool batchTraining);
 
+  /**
+   * Build the model by streaming once over the points read by the given
+   * ChunkedReader, so that only one chunk of the dataset is held in memory at
+   * a time.  The last value of each point is taken as its label.  The first
+   * chunk is used to find the types of the dimensions if the given DatasetInfo
+   * is empty.  If any dimension is categorical, or numClasses is 0, the whole
+   * file is first read once to map every category (and find the number of
+   * classes), since the tree cannot take new categories after it is built.
+   * Then the tree is created from the first chunk, and the points of all
+   * chunks are passed to the tree in streaming mode.
+   *
+   * If checkpointInterval is greater than 0, the model is saved to
+   * checkpointFile whenever at least checkpointInterval points have been seen
+   * since the last checkpoint (checkpoints are only taken between chunks), and
+   * once more after the last chunk.
+   *
+   * @param reader Reader to read the dataset with.
+   * @param datasetInfo Information about dimensions of dataset; if it has no
+   *      dimensions, it is filled from the first chunk.
+   * @param numClasses Number of classes in dataset; if 0, the largest label in
+   *      the file plus one is used.
+   * @param successProbability Probability of success required in Hoeffding
+   *      bound before a split can happen.
+   * @param maxSamples Maximum number of samples before a split is forced.
+   * @param checkInterval Number of samples required before each split check.
+   * @param minSamples If the node has seen this many points or fewer, no split
+   *      will be allowed.
+   * @param bins Number of bins, for Hoeffding numeric split.
+   * @param observationsBeforeBinning Number of observations before binning, for
+   *      Hoeffding numeric split.
+   * @param checkpointInterval Number of points between checkpoints (0 means no
+   *      checkpoints).
+   * @param checkpointFile File to save checkpoints of the model to.
+   * @return The number of points trained on.
+   */
+  size_t BuildModel(data::ChunkedReader& reader,
+                    data::DatasetInfo& datasetInfo,
+                    const size_t numClasses,
+                    const double successProbability,
+                    const size_t maxSamples,
+                    const size_t checkInterval,
+                    const size_t minSamples,
+                    const size_t bins,
+                    const size_t observationsBeforeBinning,
+                    const size_t checkpointInterval = 0,
+                    const std::string& checkpointFile = "");
+
+  /**
+   * Train in streaming mode on the points read by the given ChunkedReader,
+   * one chunk at a time.  This takes one pass, and the last value of each
+   * point is taken as its label.  Categorical values are mapped with the
+   * mappings the model was built with; a category that was not seen when the
+   * model was built causes an exception.  Checkpoints are taken as in
+   * BuildModel().  Be sure that BuildModel() has been called first!
+   *
+   * @param reader Reader to read the dataset with.
+   * @param checkpointInterval Number of points between checkpoints (0 means no
+   *      checkpoints).
+   * @param checkpointFile File to save checkpoints of the model to.
+   * @return The number of points trained on.
+   */
+  size_t Train(data::ChunkedReader& reader,
+               const size_t checkpointInterval = 0,
+               const std::string& checkpointFile = "");
+
   /**
    * Using the model, classify the given test points.  Be sure that BuildModel()
    * has been called first!
@@ -197,6 +262,18 @@ class HoeffdingTreeModel
   }
 
  private:
+  /**
+   * Pass the points of the remaining chunks of the reader to the given tree,
+   * taking checkpoints of the model as needed; pointsSinceCheckpoint is the
+   * number of points already trained on since the last checkpoint.
+   */
+  template<typename HoeffdingTreeType>
+  size_t TrainChunks(HoeffdingTreeType& tree,
+                     data::ChunkedReader& reader,
+                     size_t pointsSinceCheckpoint,
+                     const size_t checkpointInterval,
+                     const std::string& checkpointFile);
+
   //! The type of tree we are using.
   TreeType type;
 
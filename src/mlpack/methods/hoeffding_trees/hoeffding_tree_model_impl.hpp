@@ -219,6 +219,111 @@ inline void HoeffdingTreeModel::Train(const arma::mat& dataset,
   }
 }
 
+// Create the model from the chunks of a file.
+inline size_t HoeffdingTreeModel::BuildModel(
+    data::ChunkedReader& reader,
+    data::DatasetInfo& datasetInfo,
+    const size_t numClasses,
+    const double successProbability,
+    const size_t maxSamples,
+    const size_t checkInterval,
+    const size_t minSamples,
+    const size_t bins,
+    const size_t observationsBeforeBinning,
+    const size_t checkpointInterval,
+    const std::string& checkpointFile)
+{
+  // Build the tree on the first chunk.
+  size_t points;
+  {
+    arma::mat chunk;
+    arma::Row<size_t> labels;
+    if (!reader.Next(chunk, datasetInfo, labels))
+    {
+      throw std::invalid_argument("HoeffdingTreeModel::BuildModel(): no points "
+          "in '" + reader.Filename() + "'!");
+    }
+
+    // The categorical splits of the tree cannot take new categories after the
+    // tree is built, so if there are categorical dimensions, map the values of
+    // the whole file first.  The number of classes, if not given, is also
+    // taken from the whole file.  Then go back to the first chunk.
+    bool categorical = false;
+    for (size_t d = 0; d < datasetInfo.Dimensionality(); ++d)
+      if (datasetInfo.Type(d) == data::Datatype::categorical)
+        categorical = true;
+
+    size_t maxLabel = arma::max(labels);
+    if (categorical || numClasses == 0)
+    {
+      while (reader.Next(chunk, datasetInfo, labels))
+        maxLabel = std::max(maxLabel, (size_t) arma::max(labels));
+
+      reader.Reset();
+      reader.Next(chunk, datasetInfo, labels);
+    }
+
+    if (numClasses != 0 && maxLabel >= numClasses)
+    {
+      std::ostringstream oss;
+      oss << "HoeffdingTreeModel::BuildModel(): label " << maxLabel << " in '"
+          << reader.Filename() << "' is not less than the number of classes ("
+          << numClasses << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    BuildModel(chunk, datasetInfo, labels,
+        (numClasses == 0) ? maxLabel + 1 : numClasses, false,
+        successProbability, maxSamples, checkInterval, minSamples, bins,
+        observationsBeforeBinning);
+    points = chunk.n_cols;
+  }
+
+  // Now stream over the rest of the chunks.
+  switch (type)
+  {
+    case GINI_HOEFFDING:
+      return points + TrainChunks(*giniHoeffdingTree, reader, points,
+          checkpointInterval, checkpointFile);
+    case GINI_BINARY:
+      return points + TrainChunks(*giniBinaryTree, reader, points,
+          checkpointInterval, checkpointFile);
+    case INFO_HOEFFDING:
+      return points + TrainChunks(*infoHoeffdingTree, reader, points,
+          checkpointInterval, checkpointFile);
+    case INFO_BINARY:
+      return points + TrainChunks(*infoBinaryTree, reader, points,
+          checkpointInterval, checkpointFile);
+  }
+
+  return points; // This should never happen!
+}
+
+// Train the model on one pass of the chunks of a file.
+inline size_t HoeffdingTreeModel::Train(data::ChunkedReader& reader,
+                                        const size_t checkpointInterval,
+                                        const std::string& checkpointFile)
+{
+  // Depending on the type, pass through once.
+  switch (type)
+  {
+    case GINI_HOEFFDING:
+      return TrainChunks(*giniHoeffdingTree, reader, 0, checkpointInterval,
+          checkpointFile);
+    case GINI_BINARY:
+      return TrainChunks(*giniBinaryTree, reader, 0, checkpointInterval,
+          checkpointFile);
+    case INFO_HOEFFDING:
+      return TrainChunks(*infoHoeffdingTree, reader, 0, checkpointInterval,
+          checkpointFile);
+    case INFO_BINARY:
+      return TrainChunks(*infoBinaryTree, reader, 0, checkpointInterval,
+          checkpointFile);
+  }
+
+  return 0; // This should never happen!
+}
+
 // Classify the given points.
 inline void HoeffdingTreeModel::Classify(const arma::mat& dataset,
                                          arma::Row<size_t>& predictions)
@@ -272,6 +377,66 @@ inline void HoeffdingTreeModel::Classify(const arma::mat& dataset,
   }
 }
 
+// Stream the remaining chunks of a file through the given tree.
+template<typename HoeffdingTreeType>
+size_t HoeffdingTreeModel::TrainChunks(HoeffdingTreeType& tree,
+                                       data::ChunkedReader& reader,
+                                       size_t pointsSinceCheckpoint,
+                                       const size_t checkpointInterval,
+                                       const std::string& checkpointFile)
+{
+  // The reader maps categorical values with a copy of the tree's DatasetInfo.
+  // The reader may add new categories to the copy, but the tree can only
+  // handle the categories it was built with.
+  const data::DatasetInfo& treeInfo = tree.DatasetInfo();
+  data::DatasetInfo info(treeInfo);
+
+  arma::mat chunk;
+  arma::Row<size_t> labels;
+  size_t points = 0;
+  while (reader.Next(chunk, info, labels))
+  {
+    for (size_t d = 0; d < info.Dimensionality(); ++d)
+    {
+      if (info.NumMappings(d) != treeInfo.NumMappings(d))
+      {
+        std::ostringstream oss;
+        oss << "HoeffdingTreeModel::Train(): dimension " << d << " of '"
+            << reader.Filename() << "' has categories that the model was not "
+            << "built with!";
+        throw std::invalid_argument(oss.str());
+      }
+    }
+
+    const size_t maxLabel = arma::max(labels);
+    if (maxLabel >= tree.NumClasses())
+    {
+      std::ostringstream oss;
+      oss << "HoeffdingTreeModel::Train(): label " << maxLabel << " in '"
+          << reader.Filename() << "' is not less than the number of classes ("
+          << tree.NumClasses() << ")!";
+      throw std::invalid_argument(oss.str());
+    }
+
+    // Each chunk is a mini-batch for streaming training.
+    tree.Train(chunk, labels, tree.NumClasses(), false);
+
+    points += chunk.n_cols;
+    pointsSinceCheckpoint += chunk.n_cols;
+    if (checkpointInterval > 0 && pointsSinceCheckpoint >= checkpointInterval)
+    {
+      data::Save(checkpointFile, "model", *this, true);
+      pointsSinceCheckpoint = 0;
+    }
+  }
+
+  // Make sure that the last checkpoint holds the fully trained model.
+  if (checkpointInterval > 0 && pointsSinceCheckpoint > 0)
+    data::Save(checkpointFile, "model", *this, true);
+
+  return points;
+}
+
 // Utility function for counting the number of nodes.
 template<typename TreeType>
 size_t CountNodes(TreeType& tree)
@@ -22,6 +22,12 @@ namespace mlpack {
  * apply mean shift algorithm until maximum iterations or convergence.  Then
  * remove duplicate centroids.
  *
+ * All seeds are shifted simultaneously: in each iteration, a single dual-tree
+ * range search on a tree built once over the dataset finds the neighbors of
+ * every seed that has not converged yet, and the new centroids are computed in
+ * parallel with OpenMP.  Seeds whose trajectories meet (within the convergence
+ * tolerance) are merged, so that only one of them keeps shifting.
+ *
  * A simple example of how to run mean shift clustering is shown below.
  *
  * @code
@@ -18,7 +18,7 @@
 #include <mlpack/methods/neighbor_search/neighbor_search.hpp>
 #include <mlpack/methods/range_search/range_search.hpp>
 
-#include "map"
+#include <map>
 
 // In case it hasn't been included yet.
 #include "mean_shift.hpp"
@@ -202,62 +202,112 @@ inline void MeanShift<UseKernel, KernelType, MatType>::Cluster(
   }
 
   // Holds all centroids before removing duplicate ones.
-  arma::mat allCentroids(pSeeds->n_rows, pSeeds->n_cols);
+  arma::mat allCentroids(*pSeeds);
 
   assignments.set_size(data.n_cols);
 
+  // The tree on the data is built only once, and each iteration runs a single
+  // dual-tree range search for all seeds that are still shifting.
   RangeSearch<> rangeSearcher(data);
   Range validRadius(0, radius);
   std::vector<std::vector<size_t> > neighbors;
   std::vector<std::vector<double> > distances;
 
-  // For each seed, perform mean shift algorithm.
-  for (size_t i = 0; i < pSeeds->n_cols; ++i)
+  // Once two seeds are this close, their remaining trajectories are
+  // indistinguishable, so only one of them needs to be shifted further.
+  const double tolerance = 1e-3 * radius;
+
+  // Status of each seed: still shifting, converged, merged into another seed,
+  // or stopped (no neighbors, or out of iterations).
+  enum SeedStatus { ACTIVE, CONVERGED, MERGED, STOPPED };
+  std::vector<SeedStatus> status(pSeeds->n_cols, ACTIVE);
+
+  std::vector<size_t> active(pSeeds->n_cols);
+  for (size_t i = 0; i < active.size(); ++i)
+    active[i] = i;
+
+  // Map from cells (of width tolerance) to the first seed that reached them.
+  std::map<arma::colvec, size_t, less<arma::colvec> > occupiedCells;
+
+  arma::mat activeCentroids;
+  for (size_t completedIterations = 0; !active.empty() &&
+      (completedIterations < maxIterations || forceConvergence);
+      completedIterations++)
   {
-    // Initial centroid is the seed itself.
-    allCentroids.col(i) = pSeeds->unsafe_col(i);
-    for (size_t completedIterations = 0; completedIterations < maxIterations
-        || forceConvergence; completedIterations++)
+    activeCentroids = allCentroids.cols(arma::conv_to<arma::uvec>::from(
+        active));
+    rangeSearcher.Search(activeCentroids, validRadius, neighbors, distances);
+
+    // Shift every active seed in parallel; each seed only writes its own
+    // centroid and status.
+    #pragma omp parallel for schedule(dynamic)
+    for (size_t a = 0; a < active.size(); ++a)
     {
-      // Store new centroid in this.
-      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
-
-      rangeSearcher.Search(allCentroids.unsafe_col(i), validRadius,
-          neighbors, distances);
-      if (neighbors[0].size() == 0) // There are no points in the cluster.
-        break;
+      const size_t i = active[a];
+      if (neighbors[a].size() == 0) // There are no points in the cluster.
+      {
+        status[i] = STOPPED;
+        continue;
+      }
 
       // Calculate new centroid.
-      if (!CalculateCentroid(data, neighbors[0], distances[0], newCentroid))
+      arma::colvec newCentroid = arma::zeros<arma::colvec>(pSeeds->n_rows);
+      if (!CalculateCentroid(data, neighbors[a], distances[a], newCentroid))
         newCentroid = allCentroids.unsafe_col(i);
 
       // If the mean shift vector is small enough, it has converged.
       if (EuclideanDistance::Evaluate(newCentroid,
-          allCentroids.unsafe_col(i)) < 1e-3 * radius)
+          allCentroids.unsafe_col(i)) < tolerance)
+        status[i] = CONVERGED;
+      else
+        allCentroids.col(i) = newCentroid;
+    }
+
+    // Merge seeds that have run into another seed: seeds are hashed into cells
+    // of width equal to the convergence tolerance, and a seed that reaches a
+    // cell already visited by another seed stops shifting.  This is done
+    // serially, in seed order, so that the result does not depend on the
+    // number of threads.
+    std::vector<size_t> stillActive;
+    for (size_t a = 0; a < active.size(); ++a)
+    {
+      const size_t i = active[a];
+      if (status[i] == STOPPED)
+        continue;
+
+      arma::colvec cell = arma::floor(allCentroids.unsafe_col(i) / tolerance);
+      const size_t owner = occupiedCells.emplace(cell, i).first->second;
+      if (owner != i && status[i] == ACTIVE)
+        status[i] = MERGED;
+
+      if (status[i] == ACTIVE)
+        stillActive.push_back(i);
+    }
+
+    active.swap(stillActive);
+  }
+
+  // Remove duplicate centroids, in seed order.
+  for (size_t i = 0; i < allCentroids.n_cols; ++i)
+  {
+    if (status[i] != CONVERGED)
+      continue;
+
+    // Determine if the new centroid is duplicate with old ones.
+    bool isDuplicated = false;
+    for (size_t k = 0; k < centroids.n_cols; ++k)
+    {
+      const double distance = EuclideanDistance::Evaluate(
+          allCentroids.unsafe_col(i), centroids.unsafe_col(k));
+      if (distance < radius)
       {
-        // Determine if the new centroid is duplicate with old ones.
-        bool isDuplicated = false;
-        for (size_t k = 0; k < centroids.n_cols; ++k)
-        {
-          const double distance = EuclideanDistance::Evaluate(
-              allCentroids.unsafe_col(i), centroids.unsafe_col(k));
-          if (distance < radius)
-          {
-            isDuplicated = true;
-            break;
-          }
-        }
-
-        if (!isDuplicated)
-          centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
-
-        // Get out of the loop.
+        isDuplicated = true;
         break;
       }
-
-      // Update the centroid.
-      allCentroids.col(i) = newCentroid;
     }
+
+    if (!isDuplicated)
+      centroids.insert_cols(centroids.n_cols, allCentroids.unsafe_col(i));
   }
 
   // If no centroid has converged due to too little iterations and without
@@ -3,7 +3,8 @@
  * @author Ryan Curtin
  *
  * Implementation of the Bootstrap() function, which creates a bootstrapped
- * dataset from the given input dataset.
+ * dataset from the given input dataset, and the BootstrapIndices() function,
+ * which only samples the indices of the points of a bootstrapped dataset.
  *
  * mlpack is free software; you may redistribute it and/or modify it under the
  * terms of the 3-clause BSD license.  You should have received a copy of the
@@ -15,6 +16,17 @@
 
 namespace mlpack {
 
+/**
+ * Sample the indices of the points of a bootstrapped dataset: numPoints
+ * indices drawn uniformly with replacement from [0, numPoints).  The same index
+ * may appear many times.
+ */
+inline arma::uvec BootstrapIndices(const size_t numPoints)
+{
+  return arma::randi<arma::uvec>(numPoints,
+      arma::distr_param(0, numPoints - 1));
+}
+
 /**
  * Given a dataset, create another dataset via bootstrap sampling, with labels.
  */
@@ -35,8 +47,7 @@ void Bootstrap(const MatType& dataset,
     bootstrapWeights.set_size(weights.n_elem);
 
   // Random sampling with replacement.
-  arma::uvec indices = arma::randi<arma::uvec>(dataset.n_cols,
-      arma::distr_param(0, dataset.n_cols - 1));
+  arma::uvec indices = BootstrapIndices(dataset.n_cols);
   bootstrapDataset = dataset.cols(indices);
   bootstrapLabels = labels.cols(indices);
   if (UseWeights)
@@ -0,0 +1,228 @@
+/**
+ * @file methods/random_forest/compiled_forest.hpp
+ *
+ * Definition of the CompiledForest class, an inference-only representation of
+ * a trained RandomForest or DecisionTree stored in flat arrays.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_COMPILED_FOREST_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_COMPILED_FOREST_HPP
+
+#include "random_forest.hpp"
+
+namespace mlpack {
+
+/**
+ * The CompiledForest class holds the trees of a trained RandomForest (or a
+ * single DecisionTree) in a compact form that is only used for classification.
+ * Instead of pointer-linked nodes, every node of every tree is stored as an
+ * entry in a few contiguous arrays (split dimension, split point, node type,
+ * and the index of the first child), laid out breadth-first so that the
+ * children of a node are adjacent.  The class probabilities of all leaves are
+ * stored in a single matrix.
+ *
+ * Traversal is branch-free: a leaf points to itself, so every point is moved
+ * down a tree for exactly as many steps as the depth of that tree, and the
+ * direction at each node is computed with conditional moves instead of
+ * branches.  Batch classification processes blocks of BlockSize points through
+ * one tree at a time, so the nodes of a tree stay in cache for the whole block,
+ * and no memory is allocated per point or per tree.  Blocks are classified in
+ * parallel with OpenMP.
+ *
+ * The predictions and probabilities are the same as those of the original
+ * model.  The numeric split type of the trees must send a point to the left
+ * child if its value is less than or equal to the split point stored in the
+ * node (this is the case for BestBinaryNumericSplit, RandomBinaryNumericSplit
+ * and HistogramNumericSplit), and the categorical split type must send a point
+ * to the child given by its category (as AllCategoricalSplit does; this is not
+ * the case for BestBinaryCategoricalSplit).  Points with a missing (NaN) value
+ * in a numeric dimension are sent to the same child as by the original tree.
+ *
+ * Example use:
+ *
+ * @code
+ * RandomForest<> rf(data, labels, numClasses, 100);
+ * CompiledForest compiled(rf);
+ *
+ * // Only the compiled forest is needed for classification.
+ * arma::Row<size_t> predictions;
+ * compiled.Classify(testData, predictions);
+ * @endcode
+ */
+class CompiledForest
+{
+ public:
+  //! The number of points classified together by each tree.
+  static const size_t BlockSize = 64;
+
+  /**
+   * Construct an empty compiled forest.  Classify() will throw an exception
+   * until a trained model is compiled into it.
+   */
+  CompiledForest();
+
+  /**
+   * Compile the given trained decision tree.
+   *
+   * @param tree Decision tree to compile.
+   */
+  template<typename FitnessFunction,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           typename DimensionSelectionType,
+           bool NoRecursion>
+  CompiledForest(const DecisionTree<FitnessFunction,
+                                    NumericSplitType,
+                                    CategoricalSplitType,
+                                    DimensionSelectionType,
+                                    NoRecursion>& tree);
+
+  /**
+   * Compile the given trained random forest.
+   *
+   * @param forest Random forest to compile.
+   */
+  template<typename FitnessFunction,
+           typename DimensionSelectionType,
+           template<typename> class NumericSplitType,
+           template<typename> class CategoricalSplitType,
+           bool UseBootstrap>
+  CompiledForest(const RandomForest<FitnessFunction,
+                                    DimensionSelectionType,
+                                    NumericSplitType,
+                                    CategoricalSplitType,
+                                    UseBootstrap>& forest);
+
+  /**
+   * Predict the class of the given point.
+   *
+   * @param point Point to be classified.
+   */
+  template<typename VecType>
+  size_t Classify(const VecType& point) const;
+
+  /**
+   * Predict the class of the given point and return the predicted class
+   * probabilities for each class.
+   *
+   * @param point Point to be classified.
+   * @param prediction size_t to store predicted class in.
+   * @param probabilities Output vector of class probabilities.
+   */
+  template<typename VecType>
+  void Classify(const VecType& point,
+                size_t& prediction,
+                arma::vec& probabilities) const;
+
+  /**
+   * Predict the classes of each point in the given dataset.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions) const;
+
+  /**
+   * Predict the classes of each point in the given dataset, also returning the
+   * predicted class probabilities for each point.
+   *
+   * @param data Dataset to be classified.
+   * @param predictions Output predictions for each point in the dataset.
+   * @param probabilities Output matrix of class probabilities for each point.
+   */
+  template<typename MatType>
+  void Classify(const MatType& data,
+                arma::Row<size_t>& predictions,
+                arma::mat& probabilities) const;
+
+  //! Get the number of trees.
+  size_t NumTrees() const { return roots.n_elem; }
+  //! Get the total number of nodes in all trees.
+  size_t NumNodes() const { return nodeTypes.n_elem; }
+  //! Get the total number of leaves in all trees.
+  size_t NumLeaves() const { return leafProbabilities.n_cols; }
+  //! Get the number of classes.
+  size_t NumClasses() const { return leafProbabilities.n_rows; }
+
+  /**
+   * Serialize the compiled forest.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  //! The type of each node.
+  enum NodeType
+  {
+    LEAF = 0,
+    NUMERIC = 1,
+    CATEGORICAL = 2,
+    //! A numeric node that sends points with a missing value to the left.
+    NUMERIC_MISSING_LEFT = 3
+  };
+
+  /**
+   * Append the nodes of the given tree to the arrays.
+   */
+  template<typename TreeType>
+  void AddTree(const TreeType& tree);
+
+  /**
+   * Move the given point (column col of data) one step down from the given
+   * node.  Leaves return themselves.
+   */
+  template<typename MatType>
+  size_t Step(const size_t node, const MatType& data, const size_t col) const
+  {
+    // For a NaN value, (value > splitPoint) is false and !(value <=
+    // splitPoint) is true, so the comparison picks the child of missing values.
+    const double value = (double) data(dimensions[node], col);
+    const size_t direction = (nodeTypes[node] == CATEGORICAL) ?
+        (size_t) value : ((nodeTypes[node] == NUMERIC_MISSING_LEFT) ?
+        (size_t) (value > splitPoints[node]) :
+        (size_t) !(value <= splitPoints[node]));
+    return firstChildren[node] + ((nodeTypes[node] == LEAF) ? 0 : direction);
+  }
+
+  /**
+   * Compute the sum of the leaf probabilities of all trees for the points in
+   * columns begin to begin + count - 1 of the data, storing them in the first
+   * count columns of the given matrix.
+   */
+  template<typename MatType>
+  void ClassifyBlock(const MatType& data,
+                     const size_t begin,
+                     const size_t count,
+                     arma::mat& blockProbabilities) const;
+
+  //! The split dimension of each node (0 for leaves).
+  arma::uvec dimensions;
+  //! The split point of each numeric node.
+  arma::vec splitPoints;
+  //! The index of the first child of each node (the node itself for leaves).
+  arma::uvec firstChildren;
+  //! The index of the class probabilities of each leaf.
+  arma::uvec leafIndices;
+  //! The NodeType of each node.
+  arma::Col<unsigned char> nodeTypes;
+
+  //! The index of the root node of each tree.
+  arma::uvec roots;
+  //! The depth of each tree.
+  arma::uvec depths;
+  //! The class probabilities of each leaf, one column per leaf.
+  arma::mat leafProbabilities;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "compiled_forest_impl.hpp"
+
+#endif
@@ -0,0 +1,312 @@
+/**
+ * @file methods/random_forest/compiled_forest_impl.hpp
+ *
+ * Implementation of the CompiledForest class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_RANDOM_FOREST_COMPILED_FOREST_IMPL_HPP
+#define MLPACK_METHODS_RANDOM_FOREST_COMPILED_FOREST_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "compiled_forest.hpp"
+
+namespace mlpack {
+
+inline CompiledForest::CompiledForest()
+{
+  // Nothing to do here.
+}
+
+template<typename FitnessFunction,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         typename DimensionSelectionType,
+         bool NoRecursion>
+CompiledForest::CompiledForest(const DecisionTree<FitnessFunction,
+                                                  NumericSplitType,
+                                                  CategoricalSplitType,
+                                                  DimensionSelectionType,
+                                                  NoRecursion>& tree)
+{
+  static_assert(!std::is_same<CategoricalSplitType<FitnessFunction>,
+      BestBinaryCategoricalSplit<FitnessFunction>>::value,
+      "CompiledForest does not support BestBinaryCategoricalSplit!");
+
+  AddTree(tree);
+}
+
+template<typename FitnessFunction,
+         typename DimensionSelectionType,
+         template<typename> class NumericSplitType,
+         template<typename> class CategoricalSplitType,
+         bool UseBootstrap>
+CompiledForest::CompiledForest(const RandomForest<FitnessFunction,
+                                                  DimensionSelectionType,
+                                                  NumericSplitType,
+                                                  CategoricalSplitType,
+                                                  UseBootstrap>& forest)
+{
+  static_assert(!std::is_same<CategoricalSplitType<FitnessFunction>,
+      BestBinaryCategoricalSplit<FitnessFunction>>::value,
+      "CompiledForest does not support BestBinaryCategoricalSplit!");
+
+  for (size_t i = 0; i < forest.NumTrees(); ++i)
+    AddTree(forest.Tree(i));
+}
+
+template<typename VecType>
+size_t CompiledForest::Classify(const VecType& point) const
+{
+  size_t prediction;
+  arma::vec probabilities;
+  Classify(point, prediction, probabilities);
+  return prediction;
+}
+
+template<typename VecType>
+void CompiledForest::Classify(const VecType& point,
+                              size_t& prediction,
+                              arma::vec& probabilities) const
+{
+  // Check edge case.
+  if (roots.n_elem == 0)
+  {
+    probabilities.clear();
+    prediction = 0;
+
+    throw std::invalid_argument("CompiledForest::Classify(): no trained model "
+        "compiled!");
+  }
+
+  probabilities.zeros(leafProbabilities.n_rows);
+  for (size_t t = 0; t < roots.n_elem; ++t)
+  {
+    size_t node = roots[t];
+    for (size_t d = 0; d < depths[t]; ++d)
+      node = Step(node, point, 0);
+
+    probabilities += leafProbabilities.col(leafIndices[node]);
+  }
+
+  // Find maximum element after renormalizing probabilities.
+  probabilities /= roots.n_elem;
+  prediction = (size_t) probabilities.index_max();
+}
+
+template<typename MatType>
+void CompiledForest::Classify(const MatType& data,
+                              arma::Row<size_t>& predictions) const
+{
+  // Check edge case.
+  if (roots.n_elem == 0)
+  {
+    predictions.clear();
+
+    throw std::invalid_argument("CompiledForest::Classify(): no trained model "
+        "compiled!");
+  }
+
+  predictions.set_size(data.n_cols);
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+
+  #pragma omp parallel for
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t count = std::min((size_t) BlockSize,
+        (size_t) data.n_cols - begin);
+
+    arma::mat blockProbabilities(leafProbabilities.n_rows, BlockSize);
+    ClassifyBlock(data, begin, count, blockProbabilities);
+
+    blockProbabilities /= roots.n_elem;
+    for (size_t i = 0; i < count; ++i)
+    {
+      predictions[begin + i] =
+          (size_t) blockProbabilities.unsafe_col(i).index_max();
+    }
+  }
+}
+
+template<typename MatType>
+void CompiledForest::Classify(const MatType& data,
+                              arma::Row<size_t>& predictions,
+                              arma::mat& probabilities) const
+{
+  // Check edge case.
+  if (roots.n_elem == 0)
+  {
+    predictions.clear();
+    probabilities.clear();
+
+    throw std::invalid_argument("CompiledForest::Classify(): no trained model "
+        "compiled!");
+  }
+
+  predictions.set_size(data.n_cols);
+  probabilities.set_size(leafProbabilities.n_rows, data.n_cols);
+  const size_t numBlocks = (data.n_cols + BlockSize - 1) / BlockSize;
+
+  #pragma omp parallel for
+  for (size_t b = 0; b < numBlocks; ++b)
+  {
+    const size_t begin = b * BlockSize;
+    const size_t count = std::min((size_t) BlockSize,
+        (size_t) data.n_cols - begin);
+
+    // The block's columns of the output matrix are contiguous, so they can be
+    // used directly as the block buffer.
+    arma::mat blockProbabilities(probabilities.colptr(begin),
+        probabilities.n_rows, count, false, true);
+    ClassifyBlock(data, begin, count, blockProbabilities);
+
+    blockProbabilities /= roots.n_elem;
+    for (size_t i = 0; i < count; ++i)
+    {
+      predictions[begin + i] =
+          (size_t) blockProbabilities.unsafe_col(i).index_max();
+    }
+  }
+}
+
+template<typename Archive>
+void CompiledForest::serialize(Archive& ar, const uint32_t /* version */)
+{
+  ar(CEREAL_NVP(dimensions));
+  ar(CEREAL_NVP(splitPoints));
+  ar(CEREAL_NVP(firstChildren));
+  ar(CEREAL_NVP(leafIndices));
+  ar(CEREAL_NVP(nodeTypes));
+  ar(CEREAL_NVP(roots));
+  ar(CEREAL_NVP(depths));
+  ar(CEREAL_NVP(leafProbabilities));
+}
+
+template<typename TreeType>
+void CompiledForest::AddTree(const TreeType& tree)
+{
+  // Collect the nodes in breadth-first order; the children of each node are
+  // pushed together, so they get consecutive indices.
+  std::vector<const TreeType*> nodes(1, &tree);
+  std::vector<size_t> nodeDepths(1, 0);
+  std::vector<size_t> localFirstChildren(1, 0);
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    localFirstChildren[i] = nodes.size();
+    for (size_t c = 0; c < nodes[i]->NumChildren(); ++c)
+    {
+      nodes.push_back(&nodes[i]->Child(c));
+      nodeDepths.push_back(nodeDepths[i] + 1);
+      localFirstChildren.push_back(0);
+    }
+  }
+
+  const size_t offset = nodeTypes.n_elem;
+  const size_t leafOffset = leafProbabilities.n_cols;
+  const size_t numNodes = nodes.size();
+
+  size_t numLeaves = 0;
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    if (nodes[i]->NumChildren() == 0)
+      ++numLeaves;
+  }
+
+  const size_t numClasses = tree.NumClasses();
+  if (leafOffset > 0 && numClasses != leafProbabilities.n_rows)
+  {
+    std::ostringstream oss;
+    oss << "CompiledForest::AddTree(): number of classes of tree ("
+        << numClasses << ") does not match number of classes of forest ("
+        << leafProbabilities.n_rows << ")!";
+    throw std::invalid_argument(oss.str());
+  }
+
+  dimensions.resize(offset + numNodes);
+  splitPoints.resize(offset + numNodes);
+  firstChildren.resize(offset + numNodes);
+  leafIndices.resize(offset + numNodes);
+  nodeTypes.resize(offset + numNodes);
+  leafProbabilities.resize(numClasses, leafOffset + numLeaves);
+
+  size_t leaf = leafOffset;
+  for (size_t i = 0; i < numNodes; ++i)
+  {
+    const TreeType& node = *nodes[i];
+    const size_t index = offset + i;
+    if (node.NumChildren() == 0)
+    {
+      dimensions[index] = 0;
+      splitPoints[index] = 0.0;
+      firstChildren[index] = index;
+      leafIndices[index] = leaf;
+      nodeTypes[index] = LEAF;
+      leafProbabilities.col(leaf++) = node.ClassProbabilities();
+    }
+    else
+    {
+      dimensions[index] = node.SplitDimension();
+      // For internal nodes, the split information is held in the first
+      // element of the class probabilities.
+      splitPoints[index] = node.ClassProbabilities()[0];
+      firstChildren[index] = offset + localFirstChildren[i];
+      leafIndices[index] = 0;
+      if (node.SplitDimensionType() == data::Datatype::categorical)
+      {
+        nodeTypes[index] = CATEGORICAL;
+      }
+      else
+      {
+        // Ask the tree where a point with a missing value goes.
+        arma::vec missingPoint(node.SplitDimension() + 1);
+        missingPoint.fill(std::numeric_limits<double>::quiet_NaN());
+        nodeTypes[index] = (node.CalculateDirection(missingPoint) == 0) ?
+            NUMERIC_MISSING_LEFT : NUMERIC;
+      }
+    }
+  }
+
+  roots.resize(roots.n_elem + 1);
+  roots[roots.n_elem - 1] = offset;
+  depths.resize(depths.n_elem + 1);
+  depths[depths.n_elem - 1] =
+      *std::max_element(nodeDepths.begin(), nodeDepths.end());
+}
+
+template<typename MatType>
+void CompiledForest::ClassifyBlock(const MatType& data,
+                                   const size_t begin,
+                                   const size_t count,
+                                   arma::mat& blockProbabilities) const
+{
+  size_t current[BlockSize];
+
+  blockProbabilities.zeros();
+  for (size_t t = 0; t < roots.n_elem; ++t)
+  {
+    for (size_t i = 0; i < count; ++i)
+      current[i] = roots[t];
+
+    // Every point takes exactly depths[t] steps; points that reach a leaf
+    // early stay there.
+    for (size_t d = 0; d < depths[t]; ++d)
+    {
+      for (size_t i = 0; i < count; ++i)
+        current[i] = Step(current[i], data, begin + i);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      blockProbabilities.unsafe_col(i) +=
+          leafProbabilities.unsafe_col(leafIndices[current[i]]);
+    }
+  }
+}
+
+} // namespace mlpack
+
+#endif
@@ -50,6 +50,37 @@ class SSELoss
     return arma::accu(values) / (typename VecType::elem_type) values.n_elem;
   }
 
+  /**
+   * Computes the first and second order gradients of the loss with respect to
+   * the predictions, for each point.
+   *
+   * @param observed True observed values.
+   * @param predicted Predictions at the current step of boosting.
+   * @param gradients Output first order gradients.
+   * @param hessians Output second order gradients.
+   */
+  template<typename VecType>
+  void Gradients(const VecType& observed,
+                 const VecType& predicted,
+                 arma::rowvec& gradients,
+                 arma::rowvec& hessians) const
+  {
+    gradients = arma::conv_to<arma::rowvec>::from(predicted - observed);
+    hessians.ones(observed.n_elem);
+  }
+
+  /**
+   * Returns the total loss of the given predictions.
+   *
+   * @param observed True observed values.
+   * @param predicted Predicted values.
+   */
+  template<typename VecType>
+  double Loss(const VecType& observed, const VecType& predicted) const
+  {
+    return 0.5 * arma::accu(arma::square(observed - predicted));
+  }
+
   /**
    * Returns the output value for the leaf in the tree.
    */
@@ -92,11 +123,29 @@ class SSELoss
     return std::pow(ApplyL1(arma::accu(gradients)), 2) /
         (arma::accu(hessians) + lambda);
   }
+
+  //! Get the L1 regularization parameter.
+  double Alpha() const { return alpha; }
+  //! Modify the L1 regularization parameter.
+  double& Alpha() { return alpha; }
+  //! Get the L2 regularization parameter.
+  double Lambda() const { return lambda; }
+  //! Modify the L2 regularization parameter.
+  double& Lambda() { return lambda; }
+
+  //! Serialize the loss function.
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */)
+  {
+    ar(CEREAL_NVP(alpha));
+    ar(CEREAL_NVP(lambda));
+  }
+
  private:
   //! The L1 regularization parameter.
-  const double alpha;
+  double alpha;
   //! The L2 regularization parameter.
-  const double lambda;
+  double lambda;
   //! First order gradients.
   arma::vec gradients;
   //! Second order gradients (hessians).
@@ -0,0 +1,229 @@
+/**
+ * @file methods/xgboost/second_order_gain.hpp
+ *
+ * The second order gain, the fitness function used by DecisionTreeRegressor
+ * to grow the trees of XGBoostRegressor.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_SECOND_ORDER_GAIN_HPP
+#define MLPACK_METHODS_XGBOOST_SECOND_ORDER_GAIN_HPP
+
+#include <mlpack/prereqs.hpp>
+
+namespace mlpack {
+
+/**
+ * The second order gain is the regularized split criterion of XGBoost,
+ * expressed as a DecisionTreeRegressor fitness function.  Each boosting step
+ * fits a tree whose responses are the Newton targets t_i = -g_i / h_i and whose
+ * weights are the hessians h_i, where g_i and h_i are the first and second
+ * order gradients of the loss.  With G = sum(g_i), H = sum(h_i), and the
+ * soft-thresholding operator T_alpha, the gain of a node is
+ *
+ *   -(sum(h_i t_i^2) / H - T_alpha(G)^2 / (H (H + lambda))),
+ *
+ * so the (weighted) difference between the gain of the children and the gain
+ * of the parent is exactly the XGBoost split gain
+ *
+ *   T(G_L)^2 / (H_L + lambda) + T(G_R)^2 / (H_R + lambda)
+ *       - T(G)^2 / (H + lambda)
+ *
+ * divided by H, and the value of a leaf is -T_alpha(G) / (H + lambda).  When
+ * alpha and lambda are both zero, this is the same as MSEGain.
+ */
+class SecondOrderGain
+{
+ public:
+  /**
+   * Create the SecondOrderGain object with the given regularization.
+   *
+   * @param alpha The L1 regularization parameter.
+   * @param lambda The L2 regularization parameter.
+   */
+  SecondOrderGain(const double alpha = 0.0, const double lambda = 0.0) :
+      alpha(alpha),
+      lambda(lambda),
+      leftWeight(0.0),
+      leftSum(0.0),
+      leftSumSquares(0.0),
+      totalWeight(0.0),
+      totalSum(0.0),
+      totalSumSquares(0.0)
+  {
+    // Nothing to do.
+  }
+
+  /**
+   * Evaluate the second order gain of values from begin to end index.
+   *
+   * @param values Newton targets of the points.
+   * @param weights Hessians of the points.
+   * @param begin Start index.
+   * @param end End index.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  double Evaluate(const VecType& values,
+                  const WeightVecType& weights,
+                  const size_t begin,
+                  const size_t end) const
+  {
+    double sumWeights = 0.0, sum = 0.0, sumSquares = 0.0;
+    for (size_t i = begin; i < end; ++i)
+    {
+      const double w = UseWeights ? (double) weights[i] : 1.0;
+      const double x = (double) values[i];
+      sumWeights += w;
+      sum += w * x;
+      sumSquares += w * x * x;
+    }
+
+    return Gain(sumWeights, sum, sumSquares);
+  }
+
+  /**
+   * Evaluate the second order gain on the complete vector.
+   *
+   * @param values Newton targets of the points.
+   * @param weights Hessians of the points.
+   */
+  template<bool UseWeights, typename VecType, typename WeightVecType>
+  double Evaluate(const VecType& values, const WeightVecType& weights) const
+  {
+    // Corner case: if there are no elements, the impurity is zero.
+    if (values.n_elem == 0)
+      return 0.0;
+
+    return Evaluate<UseWeights>(values, weights, 0, values.n_elem);
+  }
+
+  /**
+   * Returns the regularized Newton step -T_alpha(G) / (H + lambda) as the
+   * value of a leaf.
+   */
+  template<bool UseWeights, typename ResponsesType, typename WeightsType>
+  double OutputLeafValue(const ResponsesType& responses,
+                         const WeightsType& weights) const
+  {
+    double sumWeights = 0.0, sum = 0.0;
+    for (size_t i = 0; i < responses.n_elem; ++i)
+    {
+      const double w = UseWeights ? (double) weights[i] : 1.0;
+      sumWeights += w;
+      sum += w * (double) responses[i];
+    }
+
+    if (sumWeights + lambda <= 0.0)
+      return 0.0;
+
+    return SoftThreshold(sum) / (sumWeights + lambda);
+  }
+
+  /**
+   * Returns the gain of the left and right child for the current split.
+   */
+  std::tuple<double, double> BinaryGains()
+  {
+    return std::make_tuple(Gain(leftWeight, leftSum, leftSumSquares),
+        Gain(totalWeight - leftWeight, totalSum - leftSum,
+            totalSumSquares - leftSumSquares));
+  }
+
+  /**
+   * Caches the statistics of all points, and of the first minimum - 1 points
+   * (which are always in the left child).
+   *
+   * @param responses Newton targets, sorted by the split dimension.
+   * @param weights Hessians, in the same order as the responses.
+   * @param minimum The minimum number of elements in a leaf.
+   */
+  template<bool UseWeights, typename ResponsesType, typename WeightVecType>
+  void BinaryScanInitialize(const ResponsesType& responses,
+                            const WeightVecType& weights,
+                            const size_t minimum)
+  {
+    leftWeight = leftSum = leftSumSquares = 0.0;
+    totalWeight = totalSum = totalSumSquares = 0.0;
+
+    for (size_t i = 0; i < responses.n_elem; ++i)
+    {
+      const double w = UseWeights ? (double) weights[i] : 1.0;
+      const double x = (double) responses[i];
+      totalWeight += w;
+      totalSum += w * x;
+      totalSumSquares += w * x * x;
+    }
+
+    for (size_t i = 0; i + 1 < minimum; ++i)
+      BinaryStep<UseWeights>(responses, weights, i);
+  }
+
+  /**
+   * Moves the point at the given index to the left child.
+   *
+   * @param responses Newton targets, sorted by the split dimension.
+   * @param weights Hessians, in the same order as the responses.
+   * @param index The current index.
+   */
+  template<bool UseWeights, typename ResponsesType, typename WeightVecType>
+  void BinaryStep(const ResponsesType& responses,
+                  const WeightVecType& weights,
+                  const size_t index)
+  {
+    const double w = UseWeights ? (double) weights[index] : 1.0;
+    const double x = (double) responses[index];
+    leftWeight += w;
+    leftSum += w * x;
+    leftSumSquares += w * x * x;
+  }
+
+  //! Get the L1 regularization parameter.
+  double Alpha() const { return alpha; }
+  //! Get the L2 regularization parameter.
+  double Lambda() const { return lambda; }
+
+ private:
+  //! Compute the gain of a node from its sufficient statistics.
+  double Gain(const double sumWeights,
+              const double sum,
+              const double sumSquares) const
+  {
+    if (sumWeights <= 0.0)
+      return 0.0;
+
+    const double thresholded = SoftThreshold(sum);
+    return -(sumSquares / sumWeights - thresholded * thresholded /
+        (sumWeights * (sumWeights + lambda)));
+  }
+
+  //! Apply the L1 soft-thresholding operator.
+  double SoftThreshold(const double sum) const
+  {
+    if (sum > alpha)
+      return sum - alpha;
+    else if (sum < -alpha)
+      return sum + alpha;
+
+    return 0.0;
+  }
+
+  //! The L1 regularization parameter.
+  double alpha;
+  //! The L2 regularization parameter.
+  double lambda;
+
+  //! Cached statistics for BinaryScanInitialize() and BinaryStep().
+  double leftWeight;
+  double leftSum;
+  double leftSumSquares;
+  double totalWeight;
+  double totalSum;
+  double totalSumSquares;
+};
+
+} // namespace mlpack
+
+#endif
@@ -0,0 +1,267 @@
+/**
+ * @file methods/xgboost/xgboost_regressor.hpp
+ *
+ * Definition of the XGBoostRegressor class, which implements gradient boosted
+ * regression trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_HPP
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/decision_tree/decision_tree_regressor.hpp>
+#include <mlpack/methods/decision_tree/multiple_random_dimension_select.hpp>
+
+#include "loss_functions/sse_loss.hpp"
+#include "second_order_gain.hpp"
+
+namespace mlpack {
+
+/**
+ * The XGBoostRegressor class implements gradient boosted regression trees with
+ * second order (Newton) boosting steps, as described in the XGBoost paper:
+ *
+ * @code
+ * @inproceedings{chen2016xgboost,
+ *   title={{XGBoost}: A scalable tree boosting system},
+ *   author={Chen, Tianqi and Guestrin, Carlos},
+ *   booktitle={Proceedings of the 22nd ACM SIGKDD International Conference on
+ *       Knowledge Discovery and Data Mining},
+ *   pages={785--794},
+ *   year={2016}
+ * }
+ * @endcode
+ *
+ * Each boosting step computes the gradients and hessians of the loss at the
+ * current predictions, and fits a DecisionTreeRegressor with the
+ * SecondOrderGain fitness function to them; the prediction of the tree is then
+ * added to the model, scaled by the learning rate.  Each tree can be trained on
+ * a random subset of the points (row subsampling), and each split considers a
+ * random subset of the dimensions (column subsampling).  If a validation set is
+ * given, training stops once the validation loss has not improved for a given
+ * number of rounds, and the model is truncated to the best round.
+ *
+ * The loss function must implement the following functions:
+ *
+ * @code
+ * // Return the initial (constant) prediction for the given responses.
+ * double InitialPrediction(const arma::rowvec& responses);
+ *
+ * // Compute the gradients and hessians of the loss for each point.
+ * void Gradients(const arma::rowvec& responses,
+ *                const arma::rowvec& predictions,
+ *                arma::rowvec& gradients,
+ *                arma::rowvec& hessians) const;
+ *
+ * // Return the total loss of the given predictions.
+ * double Loss(const arma::rowvec& responses,
+ *             const arma::rowvec& predictions) const;
+ *
+ * // Return the L1 and L2 regularization parameters.
+ * double Alpha() const;
+ * double Lambda() const;
+ * @endcode
+ *
+ * @tparam LossFunctionType Loss function to minimize.
+ * @tparam NumericSplitType The strategy used for finding splits on numeric
+ *     dimensions (e.g. BestBinaryNumericSplit or HistogramNumericSplit).
+ */
+template<typename LossFunctionType = SSELoss,
+         template<typename> class NumericSplitType = BestBinaryNumericSplit>
+class XGBoostRegressor
+{
+ public:
+  //! Allow access to the underlying decision tree type.
+  typedef DecisionTreeRegressor<SecondOrderGain, NumericSplitType,
+      AllCategoricalSplit, MultipleRandomDimensionSelect> TreeType;
+
+  /**
+   * Construct the model without any training.  Predict() will throw an
+   * exception until Train() is called.
+   */
+  XGBoostRegressor();
+
+  /**
+   * Create the model and train it on the given data and responses.  See
+   * Train() for the meaning of each parameter.
+   *
+   * @param data Dataset to train on.
+   * @param responses Responses for each training point.
+   * @param numTrees Number of boosting rounds (trees).
+   * @param learningRate Shrinkage applied to the prediction of each tree.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for splitting a tree node.
+   * @param rowSubsample Fraction of points used to train each tree.
+   * @param colSubsample Fraction of dimensions considered for each split.
+   * @param lossFunction Instantiated loss function.
+   */
+  template<typename MatType>
+  XGBoostRegressor(const MatType& data,
+                   const arma::rowvec& responses,
+                   const size_t numTrees = 100,
+                   const double learningRate = 0.3,
+                   const size_t maximumDepth = 6,
+                   const size_t minimumLeafSize = 1,
+                   const double minimumGainSplit = 1e-7,
+                   const double rowSubsample = 1.0,
+                   const double colSubsample = 1.0,
+                   LossFunctionType lossFunction = LossFunctionType());
+
+  /**
+   * Train the model on the given data and responses.  This overwrites the
+   * existing model.  The trees are grown with the L1 and L2 regularization
+   * parameters of the loss function.
+   *
+   * @param data Dataset to train on.
+   * @param responses Responses for each training point.
+   * @param numTrees Number of boosting rounds (trees).
+   * @param learningRate Shrinkage applied to the prediction of each tree.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for splitting a tree node.
+   * @param rowSubsample Fraction of points used to train each tree.
+   * @param colSubsample Fraction of dimensions considered for each split.
+   * @param lossFunction Instantiated loss function.
+   * @return The average loss of the model on the training set.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::rowvec& responses,
+               const size_t numTrees = 100,
+               const double learningRate = 0.3,
+               const size_t maximumDepth = 6,
+               const size_t minimumLeafSize = 1,
+               const double minimumGainSplit = 1e-7,
+               const double rowSubsample = 1.0,
+               const double colSubsample = 1.0,
+               LossFunctionType lossFunction = LossFunctionType());
+
+  /**
+   * Train the model on the given data and responses, with early stopping on
+   * the given validation set: training stops when the validation loss has not
+   * improved for earlyStoppingRounds rounds, and only the trees up to the round
+   * with the lowest validation loss are kept.  This overwrites the existing
+   * model.
+   *
+   * @param data Dataset to train on.
+   * @param responses Responses for each training point.
+   * @param validationData Validation dataset.
+   * @param validationResponses Responses for each validation point.
+   * @param earlyStoppingRounds Number of rounds without improvement of the
+   *     validation loss before training stops.
+   * @param numTrees Maximum number of boosting rounds (trees).
+   * @param learningRate Shrinkage applied to the prediction of each tree.
+   * @param maximumDepth Maximum depth of each tree (0 means no limit).
+   * @param minimumLeafSize Minimum number of points in each leaf node.
+   * @param minimumGainSplit Minimum gain for splitting a tree node.
+   * @param rowSubsample Fraction of points used to train each tree.
+   * @param colSubsample Fraction of dimensions considered for each split.
+   * @param lossFunction Instantiated loss function.
+   * @return The average loss of the model on the validation set.
+   */
+  template<typename MatType>
+  double Train(const MatType& data,
+               const arma::rowvec& responses,
+               const MatType& validationData,
+               const arma::rowvec& validationResponses,
+               const size_t earlyStoppingRounds,
+               const size_t numTrees = 100,
+               const double learningRate = 0.3,
+               const size_t maximumDepth = 6,
+               const size_t minimumLeafSize = 1,
+               const double minimumGainSplit = 1e-7,
+               const double rowSubsample = 1.0,
+               const double colSubsample = 1.0,
+               LossFunctionType lossFunction = LossFunctionType());
+
+  /**
+   * Predict the response of the given point.  If the model has not been
+   * trained, this will throw an exception.
+   *
+   * @param point Point to predict.
+   */
+  template<typename VecType>
+  double Predict(const VecType& point) const;
+
+  /**
+   * Predict the responses of each point in the given dataset.  If the model
+   * has not been trained, this will throw an exception.
+   *
+   * @param data Dataset to predict.
+   * @param predictions Output predictions for each point in the dataset.
+   */
+  template<typename MatType>
+  void Predict(const MatType& data, arma::rowvec& predictions) const;
+
+  //! Access a tree of the model.
+  const TreeType& Tree(const size_t i) const { return trees[i]; }
+  //! Modify a tree of the model (be careful!).
+  TreeType& Tree(const size_t i) { return trees[i]; }
+
+  //! Get the number of trees in the model.
+  size_t NumTrees() const { return trees.size(); }
+
+  //! Get the initial (constant) prediction of the model.
+  double InitialPrediction() const { return initialPrediction; }
+  //! Get the learning rate (shrinkage) of the model.
+  double LearningRate() const { return learningRate; }
+
+  //! Get the loss function.
+  const LossFunctionType& LossFunction() const { return lossFunction; }
+  //! Modify the loss function.
+  LossFunctionType& LossFunction() { return lossFunction; }
+
+  /**
+   * Serialize the model.
+   */
+  template<typename Archive>
+  void serialize(Archive& ar, const uint32_t /* version */);
+
+ private:
+  /**
+   * Perform the boosting.  If UseValidation is false, the validation set and
+   * earlyStoppingRounds are ignored.
+   */
+  template<bool UseValidation, typename MatType>
+  double Train(const MatType& data,
+               const arma::rowvec& responses,
+               const MatType& validationData,
+               const arma::rowvec& validationResponses,
+               const size_t earlyStoppingRounds,
+               const size_t numTrees,
+               const size_t maximumDepth,
+               const size_t minimumLeafSize,
+               const double minimumGainSplit,
+               const double rowSubsample,
+               const double colSubsample);
+
+  /**
+   * Add the prediction of the given tree, scaled by the learning rate, to the
+   * given predictions.
+   */
+  template<typename MatType>
+  void AddPrediction(const TreeType& tree,
+                     const MatType& data,
+                     arma::rowvec& predictions) const;
+
+  //! The trees of the model.
+  std::vector<TreeType> trees;
+  //! The initial (constant) prediction.
+  double initialPrediction;
+  //! The shrinkage applied to the prediction of each tree.
+  double learningRate;
+  //! The loss function.
+  LossFunctionType lossFunction;
+};
+
+} // namespace mlpack
+
+// Include implementation.
+#include "xgboost_regressor_impl.hpp"
+
+#endif
@@ -0,0 +1,322 @@
+/**
+ * @file methods/xgboost/xgboost_regressor_impl.hpp
+ *
+ * Implementation of the XGBoostRegressor class.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#ifndef MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_IMPL_HPP
+#define MLPACK_METHODS_XGBOOST_XGBOOST_REGRESSOR_IMPL_HPP
+
+// In case it hasn't been included yet.
+#include "xgboost_regressor.hpp"
+
+namespace mlpack {
+
+template<typename LossFunctionType,
+         template<typename> class NumericSplitType>
+XGBoostRegressor<LossFunctionType, NumericSplitType>::XGBoostRegressor() :
+    initialPrediction(0.0),
+    learningRate(0.3)
+{
+  // Nothing to do here.
+}
+
+template<typename LossFunctionType,
+         template<typename> class NumericSplitType>
+template<typename MatType>
+XGBoostRegressor<LossFunctionType, NumericSplitType>::XGBoostRegressor(
+    const MatType& data,
+    const arma::rowvec& responses,
+    const size_t numTrees,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const double rowSubsample,
+    const double colSubsample,
+    LossFunctionType lossFunction) :
+    initialPrediction(0.0),
+    learningRate(learningRate)
+{
+  // Pass off work to the Train() method.
+  Train(data, responses, numTrees, learningRate, maximumDepth, minimumLeafSize,
+      minimumGainSplit, rowSubsample, colSubsample, lossFunction);
+}
+
+template<typename LossFunctionType,
+         template<typename> class NumericSplitType>
+template<typename MatType>
+double XGBoostRegressor<LossFunctionType, NumericSplitType>::Train(
+    const MatType& data,
+    const arma::rowvec& responses,
+    const size_t numTrees,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const double rowSubsample,
+    const double colSubsample,
+    LossFunctionType lossFunction)
+{
+  this->learningRate = learningRate;
+  this->lossFunction = std::move(lossFunction);
+
+  MatType validationData; // Ignored.
+  arma::rowvec validationResponses; // Ignored.
+  return Train<false>(data, responses, validationData, validationResponses, 0,
+      numTrees, maximumDepth, minimumLeafSize, minimumGainSplit, rowSubsample,
+      colSubsample);
+}
+
+template<typename LossFunctionType,
+         template<typename> class NumericSplitType>
+template<typename MatType>
+double XGBoostRegressor<LossFunctionType, NumericSplitType>::Train(
+    const MatType& data,
+    const arma::rowvec& responses,
+    const MatType& validationData,
+    const arma::rowvec& validationResponses,
+    const size_t earlyStoppingRounds,
+    const size_t numTrees,
+    const double learningRate,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const double rowSubsample,
+    const double colSubsample,
+    LossFunctionType lossFunction)
+{
+  util::CheckSameSizes(validationData, validationResponses,
+      "XGBoostRegressor::Train()", "validation responses");
+  util::CheckSameDimensionality(validationData, data,
+      "XGBoostRegressor::Train()", "validation data");
+  if (earlyStoppingRounds == 0)
+  {
+    throw std::invalid_argument("XGBoostRegressor::Train(): "
+        "earlyStoppingRounds must be greater than 0!");
+  }
+
+  this->learningRate = learningRate;
+  this->lossFunction = std::move(lossFunction);
+
+  return Train<true>(data, responses, validationData, validationResponses,
+      earlyStoppingRounds, numTrees, maximumDepth, minimumLeafSize,
+      minimumGainSplit, rowSubsample, colSubsample);
+}
+
+template<typename LossFunctionType,
+         template<typename> class NumericSplitType>
+template<typename VecType>
+double XGBoostRegressor<LossFunctionType, NumericSplitType>::Predict(
+    const VecType& point) const
+{
+  // Check edge case.
+  if (trees.size() == 0)
+  {
+    throw std::invalid_argument("XGBoostRegressor::Predict(): no model "
+        "trained!");
+  }
+
+  double prediction = 0.0;
+  for (size_t i = 0; i < trees.size(); ++i)
+    prediction += trees[i].Predict(point);
+
+  return initialPrediction + learningRate * prediction;
+}
+
+template<typename LossFunctionType,
+         template<typename> class NumericSplitType>
+template<typename MatType>
+void XGBoostRegressor<LossFunctionType, NumericSplitType>::Predict(
+    const MatType& data,
+    arma::rowvec& predictions) const
+{
+  // Check edge case.
+  if (trees.size() == 0)
+  {
+    predictions.clear();
+
+    throw std::invalid_argument("XGBoostRegressor::Predict(): no model "
+        "trained!");
+  }
+
+  predictions.set_size(data.n_cols);
+
+  #pragma omp parallel for
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    predictions[i] = Predict(data.col(i));
+  }
+}
+
+template<typename LossFunctionType,
+         template<typename> class NumericSplitType>
+template<typename Archive>
+void XGBoostRegressor<LossFunctionType, NumericSplitType>::serialize(
+    Archive& ar, const uint32_t /* version */)
+{
+  size_t numTrees;
+  if (cereal::is_loading<Archive>())
+    trees.clear();
+  else
+    numTrees = trees.size();
+
+  ar(CEREAL_NVP(numTrees));
+
+  // Allocate space if needed.
+  if (cereal::is_loading<Archive>())
+    trees.resize(numTrees);
+
+  ar(CEREAL_NVP(trees));
+  ar(CEREAL_NVP(initialPrediction));
+  ar(CEREAL_NVP(learningRate));
+  ar(CEREAL_NVP(lossFunction));
+}
+
+template<typename LossFunctionType,
+         template<typename> class NumericSplitType>
+template<bool UseValidation, typename MatType>
+double XGBoostRegressor<LossFunctionType, NumericSplitType>::Train(
+    const MatType& data,
+    const arma::rowvec& responses,
+    const MatType& validationData,
+    const arma::rowvec& validationResponses,
+    const size_t earlyStoppingRounds,
+    const size_t numTrees,
+    const size_t maximumDepth,
+    const size_t minimumLeafSize,
+    const double minimumGainSplit,
+    const double rowSubsample,
+    const double colSubsample)
+{
+  util::CheckSameSizes(data, responses, "XGBoostRegressor::Train()",
+      "responses");
+  if (data.n_cols == 0)
+  {
+    throw std::invalid_argument("XGBoostRegressor::Train(): cannot train on "
+        "an empty dataset!");
+  }
+  if (numTrees == 0)
+  {
+    throw std::invalid_argument("XGBoostRegressor::Train(): numTrees must be "
+        "greater than 0!");
+  }
+  if (rowSubsample <= 0.0 || rowSubsample > 1.0)
+  {
+    throw std::invalid_argument("XGBoostRegressor::Train(): rowSubsample must "
+        "be in (0, 1]!");
+  }
+  if (colSubsample <= 0.0 || colSubsample > 1.0)
+  {
+    throw std::invalid_argument("XGBoostRegressor::Train(): colSubsample must "
+        "be in (0, 1]!");
+  }
+
+  trees.clear();
+  trees.reserve(numTrees);
+
+  const size_t n = data.n_cols;
+  const size_t rowSamples = std::max((size_t) 1,
+      (size_t) std::ceil(rowSubsample * n));
+  const size_t colSamples = std::max((size_t) 1,
+      (size_t) std::ceil(colSubsample * data.n_rows));
+
+  // The trees are grown with the regularization of the loss function.
+  const SecondOrderGain gain(lossFunction.Alpha(), lossFunction.Lambda());
+
+  initialPrediction = lossFunction.InitialPrediction(responses);
+  arma::rowvec predictions(n);
+  predictions.fill(initialPrediction);
+
+  arma::rowvec validationPredictions;
+  double bestLoss = DBL_MAX;
+  size_t bestNumTrees = 0;
+  if (UseValidation)
+  {
+    validationPredictions.set_size(validationData.n_cols);
+    validationPredictions.fill(initialPrediction);
+  }
+
+  arma::rowvec gradients, hessians;
+  for (size_t t = 0; t < numTrees; ++t)
+  {
+    lossFunction.Gradients(responses, predictions, gradients, hessians);
+
+    // Each tree fits the Newton step -g / h with weights h; see
+    // SecondOrderGain for why this gives the XGBoost split gain.
+    arma::rowvec targets(n);
+    arma::rowvec weights(n);
+    #pragma omp parallel for
+    for (size_t i = 0; i < n; ++i)
+    {
+      const double h = hessians[i];
+      targets[i] = (h > 0.0) ? -gradients[i] / h : 0.0;
+      weights[i] = std::max(h, 0.0);
+    }
+
+    // The tree is trained on the points given by a list of indices, so the
+    // data itself is never copied, whether or not the rows are subsampled.
+    arma::uvec indices;
+    if (rowSamples < n)
+      indices = arma::sort(arma::randperm(n, rowSamples));
+    else
+      indices = arma::regspace<arma::uvec>(0, n - 1);
+
+    trees.emplace_back();
+    trees.back().Train(data, std::move(indices), targets, weights,
+        minimumLeafSize, minimumGainSplit, maximumDepth,
+        MultipleRandomDimensionSelect(colSamples), gain);
+
+    AddPrediction(trees.back(), data, predictions);
+
+    if (UseValidation)
+    {
+      AddPrediction(trees.back(), validationData, validationPredictions);
+      const double loss = lossFunction.Loss(validationResponses,
+          validationPredictions);
+      if (loss < bestLoss)
+      {
+        bestLoss = loss;
+        bestNumTrees = trees.size();
+      }
+      else if (trees.size() - bestNumTrees >= earlyStoppingRounds)
+      {
+        Log::Info << "XGBoostRegressor::Train(): validation loss has not "
+            << "improved for " << earlyStoppingRounds << " rounds; stopping "
+            << "at " << bestNumTrees << " trees." << std::endl;
+        break;
+      }
+    }
+  }
+
+  if (UseValidation)
+  {
+    trees.resize(bestNumTrees);
+    return bestLoss / std::max((size_t) 1, (size_t) validationData.n_cols);
+  }
+
+  return lossFunction.Loss(responses, predictions) / std::max((size_t) 1, n);
+}
+
+template<typename LossFunctionType,
+         template<typename> class NumericSplitType>
+template<typename MatType>
+void XGBoostRegressor<LossFunctionType, NumericSplitType>::AddPrediction(
+    const TreeType& tree,
+    const MatType& data,
+    arma::rowvec& predictions) const
+{
+  #pragma omp parallel for
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    predictions[i] += learningRate * tree.Predict(data.col(i));
+  }
+}
+
+} // namespace mlpack
+
+#endif
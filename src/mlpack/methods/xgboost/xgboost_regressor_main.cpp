@@ -0,0 +1,265 @@
+/**
+ * @file methods/xgboost/xgboost_regressor_main.cpp
+ *
+ * A program to build and evaluate gradient boosted regression trees.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#include <mlpack/core.hpp>
+
+#undef BINDING_NAME
+#define BINDING_NAME xgboost_regressor
+
+#include <mlpack/core/util/mlpack_main.hpp>
+#include <mlpack/methods/xgboost/xgboost_regressor.hpp>
+
+using namespace mlpack;
+using namespace mlpack::util;
+using namespace std;
+
+// Program Name.
+BINDING_USER_NAME("Gradient boosted regression trees");
+
+// Short description.
+BINDING_SHORT_DESC(
+    "An implementation of gradient boosted regression trees with second order "
+    "(XGBoost-style) boosting steps.  Given a dataset and responses, a model "
+    "can be trained and saved for future use; or, a pre-trained model can be "
+    "used to predict the responses of new points.");
+
+// Long description.
+BINDING_LONG_DESC(
+    "This program trains an ensemble of regression trees by gradient boosting "
+    "on the squared error, with the regularized second order split gain of "
+    "XGBoost.  A model can be trained and saved for later use, or a model may "
+    "be loaded and predictions for new points may be generated."
+    "\n\n"
+    "The training set and associated responses are specified with the " +
+    PRINT_PARAM_STRING("training") + " and " +
+    PRINT_PARAM_STRING("responses") + " parameters, respectively.  The " +
+    PRINT_PARAM_STRING("num_trees") + " parameter controls the number of "
+    "boosting rounds, and the prediction of each tree is scaled by the " +
+    PRINT_PARAM_STRING("learning_rate") + " parameter.  The " +
+    PRINT_PARAM_STRING("maximum_depth") + ", " +
+    PRINT_PARAM_STRING("minimum_leaf_size") + " and " +
+    PRINT_PARAM_STRING("minimum_gain_split") + " parameters control the "
+    "growth of each tree, and the " + PRINT_PARAM_STRING("lambda") + " and " +
+    PRINT_PARAM_STRING("alpha") + " parameters specify the L2 and L1 "
+    "regularization of the leaf values.  Each tree is trained on a random "
+    "fraction " + PRINT_PARAM_STRING("row_subsample") + " of the points, and "
+    "each split considers a random fraction " +
+    PRINT_PARAM_STRING("col_subsample") + " of the dimensions."
+    "\n\n"
+    "If a validation set is given with the " +
+    PRINT_PARAM_STRING("validation") + " and " +
+    PRINT_PARAM_STRING("validation_responses") + " parameters, training stops "
+    "when the loss on the validation set has not improved for " +
+    PRINT_PARAM_STRING("early_stopping_rounds") + " rounds, and only the trees "
+    "up to the best round are kept."
+    "\n\n"
+    "When a model is trained, the " + PRINT_PARAM_STRING("output_model") + " "
+    "output parameter may be used to save the trained model.  A model may be "
+    "loaded for predictions with the " + PRINT_PARAM_STRING("input_model") +
+    " parameter.  Test data may be specified with the " +
+    PRINT_PARAM_STRING("test") + " parameter, and the predicted responses for "
+    "each test point may be saved via the " +
+    PRINT_PARAM_STRING("predictions") + " output parameter.");
+
+// Example.
+BINDING_EXAMPLE(
+    "For example, to train a model with 200 trees of depth at most 4 on the "
+    "dataset contained in " + PRINT_DATASET("data") + " with responses " +
+    PRINT_DATASET("responses") + ", saving the trained model to " +
+    PRINT_MODEL("xgb_model") + ", one could call"
+    "\n\n" +
+    PRINT_CALL("xgboost_regressor", "training", "data", "responses",
+        "responses", "num_trees", 200, "maximum_depth", 4, "output_model",
+        "xgb_model") +
+    "\n\n"
+    "Then, to use that model to predict the responses of the points in " +
+    PRINT_DATASET("test_set") + ", saving the predictions to " +
+    PRINT_DATASET("predictions") + ", one could call "
+    "\n\n" +
+    PRINT_CALL("xgboost_regressor", "input_model", "xgb_model", "test",
+        "test_set", "predictions", "predictions"));
+
+// See also...
+BINDING_SEE_ALSO("@random_forest", "#random_forest");
+BINDING_SEE_ALSO("@linear_regression", "#linear_regression");
+BINDING_SEE_ALSO("Gradient boosting on Wikipedia",
+        "https://en.wikipedia.org/wiki/Gradient_boosting");
+BINDING_SEE_ALSO("XGBoost: A scalable tree boosting system (pdf)",
+        "https://arxiv.org/pdf/1603.02754");
+BINDING_SEE_ALSO("XGBoostRegressor C++ class documentation",
+        "@src/mlpack/methods/xgboost/xgboost_regressor.hpp");
+
+PARAM_MATRIX_IN("training", "Training dataset.", "t");
+PARAM_ROW_IN("responses", "Responses for the training dataset.", "r");
+PARAM_MATRIX_IN("validation", "Validation dataset for early stopping.", "X");
+PARAM_ROW_IN("validation_responses", "Responses for the validation dataset.",
+    "Y");
+PARAM_INT_IN("early_stopping_rounds", "Number of rounds without improvement "
+    "of the validation loss before training stops.", "E", 10);
+PARAM_MATRIX_IN("test", "Test dataset to produce predictions for.", "T");
+
+PARAM_INT_IN("num_trees", "Number of trees (boosting rounds).", "N", 100);
+PARAM_DOUBLE_IN("learning_rate", "Shrinkage applied to the prediction of each "
+    "tree.", "e", 0.3);
+PARAM_INT_IN("maximum_depth", "Maximum depth of each tree (0 means no limit).",
+    "D", 6);
+PARAM_INT_IN("minimum_leaf_size", "Minimum number of points in each leaf "
+    "node.", "n", 1);
+PARAM_DOUBLE_IN("minimum_gain_split", "Minimum gain needed to make a split "
+    "when building a tree.", "g", 1e-7);
+PARAM_DOUBLE_IN("row_subsample", "Fraction of the training points used to "
+    "train each tree.", "S", 1.0);
+PARAM_DOUBLE_IN("col_subsample", "Fraction of the dimensions considered for "
+    "each split.", "C", 1.0);
+PARAM_DOUBLE_IN("lambda", "L2 regularization of the leaf values.", "l", 1.0);
+PARAM_DOUBLE_IN("alpha", "L1 regularization of the leaf values.", "a", 0.0);
+
+PARAM_ROW_OUT("predictions", "Predicted responses for each point in the test "
+    "set.", "p");
+
+PARAM_INT_IN("seed", "Random seed.  If 0, 'std::time(NULL)' is used.", "s", 0);
+
+PARAM_MODEL_IN(XGBoostRegressor<>, "input_model", "Pre-trained model to use "
+    "for prediction.", "m");
+PARAM_MODEL_OUT(XGBoostRegressor<>, "output_model", "Model to save trained "
+    "model to.", "M");
+
+void BINDING_FUNCTION(util::Params& params, util::Timers& timers)
+{
+  // Initialize random seed if needed.
+  if (params.Get<int>("seed") != 0)
+    RandomSeed((size_t) params.Get<int>("seed"));
+  else
+    RandomSeed((size_t) std::time(NULL));
+
+  // Check for incompatible input parameters.
+  RequireOnlyOnePassed(params, { "training", "input_model" }, true);
+
+  RequireAtLeastOnePassed(params, { "test", "output_model" }, false,
+      "the trained model will not be used or saved");
+
+  if (params.Has("training"))
+  {
+    RequireAtLeastOnePassed(params, { "responses" }, true, "must pass "
+        "responses when training set given");
+  }
+
+  RequireNoneOrAllPassed(params, { "validation", "validation_responses" },
+      true);
+  ReportIgnoredParam(params, {{ "validation", false }},
+      "early_stopping_rounds");
+  ReportIgnoredParam(params, {{ "test", false }}, "predictions");
+
+  ReportIgnoredParam(params, {{ "training", false }}, "num_trees");
+  ReportIgnoredParam(params, {{ "training", false }}, "learning_rate");
+  ReportIgnoredParam(params, {{ "training", false }}, "maximum_depth");
+  ReportIgnoredParam(params, {{ "training", false }}, "minimum_leaf_size");
+  ReportIgnoredParam(params, {{ "training", false }}, "minimum_gain_split");
+  ReportIgnoredParam(params, {{ "training", false }}, "row_subsample");
+  ReportIgnoredParam(params, {{ "training", false }}, "col_subsample");
+  ReportIgnoredParam(params, {{ "training", false }}, "lambda");
+  ReportIgnoredParam(params, {{ "training", false }}, "alpha");
+  ReportIgnoredParam(params, {{ "training", false }}, "validation");
+
+  RequireParamValue<int>(params, "num_trees", [](int x) { return x > 0; }, true,
+      "number of trees must be positive");
+  RequireParamValue<int>(params, "early_stopping_rounds",
+      [](int x) { return x > 0; }, true, "number of early stopping rounds must "
+      "be positive");
+  RequireParamValue<double>(params, "learning_rate",
+      [](double x) { return x > 0.0; }, true, "learning rate must be positive");
+  RequireParamValue<int>(params, "maximum_depth", [](int x) { return x >= 0; },
+      true, "maximum depth must not be negative");
+  RequireParamValue<int>(params, "minimum_leaf_size",
+      [](int x) { return x > 0; }, true, "minimum leaf size must be greater "
+      "than 0");
+  RequireParamValue<double>(params, "minimum_gain_split",
+      [](double x) { return x >= 0.0; }, true,
+      "minimum gain for splitting must be nonnegative");
+  RequireParamValue<double>(params, "row_subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "row subsample fraction must be in (0, 1]");
+  RequireParamValue<double>(params, "col_subsample",
+      [](double x) { return x > 0.0 && x <= 1.0; }, true,
+      "column subsample fraction must be in (0, 1]");
+  RequireParamValue<double>(params, "lambda", [](double x) { return x >= 0.0; },
+      true, "lambda must be nonnegative");
+  RequireParamValue<double>(params, "alpha", [](double x) { return x >= 0.0; },
+      true, "alpha must be nonnegative");
+
+  XGBoostRegressor<>* model;
+  if (params.Has("input_model"))
+    model = params.Get<XGBoostRegressor<>*>("input_model");
+  else
+    model = new XGBoostRegressor<>();
+
+  if (params.Has("training"))
+  {
+    timers.Start("xgboost_training");
+
+    arma::mat data = std::move(params.Get<arma::mat>("training"));
+    arma::rowvec responses = std::move(params.Get<arma::rowvec>("responses"));
+
+    const size_t numTrees = (size_t) params.Get<int>("num_trees");
+    const double learningRate = params.Get<double>("learning_rate");
+    const size_t maxDepth = (size_t) params.Get<int>("maximum_depth");
+    const size_t minimumLeafSize =
+        (size_t) params.Get<int>("minimum_leaf_size");
+    const double minimumGainSplit = params.Get<double>("minimum_gain_split");
+    const double rowSubsample = params.Get<double>("row_subsample");
+    const double colSubsample = params.Get<double>("col_subsample");
+    SSELoss loss(params.Get<double>("alpha"), params.Get<double>("lambda"));
+
+    Log::Info << "Training gradient boosted model with at most " << numTrees
+        << " trees..." << endl;
+
+    double trainLoss;
+    if (params.Has("validation"))
+    {
+      arma::mat validation = std::move(params.Get<arma::mat>("validation"));
+      arma::rowvec validationResponses =
+          std::move(params.Get<arma::rowvec>("validation_responses"));
+      const size_t earlyStoppingRounds =
+          (size_t) params.Get<int>("early_stopping_rounds");
+
+      trainLoss = model->Train(data, responses, validation,
+          validationResponses, earlyStoppingRounds, numTrees, learningRate,
+          maxDepth, minimumLeafSize, minimumGainSplit, rowSubsample,
+          colSubsample, loss);
+      Log::Info << "Kept " << model->NumTrees() << " trees; average validation "
+          << "loss " << trainLoss << "." << endl;
+    }
+    else
+    {
+      trainLoss = model->Train(data, responses, numTrees, learningRate,
+          maxDepth, minimumLeafSize, minimumGainSplit, rowSubsample,
+          colSubsample, loss);
+      Log::Info << "Average training loss " << trainLoss << "." << endl;
+    }
+
+    timers.Stop("xgboost_training");
+  }
+
+  if (params.Has("test"))
+  {
+    arma::mat testData = std::move(params.Get<arma::mat>("test"));
+    timers.Start("xgboost_prediction");
+
+    arma::rowvec predictions;
+    model->Predict(testData, predictions);
+
+    timers.Stop("xgboost_prediction");
+
+    params.Get<arma::rowvec>("predictions") = std::move(predictions);
+  }
+
+  // Save the output model.
+  params.Get<XGBoostRegressor<>*>("output_model") = model;
+}
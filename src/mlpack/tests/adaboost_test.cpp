@@ -1104,3 +1104,49 @@ TEMPLATE_TEST_CASE("AdaBoostTrainOverloads", "[AdaBoostTest]", fmat, mat)
   REQUIRE(a3.WeakLearner(0).MaxIterations() == 1000);
   REQUIRE(a4.WeakLearner(0).MaxIterations() == 100);
 }
+
+/**
+ * Make sure that classifying a batch of points, which is done tile by tile,
+ * gives the same predictions and probabilities as classifying each point on its
+ * own.
+ */
+TEMPLATE_TEST_CASE("BatchClassifyMatchesPointClassifyTest", "[AdaBoostTest]",
+    mat, fmat)
+{
+  typedef TestType MatType;
+  typedef typename MatType::elem_type eT;
+
+  // Use enough points that there are several tiles, the last of which is not
+  // full.
+  MatType data = randu<MatType>(5, 1000);
+  Row<size_t> labels(1000);
+  for (size_t i = 0; i < 1000; ++i)
+    labels[i] = (data(0, i) + data(2, i) > 1.0) ? 1 : ((data(1, i) > 0.7) ? 2 :
+        0);
+
+  AdaBoost<ID3DecisionStump, MatType> ab(data, labels, 3, 30, 1e-10, 10);
+  REQUIRE(ab.WeakLearners() > 0);
+
+  MatType testData = randu<MatType>(5, 777);
+  Row<size_t> predictions;
+  Mat<eT> probabilities;
+  ab.Classify(testData, predictions, probabilities);
+
+  REQUIRE(predictions.n_elem == testData.n_cols);
+  REQUIRE(probabilities.n_rows == 3);
+  REQUIRE(probabilities.n_cols == testData.n_cols);
+
+  for (size_t i = 0; i < testData.n_cols; ++i)
+  {
+    size_t prediction;
+    Row<eT> pointProbabilities;
+    ab.Classify(testData.col(i), prediction, pointProbabilities);
+
+    REQUIRE(predictions[i] == prediction);
+    for (size_t c = 0; c < 3; ++c)
+    {
+      REQUIRE(probabilities(c, i) ==
+          Approx(pointProbabilities[c]).epsilon(1e-5));
+    }
+  }
+}
@@ -13,6 +13,9 @@
 #ifndef MLPACK_ENABLE_ANN_SERIALIZATION
   #define MLPACK_ENABLE_ANN_SERIALIZATION
 #endif
+#ifndef MLPACK_ENABLE_ANN_SERIALIZATION_FMAT
+  #define MLPACK_ENABLE_ANN_SERIALIZATION_FMAT
+#endif
 #include <mlpack/core.hpp>
 #include <mlpack/methods/ann/ann.hpp>
 #include <mlpack/methods/kmeans/kmeans.hpp>
@@ -982,3 +985,556 @@ TEST_CASE("RBFNetworkTest", "[FeedForwardNetworkTest]")
   // RBFN neural net with MeanSquaredError.
   TestNetwork<>(model1, dataset, labels1, dataset, labels, 10, 0.1);
 }
+
+/**
+ * Train a network with single-precision parameters and data, using a range of
+ * layer types, and make sure that it learns and can be serialized.
+ */
+TEST_CASE("FFNFloatTrainingTest", "[FeedForwardNetworkTest]")
+{
+  arma::fmat trainData;
+  if (!data::Load("thyroid_train.csv", trainData))
+    FAIL("Cannot open thyroid_train.csv");
+
+  arma::fmat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+  trainLabels -= 1; // Labels should be from 0 to numClasses - 1.
+
+  arma::fmat testData;
+  if (!data::Load("thyroid_test.csv", testData))
+    FAIL("Cannot load dataset thyroid_test.csv");
+
+  arma::fmat testLabels = testData.row(testData.n_rows - 1);
+  testData.shed_row(testData.n_rows - 1);
+  testLabels -= 1; // Labels should be from 0 to numClasses - 1.
+
+  typedef FFN<NegativeLogLikelihoodType<arma::fmat>, RandomInitialization,
+      arma::fmat> FloatFFN;
+
+  FloatFFN model;
+  model.Add<LinearType<arma::fmat>>(16);
+  model.Add<BatchNormType<arma::fmat>>();
+  model.Add<LeakyReLUType<arma::fmat>>();
+  model.Add<DropoutType<arma::fmat>>(0.1);
+  model.Add<LinearNoBiasType<arma::fmat>>(8);
+  model.Add<LayerNormType<arma::fmat>>();
+  model.Add<SigmoidType<arma::fmat>>();
+  model.Add<LinearType<arma::fmat>>(3);
+  model.Add<LogSoftMaxType<arma::fmat>>();
+
+  TestNetwork<arma::fmat>(model, trainData, trainLabels, testData, testLabels,
+      10, 0.1);
+
+  FloatFFN xmlModel, jsonModel, binaryModel;
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::fmat predictions, xmlPredictions, jsonPredictions, binaryPredictions;
+  model.Predict(testData, predictions);
+  xmlModel.Predict(testData, xmlPredictions);
+  jsonModel.Predict(testData, jsonPredictions);
+  binaryModel.Predict(testData, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Make sure that the bfloat16 conversions round correctly, and that storing the
+ * parameters of a trained network as bfloat16 keeps its predictions.
+ */
+TEST_CASE("FFNBFloat16ParametersTest", "[FeedForwardNetworkTest]")
+{
+  // Exactly representable values are kept; others are rounded to the nearest
+  // value, with ties to even.
+  REQUIRE(ToBFloat16(1.0f) == 0x3F80);
+  REQUIRE(FromBFloat16(0x3F80) == 1.0f);
+  REQUIRE(FromBFloat16(ToBFloat16(-2.5f)) == -2.5f);
+  REQUIRE(FromBFloat16(ToBFloat16(1.0f + std::pow(2.0f, -8))) == 1.0f);
+  REQUIRE(FromBFloat16(ToBFloat16(1.0f + 3 * std::pow(2.0f, -8))) ==
+      1.0f + std::pow(2.0f, -6));
+  REQUIRE(std::isnan(FromBFloat16(ToBFloat16(
+      std::numeric_limits<float>::quiet_NaN()))));
+  REQUIRE(std::isinf(FromBFloat16(ToBFloat16(
+      std::numeric_limits<float>::infinity()))));
+
+  arma::fmat trainData;
+  if (!data::Load("thyroid_train.csv", trainData))
+    FAIL("Cannot open thyroid_train.csv");
+
+  arma::fmat trainLabels = trainData.row(trainData.n_rows - 1);
+  trainData.shed_row(trainData.n_rows - 1);
+  trainLabels -= 1; // Labels should be from 0 to numClasses - 1.
+
+  FFN<NegativeLogLikelihoodType<arma::fmat>, RandomInitialization, arma::fmat>
+      model;
+  model.Add<LinearType<arma::fmat>>(8);
+  model.Add<SigmoidType<arma::fmat>>();
+  model.Add<LinearType<arma::fmat>>(3);
+  model.Add<LogSoftMaxType<arma::fmat>>();
+
+  ens::RMSProp opt(0.01, 32, 0.88, 1e-8, trainData.n_cols * 10, -100);
+  model.Train(trainData, trainLabels, opt);
+
+  arma::fmat predictions;
+  model.Predict(trainData, predictions);
+
+  arma::Mat<uint16_t> storedParameters;
+  ToBFloat16(model.Parameters(), storedParameters);
+  REQUIRE(storedParameters.n_elem == model.Parameters().n_elem);
+
+  arma::fmat restoredParameters;
+  FromBFloat16(storedParameters, restoredParameters);
+  // bfloat16 has 8 bits of precision, so with rounding to nearest the relative
+  // error of each parameter is at most 2^-8.
+  REQUIRE(arma::all(arma::vectorise(arma::abs(restoredParameters -
+      model.Parameters())) <= arma::abs(model.Parameters()) / 256.0f));
+
+  // A network stored in bfloat16 gives the same predictions as the network
+  // with the rounded parameters.
+  FFNBFloat16<arma::fmat> storedModel(model);
+  REQUIRE(storedModel.Parameters().n_elem == model.Parameters().n_elem);
+  REQUIRE(arma::all(arma::vectorise(storedModel.Parameters() ==
+      storedParameters)));
+
+  model.Parameters() = restoredParameters;
+  arma::fmat bf16Predictions, storedPredictions;
+  model.Predict(trainData, bf16Predictions);
+  storedModel.Predict(trainData, storedPredictions, 50);
+  CheckMatrices(bf16Predictions, storedPredictions, 1e-3);
+
+  const arma::urowvec classes = arma::index_max(predictions, 0);
+  const arma::urowvec bf16Classes = arma::index_max(bf16Predictions, 0);
+  const size_t same = arma::accu(classes == bf16Classes);
+  REQUIRE(same >= 0.98 * trainData.n_cols);
+
+  // Rounding in place gives the same values as storing and restoring.
+  arma::fmat rounded = model.Parameters();
+  RoundToBFloat16(rounded);
+  CheckMatrices(rounded, restoredParameters, 0.0);
+}
+
+/**
+ * Make sure that a deep network gives the same results in inference mode, where
+ * the outputs of intermediate layers share memory, as in training mode, and
+ * that a backward pass after an inference-mode forward pass is still correct.
+ */
+TEST_CASE("FFNInferenceMemoryReuseTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 1024, arma::fill::randu);
+  arma::mat labels = arma::randi<arma::mat>(1, 1024, arma::distr_param(0, 2));
+
+  FFN<NegativeLogLikelihood> model;
+  model.Add<Linear>(64);
+  model.Add<ReLU>();
+  model.Add<Linear>(16);
+  model.Add<ReLU>();
+  model.Add<Linear>(64);
+  model.Add<ReLU>();
+  model.Add<Linear>(8);
+  model.Add<ReLU>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+
+  arma::mat trainingOutput, trainingGradient;
+  model.SetNetworkMode(true);
+  model.Forward(data, trainingOutput);
+  const double trainingObjective = model.Backward(data, labels,
+      trainingGradient);
+
+  arma::mat inferenceOutput, inferenceGradient;
+  model.SetNetworkMode(false);
+  model.Forward(data, inferenceOutput);
+  CheckMatrices(trainingOutput, inferenceOutput);
+
+  // The intermediate outputs must be recomputed for the backward pass.
+  const double inferenceObjective = model.Backward(data, labels,
+      inferenceGradient);
+  REQUIRE(inferenceObjective == Approx(trainingObjective).epsilon(1e-7));
+  CheckMatrices(trainingGradient, inferenceGradient);
+
+  // Predicting with different batch sizes reuses the same memory.
+  arma::mat predictions, smallBatchPredictions;
+  model.Predict(data, predictions, 1024);
+  model.Predict(data, smallBatchPredictions, 100);
+  CheckMatrices(trainingOutput, predictions);
+  CheckMatrices(trainingOutput, smallBatchPredictions);
+
+  // Training-mode passes still keep every output after inference.
+  model.SetNetworkMode(true);
+  arma::mat secondGradient;
+  model.Forward(data, trainingOutput);
+  model.Backward(data, labels, secondGradient);
+  CheckMatrices(trainingGradient, secondGradient);
+}
+
+/**
+ * Make sure that FFNInference gives the same predictions as FFN::Predict() when
+ * used from many threads, and that queued requests are grouped into batches.
+ */
+TEST_CASE("FFNInferenceTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 400, arma::fill::randu);
+
+  FFN<NegativeLogLikelihood> model;
+  model.Add<Linear>(32);
+  model.Add<ReLU>();
+  model.Add<Linear>(16);
+  model.Add<ReLU>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+
+  // The network must be initialized first.
+  REQUIRE_THROWS_AS(FFNInference<>(model), std::invalid_argument);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  {
+    FFNInference<> inference(model, 4, 16);
+    REQUIRE(inference.NumThreads() == 4);
+
+    // Send single-point requests from many threads at once.
+    std::vector<arma::mat> results(data.n_cols);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < 8; ++t)
+    {
+      threads.emplace_back([&, t]()
+      {
+        for (size_t i = t; i < data.n_cols; i += 8)
+          inference.Predict(data.col(i), results[i]);
+      });
+    }
+
+    for (size_t t = 0; t < threads.size(); ++t)
+      threads[t].join();
+
+    for (size_t i = 0; i < data.n_cols; ++i)
+      CheckMatrices(results[i], predictions.col(i));
+
+    // Requests with many points give the same predictions too.
+    arma::mat allResults;
+    inference.Predict(data, allResults);
+    CheckMatrices(allResults, predictions);
+
+    REQUIRE_THROWS_AS(inference.Predict(arma::mat(5, 1), allResults),
+        std::invalid_argument);
+  }
+
+  // With a single worker and a long delay, requests that are queued at once
+  // are computed in full batches.
+  FFNInference<> inference(model, 1, 16, std::chrono::seconds(10));
+  std::vector<arma::mat> results(64);
+  std::vector<arma::mat> points(64);
+  std::vector<std::future<void>> futures;
+  for (size_t i = 0; i < 64; ++i)
+  {
+    points[i] = data.col(i);
+    futures.push_back(inference.PredictAsync(points[i], results[i]));
+  }
+
+  for (size_t i = 0; i < 64; ++i)
+  {
+    futures[i].get();
+    CheckMatrices(results[i], predictions.col(i));
+  }
+  REQUIRE(inference.Batches() == 4);
+}
+
+/**
+ * Make sure that the int8 forward pass of QuantizedLinear computes exactly the
+ * product of the dequantized weights and the dequantized input.
+ */
+TEST_CASE("QuantizedLinearForwardTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat weight(5, 7, arma::fill::randn);
+  arma::mat bias(5, 1, arma::fill::randn);
+  arma::mat input(7, 12, arma::fill::randn);
+  const double inputScale = QuantizationScale(
+      (double) arma::max(arma::abs(arma::vectorise(input))));
+
+  QuantizedLinear layer(weight, bias, inputScale);
+  layer.InputDimensions() = std::vector<size_t>({ 7 });
+  layer.ComputeOutputDimensions();
+  REQUIRE(layer.OutputDimensions()[0] == 5);
+
+  arma::mat output(5, 12);
+  layer.Forward(input, output);
+
+  // Dequantize the weights and the input by hand.
+  arma::mat dequantizedWeight(5, 7);
+  for (size_t i = 0; i < 5; ++i)
+  {
+    for (size_t j = 0; j < 7; ++j)
+    {
+      dequantizedWeight(i, j) = layer.WeightScales()[i] *
+          layer.QuantizedWeight()[j + 7 * i];
+    }
+  }
+  const arma::mat dequantizedInput = inputScale * arma::round(input /
+      inputScale);
+
+  arma::mat expected = dequantizedWeight * dequantizedInput;
+  expected.each_col() += bias;
+  CheckMatrices(output, expected, 1e-8);
+
+  // The quantized weights are close to the original weights.
+  const double weightError = arma::max(arma::abs(arma::vectorise(
+      dequantizedWeight - weight)));
+  REQUIRE(weightError <= 0.5 * arma::max(layer.WeightScales().col(0)) + 1e-12);
+
+  // Quantized layers cannot be trained.
+  arma::mat g;
+  REQUIRE_THROWS_AS(layer.Backward(input, output, output, g),
+      std::logic_error);
+}
+
+/**
+ * Make sure that the given network, built for inference from `model` by
+ * QuantizeFFN() or FuseFFN(), left `model` unchanged, gives the same
+ * predictions after serialization, and cannot be trained.
+ *
+ * @param model Original network.
+ * @param rebuilt Network built from `model`.
+ * @param data Input points.
+ * @param predictions Predictions of `model` on `data` before it was rebuilt.
+ */
+void CheckRebuiltFFN(FFN<NegativeLogLikelihood>& model,
+                     FFN<NegativeLogLikelihood>& rebuilt,
+                     const arma::mat& data,
+                     const arma::mat& predictions)
+{
+  // The original model is unchanged.
+  arma::mat predictionsAfter;
+  model.Predict(data, predictionsAfter);
+  CheckMatrices(predictions, predictionsAfter);
+
+  FFN<NegativeLogLikelihood> xmlModel, jsonModel, binaryModel;
+  xmlModel.Add<Linear>(10); // Layer that will get removed.
+  SerializeObjectAll(rebuilt, xmlModel, jsonModel, binaryModel);
+
+  arma::mat rebuiltPredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions;
+  rebuilt.Predict(data, rebuiltPredictions);
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(rebuiltPredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+
+  // Networks built for inference cannot be trained.
+  arma::mat labels(1, data.n_cols, arma::fill::zeros);
+  ens::StandardSGD opt(0.01, 32, 10);
+  REQUIRE_THROWS_AS(rebuilt.Train(data, labels, opt), std::logic_error);
+}
+
+/**
+ * Quantize a trained network with Convolution, Linear and LinearNoBias layers,
+ * and make sure the quantized network gives close predictions and can be
+ * serialized.
+ */
+TEST_CASE("FFNQuantizationTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(7 * 7 * 2, 300, arma::fill::randu);
+
+  FFN<NegativeLogLikelihood> model;
+  model.Add<Convolution>(4, 3, 3, 2, 2, 1, 1);
+  model.Add<ReLU>();
+  model.Add<Linear>(16);
+  model.Add<ReLU>();
+  model.Add<LinearNoBias>(3);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 7, 7, 2 });
+
+  // The network must be initialized first.
+  REQUIRE_THROWS_AS(QuantizeFFN(model, data), std::invalid_argument);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  FFN<NegativeLogLikelihood> quantized = QuantizeFFN(model,
+      arma::mat(data.cols(0, 99)));
+
+  // Only the layers with weights are replaced.
+  REQUIRE(quantized.Network().size() == 6);
+  REQUIRE(dynamic_cast<QuantizedConvolution*>(quantized.Network()[0]) != NULL);
+  REQUIRE(dynamic_cast<ReLU*>(quantized.Network()[1]) != NULL);
+  REQUIRE(dynamic_cast<QuantizedLinear*>(quantized.Network()[2]) != NULL);
+  REQUIRE(dynamic_cast<QuantizedLinear*>(quantized.Network()[4]) != NULL);
+
+  const QuantizationReport report = EvaluateQuantization(model, quantized,
+      data);
+  REQUIRE(report.relativeError < 0.02);
+  REQUIRE(report.maxAbsoluteError < 0.1);
+  REQUIRE(report.meanAbsoluteError <= report.maxAbsoluteError);
+  REQUIRE(report.argmaxAgreement >= 0.9);
+
+  // The quantized network has no parameters left to store.
+  REQUIRE(quantized.Parameters().n_elem == 0);
+
+  CheckRebuiltFFN(model, quantized, data, predictions);
+}
+
+/**
+ * Test that the FusedLinear layer computes the activation of an affine
+ * transformation in one pass.
+ */
+TEST_CASE("FusedLinearForwardTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat weight(5, 8, arma::fill::randn);
+  arma::mat bias(5, 1, arma::fill::randn);
+  arma::mat input(8, 20, arma::fill::randn);
+
+  REQUIRE_THROWS_AS(FusedLinear(weight, bias, "unknown"),
+      std::invalid_argument);
+  REQUIRE_THROWS_AS(FusedLinear(weight, arma::mat(4, 1), "relu"),
+      std::invalid_argument);
+
+  FusedLinear layer(weight, bias, "tanh");
+  layer.InputDimensions() = std::vector<size_t>({ 8 });
+  REQUIRE(layer.OutputSize() == 5);
+  REQUIRE(layer.WeightSize() == 0);
+
+  arma::mat output(5, 20);
+  layer.Forward(input, output);
+
+  arma::mat expected = weight * input;
+  expected.each_col() += bias;
+  CheckMatrices(output, arma::mat(arma::tanh(expected)));
+
+  arma::mat g;
+  REQUIRE_THROWS_AS(layer.Backward(input, output, output, g),
+      std::logic_error);
+}
+
+/**
+ * Test that fusing a trained network folds its BatchNorm layers and merges its
+ * activation layers, without changing its predictions.
+ */
+TEST_CASE("FFNFusionTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(7 * 7 * 2, 200, arma::fill::randu);
+  arma::mat labels = arma::randi<arma::mat>(1, data.n_cols,
+      arma::distr_param(0, 2));
+
+  FFN<NegativeLogLikelihood> model;
+  model.Add<Convolution>(4, 3, 3, 1, 1, 1, 1);
+  model.Add<BatchNorm>();
+  model.Add<ReLU>();
+  model.Add<Linear>(16);
+  model.Add<BatchNorm>(0, 0);
+  model.Add<Sigmoid>();
+  model.Add<LinearNoBias>(3);
+  model.Add<LogSoftMax>();
+  model.InputDimensions() = std::vector<size_t>({ 7, 7, 2 });
+
+  // The network must be initialized first.
+  REQUIRE_THROWS_AS(FuseFFN(model), std::invalid_argument);
+
+  // Train for a little while, so that the BatchNorm layers have non-trivial
+  // statistics.
+  ens::StandardSGD opt(0.01, 32, 400);
+  model.Train(data, labels, opt);
+
+  arma::mat predictions;
+  model.Predict(data, predictions);
+
+  FFN<NegativeLogLikelihood> fused = FuseFFN(model);
+
+  REQUIRE(fused.Network().size() == 4);
+  FusedConvolution* convolution =
+      dynamic_cast<FusedConvolution*>(fused.Network()[0]);
+  FusedLinear* linear = dynamic_cast<FusedLinear*>(fused.Network()[1]);
+  REQUIRE(convolution != NULL);
+  REQUIRE(convolution->Activation() == "relu");
+  REQUIRE(linear != NULL);
+  REQUIRE(linear->Activation() == "sigmoid");
+  REQUIRE(dynamic_cast<LinearNoBias*>(fused.Network()[2]) != NULL);
+  REQUIRE(dynamic_cast<LogSoftMax*>(fused.Network()[3]) != NULL);
+
+  // Only the weights of the LinearNoBias layer are left.
+  REQUIRE(fused.Parameters().n_elem == 3 * 16);
+
+  arma::mat fusedPredictions;
+  fused.Predict(data, fusedPredictions);
+  CheckMatrices(predictions, fusedPredictions);
+
+  CheckRebuiltFFN(model, fused, data, predictions);
+}
+
+/**
+ * Test that data-parallel training gives the same model as regular training,
+ * also when the batches do not split evenly over the replicas.
+ */
+TEST_CASE("FFNDataParallelTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 100, arma::fill::randu);
+  arma::mat labels = arma::randi<arma::mat>(1, data.n_cols,
+      arma::distr_param(0, 2));
+
+  FFN<NegativeLogLikelihood> model;
+  model.Add<Linear>(8);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(3);
+  model.Add<LogSoftMax>();
+  model.Reset(data.n_rows);
+
+  FFN<NegativeLogLikelihood> parallelModel(model);
+
+  FFNDataParallel<NegativeLogLikelihood> trainer(parallelModel, 3);
+  REQUIRE(trainer.NumThreads() == 3);
+
+  // Without shuffling, both models see the same batches; the last batch of
+  // each epoch has only 4 points.
+  ens::StandardSGD opt(0.01, 16, 2 * data.n_cols, -100, false);
+  model.Train(data, labels, opt);
+  trainer.Train(data, labels, opt);
+
+  CheckMatrices(model.Parameters(), parallelModel.Parameters());
+
+  arma::mat predictions, parallelPredictions;
+  model.Predict(data, predictions);
+  parallelModel.Predict(data, parallelPredictions);
+  CheckMatrices(predictions, parallelPredictions);
+
+  // By default, one replica per thread is used.
+  FFNDataParallel<NegativeLogLikelihood> defaultTrainer(parallelModel);
+  REQUIRE(defaultTrainer.NumThreads() >= 1);
+}
+
+/**
+ * Test that data-parallel training gives the same model as regular training
+ * for a network with a regularized layer and an output layer with 'mean'
+ * reduction: the shards must be weighted by their size, and the regularization
+ * must only be counted once per batch.
+ */
+TEST_CASE("FFNDataParallelRegularizedMeanTest", "[FeedForwardNetworkTest]")
+{
+  arma::mat data(10, 100, arma::fill::randu);
+  arma::mat responses(2, 100, arma::fill::randu);
+
+  FFN<MeanSquaredError> model(MeanSquaredError(false));
+  model.Add<LinearType<arma::mat, L2Regularizer>>(8, L2Regularizer(0.1));
+  model.Add<Sigmoid>();
+  model.Add<Linear>(2);
+  model.Reset(data.n_rows);
+
+  FFN<MeanSquaredError> parallelModel(model);
+  FFNDataParallel<MeanSquaredError> trainer(parallelModel, 3);
+
+  // The last batch of each epoch has only 4 points, so the shards do not all
+  // have the same size.
+  ens::StandardSGD opt(0.1, 16, 2 * data.n_cols, -100, false);
+  const double objective = model.Train(data, responses, opt);
+  const double parallelObjective = trainer.Train(data, responses, opt);
+
+  REQUIRE(parallelObjective == Approx(objective).epsilon(1e-7));
+  CheckMatrices(model.Parameters(), parallelModel.Parameters());
+
+  // Output layers whose objective is not a sum or a mean over the points
+  // cannot be split into shards.
+  FFN<MeanAbsolutePercentageError> percentageModel;
+  REQUIRE_THROWS_AS(
+      FFNDataParallel<MeanAbsolutePercentageError>(percentageModel),
+      std::invalid_argument);
+}
@@ -461,3 +461,87 @@ TEST_CASE("NonSquareConvolutionTest", "[ANNLayerTest]")
   arma::mat gradientResult(module1.WeightSize(), 1);
   REQUIRE_NOTHROW(module1.Gradient(data, backwardResult, gradientResult));
 }
+
+/**
+ * Make sure that a Convolution layer that uses Im2ColConvolution gives the same
+ * results as one that uses NaiveConvolution for the forward pass, the backward
+ * pass and the gradient.
+ */
+TEST_CASE("Im2ColConvolutionLayerTest", "[ANNLayerTest]")
+{
+  typedef ConvolutionType<
+      Im2ColConvolution<ValidConvolution>,
+      Im2ColConvolution<FullConvolution>,
+      Im2ColConvolution<ValidConvolution>,
+      arma::mat
+  > Im2ColConvolutionLayer;
+
+  // Each configuration is: maps, kernel width, kernel height, stride, padding
+  // (left, right, top, bottom), bias, and input dimensions.
+  struct Config
+  {
+    size_t maps, kW, kH, stride, padWLeft, padWRight, padHTop, padHBottom;
+    bool useBias;
+    std::vector<size_t> inputDimensions;
+  };
+  const std::vector<Config> configs = {
+      { 4, 3, 3, 1, 1, 1, 1, 1, true, { 7, 6, 3 } },
+      { 3, 3, 2, 2, 1, 2, 0, 1, true, { 9, 8, 2 } },
+      { 2, 2, 3, 1, 0, 0, 0, 0, false, { 5, 6, 1 } },
+      { 2, 3, 3, 2, 1, 0, 1, 0, true, { 6, 7, 2, 2 } } };
+
+  for (const Config& c : configs)
+  {
+    Convolution naive(c.maps, c.kW, c.kH, c.stride, c.stride,
+        std::tuple<size_t, size_t>(c.padWLeft, c.padWRight),
+        std::tuple<size_t, size_t>(c.padHTop, c.padHBottom), "none",
+        c.useBias);
+    Im2ColConvolutionLayer im2col(c.maps, c.kW, c.kH, c.stride, c.stride,
+        std::tuple<size_t, size_t>(c.padWLeft, c.padWRight),
+        std::tuple<size_t, size_t>(c.padHTop, c.padHBottom), "none",
+        c.useBias);
+
+    naive.InputDimensions() = c.inputDimensions;
+    naive.ComputeOutputDimensions();
+    im2col.InputDimensions() = c.inputDimensions;
+    im2col.ComputeOutputDimensions();
+    REQUIRE(naive.OutputSize() == im2col.OutputSize());
+    REQUIRE(naive.WeightSize() == im2col.WeightSize());
+
+    arma::mat weights(naive.WeightSize(), 1, arma::fill::randn);
+    naive.SetWeights(weights.memptr());
+    im2col.SetWeights(weights.memptr());
+
+    size_t inputSize = 1;
+    for (size_t d = 0; d < c.inputDimensions.size(); ++d)
+      inputSize *= c.inputDimensions[d];
+    arma::mat input(inputSize, 5, arma::fill::randn);
+
+    arma::mat naiveOutput(naive.OutputSize(), 5);
+    arma::mat im2colOutput(im2col.OutputSize(), 5);
+    naive.Forward(input, naiveOutput);
+    im2col.Forward(input, im2colOutput);
+    CheckMatrices(naiveOutput, im2colOutput, 1e-8);
+
+    arma::mat error(naive.OutputSize(), 5, arma::fill::randn);
+    arma::mat naiveDelta(inputSize, 5);
+    arma::mat im2colDelta(inputSize, 5);
+    naive.Backward(input, naiveOutput, error, naiveDelta);
+    im2col.Backward(input, im2colOutput, error, im2colDelta);
+    CheckMatrices(naiveDelta, im2colDelta, 1e-8);
+
+    arma::mat naiveGradient(naive.WeightSize(), 1);
+    arma::mat im2colGradient(im2col.WeightSize(), 1);
+    naive.Gradient(input, error, naiveGradient);
+    im2col.Gradient(input, error, im2colGradient);
+    CheckMatrices(naiveGradient, im2colGradient, 1e-8);
+
+    // The buffers are reused by a second call with a different batch size.
+    arma::mat input2(inputSize, 3, arma::fill::randn);
+    naiveOutput.set_size(naive.OutputSize(), 3);
+    im2colOutput.set_size(im2col.OutputSize(), 3);
+    naive.Forward(input2, naiveOutput);
+    im2col.Forward(input2, im2colOutput);
+    CheckMatrices(naiveOutput, im2colOutput, 1e-8);
+  }
+}
@@ -231,3 +231,64 @@ TEST_CASE("GradientMultiheadAttentionTest", "[ANNLayerTest]")
 
   REQUIRE(CheckGradient(function) <= 3e-06);
 }
+
+/**
+ * Make sure that computing the attention scores in blocks gives the same
+ * results as computing all scores at once.
+ */
+TEST_CASE("BlockedMultiheadAttentionTest", "[ANNLayerTest]")
+{
+  const size_t tgtSeqLen = 5;
+  const size_t embedDim = 4;
+  const size_t numHeads = 2;
+  const size_t batchSize = 3;
+
+  for (const bool selfAttention : { false, true })
+  {
+    const size_t srcSeqLen = selfAttention ? tgtSeqLen : 7;
+    const size_t inputLen = selfAttention ? srcSeqLen :
+        (tgtSeqLen + 2 * srcSeqLen);
+
+    arma::mat attnMask = arma::zeros(tgtSeqLen, srcSeqLen);
+    for (size_t i = 0; i < tgtSeqLen; ++i)
+    {
+      for (size_t j = 0; j < srcSeqLen; ++j)
+      {
+        if (i < j)
+          attnMask(i, j) = std::numeric_limits<double>::lowest();
+      }
+    }
+
+    arma::mat keyPaddingMask = arma::zeros(1, srcSeqLen);
+    keyPaddingMask(srcSeqLen - 2) = std::numeric_limits<double>::lowest();
+
+    arma::mat input = arma::randu(embedDim * inputLen, batchSize);
+    arma::mat weights = 0.5 * arma::randu(4 * (embedDim + 1) * embedDim, 1);
+    arma::mat gy = arma::randu(embedDim * tgtSeqLen, batchSize);
+
+    // Block sizes that do and do not divide the source sequence length, and
+    // one that is larger than it.
+    arma::mat outputs[4], deltas[4], gradients[4];
+    const size_t blockSizes[4] = { 0, 1, 3, 10 };
+    for (size_t b = 0; b < 4; ++b)
+    {
+      MultiheadAttention module(tgtSeqLen, numHeads, attnMask, keyPaddingMask,
+          selfAttention, blockSizes[b]);
+      module.InputDimensions() = std::vector<size_t>({ embedDim, inputLen });
+      module.ComputeOutputDimensions();
+      module.SetWeights(weights.memptr());
+
+      module.Forward(input, outputs[b]);
+      module.Backward(input, outputs[b], gy, deltas[b]);
+      gradients[b].set_size(weights.n_elem, 1);
+      module.Gradient(input, gy, gradients[b]);
+    }
+
+    for (size_t b = 1; b < 4; ++b)
+    {
+      CheckMatrices(outputs[0], outputs[b], 1e-8);
+      CheckMatrices(deltas[0], deltas[b], 1e-8);
+      CheckMatrices(gradients[0], gradients[b], 1e-8);
+    }
+  }
+}
@@ -1272,3 +1272,34 @@ TEST_CASE("JacobianNegativeLogLikelihoodLayerTest", "[LossFunctionsTest]")
     REQUIRE(error <= 1e-5);
   }
 }
+
+/**
+ * Make sure that loss functions give the same results with single precision
+ * matrices as with double precision matrices.
+ */
+TEST_CASE("FloatLossFunctionsTest", "[LossFunctionsTest]")
+{
+  arma::mat input("1 2 3 4 5");
+  arma::mat target("0.5 1 3.5 3 6");
+  arma::fmat fInput = arma::conv_to<arma::fmat>::from(input);
+  arma::fmat fTarget = arma::conv_to<arma::fmat>::from(target);
+
+  arma::mat output;
+  arma::fmat fOutput;
+
+  SigmoidCrossEntropyError sce;
+  SigmoidCrossEntropyErrorType<arma::fmat> fSce;
+  REQUIRE(fSce.Forward(fInput, fTarget) ==
+      Approx(sce.Forward(input, target)).epsilon(1e-5));
+  sce.Backward(input, target, output);
+  fSce.Backward(fInput, fTarget, fOutput);
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(fOutput), 1e-3);
+
+  MeanAbsolutePercentageError mape;
+  MeanAbsolutePercentageErrorType<arma::fmat> fMape;
+  REQUIRE(fMape.Forward(fInput, fTarget) ==
+      Approx(mape.Forward(input, target)).epsilon(1e-5));
+  mape.Backward(input, target, output);
+  fMape.Backward(fInput, fTarget, fOutput);
+  CheckMatrices(output, arma::conv_to<arma::mat>::from(fOutput), 1e-3);
+}
@@ -9,12 +9,16 @@
  * 3-clause BSD license along with mlpack.  If not, see
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
+#ifndef MLPACK_ENABLE_ANN_SERIALIZATION
+  #define MLPACK_ENABLE_ANN_SERIALIZATION
+#endif
 #include <mlpack/core.hpp>
 
 #include <mlpack/methods/ann/ann.hpp>
 
 #include "../catch.hpp"
 #include "../serialization.hpp"
+#include "ann_test_tools.hpp"
 
 using namespace mlpack;
 using namespace ens;
@@ -432,3 +436,285 @@ TEST_CASE("RNNFFNTest", "[RecurrentNetworkTest]")
   // Now, the weights should be the same!
   CheckMatrices(ffn.Parameters(), rnn.Parameters());
 }
+
+/**
+ * Check the gradient of the given recurrent layer numerically, over a whole
+ * sequence, and then check the gradient of truncated BPTT, with sequences
+ * longer than `bpttSteps`.  Truncated BPTT ignores the contribution of the
+ * parameters to the steps before the window, so its reference is the loss of
+ * the window with those steps computed with fixed parameters.
+ */
+template<typename RecurrentLayerType>
+void RecurrentLayerGradientTest()
+{
+  struct GradientFunction
+  {
+    GradientFunction() :
+        input(arma::randu(3, 4, 5)),
+        target(arma::randu(2, 4, 5)),
+        model(5)
+    {
+      model.Add<RecurrentLayerType>(2);
+      model.ResetData(input, target);
+      model.Reset(3);
+    }
+
+    double Gradient(arma::mat& gradient)
+    {
+      return model.EvaluateWithGradient(model.Parameters(), 0, gradient, 4);
+    }
+
+    arma::mat& Parameters() { return model.Parameters(); }
+
+    arma::cube input, target;
+    RNN<MeanSquaredError> model;
+  } function;
+
+  REQUIRE(CheckGradient(function) <= 1e-5);
+
+  struct TruncatedGradientFunction
+  {
+    TruncatedGradientFunction(const arma::cube& input,
+                              const arma::cube& target,
+                              const arma::mat& parameters) :
+        input(input),
+        target(target),
+        fixedParameters(parameters),
+        model(3),
+        layer(2)
+    {
+      // Only the last three steps are kept for BPTT.
+      model.Add<RecurrentLayerType>(2);
+      model.ResetData(input, target);
+      model.Reset(3);
+      model.Parameters() = parameters;
+
+      layer.InputDimensions() = std::vector<size_t>({ 3 });
+      layer.ComputeOutputDimensions();
+    }
+
+    double Gradient(arma::mat& gradient)
+    {
+      model.EvaluateWithGradient(model.Parameters(), 0, gradient, 4);
+
+      // Run the layer by hand, as the RNN does: the two steps before the
+      // window share slot 0, with the fixed parameters, and the window uses
+      // slots 1 to 3.
+      layer.ClearRecurrentState(4, 4);
+      layer.PreviousStep() = size_t(-1);
+      layer.SetWeights(fixedParameters.memptr());
+
+      arma::mat output;
+      double loss = 0.0;
+      for (size_t t = 0; t < input.n_slices; ++t)
+      {
+        const size_t slot = (t < 2) ? 0 : t - 1;
+        if (t == 2)
+          layer.SetWeights(model.Parameters().memptr());
+
+        layer.CurrentStep() = slot;
+        layer.Forward(input.slice(t), output);
+        if (t >= 2)
+          loss += lossFunction.Forward(output, target.slice(t));
+        layer.PreviousStep() = slot;
+      }
+
+      return loss;
+    }
+
+    arma::mat& Parameters() { return model.Parameters(); }
+
+    const arma::cube& input;
+    const arma::cube& target;
+    arma::mat fixedParameters;
+    RNN<MeanSquaredError> model;
+    RecurrentLayerType layer;
+    MeanSquaredError lossFunction;
+  } truncated(function.input, function.target, function.Parameters());
+
+  REQUIRE(CheckGradient(truncated) <= 1e-5);
+
+  // The loss does not depend on the number of BPTT steps.
+  arma::mat gradient, fullGradient;
+  const double loss = truncated.model.EvaluateWithGradient(
+      truncated.Parameters(), 0, gradient, 4);
+  REQUIRE(loss == Approx(function.Gradient(fullGradient)).epsilon(1e-10));
+}
+
+/**
+ * Check the gradient of the LSTM layer.
+ */
+TEST_CASE("LSTMGradientTest", "[RecurrentNetworkTest]")
+{
+  RecurrentLayerGradientTest<LSTM>();
+}
+
+/**
+ * Check the gradient of the GRU layer.
+ */
+TEST_CASE("GRUGradientTest", "[RecurrentNetworkTest]")
+{
+  RecurrentLayerGradientTest<GRU>();
+}
+
+/**
+ * Check the gradient of the FastLSTM layer.
+ */
+TEST_CASE("FastLSTMGradientTest", "[RecurrentNetworkTest]")
+{
+  RecurrentLayerGradientTest<FastLSTM>();
+}
+
+/**
+ * Make sure that an RNN with the given recurrent layer gives the same
+ * predictions after serialization.
+ */
+template<typename RecurrentLayerType>
+void RecurrentLayerSerializationTest()
+{
+  arma::cube input(arma::randu(3, 6, 5)), target(arma::randu(2, 6, 5));
+
+  RNN<MeanSquaredError> model(5);
+  model.Add<RecurrentLayerType>(4);
+  model.Add<Linear>(2);
+
+  ens::StandardSGD opt(0.01, 2, 12 /* 2 epochs */, -100, false);
+  model.Train(input, target, opt);
+
+  RNN<MeanSquaredError> xmlModel, jsonModel, binaryModel;
+  xmlModel.Add<Linear>(10); // Layer that will get removed.
+
+  // Serialize into other models.
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  arma::cube predictions, xmlPredictions, jsonPredictions, binaryPredictions;
+  model.Predict(input, predictions);
+  xmlModel.Predict(input, xmlPredictions);
+  jsonModel.Predict(input, jsonPredictions);
+  binaryModel.Predict(input, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}
+
+/**
+ * Serialize an RNN holding a GRU layer.
+ */
+TEST_CASE("GRUSerializationTest", "[RecurrentNetworkTest]")
+{
+  RecurrentLayerSerializationTest<GRU>();
+}
+
+/**
+ * Serialize an RNN holding a FastLSTM layer.
+ */
+TEST_CASE("FastLSTMSerializationTest", "[RecurrentNetworkTest]")
+{
+  RecurrentLayerSerializationTest<FastLSTM>();
+}
+
+/**
+ * Make sure that an RNN handles a recurrent layer nested inside another layer
+ * like a top-level one, and that inference-mode passes keep the intermediate
+ * outputs of such a network, so that a backward pass after them is correct.
+ */
+TEST_CASE("RNNNestedRecurrentLayerTest", "[RecurrentNetworkTest]")
+{
+  arma::cube input(3, 8, 5, arma::fill::randu);
+  arma::cube target(2, 8, 5, arma::fill::randu);
+
+  // The nested LSTM is the only layer of an AddMerge layer, so both networks
+  // compute the same function with the same parameters.  The networks are
+  // deep enough that inference-mode passes could share memory between the
+  // outputs of their layers.
+  RNN<MeanSquaredError> model(5), nestedModel(5);
+  model.Add<Linear>(8);
+  model.Add<Sigmoid>();
+  model.Add<LSTM>(8);
+  model.Add<Linear>(8);
+  model.Add<Sigmoid>();
+  model.Add<Linear>(2);
+
+  AddMerge* merge = new AddMerge();
+  merge->Add<LSTM>(8);
+  nestedModel.Add<Linear>(8);
+  nestedModel.Add<Sigmoid>();
+  nestedModel.Add(merge);
+  nestedModel.Add<Linear>(8);
+  nestedModel.Add<Sigmoid>();
+  nestedModel.Add<Linear>(2);
+
+  model.ResetData(input, target);
+  model.Reset(3);
+  nestedModel.ResetData(input, target);
+  nestedModel.Reset(3);
+  REQUIRE(nestedModel.Parameters().n_elem == model.Parameters().n_elem);
+  nestedModel.Parameters() = model.Parameters();
+
+  arma::cube predictions, nestedPredictions;
+  model.Predict(input, predictions);
+  nestedModel.Predict(input, nestedPredictions);
+  CheckMatrices(predictions, nestedPredictions);
+
+  // Predict() leaves the networks in inference mode, so these passes run in
+  // inference mode too.
+  arma::mat gradient, nestedGradient;
+  const double loss = model.EvaluateWithGradient(model.Parameters(), 0,
+      gradient, 8);
+  const double nestedLoss = nestedModel.EvaluateWithGradient(
+      nestedModel.Parameters(), 0, nestedGradient, 8);
+  REQUIRE(nestedLoss == Approx(loss).epsilon(1e-10));
+  CheckMatrices(gradient, nestedGradient);
+}
+
+/**
+ * Make sure that an RNN whose first layer is an LSTM, for which the input
+ * projections of all time steps are computed at once, gives the same results
+ * as the same network where the LSTM computes them one step at a time.
+ */
+TEST_CASE("RNNInputProjectionTest", "[RecurrentNetworkTest]")
+{
+  arma::cube input(3, 8, 5, arma::fill::randu);
+  arma::cube target(2, 8, 5, arma::fill::randu);
+
+  // The Identity layer in front of the LSTM keeps `stepModel` from computing
+  // the projections of all time steps at once.  `bpttSteps` is less than the
+  // number of time steps, so that some steps are outside of the BPTT window.
+  RNN<MeanSquaredError> model(3), stepModel(3);
+  model.Add<LSTM>(6);
+  model.Add<Linear>(2);
+
+  stepModel.Add<Identity>();
+  stepModel.Add<LSTM>(6);
+  stepModel.Add<Linear>(2);
+
+  model.ResetData(input, target);
+  model.Reset(3);
+  stepModel.ResetData(input, target);
+  stepModel.Reset(3);
+  REQUIRE(stepModel.Parameters().n_elem == model.Parameters().n_elem);
+  stepModel.Parameters() = model.Parameters();
+
+  // Check both the case where a batch holds all points (so that the inputs are
+  // contiguous) and the case where it does not.
+  arma::cube predictions, stepPredictions;
+  model.Predict(input, predictions, 8);
+  stepModel.Predict(input, stepPredictions, 8);
+  CheckMatrices(predictions, stepPredictions);
+
+  model.Predict(input, predictions, 3);
+  stepModel.Predict(input, stepPredictions, 3);
+  CheckMatrices(predictions, stepPredictions);
+
+  const double loss = model.Evaluate(model.Parameters(), 2, 4);
+  const double stepLoss = stepModel.Evaluate(stepModel.Parameters(), 2, 4);
+  REQUIRE(stepLoss == Approx(loss).epsilon(1e-10));
+
+  arma::mat gradient, stepGradient;
+  const double gradientLoss = model.EvaluateWithGradient(model.Parameters(), 3,
+      gradient, 5);
+  const double stepGradientLoss = stepModel.EvaluateWithGradient(
+      stepModel.Parameters(), 3, stepGradient, 5);
+  REQUIRE(stepGradientLoss == Approx(gradientLoss).epsilon(1e-10));
+  CheckMatrices(gradient, stepGradient);
+}
@@ -275,6 +275,122 @@ TEST_CASE("AllCategoricalSplitNoGainTest_", "[DecisionTreeRegressorTest]")
   REQUIRE(gain == weightedGain);
 }
 
+/**
+ * Check that BestBinaryCategoricalSplit finds the best partition of the
+ * categories, even when the categories of each side are not contiguous.
+ */
+TEST_CASE("BestBinaryCategoricalSplitSimpleSplitTest_",
+          "[DecisionTreeRegressorTest]")
+{
+  arma::rowvec predictor(100);
+  arma::rowvec responses(100);
+  arma::rowvec weights(responses.n_elem);
+  weights.ones();
+
+  for (size_t i = 0; i < 100; i += 4)
+  {
+    predictor[i] = 0;
+    responses[i] = 5.0;
+    predictor[i + 1] = 1;
+    responses[i + 1] = 100.0;
+    predictor[i + 2] = 2;
+    responses[i + 2] = 5.0;
+    predictor[i + 3] = 3;
+    responses[i + 3] = 100.0;
+  }
+
+  double splitInfo;
+  BestBinaryCategoricalSplit<MSEGain>::AuxiliarySplitInfo aux;
+
+  // Call the method to do the splitting.
+  MSEGain f;
+  const double bestGain = f.Evaluate<false>(responses, weights);
+  const double gain = BestBinaryCategoricalSplit<MSEGain>::SplitIfBetter<
+      false>(bestGain, predictor, 4, responses, weights, 3, 1e-7, splitInfo,
+      aux, f);
+  const double weightedGain =
+      BestBinaryCategoricalSplit<MSEGain>::SplitIfBetter<true>(bestGain,
+      predictor, 4, responses, weights, 3, 1e-7, splitInfo, aux, f);
+
+  // Make sure that a split was made, and that it is perfect.
+  REQUIRE(gain > bestGain);
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+  REQUIRE(weightedGain == Approx(gain).margin(1e-7));
+
+  // Categories 0 and 2 must go to one child, and 1 and 3 to the other.
+  const size_t d0 = BestBinaryCategoricalSplit<MSEGain>::CalculateDirection(
+      0.0, splitInfo, aux);
+  const size_t d1 = BestBinaryCategoricalSplit<MSEGain>::CalculateDirection(
+      1.0, splitInfo, aux);
+  REQUIRE(d0 != d1);
+  REQUIRE(BestBinaryCategoricalSplit<MSEGain>::CalculateDirection(2.0,
+      splitInfo, aux) == d0);
+  REQUIRE(BestBinaryCategoricalSplit<MSEGain>::CalculateDirection(3.0,
+      splitInfo, aux) == d1);
+
+  // The fitness function without an optimized binary scan must give the same
+  // partition.
+  MADGain g;
+  BestBinaryCategoricalSplit<MADGain>::AuxiliarySplitInfo madAux;
+  double madSplitInfo;
+  const double madBestGain = g.Evaluate<false>(responses, weights);
+  const double madGain = BestBinaryCategoricalSplit<MADGain>::SplitIfBetter<
+      false>(madBestGain, predictor, 4, responses, weights, 3, 1e-7,
+      madSplitInfo, madAux, g);
+  REQUIRE(madGain == Approx(0.0).margin(1e-7));
+  REQUIRE(madAux.categoryDirections == aux.categoryDirections);
+}
+
+/**
+ * Build regression trees with BestBinaryCategoricalSplit on a categorical
+ * feature with many categories, and make sure that they are accurate and that
+ * they survive serialization.
+ */
+TEST_CASE("BestBinaryCategoricalSplitHighCardinalityTest_",
+          "[DecisionTreeRegressorTest]")
+{
+  arma::mat d;
+  arma::rowvec r;
+  data::DatasetInfo di;
+  MockHighCardinalityData(d, r, di, 12000, 500);
+
+  // Split into a training set and a test set.
+  arma::mat trainingData = d.cols(0, 9999);
+  arma::mat testData = d.cols(10000, 11999);
+  arma::rowvec trainingResponses = r.subvec(0, 9999);
+  arma::rowvec testResponses = r.subvec(10000, 11999);
+
+  DecisionTreeRegressor<MSEGain, BestBinaryNumericSplit,
+      BestBinaryCategoricalSplit> tree(trainingData, di, trainingResponses, 5);
+  DecisionTreeRegressor<MADGain, BestBinaryNumericSplit,
+      BestBinaryCategoricalSplit> madTree(trainingData, di, trainingResponses,
+      5);
+
+  // The root must split the categorical feature into two children.
+  REQUIRE(tree.NumChildren() == 2);
+  REQUIRE(tree.SplitDimension() == 0);
+  REQUIRE(madTree.NumChildren() == 2);
+
+  arma::rowvec predictions, madPredictions;
+  tree.Predict(testData, predictions);
+  madTree.Predict(testData, madPredictions);
+  REQUIRE(RMSE(predictions, testResponses) < 1.0);
+  REQUIRE(RMSE(madPredictions, testResponses) < 1.0);
+
+  // Make sure that the split of every node is kept by serialization.
+  DecisionTreeRegressor<MSEGain, BestBinaryNumericSplit,
+      BestBinaryCategoricalSplit> xmlTree, jsonTree, binaryTree;
+  SerializeObjectAll(tree, xmlTree, jsonTree, binaryTree);
+
+  arma::rowvec xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlTree.Predict(testData, xmlPredictions);
+  jsonTree.Predict(testData, jsonPredictions);
+  binaryTree.Predict(testData, binaryPredictions);
+  CheckMatrices(predictions, xmlPredictions);
+  CheckMatrices(predictions, jsonPredictions);
+  CheckMatrices(predictions, binaryPredictions);
+}
+
 /**
  * Check that the BestBinaryNumericSplit will split on an obviously splittable
  * dimension.
@@ -374,6 +490,80 @@ TEST_CASE("BestBinaryNumericSplitNoGainTest_", "[DecisionTreeRegressorTest]")
   REQUIRE(gain == DBL_MAX);
 }
 
+/**
+ * Check that the BestBinaryNumericSplit learns which child points with a
+ * missing value go to, both with a fitness function that uses the binary scan
+ * (MSEGain) and with one that does not (MADGain).
+ */
+TEST_CASE("BestBinaryNumericSplitMissingValuesTest_",
+    "[DecisionTreeRegressorTest]")
+{
+  arma::rowvec predictors =
+      { 0.0, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0, 0.0, 0.0, 0.0 };
+  predictors.tail(3).fill(arma::datum::nan);
+  arma::rowvec responses =
+      { 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 0.0, 0.0, 0.0 };
+  arma::rowvec weights(responses.n_elem, arma::fill::ones);
+
+  for (size_t direction = 0; direction < 2; ++direction)
+  {
+    // The split is only perfect if the points with a missing value go to the
+    // child with the same response.
+    responses.tail(3).fill((double) direction);
+
+    double splitInfo, weightedSplitInfo;
+    BestBinaryNumericSplit<MSEGain>::AuxiliarySplitInfo mseAux, mseWeightedAux;
+    MSEGain mse;
+    const double mseBestGain = mse.Evaluate<false>(responses, weights);
+    const double mseGain =
+        BestBinaryNumericSplit<MSEGain>::SplitIfBetter<false>(mseBestGain,
+        predictors, responses, weights, 3, 1e-7, splitInfo, mseAux, mse);
+    const double mseWeightedGain =
+        BestBinaryNumericSplit<MSEGain>::SplitIfBetter<true>(mseBestGain,
+        predictors, responses, weights, 3, 1e-7, weightedSplitInfo,
+        mseWeightedAux, mse);
+
+    REQUIRE(mseGain == Approx(0.0).margin(1e-7));
+    REQUIRE(mseWeightedGain == Approx(0.0).margin(1e-7));
+    REQUIRE(splitInfo > 0.4);
+    REQUIRE(splitInfo < 0.5);
+    REQUIRE(weightedSplitInfo == splitInfo);
+    REQUIRE(mseAux.missingDirection == direction);
+    REQUIRE(mseWeightedAux.missingDirection == direction);
+    REQUIRE(BestBinaryNumericSplit<MSEGain>::CalculateDirection(
+        arma::datum::nan, splitInfo, mseAux) == direction);
+
+    BestBinaryNumericSplit<MADGain>::AuxiliarySplitInfo madAux, madWeightedAux;
+    MADGain mad;
+    const double madBestGain = mad.Evaluate<false>(responses, weights);
+    const double madGain =
+        BestBinaryNumericSplit<MADGain>::SplitIfBetter<false>(madBestGain,
+        predictors, responses, weights, 3, 1e-7, splitInfo, madAux, mad);
+    const double madWeightedGain =
+        BestBinaryNumericSplit<MADGain>::SplitIfBetter<true>(madBestGain,
+        predictors, responses, weights, 3, 1e-7, weightedSplitInfo,
+        madWeightedAux, mad);
+
+    REQUIRE(madGain == Approx(0.0).margin(1e-7));
+    REQUIRE(madWeightedGain == Approx(0.0).margin(1e-7));
+    REQUIRE(splitInfo > 0.4);
+    REQUIRE(splitInfo < 0.5);
+    REQUIRE(madAux.missingDirection == direction);
+    REQUIRE(madWeightedAux.missingDirection == direction);
+
+    // The histogram split should find the same split.
+    HistogramNumericSplit<MSEGain>::AuxiliarySplitInfo histogramAux;
+    const double histogramGain =
+        HistogramNumericSplit<MSEGain>::SplitIfBetter<false>(mseBestGain,
+        predictors, responses, weights, 3, 1e-7, splitInfo, histogramAux, mse);
+
+    REQUIRE(histogramGain == Approx(0.0).margin(1e-7));
+    REQUIRE(splitInfo > 0.4);
+    REQUIRE(splitInfo < 0.5);
+    REQUIRE(histogramAux.missingDirection == direction);
+  }
+}
+
 /**
  * Check that the RandomBinaryNumericSplit always splits when splitIfBetterGain
  * is false.
@@ -723,6 +913,88 @@ TEST_CASE("NumericalBuildTest", "[DecisionTreeRegressorTest]")
   REQUIRE(rmse < 1.0);
 }
 
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit for both kinds of fitness functions, when there are
+ * fewer distinct values than bins.
+ */
+TEST_CASE("HistogramNumericSplitSimpleSplitTest_",
+    "[DecisionTreeRegressorTest]")
+{
+  arma::rowvec predictors =
+      { 0.0, 0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0 };
+  arma::rowvec responses =
+      { 0.0, 0.1, 0.0, 0.1, 0.0, 1.0, 1.1, 1.0, 1.1, 1.0, 1.1 };
+  arma::rowvec weights(responses.n_elem);
+  weights.ones();
+
+  // MADGain uses the generic overload.
+  double splitInfo, bestSplitInfo;
+  HistogramNumericSplit<MADGain>::AuxiliarySplitInfo aux;
+  BestBinaryNumericSplit<MADGain>::AuxiliarySplitInfo bestAux;
+  MADGain f;
+  double bestGain = f.Evaluate<false>(responses, weights);
+  double gain = HistogramNumericSplit<MADGain>::SplitIfBetter<false>(
+      bestGain, predictors, responses, weights, 3, 1e-7, splitInfo, aux, f);
+  double weightedGain = HistogramNumericSplit<MADGain>::SplitIfBetter<true>(
+      bestGain, predictors, responses, weights, 3, 1e-7, splitInfo, aux, f);
+  double exhaustiveGain = BestBinaryNumericSplit<MADGain>::SplitIfBetter<false>(
+      bestGain, predictors, responses, weights, 3, 1e-7, bestSplitInfo,
+      bestAux, f);
+
+  REQUIRE(gain > bestGain);
+  REQUIRE(gain == Approx(weightedGain).epsilon(1e-7));
+  REQUIRE(gain == Approx(exhaustiveGain).epsilon(1e-7));
+  REQUIRE(splitInfo == Approx(bestSplitInfo).epsilon(1e-7));
+
+  // MSEGain uses the optimized overload.
+  HistogramNumericSplit<MSEGain>::AuxiliarySplitInfo mseAux;
+  BestBinaryNumericSplit<MSEGain>::AuxiliarySplitInfo mseBestAux;
+  MSEGain g;
+  bestGain = g.Evaluate<false>(responses, weights);
+  gain = HistogramNumericSplit<MSEGain>::SplitIfBetter<false>(
+      bestGain, predictors, responses, weights, 3, 1e-7, splitInfo, mseAux, g);
+  weightedGain = HistogramNumericSplit<MSEGain>::SplitIfBetter<true>(
+      bestGain, predictors, responses, weights, 3, 1e-7, splitInfo, mseAux, g);
+  exhaustiveGain = BestBinaryNumericSplit<MSEGain>::SplitIfBetter<false>(
+      bestGain, predictors, responses, weights, 3, 1e-7, bestSplitInfo,
+      mseBestAux, g);
+
+  REQUIRE(gain > bestGain);
+  REQUIRE(gain == Approx(weightedGain).epsilon(1e-7));
+  REQUIRE(gain == Approx(exhaustiveGain).epsilon(1e-7));
+  REQUIRE(splitInfo > 0.4);
+  REQUIRE(splitInfo < 0.5);
+}
+
+/**
+ * Test that a tree built with the HistogramNumericSplit performs decently.
+ */
+TEST_CASE("HistogramNumericalBuildTest", "[DecisionTreeRegressorTest]")
+{
+  arma::mat X;
+  arma::rowvec Y;
+
+  if (!data::Load("lars_dependent_x.csv", X))
+    FAIL("Cannot load dataset lars_dependent_x.csv");
+  if (!data::Load("lars_dependent_y.csv", Y))
+    FAIL("Cannot load dataset lars_dependent_y.csv");
+
+  arma::mat XTrain, XTest;
+  arma::rowvec YTrain, YTest;
+  data::Split(X, Y, XTrain, XTest, YTrain, YTest, 0.3);
+
+  DecisionTreeRegressor<MSEGain, HistogramNumericSplit> tree(XTrain, YTrain,
+      5);
+
+  arma::rowvec predictions;
+  tree.Predict(XTest, predictions);
+
+  // Ensuring a decent performance.
+  const double rmse = RMSE(predictions, YTest);
+  REQUIRE(rmse < 1.0);
+}
+
 /**
  * Test that the tree builds correctly on weighted numerical dataset.
  */
@@ -1089,3 +1361,89 @@ TEST_CASE("WeightedDecisionTreeMADGainTest", "[DecisionTreeRegressorTest]")
 
   REQUIRE(success == true);
 }
+
+/**
+ * Make sure that training a regression tree with many threads (where the split
+ * search and the children are handled by OpenMP tasks) gives the same tree as
+ * training with a single thread.
+ */
+TEST_CASE("DecisionTreeRegressorParallelTrainingTest",
+          "[DecisionTreeRegressorTest]")
+{
+  // The dataset must be large enough for the nodes near the root to be
+  // trained in parallel.
+  arma::mat dataset(8, 5000, arma::fill::randu);
+  arma::rowvec responses = 3.0 * dataset.row(1) - 2.0 * dataset.row(4) +
+      arma::square(dataset.row(6)) + 0.05 * arma::randn<arma::rowvec>(5000);
+
+  #ifdef MLPACK_USE_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  DecisionTreeRegressor<> serialTree(dataset, responses, 10);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  DecisionTreeRegressor<> tree(dataset, responses, 10);
+
+  REQUIRE(tree.NumChildren() == serialTree.NumChildren());
+  REQUIRE(tree.SplitDimension() == serialTree.SplitDimension());
+
+  arma::mat testData(8, 1000, arma::fill::randu);
+  arma::rowvec predictions, serialPredictions;
+  tree.Predict(testData, predictions);
+  serialTree.Predict(testData, serialPredictions);
+  CheckMatrices(predictions, serialPredictions);
+}
+
+/**
+ * Make sure that training on a subset of a dataset given by (repeated) indices
+ * gives the same tree as training on a copy of that subset, and does not modify
+ * the dataset.
+ */
+TEST_CASE("DecisionTreeRegressorIndicesTrainTest",
+          "[DecisionTreeRegressorTest]")
+{
+  arma::mat d;
+  arma::rowvec r;
+  data::DatasetInfo di;
+  MockCategoricalData(d, r, di);
+  arma::rowvec weights(d.n_cols, arma::fill::randu);
+
+  // Take a bootstrap sample of the first 2000 points.
+  const arma::uvec indices = arma::randi<arma::uvec>(2000,
+      arma::distr_param(0, 1999));
+  const arma::mat originalData(d);
+  const arma::mat testData = d.cols(2000, 3999);
+
+  arma::mat subsetData = d.cols(indices);
+  arma::rowvec subsetResponses = r.cols(indices);
+  arma::rowvec subsetWeights = weights.cols(indices);
+
+  // Numeric-only training.
+  DecisionTreeRegressor<> tree, subsetTree;
+  const double gain = tree.Train(d, indices, r, weights, 10);
+  const double subsetGain = subsetTree.Train(subsetData, subsetResponses,
+      subsetWeights, 10);
+  REQUIRE(gain == Approx(subsetGain).epsilon(1e-7));
+
+  arma::rowvec predictions, subsetPredictions;
+  tree.Predict(testData, predictions);
+  subsetTree.Predict(testData, subsetPredictions);
+  CheckMatrices(predictions, subsetPredictions);
+
+  // Weighted training on categorical data.
+  DecisionTreeRegressor<> weightedTree, weightedSubsetTree;
+  weightedTree.Train(d, di, indices, r, weights, 10);
+  weightedSubsetTree.Train(subsetData, di, subsetResponses, subsetWeights, 10);
+
+  weightedTree.Predict(testData, predictions);
+  weightedSubsetTree.Predict(testData, subsetPredictions);
+  CheckMatrices(predictions, subsetPredictions);
+
+  // The dataset must not have been modified.
+  CheckMatrices(d, originalData);
+}
@@ -468,6 +468,234 @@ TEST_CASE("RandomBinaryNumericSplitDiffSplitTest", "[DecisionTreeTest]")
   REQUIRE(classProbabilities[0] != classProbabilities1[0]);
 }
 
+/**
+ * Check that the BestBinaryNumericSplit skips missing values when searching for
+ * the split point, and learns which child they should go to.
+ */
+TEST_CASE("BestBinaryNumericSplitMissingValuesTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0 0.0 0.0 0.0");
+  values.tail(3).fill(arma::datum::nan);
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1 0 0 0");
+  arma::rowvec weights(labels.n_elem, arma::fill::ones);
+
+  // The points with a missing value all have class 0, so the split is only
+  // perfect if they go to the left child.
+  arma::vec classProbabilities;
+  BestBinaryNumericSplit<GiniGain>::AuxiliarySplitInfo aux, weightedAux;
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  const double weightedGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, weightedAux);
+
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+  REQUIRE(weightedGain == Approx(0.0).margin(1e-7));
+  REQUIRE(classProbabilities.n_elem == 1);
+  REQUIRE(classProbabilities[0] > 0.4);
+  REQUIRE(classProbabilities[0] < 0.5);
+  REQUIRE(aux.missingDirection == 0);
+  REQUIRE(weightedAux.missingDirection == 0);
+
+  REQUIRE(BestBinaryNumericSplit<GiniGain>::CalculateDirection(
+      arma::datum::nan, classProbabilities[0], aux) == 0);
+  REQUIRE(BestBinaryNumericSplit<GiniGain>::CalculateDirection(0.2,
+      classProbabilities[0], aux) == 0);
+  REQUIRE(BestBinaryNumericSplit<GiniGain>::CalculateDirection(0.8,
+      classProbabilities[0], aux) == 1);
+
+  // Now the points with a missing value belong to the right child.
+  labels.tail(3).fill(1);
+  const double rightGain =
+      BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  REQUIRE(rightGain == Approx(0.0).margin(1e-7));
+  REQUIRE(aux.missingDirection == 1);
+  REQUIRE(BestBinaryNumericSplit<GiniGain>::CalculateDirection(
+      arma::datum::nan, classProbabilities[0], aux) == 1);
+
+  // If only missing values are given, no split can be made.
+  arma::vec missingValues(labels.n_elem);
+  missingValues.fill(arma::datum::nan);
+  arma::vec noSplitProbabilities;
+  REQUIRE(BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      missingValues, labels, 2, weights, 3, 1e-7, noSplitProbabilities, aux) ==
+      DBL_MAX);
+  REQUIRE(noSplitProbabilities.n_elem == 0);
+}
+
+/**
+ * Check that the HistogramNumericSplit finds the same split as the
+ * BestBinaryNumericSplit when there are fewer distinct values than bins.
+ */
+TEST_CASE("HistogramNumericSplitSimpleSplitTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0");
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities, bestClassProbabilities;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo aux;
+  BestBinaryNumericSplit<GiniGain>::AuxiliarySplitInfo bestAux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  (void) BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 3, 1e-7, bestClassProbabilities, bestAux);
+
+  // Make sure that a split was made.
+  REQUIRE(gain > bestGain);
+  REQUIRE(gain == weightedGain);
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+
+  // The split point should be the same one the exhaustive search finds.
+  REQUIRE(classProbabilities.n_elem == 1);
+  REQUIRE(classProbabilities[0] ==
+      Approx(bestClassProbabilities[0]).epsilon(1e-7));
+
+  // Not enough points to split.
+  arma::vec noSplitProbabilities;
+  REQUIRE(HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 8, 1e-7, noSplitProbabilities, aux) ==
+      DBL_MAX);
+  REQUIRE(noSplitProbabilities.n_elem == 0);
+}
+
+/**
+ * Check that the HistogramNumericSplit leaves missing values out of the
+ * histogram, and learns which child they should go to.
+ */
+TEST_CASE("HistogramNumericSplitMissingValuesTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0.0 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 0.9 1.0 0.0 0.0 0.0");
+  values.tail(3).fill(arma::datum::nan);
+  arma::Row<size_t> labels("0 0 0 0 0 1 1 1 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem, arma::fill::ones);
+
+  arma::vec classProbabilities, weightedClassProbabilities;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo aux, weightedAux;
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  const double weightedGain =
+      HistogramNumericSplit<GiniGain>::SplitIfBetter<true>(bestGain, values,
+      labels, 2, weights, 3, 1e-7, weightedClassProbabilities, weightedAux);
+
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+  REQUIRE(weightedGain == Approx(0.0).margin(1e-7));
+  REQUIRE(classProbabilities.n_elem == 1);
+  REQUIRE(classProbabilities[0] > 0.4);
+  REQUIRE(classProbabilities[0] < 0.5);
+  REQUIRE(aux.missingDirection == 1);
+  REQUIRE(weightedAux.missingDirection == 1);
+  REQUIRE(HistogramNumericSplit<GiniGain>::CalculateDirection(
+      arma::datum::nan, classProbabilities[0], aux) == 1);
+
+  // Send the points with a missing value to the left.
+  labels.tail(3).fill(0);
+  REQUIRE(HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 3, 1e-7, classProbabilities, aux) ==
+      Approx(0.0).margin(1e-7));
+  REQUIRE(aux.missingDirection == 0);
+  REQUIRE(HistogramNumericSplit<GiniGain>::CalculateDirection(
+      arma::datum::nan, classProbabilities[0], aux) == 0);
+}
+
+/**
+ * Check that an outlier does not squeeze all other values of a dimension into
+ * one bin of the HistogramNumericSplit, so that the best split among them is
+ * still found.
+ */
+TEST_CASE("HistogramNumericSplitOutlierTest", "[DecisionTreeTest]")
+{
+  // There are more distinct values than bins, and with equal-width bins all
+  // values but the outlier would be in the first bin.  With 1024 points, each
+  // bin holds 4 points, so the best split (after the first 400 points) is at a
+  // bin boundary.
+  arma::vec values(1024);
+  arma::Row<size_t> labels(1024);
+  for (size_t i = 0; i < 1023; ++i)
+  {
+    values[i] = i / 1024.0;
+    labels[i] = (i < 400) ? 0 : 1;
+  }
+  values[1023] = 1e6;
+  labels[1023] = 1;
+  arma::rowvec weights(labels.n_elem, arma::fill::ones);
+
+  arma::vec classProbabilities, bestClassProbabilities;
+  HistogramNumericSplit<GiniGain>::AuxiliarySplitInfo aux;
+  BestBinaryNumericSplit<GiniGain>::AuxiliarySplitInfo bestAux;
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = HistogramNumericSplit<GiniGain>::SplitIfBetter<false>(
+      bestGain, values, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+  (void) BestBinaryNumericSplit<GiniGain>::SplitIfBetter<false>(bestGain,
+      values, labels, 2, weights, 3, 1e-7, bestClassProbabilities, bestAux);
+
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+  REQUIRE(classProbabilities.n_elem == 1);
+  REQUIRE(classProbabilities[0] ==
+      Approx(bestClassProbabilities[0]).epsilon(1e-7));
+}
+
+/**
+ * Make sure a decision tree built with the HistogramNumericSplit generalizes
+ * about as well as one built with the default split.
+ */
+TEST_CASE("HistogramNumericSplitGeneralizationTest", "[DecisionTreeTest]")
+{
+  arma::mat inputData;
+  if (!data::Load("vc2.csv", inputData))
+    FAIL("Cannot load test dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::rowvec weights(labels.n_cols, arma::fill::ones);
+
+  DecisionTree<GiniGain, HistogramNumericSplit> d(inputData, labels, 3, 10);
+  DecisionTree<GiniGain, HistogramNumericSplit> wd(inputData, labels, 3,
+      weights, 10);
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData))
+    FAIL("Cannot load test dataset vc2_test.csv!");
+
+  arma::Mat<size_t> trueTestLabels;
+  if (!data::Load("vc2_test_labels.txt", trueTestLabels))
+    FAIL("Cannot load labels for vc2_test_labels.txt");
+
+  arma::Row<size_t> predictions, weightedPredictions;
+  d.Classify(testData, predictions);
+  wd.Classify(testData, weightedPredictions);
+
+  REQUIRE(predictions.n_elem == testData.n_cols);
+  REQUIRE(weightedPredictions.n_elem == testData.n_cols);
+
+  double correct = 0.0, weightedCorrect = 0.0;
+  for (size_t i = 0; i < predictions.n_elem; ++i)
+  {
+    if (predictions[i] == trueTestLabels[i])
+      ++correct;
+    if (weightedPredictions[i] == trueTestLabels[i])
+      ++weightedCorrect;
+  }
+  correct /= predictions.n_elem;
+  weightedCorrect /= predictions.n_elem;
+
+  REQUIRE(correct > 0.75);
+  REQUIRE(weightedCorrect > 0.75);
+}
+
 /**
  * Check that the AllCategoricalSplit will split when the split is obviously
  * better.
@@ -566,6 +794,129 @@ TEST_CASE("AllCategoricalSplitNoGainTest", "[DecisionTreeTest]")
   REQUIRE(classProbabilities.n_elem == 0);
 }
 
+/**
+ * Check that BestBinaryCategoricalSplit finds the perfect partition of the
+ * categories, even when the categories of each class are not contiguous.
+ */
+TEST_CASE("BestBinaryCategoricalSplitSimpleSplitTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0 0 0 1 1 1 2 2 2 3 3 3 4 4 4");
+  arma::Row<size_t> labels("0 0 0 1 1 1 0 0 0 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  BestBinaryCategoricalSplit<GiniGain>::AuxiliarySplitInfo aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BestBinaryCategoricalSplit<GiniGain>::SplitIfBetter<
+      false>(bestGain, values, 6, labels, 2, weights, 3, 1e-7,
+      classProbabilities, aux);
+  const double weightedGain =
+      BestBinaryCategoricalSplit<GiniGain>::SplitIfBetter<true>(bestGain,
+      values, 6, labels, 2, weights, 3, 1e-7, classProbabilities, aux);
+
+  // Make sure that a split was made, and that it is perfect.
+  REQUIRE(gain > bestGain);
+  REQUIRE(gain == Approx(0.0).margin(1e-7));
+  REQUIRE(weightedGain == Approx(gain).margin(1e-7));
+
+  // There are always two children.
+  REQUIRE(BestBinaryCategoricalSplit<GiniGain>::NumChildren(
+      classProbabilities[0], aux) == 2);
+
+  // Categories 0 and 2 must go to one child, and 1, 3 and 4 to the other.
+  // Category 5 holds no points, so it goes to the heavier child.
+  size_t directions[6];
+  for (size_t c = 0; c < 6; ++c)
+  {
+    directions[c] = BestBinaryCategoricalSplit<GiniGain>::CalculateDirection(
+        (double) c, classProbabilities[0], aux);
+  }
+  REQUIRE(directions[0] == directions[2]);
+  REQUIRE(directions[1] == directions[3]);
+  REQUIRE(directions[1] == directions[4]);
+  REQUIRE(directions[0] != directions[1]);
+  REQUIRE(directions[5] == directions[1]);
+
+  // A category that was unknown when splitting also goes to the heavier child.
+  REQUIRE(BestBinaryCategoricalSplit<GiniGain>::CalculateDirection(10.0,
+      classProbabilities[0], aux) == directions[1]);
+}
+
+/**
+ * Make sure that BestBinaryCategoricalSplit respects the minimum number of
+ * samples required to split.
+ */
+TEST_CASE("BestBinaryCategoricalSplitMinSamplesTest", "[DecisionTreeTest]")
+{
+  arma::vec values("0 0 0 1 1 1 1 1 1 1");
+  arma::Row<size_t> labels("0 0 0 1 1 1 1 1 1 1");
+  arma::rowvec weights(labels.n_elem);
+  weights.ones();
+
+  arma::vec classProbabilities;
+  BestBinaryCategoricalSplit<GiniGain>::AuxiliarySplitInfo aux;
+
+  // Call the method to do the splitting.
+  const double bestGain = GiniGain::Evaluate<false>(labels, 2, weights);
+  const double gain = BestBinaryCategoricalSplit<GiniGain>::SplitIfBetter<
+      false>(bestGain, values, 2, labels, 2, weights, 4, 1e-7,
+      classProbabilities, aux);
+
+  // Make sure it's not split.
+  REQUIRE(gain == DBL_MAX);
+  REQUIRE(classProbabilities.n_elem == 0);
+  REQUIRE(aux.categoryDirections.size() == 0);
+}
+
+/**
+ * Build a decision tree with BestBinaryCategoricalSplit on a categorical
+ * feature with many categories, and make sure that it is accurate and that it
+ * survives serialization.
+ */
+TEST_CASE("BestBinaryCategoricalSplitHighCardinalityTest",
+          "[DecisionTreeTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockHighCardinalityData(d, l, di, 12000, 500, 3);
+
+  // Split into a training set and a test set.
+  arma::mat trainingData = d.cols(0, 9999);
+  arma::mat testData = d.cols(10000, 11999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 9999);
+  arma::Row<size_t> testLabels = l.subvec(10000, 11999);
+
+  DecisionTree<GiniGain, BestBinaryNumericSplit, BestBinaryCategoricalSplit>
+      tree(trainingData, di, trainingLabels, 3, 10);
+
+  // The root must split the categorical feature into two children.
+  REQUIRE(tree.NumChildren() == 2);
+  REQUIRE(tree.SplitDimension() == 0);
+
+  arma::Row<size_t> predictions;
+  tree.Classify(testData, predictions);
+  const double correctPct = double(arma::accu(predictions == testLabels)) /
+      double(testData.n_cols);
+  REQUIRE(correctPct > 0.85);
+
+  // Make sure that the split of every node is kept by serialization.
+  DecisionTree<GiniGain, BestBinaryNumericSplit, BestBinaryCategoricalSplit>
+      xmlTree, jsonTree, binaryTree;
+  SerializeObjectAll(tree, xmlTree, jsonTree, binaryTree);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlTree.Classify(testData, xmlPredictions);
+  jsonTree.Classify(testData, jsonPredictions);
+  binaryTree.Classify(testData, binaryPredictions);
+  CheckMatrices(predictions, xmlPredictions);
+  CheckMatrices(predictions, jsonPredictions);
+  CheckMatrices(predictions, binaryPredictions);
+}
+
 /**
  * A basic construction of the decision tree---ensure that we can create the
  * tree and that it split at least once.
@@ -1393,3 +1744,161 @@ TEST_CASE("DifferentMaximumDepthTest", "[DecisionTreeTest]")
   REQUIRE(d2.Child(0).NumChildren() == 2);
   REQUIRE(d2.Child(1).NumChildren() == 2);
 }
+
+/**
+ * Make sure that training a tree with many threads (where the split search and
+ * the children are handled by OpenMP tasks) gives the same tree as training
+ * with a single thread.
+ */
+TEST_CASE("DecisionTreeParallelTrainingTest", "[DecisionTreeTest]")
+{
+  // The dataset must be large enough for the nodes near the root to be
+  // trained in parallel.
+  arma::mat dataset(8, 5000, arma::fill::randu);
+  arma::Row<size_t> labels(dataset.n_cols);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+  {
+    labels[i] = (dataset(1, i) + dataset(4, i) > 1.0) ? 1 :
+        ((dataset(6, i) > 0.3) ? 2 : 0);
+  }
+  arma::rowvec weights(dataset.n_cols, arma::fill::randu);
+
+  #ifdef MLPACK_USE_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  DecisionTree<> serialTree(dataset, labels, 3, 10);
+  DecisionTree<> serialWeightedTree(dataset, labels, 3, weights, 10);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  DecisionTree<> tree(dataset, labels, 3, 10);
+  DecisionTree<> weightedTree(dataset, labels, 3, weights, 10);
+
+  REQUIRE(tree.NumChildren() == serialTree.NumChildren());
+  REQUIRE(tree.SplitDimension() == serialTree.SplitDimension());
+  REQUIRE(weightedTree.NumChildren() == serialWeightedTree.NumChildren());
+  REQUIRE(weightedTree.SplitDimension() ==
+      serialWeightedTree.SplitDimension());
+
+  arma::mat testData(8, 1000, arma::fill::randu);
+  arma::Row<size_t> predictions, serialPredictions;
+  arma::mat probabilities, serialProbabilities;
+  tree.Classify(testData, predictions, probabilities);
+  serialTree.Classify(testData, serialPredictions, serialProbabilities);
+  CheckMatrices(predictions, serialPredictions);
+  CheckMatrices(probabilities, serialProbabilities);
+
+  weightedTree.Classify(testData, predictions, probabilities);
+  serialWeightedTree.Classify(testData, serialPredictions,
+      serialProbabilities);
+  CheckMatrices(predictions, serialPredictions);
+  CheckMatrices(probabilities, serialProbabilities);
+}
+
+/**
+ * Make sure that training on a subset of a dataset given by (repeated) indices
+ * gives the same tree as training on a copy of that subset, and does not modify
+ * the dataset.
+ */
+TEST_CASE("DecisionTreeIndicesTrainTest", "[DecisionTreeTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+  arma::rowvec weights(d.n_cols, arma::fill::randu);
+
+  // Take a bootstrap sample of the first 2000 points.
+  const arma::uvec indices = arma::randi<arma::uvec>(2000,
+      arma::distr_param(0, 1999));
+  const arma::mat originalData(d);
+  const arma::mat testData = d.cols(2000, 3999);
+
+  arma::mat subsetData = d.cols(indices);
+  arma::Row<size_t> subsetLabels = l.cols(indices);
+  arma::rowvec subsetWeights = weights.cols(indices);
+
+  // Numeric-only training.
+  DecisionTree<> tree, subsetTree;
+  const double gain = tree.Train(d, indices, l, 5, 10);
+  const double subsetGain = subsetTree.Train(subsetData, subsetLabels, 5, 10);
+  REQUIRE(gain == Approx(subsetGain).epsilon(1e-7));
+
+  arma::Row<size_t> predictions, subsetPredictions;
+  arma::mat probabilities, subsetProbabilities;
+  tree.Classify(testData, predictions, probabilities);
+  subsetTree.Classify(testData, subsetPredictions, subsetProbabilities);
+  CheckMatrices(predictions, subsetPredictions);
+  CheckMatrices(probabilities, subsetProbabilities);
+
+  // Weighted training on categorical data.
+  DecisionTree<> weightedTree, weightedSubsetTree;
+  weightedTree.Train(d, di, indices, l, 5, weights, 10);
+  weightedSubsetTree.Train(subsetData, di, subsetLabels, 5, subsetWeights, 10);
+
+  weightedTree.Classify(testData, predictions, probabilities);
+  weightedSubsetTree.Classify(testData, subsetPredictions,
+      subsetProbabilities);
+  CheckMatrices(predictions, subsetPredictions);
+  CheckMatrices(probabilities, subsetProbabilities);
+
+  // The dataset must not have been modified.
+  CheckMatrices(d, originalData);
+
+  // Out-of-bounds indices must be rejected.
+  arma::uvec badIndices = indices;
+  badIndices[0] = d.n_cols;
+  REQUIRE_THROWS_AS(tree.Train(d, badIndices, l, 5), std::invalid_argument);
+}
+
+/**
+ * Make sure that a decision tree can be trained on data with missing values
+ * without imputing them first, and that points with a missing value are
+ * classified the same way after serialization.
+ */
+TEST_CASE("DecisionTreeMissingValuesTest", "[DecisionTreeTest]")
+{
+  // The class only depends on the first dimension; some of the points of
+  // class 1 have a missing value in that dimension.
+  arma::mat data(2, 1000, arma::fill::randu);
+  arma::Row<size_t> labels(data.n_cols);
+  for (size_t i = 0; i < data.n_cols; ++i)
+  {
+    labels[i] = (data(0, i) < 0.5) ? 0 : 1;
+    if (labels[i] == 1 && i % 5 == 0)
+      data(0, i) = arma::datum::nan;
+  }
+
+  DecisionTree<> tree(data, labels, 2, 10);
+  DecisionTree<GiniGain, HistogramNumericSplit> histogramTree(data, labels, 2,
+      10);
+
+  // The missing values should follow the points of class 1.  The histogram
+  // may put a few points close to 0.5 in the wrong child.
+  arma::Row<size_t> predictions, histogramPredictions;
+  tree.Classify(data, predictions);
+  histogramTree.Classify(data, histogramPredictions);
+  CheckMatrices(predictions, labels);
+  REQUIRE(arma::accu(histogramPredictions == labels) > 0.98 * labels.n_elem);
+
+  arma::mat testData(2, 100, arma::fill::randu);
+  testData.row(0).fill(arma::datum::nan);
+  arma::Row<size_t> testPredictions;
+  tree.Classify(testData, testPredictions);
+  REQUIRE(arma::all(testPredictions == 1));
+
+  DecisionTree<> xmlTree, jsonTree, binaryTree;
+  SerializeObjectAll(tree, xmlTree, jsonTree, binaryTree);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlTree.Classify(testData, xmlPredictions);
+  jsonTree.Classify(testData, jsonPredictions);
+  binaryTree.Classify(testData, binaryPredictions);
+  CheckMatrices(testPredictions, xmlPredictions);
+  CheckMatrices(testPredictions, jsonPredictions);
+  CheckMatrices(testPredictions, binaryPredictions);
+}
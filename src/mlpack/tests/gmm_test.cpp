@@ -1230,3 +1230,111 @@ TEST_CASE("DiagonalGMMLoadSaveTest", "[GMMTest]")
     }
   }
 }
+
+/**
+ * Make sure that online EM can recover a single Gaussian when it only sees
+ * small batches of the data at a time.
+ */
+TEST_CASE("GMMTrainOnlineEMOneGaussian", "[GMMTest]")
+{
+  arma::vec mean("1.0 -2.0");
+  arma::mat data(2, 5000, arma::fill::randn);
+  data.row(0) *= 0.5;
+  data.row(1) *= 2.0;
+  data.each_col() += mean;
+
+  GMM gmm(1, 2);
+  OnlineEMFit<> fitter(20, 1e-10, 250);
+  gmm.Train(data, 1, false, fitter);
+
+  arma::vec actualMean = arma::mean(data, 1);
+  arma::mat actualCovar = ColumnCovariance(data, 1 /* biased estimator */);
+
+  REQUIRE(arma::norm(gmm.Component(0).Mean() - actualMean) < 0.1);
+  REQUIRE(arma::norm(gmm.Component(0).Covariance() - actualCovar) < 0.3);
+  REQUIRE(gmm.Weights()[0] == Approx(1.0).epsilon(1e-7));
+}
+
+/**
+ * Make sure that the DiagonalConstraint is respected by online EM.
+ */
+TEST_CASE("GMMTrainOnlineEMDiagonalConstraint", "[GMMTest]")
+{
+  arma::mat data(3, 3000, arma::fill::randn);
+  data.row(1) *= 3.0;
+  data.row(2) += 5.0;
+
+  GMM gmm(1, 3);
+  OnlineEMFit<KMeans<>, DiagonalConstraint> fitter(10, 1e-10, 200);
+  gmm.Train(data, 1, false, fitter);
+
+  const arma::mat& covariance = gmm.Component(0).Covariance();
+  for (size_t i = 0; i < covariance.n_rows; ++i)
+    for (size_t j = 0; j < covariance.n_cols; ++j)
+      if (i != j)
+        REQUIRE(covariance(i, j) == 0.0);
+
+  arma::vec actualCovar = arma::diagvec(ColumnCovariance(data, 1));
+  REQUIRE(arma::norm(covariance.diag() - actualCovar) < 0.5);
+}
+
+/**
+ * Train a GMM on a stream of batches with GMM::Update() and make sure that the
+ * two well-separated components are recovered.
+ */
+TEST_CASE("GMMUpdateOnlineEMStreamTest", "[GMMTest]")
+{
+  GaussianDistribution d1("0.0 0.0", "1.0 0.0; 0.0 1.0");
+  GaussianDistribution d2("20.0 20.0", "2.0 0.5; 0.5 1.0");
+
+  GMM gmm(2, 2);
+  OnlineEMFit<> fitter;
+  for (size_t batch = 0; batch < 40; ++batch)
+  {
+    // Each batch has 30% of points from d1 and 70% from d2.
+    arma::mat observations(2, 500);
+    for (size_t i = 0; i < 500; ++i)
+      observations.col(i) = (i < 150) ? d1.Random() : d2.Random();
+
+    const double logLikelihood = gmm.Update(observations, fitter);
+    REQUIRE(std::isfinite(logLikelihood));
+  }
+
+  REQUIRE(fitter.Steps() == 40);
+
+  arma::uvec order = arma::sort_index(gmm.Weights());
+  REQUIRE(gmm.Weights()[order[0]] == Approx(0.3).epsilon(0.05));
+  REQUIRE(gmm.Weights()[order[1]] == Approx(0.7).epsilon(0.05));
+  REQUIRE(arma::norm(gmm.Component(order[0]).Mean() - d1.Mean()) < 0.2);
+  REQUIRE(arma::norm(gmm.Component(order[1]).Mean() - d2.Mean()) < 0.2);
+  REQUIRE(arma::norm(gmm.Component(order[1]).Covariance() -
+      d2.Covariance()) < 0.5);
+}
+
+/**
+ * Make sure that streaming updates also work for DiagonalGMM, starting from an
+ * existing model.
+ */
+TEST_CASE("DiagonalGMMUpdateOnlineEMTest", "[GMMTest]")
+{
+  DiagonalGaussianDistribution d("1.0 -1.0 3.0", "1.0 2.0 0.5");
+
+  DiagonalGMM gmm(1, 3);
+  gmm.Component(0) = DiagonalGaussianDistribution("0.0 0.0 0.0",
+      "1.0 1.0 1.0");
+  gmm.Weights() = "1.0";
+
+  OnlineEMFit<KMeans<>, DiagonalConstraint, DiagonalGaussianDistribution>
+      fitter;
+  for (size_t batch = 0; batch < 50; ++batch)
+  {
+    arma::mat observations(3, 400);
+    for (size_t i = 0; i < 400; ++i)
+      observations.col(i) = d.Random();
+
+    gmm.Update(observations, fitter, true);
+  }
+
+  REQUIRE(arma::norm(gmm.Component(0).Mean() - d.Mean()) < 0.1);
+  REQUIRE(arma::norm(gmm.Component(0).Covariance() - d.Covariance()) < 0.2);
+}
@@ -1506,6 +1506,278 @@ TEST_CASE("HMMTrainReturnLogLikelihood", "[HMMTest]")
   REQUIRE(std::isfinite(loglik) == true);
 }
 
+/**
+ * Train on many short sequences of different lengths, and make sure that the
+ * log-likelihood returned by HMM::Train() (which is combined across threads
+ * when OpenMP is enabled) matches the sum of the per-sequence log-likelihoods.
+ */
+TEST_CASE("HMMTrainManySequencesLogLikelihood", "[HMMTest]")
+{
+  HMM<DiscreteDistribution> hmm(2, DiscreteDistribution(3));
+  hmm.Transition() = arma::mat("0.7 0.4; 0.3 0.6");
+  hmm.Emission()[0].Probabilities() = "0.6 0.3 0.1";
+  hmm.Emission()[1].Probabilities() = "0.1 0.3 0.6";
+
+  HMM<DiscreteDistribution> trueHMM(hmm);
+  std::vector<arma::mat> observations(500);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    trueHMM.Generate(5 + (i % 20), observations[i], states);
+  }
+
+  const double loglik = hmm.Train(observations);
+
+  double expectedLoglik = 0.0;
+  for (size_t i = 0; i < observations.size(); ++i)
+    expectedLoglik += hmm.LogLikelihood(observations[i]);
+
+  REQUIRE(loglik == Approx(expectedLoglik).epsilon(1e-5));
+}
+
+/**
+ * Make sure that Baum-Welch training with several threads gives the same model
+ * as training with one thread.
+ */
+TEST_CASE("HMMTrainParallelMatchesSerial", "[HMMTest]")
+{
+  HMM<DiscreteDistribution> trueHMM(2, DiscreteDistribution(3));
+  trueHMM.Transition() = arma::mat("0.7 0.4; 0.3 0.6");
+  trueHMM.Emission()[0].Probabilities() = "0.6 0.3 0.1";
+  trueHMM.Emission()[1].Probabilities() = "0.1 0.3 0.6";
+
+  HMM<GaussianDistribution> trueGaussianHMM(2, GaussianDistribution(2));
+  trueGaussianHMM.Transition() = arma::mat("0.8 0.3; 0.2 0.7");
+  trueGaussianHMM.Emission()[0] = GaussianDistribution("0.0 0.0",
+      "1.0 0.2; 0.2 1.0");
+  trueGaussianHMM.Emission()[1] = GaussianDistribution("3.0 -2.0",
+      "0.8 0.0; 0.0 1.5");
+
+  std::vector<arma::mat> observations(300), gaussianObservations(300);
+  for (size_t i = 0; i < observations.size(); ++i)
+  {
+    arma::Row<size_t> states;
+    trueHMM.Generate(5 + (i % 20), observations[i], states);
+    trueGaussianHMM.Generate(5 + (i % 15), gaussianObservations[i], states);
+  }
+
+  // Start both trainings from the same (perturbed) models.
+  HMM<DiscreteDistribution> serialHMM(2, DiscreteDistribution(3));
+  serialHMM.Transition() = arma::mat("0.6 0.5; 0.4 0.5");
+  serialHMM.Emission()[0].Probabilities() = "0.5 0.3 0.2";
+  serialHMM.Emission()[1].Probabilities() = "0.2 0.3 0.5";
+  HMM<DiscreteDistribution> parallelHMM(serialHMM);
+
+  HMM<GaussianDistribution> serialGaussianHMM(2, GaussianDistribution(2));
+  serialGaussianHMM.Transition() = arma::mat("0.6 0.5; 0.4 0.5");
+  serialGaussianHMM.Emission()[0] = GaussianDistribution("0.5 0.5",
+      "1.0 0.0; 0.0 1.0");
+  serialGaussianHMM.Emission()[1] = GaussianDistribution("2.0 -1.0",
+      "1.0 0.0; 0.0 1.0");
+  HMM<GaussianDistribution> parallelGaussianHMM(serialGaussianHMM);
+
+  #ifdef MLPACK_USE_OPENMP
+  const int numThreads = omp_get_max_threads();
+  omp_set_num_threads(1);
+  #endif
+
+  const double serialLoglik = serialHMM.Train(observations);
+  const double serialGaussianLoglik =
+      serialGaussianHMM.Train(gaussianObservations);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(std::max(numThreads, 4));
+  #endif
+
+  const double parallelLoglik = parallelHMM.Train(observations);
+  const double parallelGaussianLoglik =
+      parallelGaussianHMM.Train(gaussianObservations);
+
+  #ifdef MLPACK_USE_OPENMP
+  omp_set_num_threads(numThreads);
+  #endif
+
+  REQUIRE(parallelLoglik == Approx(serialLoglik).epsilon(1e-8));
+  REQUIRE(parallelGaussianLoglik ==
+      Approx(serialGaussianLoglik).epsilon(1e-8));
+
+  CheckMatrices(parallelHMM.Initial(), serialHMM.Initial(), 1e-6);
+  CheckMatrices(parallelHMM.Transition(), serialHMM.Transition(), 1e-6);
+  for (size_t j = 0; j < 2; ++j)
+  {
+    CheckMatrices(parallelHMM.Emission()[j].Probabilities(),
+        serialHMM.Emission()[j].Probabilities(), 1e-6);
+  }
+
+  CheckMatrices(parallelGaussianHMM.Initial(), serialGaussianHMM.Initial(),
+      1e-6);
+  CheckMatrices(parallelGaussianHMM.Transition(),
+      serialGaussianHMM.Transition(), 1e-6);
+  for (size_t j = 0; j < 2; ++j)
+  {
+    CheckMatrices(parallelGaussianHMM.Emission()[j].Mean(),
+        serialGaussianHMM.Emission()[j].Mean(), 1e-6);
+    CheckMatrices(parallelGaussianHMM.Emission()[j].Covariance(),
+        serialGaussianHMM.Emission()[j].Covariance(), 1e-6);
+  }
+}
+
+/**
+ * Compare the forward log-likelihood and Viterbi path with a brute-force
+ * enumeration of every state sequence for a small model.
+ */
+TEST_CASE("HMMBruteForceLogLikelihoodViterbiTest", "[HMMTest]")
+{
+  const size_t states = 3;
+  HMM<DiscreteDistribution> hmm(states, DiscreteDistribution(2));
+  hmm.Initial() = "0.5 0.3 0.2";
+  hmm.Transition() = arma::mat("0.6 0.2 0.1; 0.3 0.5 0.3; 0.1 0.3 0.6");
+  hmm.Emission()[0].Probabilities() = "0.9 0.1";
+  hmm.Emission()[1].Probabilities() = "0.5 0.5";
+  hmm.Emission()[2].Probabilities() = "0.05 0.95";
+
+  arma::mat obs("0 1 1 0 1");
+
+  // Enumerate all state sequences.
+  double likelihood = 0.0;
+  double bestPath = 0.0;
+  arma::Row<size_t> bestStates(obs.n_cols);
+  arma::Row<size_t> path(obs.n_cols, arma::fill::zeros);
+  const size_t numPaths = (size_t) std::pow(states, obs.n_cols);
+  for (size_t p = 0; p < numPaths; ++p)
+  {
+    size_t code = p;
+    for (size_t t = 0; t < obs.n_cols; ++t)
+    {
+      path[t] = code % states;
+      code /= states;
+    }
+
+    double pathProb = hmm.Initial()[path[0]] *
+        hmm.Emission()[path[0]].Probability(obs.col(0));
+    for (size_t t = 1; t < obs.n_cols; ++t)
+    {
+      pathProb *= hmm.Transition()(path[t], path[t - 1]) *
+          hmm.Emission()[path[t]].Probability(obs.col(t));
+    }
+
+    likelihood += pathProb;
+    if (pathProb > bestPath)
+    {
+      bestPath = pathProb;
+      bestStates = path;
+    }
+  }
+
+  REQUIRE(hmm.LogLikelihood(obs) ==
+      Approx(std::log(likelihood)).epsilon(1e-7));
+
+  arma::Row<size_t> predicted;
+  const double logBest = hmm.Predict(obs, predicted);
+  REQUIRE(logBest == Approx(std::log(bestPath)).epsilon(1e-7));
+  for (size_t t = 0; t < obs.n_cols; ++t)
+    REQUIRE(predicted[t] == bestStates[t]);
+}
+
+/**
+ * Make sure that OnlineViterbi gives exactly the same state sequence as
+ * HMM::Predict() on a long sequence, no matter how the sequence is split into
+ * blocks.
+ */
+TEST_CASE("OnlineViterbiDiscreteTest", "[HMMTest]")
+{
+  HMM<DiscreteDistribution> hmm(3, DiscreteDistribution(3));
+  hmm.Initial() = "0.6 0.3 0.1";
+  hmm.Transition() = arma::mat("0.8 0.1 0.2; 0.1 0.7 0.2; 0.1 0.2 0.6");
+  hmm.Emission()[0].Probabilities() = "0.7 0.2 0.1";
+  hmm.Emission()[1].Probabilities() = "0.2 0.6 0.2";
+  hmm.Emission()[2].Probabilities() = "0.1 0.3 0.6";
+
+  arma::mat obs;
+  arma::Row<size_t> trueStates;
+  hmm.Generate(5000, obs, trueStates);
+
+  arma::Row<size_t> expected;
+  const double expectedLogLik = hmm.Predict(obs, expected);
+
+  // Feed blocks of varying size.
+  OnlineViterbi<HMM<DiscreteDistribution>> viterbi(hmm);
+  arma::Row<size_t> decoded, states;
+  size_t begin = 0, blockSize = 1;
+  while (begin < obs.n_cols)
+  {
+    const size_t end = std::min(begin + blockSize, (size_t) obs.n_cols);
+    viterbi.Update(arma::mat(obs.cols(begin, end - 1)), states);
+    decoded = arma::join_rows(decoded, states);
+    begin = end;
+    blockSize = (blockSize % 97) + 13;
+  }
+
+  // Without a delay limit, some states must have been decided early.
+  REQUIRE(viterbi.Decided() > 0);
+  REQUIRE(viterbi.Decided() + viterbi.Pending() == obs.n_cols);
+
+  const double logLik = viterbi.Finish(states);
+  decoded = arma::join_rows(decoded, states);
+
+  REQUIRE(viterbi.Time() == 0);
+  REQUIRE(logLik == Approx(expectedLogLik).epsilon(1e-7));
+  REQUIRE(decoded.n_elem == expected.n_elem);
+  for (size_t t = 0; t < expected.n_elem; ++t)
+    REQUIRE(decoded[t] == expected[t]);
+}
+
+/**
+ * Make sure that OnlineViterbi matches HMM::Predict() for Gaussian emissions
+ * when observations are given one at a time, and that the delay limit is
+ * respected.
+ */
+TEST_CASE("OnlineViterbiGaussianMaxDelayTest", "[HMMTest]")
+{
+  std::vector<GaussianDistribution> emission;
+  emission.push_back(GaussianDistribution("0.0 0.0", "1.0 0.0; 0.0 1.0"));
+  emission.push_back(GaussianDistribution("1.5 1.0", "1.0 0.3; 0.3 1.0"));
+  emission.push_back(GaussianDistribution("3.0 0.5", "0.5 0.0; 0.0 2.0"));
+
+  arma::mat transition("0.7 0.2 0.2; 0.2 0.6 0.2; 0.1 0.2 0.6");
+  HMM<GaussianDistribution> hmm(arma::vec("0.4 0.3 0.3"), transition,
+      emission);
+
+  arma::mat obs;
+  arma::Row<size_t> trueStates;
+  hmm.Generate(2000, obs, trueStates);
+
+  arma::Row<size_t> expected;
+  hmm.Predict(obs, expected);
+
+  OnlineViterbi<HMM<GaussianDistribution>> viterbi(hmm);
+  OnlineViterbi<HMM<GaussianDistribution>> bounded(hmm, 5);
+  arma::Row<size_t> decoded, boundedDecoded, states;
+  for (size_t t = 0; t < obs.n_cols; ++t)
+  {
+    viterbi.Update(arma::vec(obs.col(t)), states);
+    decoded = arma::join_rows(decoded, states);
+
+    bounded.Update(arma::vec(obs.col(t)), states);
+    boundedDecoded = arma::join_rows(boundedDecoded, states);
+    REQUIRE(bounded.Pending() <= 5);
+  }
+
+  viterbi.Finish(states);
+  decoded = arma::join_rows(decoded, states);
+  bounded.Finish(states);
+  boundedDecoded = arma::join_rows(boundedDecoded, states);
+
+  REQUIRE(decoded.n_elem == expected.n_elem);
+  for (size_t t = 0; t < expected.n_elem; ++t)
+    REQUIRE(decoded[t] == expected[t]);
+
+  // The bounded decoder is approximate, but it should still mostly agree.
+  REQUIRE(boundedDecoded.n_elem == expected.n_elem);
+  const size_t agree = arma::accu(boundedDecoded == expected);
+  REQUIRE(agree > 0.9 * expected.n_elem);
+}
+
 /********************************************/
 /** DiagonalGMM Hidden Markov Models Tests **/
 /********************************************/
@@ -1835,3 +1835,163 @@ TEST_CASE("HoeffdingTreeCategoricalFloatDataTest", "[HoeffdingTreeTest]")
   REQUIRE(arma::accu(batchPredictions == labels) > (labels.n_elem / 2));
   REQUIRE(arma::accu(streamPredictions == labels) > (labels.n_elem / 2));
 }
+
+/**
+ * Make sure that building a HoeffdingTreeModel from a file read in chunks gives
+ * the same model as building it in streaming mode from the whole dataset, and
+ * that the checkpoint holds the trained model.
+ */
+TEST_CASE("HoeffdingTreeModelChunkedTrainTest", "[HoeffdingTreeTest]")
+{
+  // Generate data where the label depends on the first dimension.
+  arma::mat dataset(4, 3000, arma::fill::randu);
+  arma::Row<size_t> labels(3000);
+  for (size_t i = 0; i < 3000; ++i)
+    labels[i] = (dataset(0, i) > 0.5) ? 1 : 0;
+
+  // A binary file is used so that the values in the file are exact.
+  arma::mat fileData = arma::join_cols(dataset,
+      ConvTo<arma::rowvec>::From(labels));
+  REQUIRE(data::Save("hoeffding_chunked.bin", fileData));
+
+  data::DatasetInfo info(4);
+  HoeffdingTreeModel model(HoeffdingTreeModel::GINI_BINARY);
+  model.BuildModel(dataset, info, labels, 2, false, 0.95, 5000, 100, 100, 10,
+      100);
+
+  data::ChunkedReader reader("hoeffding_chunked.bin", 128);
+  data::DatasetInfo chunkedInfo;
+  HoeffdingTreeModel chunkedModel(HoeffdingTreeModel::GINI_BINARY);
+  REQUIRE(chunkedModel.BuildModel(reader, chunkedInfo, 2, 0.95, 5000, 100,
+      100, 10, 100, 1000, "hoeffding_checkpoint.bin") == 3000);
+
+  REQUIRE(chunkedInfo.Dimensionality() == 4);
+  REQUIRE(model.NumNodes() > 1);
+  REQUIRE(chunkedModel.NumNodes() == model.NumNodes());
+
+  arma::Row<size_t> predictions, chunkedPredictions, checkpointPredictions;
+  model.Classify(dataset, predictions);
+  chunkedModel.Classify(dataset, chunkedPredictions);
+  CheckMatrices(predictions, chunkedPredictions);
+
+  HoeffdingTreeModel checkpoint;
+  REQUIRE(data::Load("hoeffding_checkpoint.bin", "model", checkpoint));
+  checkpoint.Classify(dataset, checkpointPredictions);
+  CheckMatrices(predictions, checkpointPredictions);
+
+  // A second pass over the file continues to train the model.
+  reader.Reset();
+  REQUIRE(chunkedModel.Train(reader) == 3000);
+  model.Train(dataset, labels, false);
+  REQUIRE(chunkedModel.NumNodes() == model.NumNodes());
+
+  remove("hoeffding_chunked.bin");
+  remove("hoeffding_checkpoint.bin");
+}
+
+/**
+ * Make sure that streaming training on a matrix, which updates the split
+ * statistics of all dimensions in parallel for each mini-batch of points, gives
+ * the same tree as passing the points one at a time.
+ */
+TEST_CASE("HoeffdingTreeMiniBatchStreamingTest", "[HoeffdingTreeTest]")
+{
+  // Generate data with many dimensions (so that the statistics are updated in
+  // parallel), where the label depends on two numeric dimensions and one
+  // categorical dimension.
+  arma::mat dataset(60, 4000, arma::fill::randu);
+  dataset.row(59) = arma::floor(4.0 * dataset.row(59));
+  arma::Row<size_t> labels(4000);
+  for (size_t i = 0; i < 4000; ++i)
+  {
+    if (dataset(59, i) == 3.0)
+      labels[i] = 2;
+    else
+      labels[i] = (dataset(3, i) + dataset(17, i) > 1.0) ? 1 : 0;
+  }
+
+  data::DatasetInfo info(60);
+  info.Type(59) = data::Datatype::categorical;
+  for (size_t c = 0; c < 4; ++c)
+    info.MapString<double>(std::to_string(c), 59);
+
+  // Train one tree in streaming mode on the whole matrix, in two calls, and
+  // another one point at a time.
+  const arma::mat firstData = dataset.cols(0, 1449);
+  const arma::mat secondData = dataset.cols(1450, 3999);
+  const arma::Row<size_t> firstLabels = labels.subvec(0, 1449);
+  const arma::Row<size_t> secondLabels = labels.subvec(1450, 3999);
+
+  HoeffdingTree<> batchTree(info, 3, 0.95, 0, 100, 100);
+  batchTree.Train(firstData, firstLabels, 3, false);
+  batchTree.Train(secondData, secondLabels, 3, false);
+
+  HoeffdingTree<> pointTree(info, 3, 0.95, 0, 100, 100);
+  for (size_t i = 0; i < dataset.n_cols; ++i)
+    pointTree.Train(dataset.col(i), labels[i]);
+
+  REQUIRE(pointTree.NumDescendants() > 1);
+  REQUIRE(batchTree.NumDescendants() == pointTree.NumDescendants());
+  REQUIRE(batchTree.NumSamples() == pointTree.NumSamples());
+  REQUIRE(batchTree.SplitDimension() == pointTree.SplitDimension());
+
+  arma::Row<size_t> batchPredictions, pointPredictions;
+  arma::rowvec batchProbabilities, pointProbabilities;
+  batchTree.Classify(dataset, batchPredictions, batchProbabilities);
+  pointTree.Classify(dataset, pointPredictions, pointProbabilities);
+
+  CheckMatrices(batchPredictions, pointPredictions);
+  CheckMatrices(batchProbabilities, pointProbabilities);
+}
+
+/**
+ * Make sure that a category that first appears after the first chunk of a file
+ * can be used when building a HoeffdingTreeModel from the file.
+ */
+TEST_CASE("HoeffdingTreeModelChunkedNewCategoryTest", "[HoeffdingTreeTest]")
+{
+  // The first dimension is categorical, and the category "c" only appears
+  // after the first 500 points.  The other dimensions hold small integers, so
+  // that they are written exactly to the file.
+  const char* categories[] = { "a", "b", "c" };
+  arma::mat dataset(3, 2000);
+  arma::Row<size_t> labels(2000);
+  data::DatasetInfo info(3);
+  info.Type(0) = data::Datatype::categorical;
+  std::ofstream f("hoeffding_chunked_categories.csv");
+  for (size_t i = 0; i < 2000; ++i)
+  {
+    const size_t c = (i < 500) ? (i % 2) : (i % 3);
+    dataset(0, i) = info.MapString<double>(categories[c], 0);
+    dataset(1, i) = RandInt(10);
+    dataset(2, i) = RandInt(10);
+    labels[i] = (c == 2 || dataset(1, i) > 5) ? 1 : 0;
+
+    f << categories[c] << "," << dataset(1, i) << "," << dataset(2, i) << ","
+        << labels[i] << std::endl;
+  }
+  f.close();
+
+  HoeffdingTreeModel model(HoeffdingTreeModel::GINI_HOEFFDING);
+  model.BuildModel(dataset, info, labels, 2, false, 0.95, 5000, 100, 100, 10,
+      100);
+
+  // The number of classes is found from the file too.
+  data::ChunkedReader reader("hoeffding_chunked_categories.csv", 128);
+  data::DatasetInfo chunkedInfo;
+  HoeffdingTreeModel chunkedModel(HoeffdingTreeModel::GINI_HOEFFDING);
+  REQUIRE(chunkedModel.BuildModel(reader, chunkedInfo, 0, 0.95, 5000, 100,
+      100, 10, 100) == 2000);
+
+  REQUIRE(chunkedInfo.Type(0) == data::Datatype::categorical);
+  REQUIRE(chunkedInfo.NumMappings(0) == 3);
+  REQUIRE(model.NumNodes() > 1);
+  REQUIRE(chunkedModel.NumNodes() == model.NumNodes());
+
+  arma::Row<size_t> predictions, chunkedPredictions;
+  model.Classify(dataset, predictions);
+  chunkedModel.Classify(dataset, chunkedPredictions);
+  CheckMatrices(predictions, chunkedPredictions);
+
+  remove("hoeffding_chunked_categories.csv");
+}
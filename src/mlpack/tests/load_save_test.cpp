@@ -2496,3 +2496,113 @@ TEST_CASE("LoadCSVHeaderTest", "[LoadSaveTest]")
   REQUIRE(dataset.n_rows == 4);
   REQUIRE(dataset.n_cols == 2);
 }
+
+/**
+ * Make sure that reading a dataset in chunks with ChunkedReader gives the same
+ * points and labels as the whole dataset, for text and binary files.
+ */
+TEST_CASE("ChunkedReaderTest", "[LoadSaveTest]")
+{
+  // The last dimension holds labels.
+  arma::mat dataset(4, 103, arma::fill::randu);
+  dataset.row(3) = arma::floor(3.0 * dataset.row(3));
+
+  const std::vector<std::string> filenames = { "chunked_test.csv",
+      "chunked_test.bin" };
+  for (const std::string& filename : filenames)
+  {
+    REQUIRE(data::Save(filename, dataset));
+
+    ChunkedReader reader(filename, 10);
+    arma::mat chunk, points;
+    size_t chunks = 0;
+    while (reader.Next(chunk))
+    {
+      REQUIRE(chunk.n_cols <= 10);
+      points = arma::join_rows(points, chunk);
+      ++chunks;
+    }
+
+    REQUIRE(chunks == 11);
+    REQUIRE(reader.PointsRead() == 103);
+    REQUIRE(chunk.n_elem == 0);
+    CheckMatrices(points, dataset);
+
+    // Read the file again, taking the last dimension as labels.
+    reader.Reset();
+    arma::Row<size_t> chunkLabels, labels;
+    points.clear();
+    while (reader.Next(chunk, chunkLabels))
+    {
+      points = arma::join_rows(points, chunk);
+      labels = arma::join_rows(labels, chunkLabels);
+    }
+
+    CheckMatrices(points, dataset.rows(0, 2));
+    CheckMatrices(labels, ConvTo<arma::Row<size_t>>::From(dataset.row(3)));
+
+    remove(filename.c_str());
+  }
+}
+
+/**
+ * Make sure that ChunkedReader maps categorical values consistently across
+ * chunks, and that non-numeric values in numeric dimensions are caught.
+ */
+TEST_CASE("ChunkedReaderCategoricalTest", "[LoadSaveTest]")
+{
+  fstream f;
+  f.open("chunked_test.csv", fstream::out);
+  f << "1, a, 0" << endl;
+  f << "2, b, 1" << endl;
+  f << endl;
+  f << "3, a, 0" << endl;
+  f << "4, c, 1" << endl;
+  f << "5, b, 1" << endl;
+  f.close();
+
+  ChunkedReader reader("chunked_test.csv", 2);
+  DatasetInfo info;
+  arma::mat chunk;
+  arma::Row<size_t> labels;
+
+  REQUIRE(reader.Next(chunk, info, labels));
+  REQUIRE(info.Dimensionality() == 2);
+  REQUIRE(info.Type(0) == Datatype::numeric);
+  REQUIRE(info.Type(1) == Datatype::categorical);
+  REQUIRE(chunk.n_rows == 2);
+  REQUIRE(chunk.n_cols == 2);
+  REQUIRE(chunk(0, 1) == Approx(2.0));
+  REQUIRE(chunk(1, 0) == 0.0);
+  REQUIRE(chunk(1, 1) == 1.0);
+  REQUIRE(labels[1] == 1);
+
+  // The empty line is skipped, and known categories keep their mappings.
+  REQUIRE(reader.Next(chunk, info, labels));
+  REQUIRE(chunk.n_cols == 2);
+  REQUIRE(chunk(0, 0) == Approx(3.0));
+  REQUIRE(chunk(1, 0) == 0.0);
+  REQUIRE(chunk(1, 1) == 2.0);
+  REQUIRE(info.NumMappings(1) == 3);
+
+  REQUIRE(reader.Next(chunk, info, labels));
+  REQUIRE(chunk.n_cols == 1);
+  REQUIRE(chunk(1, 0) == 1.0);
+  REQUIRE(!reader.Next(chunk, info, labels));
+  REQUIRE(reader.PointsRead() == 5);
+
+  // A non-numeric value in a numeric dimension after the first chunk must
+  // fail.
+  f.open("chunked_test.csv", fstream::out);
+  f << "1, a, 0" << endl;
+  f << "x, b, 1" << endl;
+  f.close();
+
+  ChunkedReader badReader("chunked_test.csv", 1);
+  DatasetInfo badInfo;
+  REQUIRE(badReader.Next(chunk, badInfo, labels));
+  REQUIRE_THROWS_AS(badReader.Next(chunk, badInfo, labels),
+      std::runtime_error);
+
+  remove("chunked_test.csv");
+}
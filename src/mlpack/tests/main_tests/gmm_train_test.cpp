@@ -560,3 +560,67 @@ TEST_CASE_METHOD(GmmTrainTestFixture, "GmmTrainDiagCovariance",
             FAIL("Covariance is not diagonal");
   }
 }
+
+/**
+ * Make sure that online EM can be used from the binding.
+ */
+TEST_CASE_METHOD(GmmTrainTestFixture, "GmmTrainOnlineEMTest",
+                 "[GmmTrainMainTest][BindingTests]")
+{
+  arma::mat inputData(5, 200, arma::fill::randu);
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("gaussians", (int) 2);
+  SetInputParam("batch_size", (int) 20);
+  SetInputParam("max_iterations", (int) 5);
+
+  RUN_BINDING();
+
+  GMM* gmm = params.Get<GMM*>("output_model");
+  REQUIRE(gmm->Gaussians() == 2);
+  REQUIRE(arma::accu(gmm->Weights()) == Approx(1.0).epsilon(1e-7));
+}
+
+/**
+ * Make sure that online EM with diagonal covariances gives diagonal
+ * covariances.
+ */
+TEST_CASE_METHOD(GmmTrainTestFixture, "GmmTrainOnlineEMDiagCovarianceTest",
+                 "[GmmTrainMainTest][BindingTests]")
+{
+  arma::mat inputData(5, 200, arma::fill::randu);
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("gaussians", (int) 2);
+  SetInputParam("batch_size", (int) 20);
+  SetInputParam("max_iterations", (int) 5);
+  SetInputParam("diagonal_covariance", true);
+
+  RUN_BINDING();
+
+  GMM* gmm = params.Get<GMM*>("output_model");
+  REQUIRE(gmm->Gaussians() == 2);
+  REQUIRE(arma::accu(gmm->Weights()) == Approx(1.0).epsilon(1e-7));
+  for (size_t k = 0; k < gmm->Gaussians(); ++k)
+  {
+    const arma::mat& cov = gmm->Component(k).Covariance();
+    REQUIRE(arma::accu(arma::abs(cov - arma::diagmat(cov))) == 0.0);
+    REQUIRE(arma::all(cov.diag() > 0.0));
+  }
+}
+
+/**
+ * Ensure that an invalid online EM step size decay is rejected.
+ */
+TEST_CASE_METHOD(GmmTrainTestFixture, "GmmTrainOnlineEMStepSizeDecayTest",
+                 "[GmmTrainMainTest][BindingTests]")
+{
+  arma::mat inputData(5, 20, arma::fill::randu);
+
+  SetInputParam("input", std::move(inputData));
+  SetInputParam("gaussians", (int) 2);
+  SetInputParam("batch_size", (int) 5);
+  SetInputParam("step_size_decay", 0.2);
+
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+}
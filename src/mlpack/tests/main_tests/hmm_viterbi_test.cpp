@@ -227,3 +227,36 @@ TEST_CASE_METHOD(HMMViterbiTestFixture,
   REQUIRE(out.n_rows == 1);
   REQUIRE(out.n_cols == observations.n_cols);
 }
+
+TEST_CASE_METHOD(HMMViterbiTestFixture,
+                 "HMMViterbiOnlineMatchesOfflineTest",
+                 "[HMMViterbiMainTest][BindingTests]")
+{
+  // Load data to train a discrete HMM model with.
+  arma::mat inp;
+  data::Load("obs1.csv", inp);
+  std::vector<arma::mat> trainSeq = {inp};
+
+  // Initialize and train a discrete HMM model.
+  HMMModel* h = new HMMModel(DiscreteHMM);
+  h->PerformAction<InitHMMModel, std::vector<arma::mat>>(params, &trainSeq);
+  h->PerformAction<TrainHMMModel, std::vector<arma::mat>>(params, &trainSeq);
+
+  // Compute the expected state sequence with the regular Viterbi algorithm.
+  arma::Row<size_t> expected;
+  h->DiscreteHMM()->Predict(inp, expected);
+
+  SetInputParam("input_model", h);
+  SetInputParam("input", inp);
+  SetInputParam("online", true);
+
+  // Call to hmm_viterbi_main.
+  RUN_BINDING();
+
+  arma::Mat<size_t> out = params.Get<arma::Mat<size_t> >("output");
+
+  REQUIRE(out.n_rows == 1);
+  REQUIRE(out.n_cols == inp.n_cols);
+  for (size_t i = 0; i < out.n_cols; ++i)
+    REQUIRE(out[i] == expected[i]);
+}
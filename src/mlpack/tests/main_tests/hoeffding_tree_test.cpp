@@ -722,3 +722,62 @@ TEST_CASE_METHOD(HoeffdingTreeTestFixture, "HoeffdingBinningTest",
   REQUIRE((params.Get<HoeffdingTreeModel*>("output_model"))->NumNodes()
       == 1);
 }
+
+/**
+ * Make sure that training on a file streamed in chunks gives the same
+ * predictions as training on the same dataset loaded into memory.
+ */
+TEST_CASE_METHOD(HoeffdingTreeTestFixture, "HoeffdingTrainingFileTest",
+                 "[HoeffdingTreeMainTest][BindingTest]")
+{
+  arma::mat inputData;
+  DatasetInfo info;
+  if (!data::Load("vc2.csv", inputData, info))
+    FAIL("Cannot load train dataset vc2.csv!");
+
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load labels for vc2_labels.txt");
+
+  arma::mat testData;
+  if (!data::Load("vc2_test.csv", testData, info))
+    FAIL("Cannot load test dataset vc2.csv!");
+
+  // Write the training set with the labels as the last dimension.
+  const int numClasses = (int) arma::max(labels) + 1;
+  arma::mat fileData = arma::join_cols(inputData,
+      ConvTo<arma::rowvec>::From(labels));
+  if (!data::Save("hoeffding_training.bin", fileData))
+    FAIL("Cannot save training dataset hoeffding_training.bin!");
+
+  // Input training data.
+  SetInputParam("training", std::make_tuple(info, inputData));
+  SetInputParam("labels", std::move(labels));
+
+  // Input test data.
+  SetInputParam("test", std::make_tuple(info, testData));
+
+  RUN_BINDING();
+
+  arma::Row<size_t> predictions;
+  predictions = std::move(params.Get<arma::Row<size_t>>("predictions"));
+  const size_t numNodes =
+      params.Get<HoeffdingTreeModel*>("output_model")->NumNodes();
+
+  CleanMemory();
+  ResetSettings();
+
+  // Now stream the training set from the file.
+  SetInputParam("training_file", (string) "hoeffding_training.bin");
+  SetInputParam("chunk_size", 25);
+  SetInputParam("num_classes", numClasses);
+  SetInputParam("test", std::make_tuple(info, testData));
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<HoeffdingTreeModel*>("output_model")->NumNodes() ==
+      numNodes);
+  CheckMatrices(predictions, params.Get<arma::Row<size_t>>("predictions"));
+
+  remove("hoeffding_training.bin");
+}
@@ -0,0 +1,103 @@
+/**
+ * @file tests/main_tests/xgboost_regressor_test.cpp
+ *
+ * Test RUN_BINDING() of xgboost_regressor_main.cpp.
+ *
+ * mlpack is free software; you may redistribute it and/or modify it under the
+ * terms of the 3-clause BSD license.  You should have received a copy of the
+ * 3-clause BSD license along with mlpack.  If not, see
+ * http://www.opensource.org/licenses/BSD-3-Clause for more information.
+ */
+#define BINDING_TYPE BINDING_TYPE_TEST
+
+#include <mlpack/core.hpp>
+#include <mlpack/methods/xgboost/xgboost_regressor_main.cpp>
+#include <mlpack/core/util/mlpack_main.hpp>
+
+#include "main_test_fixture.hpp"
+
+#include "../catch.hpp"
+#include "../test_catch_tools.hpp"
+
+using namespace mlpack;
+
+BINDING_TEST_FIXTURE(XGBoostRegressorTestFixture);
+
+/**
+ * Check that a trained model gives a prediction for each test point, and that
+ * the saved model gives the same predictions.
+ */
+TEST_CASE_METHOD(XGBoostRegressorTestFixture, "XGBoostRegressorModelReuseTest",
+                 "[XGBoostRegressorMainTest][BindingTests]")
+{
+  arma::mat inputData(3, 300, arma::fill::randu);
+  arma::rowvec responses = 2 * inputData.row(0) - inputData.row(2);
+  arma::mat testData(3, 50, arma::fill::randu);
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("responses", std::move(responses));
+  SetInputParam("num_trees", (int) 20);
+  SetInputParam("test", testData);
+
+  RUN_BINDING();
+
+  arma::rowvec predictions =
+      std::move(params.Get<arma::rowvec>("predictions"));
+  REQUIRE(predictions.n_elem == 50);
+
+  // Reset passed parameters.
+  XGBoostRegressor<>* m = params.Get<XGBoostRegressor<>*>("output_model");
+  params.Get<XGBoostRegressor<>*>("output_model") = NULL;
+  CleanMemory();
+  ResetSettings();
+
+  // Input trained model.
+  SetInputParam("test", std::move(testData));
+  SetInputParam("input_model", m);
+
+  RUN_BINDING();
+
+  CheckMatrices(predictions, params.Get<arma::rowvec>("predictions"));
+}
+
+/**
+ * Make sure that early stopping on a validation set keeps fewer trees than the
+ * maximum when the responses are noise.
+ */
+TEST_CASE_METHOD(XGBoostRegressorTestFixture,
+                 "XGBoostRegressorEarlyStoppingTest",
+                 "[XGBoostRegressorMainTest][BindingTests]")
+{
+  arma::mat inputData(3, 300, arma::fill::randu);
+  arma::rowvec responses(300, arma::fill::randn);
+  arma::mat validation(3, 100, arma::fill::randu);
+  arma::rowvec validationResponses(100, arma::fill::randn);
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("responses", std::move(responses));
+  SetInputParam("validation", std::move(validation));
+  SetInputParam("validation_responses", std::move(validationResponses));
+  SetInputParam("early_stopping_rounds", (int) 3);
+  SetInputParam("maximum_depth", (int) 0);
+  SetInputParam("num_trees", (int) 200);
+
+  RUN_BINDING();
+
+  REQUIRE(params.Get<XGBoostRegressor<>*>("output_model")->NumTrees() < 200);
+}
+
+/**
+ * Make sure invalid subsampling fractions are rejected.
+ */
+TEST_CASE_METHOD(XGBoostRegressorTestFixture, "XGBoostRegressorSubsampleTest",
+                 "[XGBoostRegressorMainTest][BindingTests]")
+{
+  arma::mat inputData(3, 100, arma::fill::randu);
+  arma::rowvec responses(100, arma::fill::randu);
+
+  SetInputParam("training", std::move(inputData));
+  SetInputParam("responses", std::move(responses));
+  SetInputParam("row_subsample", 1.5); // Invalid.
+
+  REQUIRE_THROWS_AS(RUN_BINDING(), std::runtime_error);
+}
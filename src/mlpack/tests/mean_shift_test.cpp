@@ -160,3 +160,44 @@ TEST_CASE("GaussianClustering", "[MeanShiftTest]")
 
   REQUIRE(success == true);
 }
+
+/**
+ * Make sure that using every point as a seed (which makes many trajectories
+ * merge) finds the same clusters as binned seeds.
+ */
+TEST_CASE("MeanShiftNoSeedsTest", "[MeanShiftTest]")
+{
+  MeanShift<> meanShift;
+
+  arma::Row<size_t> assignments, seedAssignments;
+  arma::mat centroids, seedCentroids;
+  meanShift.Cluster((arma::mat) trans(meanShiftData), assignments, centroids,
+      true, false);
+  meanShift.Cluster((arma::mat) trans(meanShiftData), seedAssignments,
+      seedCentroids, true, true);
+
+  REQUIRE(centroids.n_cols == 3);
+  REQUIRE(seedCentroids.n_cols == 3);
+
+  // Each centroid must be close to one of the centroids found with seeds.
+  for (size_t i = 0; i < centroids.n_cols; ++i)
+  {
+    double minDistance = DBL_MAX;
+    for (size_t j = 0; j < seedCentroids.n_cols; ++j)
+    {
+      minDistance = std::min(minDistance, EuclideanDistance::Evaluate(
+          centroids.col(i), seedCentroids.col(j)));
+    }
+    REQUIRE(minDistance < meanShift.Radius());
+  }
+
+  // The partitions must be the same, up to a relabeling.
+  for (size_t i = 0; i < assignments.n_elem; ++i)
+  {
+    for (size_t j = i + 1; j < assignments.n_elem; ++j)
+    {
+      REQUIRE((assignments[i] == assignments[j]) ==
+          (seedAssignments[i] == seedAssignments[j]));
+    }
+  }
+}
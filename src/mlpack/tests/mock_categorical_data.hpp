@@ -170,4 +170,67 @@ inline void MockCategoricalData(arma::mat& d,
   datasetInfo.MapString<double>("4", 4);
 }
 
+/**
+ * Create a mock dataset with one categorical feature with many categories and
+ * one numeric noise feature, for testing classification.  The class of each
+ * point is given by its category, except for 5% of the points, whose class is
+ * random.
+ */
+inline void MockHighCardinalityData(arma::mat& d,
+                                    arma::Row<size_t>& l,
+                                    mlpack::data::DatasetInfo& datasetInfo,
+                                    const size_t numPoints,
+                                    const size_t numCategories,
+                                    const size_t numClasses)
+{
+  // Assign a class to every category.
+  arma::Row<size_t> categoryClasses = arma::randi<arma::Row<size_t>>(
+      numCategories, arma::distr_param(0, (int) numClasses - 1));
+
+  d.set_size(2, numPoints);
+  l.set_size(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    d(0, i) = mlpack::RandInt(numCategories);
+    d(1, i) = mlpack::Random();
+    l[i] = (mlpack::Random() < 0.05) ? mlpack::RandInt(numClasses) :
+        categoryClasses[(size_t) d(0, i)];
+  }
+
+  datasetInfo = mlpack::data::DatasetInfo(2);
+  datasetInfo.Type(0) = mlpack::data::Datatype::categorical;
+  for (size_t c = 0; c < numCategories; ++c)
+    datasetInfo.MapString<double>(std::to_string(c), 0);
+}
+
+/**
+ * Create a mock dataset with one categorical feature with many categories and
+ * one numeric noise feature, for testing regression.  The response of each
+ * point is the mean response of its category, plus some noise.
+ */
+inline void MockHighCardinalityData(arma::mat& d,
+                                    arma::Row<double>& r,
+                                    mlpack::data::DatasetInfo& datasetInfo,
+                                    const size_t numPoints,
+                                    const size_t numCategories)
+{
+  // Assign a mean response to every category.
+  arma::rowvec categoryMeans = 10.0 * arma::randu<arma::rowvec>(numCategories);
+
+  d.set_size(2, numPoints);
+  r.set_size(numPoints);
+  for (size_t i = 0; i < numPoints; ++i)
+  {
+    d(0, i) = mlpack::RandInt(numCategories);
+    d(1, i) = mlpack::Random();
+    // Random noise in range [-0.5, 0.5).
+    r[i] = categoryMeans[(size_t) d(0, i)] + (mlpack::Random() - 0.5);
+  }
+
+  datasetInfo = mlpack::data::DatasetInfo(2);
+  datasetInfo.Type(0) = mlpack::data::Datatype::categorical;
+  for (size_t c = 0; c < numCategories; ++c)
+    datasetInfo.MapString<double>(std::to_string(c), 0);
+}
+
 #endif
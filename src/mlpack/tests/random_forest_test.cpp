@@ -245,6 +245,33 @@ TEST_CASE("UnweightedCategoricalLearningTest", "[RandomForestTest]")
   REQUIRE(rfCorrect >= size_t(0.7 * testData.n_cols));
 }
 
+/**
+ * Test that a random forest can split a categorical feature with many
+ * categories with BestBinaryCategoricalSplit.
+ */
+TEST_CASE("BinaryCategoricalSplitLearningTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockHighCardinalityData(d, l, di, 12000, 500, 3);
+
+  // Split into a training set and a test set.
+  arma::mat trainingData = d.cols(0, 9999);
+  arma::mat testData = d.cols(10000, 11999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 9999);
+  arma::Row<size_t> testLabels = l.subvec(10000, 11999);
+
+  RandomForest<GiniGain, MultipleRandomDimensionSelect, BestBinaryNumericSplit,
+      BestBinaryCategoricalSplit> rf(trainingData, di, trainingLabels, 3,
+      10 /* 10 trees */, 3, 1e-7, 0, MultipleRandomDimensionSelect(2));
+
+  arma::Row<size_t> predictions;
+  rf.Classify(testData, predictions);
+  REQUIRE(arma::accu(predictions == testLabels) >=
+      size_t(0.85 * testData.n_cols));
+}
+
 /**
  * Test weighted categorical learning.
  */
@@ -607,3 +634,135 @@ TEST_CASE("ExtraTreesAccuracyTest", "[RandomForestTest]")
 
   REQUIRE(accuracy >= 0.85);
 }
+
+/**
+ * Test that a CompiledForest gives exactly the same predictions and
+ * probabilities as the random forest it was compiled from, on numeric data.
+ */
+TEST_CASE("CompiledForestNumericTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+  arma::mat testDataset;
+  if (!data::Load("vc2_test.csv", testDataset))
+    FAIL("Cannot load dataset vc2_test.csv");
+
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 1);
+  CompiledForest compiled(rf);
+
+  REQUIRE(compiled.NumTrees() == 20);
+  REQUIRE(compiled.NumClasses() == 3);
+
+  arma::Row<size_t> predictions, compiledPredictions, compiledPredictions2;
+  arma::mat probabilities, compiledProbabilities;
+  rf.Classify(testDataset, predictions, probabilities);
+  compiled.Classify(testDataset, compiledPredictions, compiledProbabilities);
+  compiled.Classify(testDataset, compiledPredictions2);
+
+  CheckMatrices(predictions, compiledPredictions);
+  CheckMatrices(predictions, compiledPredictions2);
+  CheckMatrices(probabilities, compiledProbabilities);
+
+  for (size_t i = 0; i < testDataset.n_cols; ++i)
+  {
+    size_t prediction;
+    arma::vec pointProbabilities;
+    compiled.Classify(testDataset.col(i), prediction, pointProbabilities);
+
+    REQUIRE(compiled.Classify(testDataset.col(i)) == predictions[i]);
+    REQUIRE(prediction == predictions[i]);
+    CheckMatrices(pointProbabilities, arma::vec(probabilities.col(i)));
+  }
+}
+
+/**
+ * Test that a CompiledForest matches a random forest and a single decision tree
+ * on categorical data, and that it can be serialized.
+ */
+TEST_CASE("CompiledForestCategoricalTest", "[RandomForestTest]")
+{
+  arma::mat d;
+  arma::Row<size_t> l;
+  data::DatasetInfo di;
+  MockCategoricalData(d, l, di);
+
+  arma::mat trainingData = d.cols(0, 1999);
+  arma::mat testData = d.cols(2000, 3999);
+  arma::Row<size_t> trainingLabels = l.subvec(0, 1999);
+
+  RandomForest<> rf(trainingData, di, trainingLabels, 5, 10 /* 10 trees */, 1,
+      1e-7, 0, MultipleRandomDimensionSelect(4));
+  DecisionTree<> dt(trainingData, di, trainingLabels, 5, 5);
+
+  CompiledForest compiledForest(rf);
+  CompiledForest compiledTree(dt);
+  REQUIRE(compiledTree.NumTrees() == 1);
+
+  arma::Row<size_t> rfPredictions, dtPredictions, compiledRFPredictions,
+      compiledDTPredictions;
+  arma::mat rfProbabilities, dtProbabilities, compiledRFProbabilities,
+      compiledDTProbabilities;
+  rf.Classify(testData, rfPredictions, rfProbabilities);
+  dt.Classify(testData, dtPredictions, dtProbabilities);
+  compiledForest.Classify(testData, compiledRFPredictions,
+      compiledRFProbabilities);
+  compiledTree.Classify(testData, compiledDTPredictions,
+      compiledDTProbabilities);
+
+  CheckMatrices(rfPredictions, compiledRFPredictions);
+  CheckMatrices(rfProbabilities, compiledRFProbabilities);
+  CheckMatrices(dtPredictions, compiledDTPredictions);
+  CheckMatrices(dtProbabilities, compiledDTProbabilities);
+
+  CompiledForest xmlForest, jsonForest, binaryForest;
+  SerializeObjectAll(compiledForest, xmlForest, jsonForest, binaryForest);
+
+  arma::Row<size_t> xmlPredictions, jsonPredictions, binaryPredictions;
+  arma::mat xmlProbabilities, jsonProbabilities, binaryProbabilities;
+  xmlForest.Classify(testData, xmlPredictions, xmlProbabilities);
+  jsonForest.Classify(testData, jsonPredictions, jsonProbabilities);
+  binaryForest.Classify(testData, binaryPredictions, binaryProbabilities);
+
+  CheckMatrices(rfPredictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+  CheckMatrices(rfProbabilities, xmlProbabilities, jsonProbabilities,
+      binaryProbabilities);
+}
+
+/**
+ * Test that a CompiledForest sends points with missing values to the same
+ * children as the random forest it was compiled from.
+ */
+TEST_CASE("CompiledForestMissingValuesTest", "[RandomForestTest]")
+{
+  arma::mat dataset;
+  if (!data::Load("vc2.csv", dataset))
+    FAIL("Cannot load dataset vc2.csv");
+  arma::Row<size_t> labels;
+  if (!data::Load("vc2_labels.txt", labels))
+    FAIL("Cannot load dataset vc2_labels.txt");
+  arma::mat testDataset;
+  if (!data::Load("vc2_test.csv", testDataset))
+    FAIL("Cannot load dataset vc2_test.csv");
+
+  // Remove some of the values of the training and test sets.
+  for (size_t i = 0; i < dataset.n_elem; i += 7)
+    dataset[i] = arma::datum::nan;
+  for (size_t i = 0; i < testDataset.n_elem; i += 5)
+    testDataset[i] = arma::datum::nan;
+
+  RandomForest<> rf(dataset, labels, 3, 20 /* 20 trees */, 1);
+  CompiledForest compiled(rf);
+
+  arma::Row<size_t> predictions, compiledPredictions;
+  arma::mat probabilities, compiledProbabilities;
+  rf.Classify(testDataset, predictions, probabilities);
+  compiled.Classify(testDataset, compiledPredictions, compiledProbabilities);
+
+  CheckMatrices(predictions, compiledPredictions);
+  CheckMatrices(probabilities, compiledProbabilities);
+}
@@ -10,10 +10,11 @@
  * http://www.opensource.org/licenses/BSD-3-Clause for more information.
  */
 #include <mlpack/core.hpp>
-#include <mlpack/methods/xgboost/loss_functions/sse_loss.hpp>
+#include <mlpack/methods/xgboost.hpp>
 
 #include "catch.hpp"
 #include "serialization.hpp"
+#include "test_function_tools.hpp"
 
 using namespace mlpack;
 
@@ -63,3 +64,173 @@ TEST_CASE("SSEGainTest", "[XGBTest]")
   SSELoss Loss;
   REQUIRE(Loss.Evaluate<false>(input, weights) == gain);
 }
+
+/**
+ * Test that SecondOrderGain is the same as MSEGain when there is no
+ * regularization, and that the leaf value is the mean.
+ */
+TEST_CASE("SecondOrderGainMSETest", "[XGBTest]")
+{
+  arma::rowvec targets = { 1, 3, 2, 2, 5, 6, 9, 11, 8, 8 };
+  arma::rowvec weights = { 1, 2, 1, 1, 3, 1, 1, 2, 1, 1 };
+
+  SecondOrderGain gain;
+  MSEGain mse;
+
+  REQUIRE(gain.Evaluate<false>(targets, weights) ==
+      Approx(mse.Evaluate<false>(targets, weights)).epsilon(1e-7));
+  REQUIRE(gain.Evaluate<true>(targets, weights) ==
+      Approx(mse.Evaluate<true>(targets, weights)).epsilon(1e-7));
+  REQUIRE(gain.OutputLeafValue<false>(targets, weights) ==
+      Approx(5.5).epsilon(1e-7));
+
+  // The cached statistics must give the same gains.
+  gain.BinaryScanInitialize<true>(targets, weights, 1);
+  for (size_t i = 0; i < 4; ++i)
+    gain.BinaryStep<true>(targets, weights, i);
+
+  const std::tuple<double, double> gains = gain.BinaryGains();
+  REQUIRE(std::get<0>(gains) == Approx(mse.Evaluate<true>(
+      targets.subvec(0, 3), weights.subvec(0, 3))).epsilon(1e-7));
+  REQUIRE(std::get<1>(gains) == Approx(mse.Evaluate<true>(
+      targets.subvec(4, 9), weights.subvec(4, 9))).epsilon(1e-7));
+}
+
+/**
+ * Test that the regularized leaf value of SecondOrderGain matches the leaf
+ * value of SSELoss, when the targets are the Newton steps.
+ */
+TEST_CASE("SecondOrderGainLeafValueTest", "[XGBTest]")
+{
+  arma::mat input = { { 1,   3,   2,   2, 5, 6, 9,    11, 8,   8 },
+                      { 0.5, 1, 2.5, 1.5, 5, 8, 8, 10.75, 9, 9.5 } };
+  arma::vec weights; // dummy weights not used.
+
+  SSELoss loss(0.5, 2.0);
+  (void) loss.Evaluate<false>(input, weights);
+
+  // For SSELoss the hessians are all one, so the targets are the residuals.
+  arma::rowvec gradients, hessians;
+  loss.Gradients(arma::rowvec(input.row(0)), arma::rowvec(input.row(1)),
+      gradients, hessians);
+  arma::rowvec targets = -gradients / hessians;
+
+  SecondOrderGain gain(0.5, 2.0);
+  REQUIRE(gain.OutputLeafValue<true>(targets, hessians) ==
+      Approx(loss.OutputLeafValue(input, weights)).epsilon(1e-7));
+}
+
+/**
+ * Test that a boosted model fits a nonlinear function much better than a single
+ * regression tree of the same depth.
+ */
+TEST_CASE("XGBoostRegressorFitTest", "[XGBTest]")
+{
+  arma::mat data(2, 1000, arma::fill::randu);
+  arma::rowvec responses = arma::sin(4 * data.row(0)) +
+      data.row(1) % data.row(1);
+
+  arma::mat trainData = data.cols(0, 799);
+  arma::mat testData = data.cols(800, 999);
+  arma::rowvec trainResponses = responses.subvec(0, 799);
+  arma::rowvec testResponses = responses.subvec(800, 999);
+
+  XGBoostRegressor<> model(trainData, trainResponses, 100, 0.3, 3);
+  REQUIRE(model.NumTrees() == 100);
+
+  arma::rowvec predictions;
+  model.Predict(testData, predictions);
+  REQUIRE(predictions.n_elem == testData.n_cols);
+
+  DecisionTreeRegressor<> tree(trainData, trainResponses, 1, 1e-7, 3);
+  arma::rowvec treePredictions;
+  tree.Predict(testData, treePredictions);
+
+  REQUIRE(RMSE(predictions, testResponses) < 0.1);
+  REQUIRE(RMSE(predictions, testResponses) <
+      RMSE(treePredictions, testResponses));
+
+  // The single-point prediction must agree with the batch prediction.
+  for (size_t i = 0; i < testData.n_cols; ++i)
+    REQUIRE(model.Predict(testData.col(i)) ==
+        Approx(predictions[i]).epsilon(1e-7));
+}
+
+/**
+ * Test that row and column subsampling, regularization and the histogram split
+ * still give a good model.
+ */
+TEST_CASE("XGBoostRegressorSubsampleTest", "[XGBTest]")
+{
+  arma::mat data(4, 1000, arma::fill::randu);
+  arma::rowvec responses = 3 * data.row(0) - 2 * data.row(2);
+
+  XGBoostRegressor<SSELoss, HistogramNumericSplit> model;
+  const double loss = model.Train(data, responses, 200, 0.1, 4, 5, 1e-7, 0.5,
+      0.5, SSELoss(0.0, 1.0));
+
+  arma::rowvec predictions;
+  model.Predict(data, predictions);
+
+  REQUIRE(loss == Approx(0.5 * arma::accu(arma::square(predictions -
+      responses)) / responses.n_elem).epsilon(1e-5));
+  REQUIRE(RMSE(predictions, responses) < 0.1);
+}
+
+/**
+ * Test that early stopping keeps only the trees up to the best validation
+ * loss.
+ */
+TEST_CASE("XGBoostRegressorEarlyStoppingTest", "[XGBTest]")
+{
+  // The responses are pure noise, so the validation loss cannot improve for
+  // long.
+  arma::mat data(3, 500, arma::fill::randu);
+  arma::rowvec responses(500, arma::fill::randn);
+  arma::mat validationData(3, 200, arma::fill::randu);
+  arma::rowvec validationResponses(200, arma::fill::randn);
+
+  XGBoostRegressor<> model;
+  const double loss = model.Train(data, responses, validationData,
+      validationResponses, 5, 500, 0.3, 0);
+
+  REQUIRE(model.NumTrees() > 0);
+  REQUIRE(model.NumTrees() < 500);
+
+  // The returned loss must be the validation loss of the kept trees.
+  arma::rowvec predictions;
+  model.Predict(validationData, predictions);
+  REQUIRE(loss == Approx(0.5 * arma::accu(arma::square(predictions -
+      validationResponses)) / validationResponses.n_elem).epsilon(1e-5));
+}
+
+/**
+ * Test that the model can be serialized and deserialized.
+ */
+TEST_CASE("XGBoostRegressorSerializationTest", "[XGBTest]")
+{
+  arma::mat data(2, 300, arma::fill::randu);
+  arma::rowvec responses = data.row(0) + 2 * data.row(1);
+
+  XGBoostRegressor<> model(data, responses, 20);
+
+  arma::rowvec predictions;
+  model.Predict(data, predictions);
+
+  XGBoostRegressor<> xmlModel, jsonModel, binaryModel;
+  xmlModel.Train(data, arma::rowvec(300, arma::fill::randu), 5);
+
+  SerializeObjectAll(model, xmlModel, jsonModel, binaryModel);
+
+  REQUIRE(xmlModel.NumTrees() == 20);
+  REQUIRE(jsonModel.NumTrees() == 20);
+  REQUIRE(binaryModel.NumTrees() == 20);
+
+  arma::rowvec xmlPredictions, jsonPredictions, binaryPredictions;
+  xmlModel.Predict(data, xmlPredictions);
+  jsonModel.Predict(data, jsonPredictions);
+  binaryModel.Predict(data, binaryPredictions);
+
+  CheckMatrices(predictions, xmlPredictions, jsonPredictions,
+      binaryPredictions);
+}